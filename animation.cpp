@@ -0,0 +1,417 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "animation.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+
+  // out = nlerp(a, b, weight) for every bone of two poses, b's rotation is
+  // flipped where it points away from a's so the shorter way is taken
+  void blendPoses(const float* a, const float* b, float weight, float* out,
+                  unsigned int stride)
+  {
+    const float8 w(weight), zero(0.0f), one(1.0f), minusOne(-1.0f);
+    const float8 tiny(1e-12f);
+    for (unsigned int i = 0; i < stride; i += 8)
+    {
+      float8 ax = float8::load(a + i), bx = float8::load(b + i);
+      float8 ay = float8::load(a + stride + i);
+      float8 by = float8::load(b + stride + i);
+      float8 az = float8::load(a + 2 * stride + i);
+      float8 bz = float8::load(b + 2 * stride + i);
+      float8 aw = float8::load(a + 3 * stride + i);
+      float8 bw = float8::load(b + 3 * stride + i);
+      float8 dot = ax * bx + ay * by + az * bz + aw * bw;
+      float8 sign = select(dot < zero, minusOne, one);
+      float8 x = fmadd(bx * sign - ax, w, ax);
+      float8 y = fmadd(by * sign - ay, w, ay);
+      float8 z = fmadd(bz * sign - az, w, az);
+      float8 q = fmadd(bw * sign - aw, w, aw);
+      float8 scale = one / sqrt(max(x * x + y * y + z * z + q * q, tiny));
+      (x * scale).store(out + i);
+      (y * scale).store(out + stride + i);
+      (z * scale).store(out + 2 * stride + i);
+      (q * scale).store(out + 3 * stride + i);
+      for (int c = 4; c < AnimationClip::CHANNELS; c++)
+      {
+        float8 from = float8::load(a + c * stride + i);
+        float8 to = float8::load(b + c * stride + i);
+        fmadd(to - from, w, from).store(out + c * stride + i);
+      }
+    }
+  }
+
+  // 3x4 local matrix (row major) of one bone of 8 characters: rotation
+  // times scale, translation in the last column
+  void localMatrix(const float8 pose[AnimationClip::CHANNELS], float8 out[12])
+  {
+    const float8 one(1.0f), two(2.0f);
+    float8 x = pose[0], y = pose[1], z = pose[2], w = pose[3];
+    float8 xx = x * x, yy = y * y, zz = z * z;
+    float8 xy = x * y, xz = x * z, yz = y * z;
+    float8 wx = w * x, wy = w * y, wz = w * z;
+    out[0] = (one - two * (yy + zz)) * pose[7];
+    out[1] = two * (xy - wz) * pose[8];
+    out[2] = two * (xz + wy) * pose[9];
+    out[3] = pose[4];
+    out[4] = two * (xy + wz) * pose[7];
+    out[5] = (one - two * (xx + zz)) * pose[8];
+    out[6] = two * (yz - wx) * pose[9];
+    out[7] = pose[5];
+    out[8] = two * (xz - wy) * pose[7];
+    out[9] = two * (yz + wx) * pose[8];
+    out[10] = (one - two * (xx + yy)) * pose[9];
+    out[11] = pose[6];
+  }
+
+  // out = a * b for affine 3x4 row major matrices, 8 pairs at once
+  void multiplyAffine(const float8* a, const float8* b, float8* out)
+  {
+    for (int r = 0; r < 3; r++)
+    {
+      const float8* row = a + r * 4;
+      for (int c = 0; c < 3; c++)
+        out[r * 4 + c] = fmadd(row[0], b[c],
+                               fmadd(row[1], b[4 + c], row[2] * b[8 + c]));
+      out[r * 4 + 3] = fmadd(row[0], b[3],
+                             fmadd(row[1], b[7], fmadd(row[2], b[11],
+                                                       row[3])));
+    }
+  }
+
+  void toAffine(const glm::mat4 &m, float* out)
+  {
+    for (int r = 0; r < 3; r++)
+      for (int c = 0; c < 4; c++)
+        out[r * 4 + c] = m[c][r];
+  }
+
+  glm::quat nlerp(glm::quat a, glm::quat b, float weight)
+  {
+    if (glm::dot(a, b) < 0.0f)
+      b = -b;
+    return glm::normalize(a * (1.0f - weight) + b * weight);
+  }
+}
+
+AnimationClip::AnimationClip(unsigned int boneCount, unsigned int frameCount,
+                             float frameRate)
+  : bones(boneCount), paddedBones((boneCount + 7) & ~7u),
+    frames(std::max(frameCount, 1u)), frameRate(frameRate)
+{
+  // identity everywhere, padding included, so the padded lanes stay finite
+  data.assign(frames * CHANNELS * paddedBones, 0.0f);
+  for (unsigned int f = 0; f < frames; f++)
+  {
+    float* key = &data[f * CHANNELS * paddedBones];
+    std::fill(key + 3 * paddedBones, key + 4 * paddedBones, 1.0f);
+    std::fill(key + 7 * paddedBones, key + 10 * paddedBones, 1.0f);
+  }
+}
+
+void AnimationClip::setKey(unsigned int frame, unsigned int bone,
+                           const glm::quat &rotation,
+                           const glm::vec3 &translation,
+                           const glm::vec3 &scale)
+{
+  if (frame >= frames || bone >= bones)
+    return;
+  float* key = &data[frame * CHANNELS * paddedBones] + bone;
+  const float values[CHANNELS] = {rotation.x, rotation.y, rotation.z,
+                                  rotation.w, translation.x, translation.y,
+                                  translation.z, scale.x, scale.y, scale.z};
+  for (int c = 0; c < CHANNELS; c++)
+    key[c * paddedBones] = values[c];
+}
+
+unsigned int AnimationClip::boneCount() const
+{
+  return bones;
+}
+
+unsigned int AnimationClip::stride() const
+{
+  return paddedBones;
+}
+
+float AnimationClip::duration() const
+{
+  return frames / frameRate;
+}
+
+void AnimationClip::keys(float time, const float* &a, const float* &b,
+                         float &weight) const
+{
+  float position = time * frameRate;
+  position -= std::floor(position / frames) * frames;
+  unsigned int first = std::min((unsigned int)position, frames - 1);
+  unsigned int second = (first + 1) % frames;
+  weight = position - first;
+  a = &data[first * CHANNELS * paddedBones];
+  b = &data[second * CHANNELS * paddedBones];
+}
+
+AnimationSystem::AnimationSystem(const Skeleton &skeleton,
+                                 unsigned int maxCharacters)
+  : simd(true), chunkSize(16), skeleton(skeleton),
+    maxCharacters(maxCharacters), lastMilliseconds(0.0)
+{
+  if (skeleton.parents.size() > MAX_BONES)
+  {
+    std::cout << "ERROR::ANIMATION::TOO_MANY_BONES" << std::endl;
+    this->skeleton.parents.resize(MAX_BONES);
+  }
+  for (size_t i = 0; i < this->skeleton.parents.size(); i++)
+    if (this->skeleton.parents[i] >= (int)i)
+    {
+      std::cout << "ERROR::ANIMATION::PARENT_AFTER_CHILD" << std::endl;
+      this->skeleton.parents[i] = -1;
+    }
+  this->skeleton.inverseBind.resize(this->skeleton.parents.size(),
+                                    glm::mat4(1.0f));
+  paddedBones = (boneCount() + 7) & ~7u;
+  inverseBind.resize(boneCount() * 12);
+  for (unsigned int bone = 0; bone < boneCount(); bone++)
+    toAffine(this->skeleton.inverseBind[bone], &inverseBind[bone * 12]);
+
+  glGenBuffers(1, &paletteBuffer);
+  glGenTextures(1, &paletteBufferTexture);
+  glBindBuffer(GL_TEXTURE_BUFFER, paletteBuffer);
+  glBufferData(GL_TEXTURE_BUFFER,
+               std::max(maxCharacters * boneCount(), 1u) * 12 * sizeof(float),
+               NULL, GL_STREAM_DRAW);
+  glBindTexture(GL_TEXTURE_BUFFER, paletteBufferTexture);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, paletteBuffer);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+  glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+AnimationSystem::~AnimationSystem()
+{
+  glDeleteTextures(1, &paletteBufferTexture);
+  glDeleteBuffers(1, &paletteBuffer);
+}
+
+void AnimationSystem::evaluateSimd(const CharacterState* characters,
+                                   unsigned int count, float* palettes) const
+{
+  // sampling and blending run over the bones of one character, the
+  // hierarchy over one bone of up to 8 characters; missing characters of
+  // a short group repeat the last one and aren't written
+  unsigned int stride = paddedBones;
+  alignas(32) float poses[8][AnimationClip::CHANNELS * MAX_BONES];
+  alignas(32) float second[AnimationClip::CHANNELS * MAX_BONES];
+  float worlds[8][12];
+  for (unsigned int j = 0; j < 8; j++)
+  {
+    const CharacterState &character = characters[std::min(j, count - 1)];
+    const float *a, *b;
+    float weight;
+    character.clip->keys(character.time, a, b, weight);
+    blendPoses(a, b, weight, poses[j], stride);
+    if (character.blendClip != nullptr && character.blendWeight > 0.0f)
+    {
+      character.blendClip->keys(character.blendTime, a, b, weight);
+      blendPoses(a, b, weight, second, stride);
+      blendPoses(poses[j], second, character.blendWeight, poses[j], stride);
+    }
+    toAffine(character.world, worlds[j]);
+  }
+
+  float lanes[8];
+  float8 world[12];
+  for (int e = 0; e < 12; e++)
+  {
+    for (int j = 0; j < 8; j++)
+      lanes[j] = worlds[j][e];
+    world[e] = float8::load(lanes);
+  }
+  float8 model[12 * MAX_BONES];
+  size_t paletteFloats = boneCount() * 12;
+  for (unsigned int bone = 0; bone < boneCount(); bone++)
+  {
+    float8 pose[AnimationClip::CHANNELS];
+    for (int c = 0; c < AnimationClip::CHANNELS; c++)
+    {
+      for (int j = 0; j < 8; j++)
+        lanes[j] = poses[j][c * stride + bone];
+      pose[c] = float8::load(lanes);
+    }
+    float8 local[12], bind[12], palette[12];
+    localMatrix(pose, local);
+    int parent = skeleton.parents[bone];
+    float8* current = model + bone * 12;
+    multiplyAffine(parent < 0 ? world : model + parent * 12, local, current);
+    for (int e = 0; e < 12; e++)
+      bind[e] = float8(inverseBind[bone * 12 + e]);
+    multiplyAffine(current, bind, palette);
+
+    // back to one 3x4 matrix per character
+    float rows[3][32];
+    for (int r = 0; r < 3; r++)
+      storeInterleaved4(rows[r], palette[r * 4], palette[r * 4 + 1],
+                        palette[r * 4 + 2], palette[r * 4 + 3]);
+    for (unsigned int j = 0; j < count; j++)
+    {
+      float* out = palettes + j * paletteFloats + bone * 12;
+      for (int r = 0; r < 3; r++)
+        std::memcpy(out + r * 4, rows[r] + j * 4, 4 * sizeof(float));
+    }
+  }
+}
+
+void AnimationSystem::evaluateScalar(const CharacterState &character,
+                                     float* palette) const
+{
+  unsigned int stride = paddedBones;
+  glm::mat4 model[MAX_BONES];
+  const float *a0, *a1, *b0 = nullptr, *b1 = nullptr;
+  float weightA, weightB = 0.0f;
+  character.clip->keys(character.time, a0, a1, weightA);
+  bool blend = character.blendClip != nullptr && character.blendWeight > 0.0f;
+  if (blend)
+    character.blendClip->keys(character.blendTime, b0, b1, weightB);
+
+  for (unsigned int bone = 0; bone < boneCount(); bone++)
+  {
+    // quaternion, translation and scale of one key
+    auto read = [stride, bone](const float* key, glm::quat &q, glm::vec3 &t,
+                               glm::vec3 &s)
+    {
+      const float* k = key + bone;
+      q = glm::quat(k[3 * stride], k[0], k[stride], k[2 * stride]);
+      t = glm::vec3(k[4 * stride], k[5 * stride], k[6 * stride]);
+      s = glm::vec3(k[7 * stride], k[8 * stride], k[9 * stride]);
+    };
+    glm::quat q0, q1;
+    glm::vec3 t0, t1, s0, s1;
+    read(a0, q0, t0, s0);
+    read(a1, q1, t1, s1);
+    glm::quat rotation = nlerp(q0, q1, weightA);
+    glm::vec3 translation = glm::mix(t0, t1, weightA);
+    glm::vec3 scale = glm::mix(s0, s1, weightA);
+    if (blend)
+    {
+      read(b0, q0, t0, s0);
+      read(b1, q1, t1, s1);
+      rotation = nlerp(rotation, nlerp(q0, q1, weightB),
+                       character.blendWeight);
+      translation = glm::mix(translation, glm::mix(t0, t1, weightB),
+                             character.blendWeight);
+      scale = glm::mix(scale, glm::mix(s0, s1, weightB),
+                       character.blendWeight);
+    }
+    glm::mat4 local = glm::translate(glm::mat4(1.0f), translation) *
+                      glm::mat4_cast(rotation) *
+                      glm::scale(glm::mat4(1.0f), scale);
+    int parent = skeleton.parents[bone];
+    model[bone] = (parent < 0 ? character.world : model[parent]) * local;
+    toAffine(model[bone] * skeleton.inverseBind[bone], palette + bone * 12);
+  }
+}
+
+bool AnimationSystem::clipsMatch(
+        const std::vector<CharacterState> &characters, size_t count) const
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    const CharacterState &character = characters[i];
+    if (character.clip->boneCount() != boneCount() ||
+        (character.blendClip != nullptr &&
+         character.blendClip->boneCount() != boneCount()))
+    {
+      std::cout << "ERROR::ANIMATION::CLIP_DOES_NOT_MATCH_SKELETON"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+void AnimationSystem::evaluate(const std::vector<CharacterState> &characters,
+                               float* palettes, JobSystem* jobs)
+{
+  double start = now();
+  size_t count = std::min(characters.size(), (size_t)maxCharacters);
+  if (count < characters.size())
+    std::cout << "ERROR::ANIMATION::TOO_MANY_CHARACTERS" << std::endl;
+  if (!clipsMatch(characters, count))
+    return;
+
+  // the float8 path takes groups of 8 characters
+  size_t paletteFloats = boneCount() * 12;
+  size_t groups = (count + 7) / 8;
+  JobSystem::RangeFunction work =
+          [this, &characters, palettes, paletteFloats, count](size_t begin,
+                                                              size_t end)
+          {
+            for (size_t i = begin; i < end; i++)
+              if (simd)
+                evaluateSimd(&characters[i * 8],
+                             (unsigned int)std::min(count - i * 8,
+                                                    (size_t)8),
+                             palettes + i * 8 * paletteFloats);
+              else
+                evaluateScalar(characters[i], palettes + i * paletteFloats);
+          };
+  size_t items = simd ? groups : count;
+  size_t chunk = simd ? std::max(chunkSize / 8, 1u) : chunkSize;
+  parallelFor(jobs, items, chunk, work);
+  lastMilliseconds = now() - start;
+}
+
+void AnimationSystem::update(const std::vector<CharacterState> &characters,
+                             JobSystem* jobs)
+{
+  size_t count = std::min(characters.size(), (size_t)maxCharacters);
+  // checked before mapping: an invalidated buffer left unwritten would
+  // hand the skinning draw undefined palettes
+  if (count == 0 || boneCount() == 0 || !clipsMatch(characters, count))
+    return;
+  glBindBuffer(GL_TEXTURE_BUFFER, paletteBuffer);
+  // the whole buffer is rewritten, invalidating it lets the driver hand out
+  // fresh memory instead of waiting for last frame's draws
+  float* palettes = (float*)glMapBufferRange(
+          GL_TEXTURE_BUFFER, 0, count * boneCount() * 12 * sizeof(float),
+          GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+  if (palettes != NULL)
+  {
+    evaluate(characters, palettes, jobs);
+    glUnmapBuffer(GL_TEXTURE_BUFFER);
+  }
+  else
+    std::cout << "ERROR::ANIMATION::MAP_FAILED" << std::endl;
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+unsigned int AnimationSystem::boneCount() const
+{
+  return (unsigned int)skeleton.parents.size();
+}
+
+unsigned int AnimationSystem::paletteTexture() const
+{
+  return paletteBufferTexture;
+}
+
+double AnimationSystem::cpuMilliseconds() const
+{
+  return lastMilliseconds;
+}
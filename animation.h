@@ -0,0 +1,147 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_ANIMATION_H
+#define COORDINATESPACE_ANIMATION_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "jobsystem.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Skeletal animation
+ *  A skinned character is a hierarchy of bones. Each frame every bone gets
+ *  a local transform (rotation quaternion, translation, scale) sampled
+ *  from an animation clip, maybe blended with a second clip; the local
+ *  transforms are chained from the root down to give each bone's model
+ *  transform, and that times the bone's inverse bind matrix is what the
+ *  vertex shader needs: the skinning palette, one matrix per bone.
+ *
+ *  Done with a glm::mat4 per bone that's a lot of scalar math on one
+ *  thread. Here:
+ *
+ *   - a clip stores its keys structure of arrays: for every frame, every
+ *     channel (rotation x y z w, translation x y z, scale x y z) holds the
+ *     values of all bones next to each other, padded to 8. Sampling between
+ *     two keys and blending two poses are the same operation, a normalized
+ *     lerp (nlerp) of the rotations and a lerp of the rest, done with
+ *     float8 for 8 bones at once. nlerp isn't slerp but between nearby keys
+ *     or for blending similar poses the difference doesn't show.
+ *   - the hierarchy runs on 8 characters at once, one per lane: the
+ *     blended poses are transposed bone by bone and everything after that
+ *     (local 3x4 matrices, parent times local, times the inverse bind
+ *     matrix) is float8 math without a single branch or gather.
+ *   - the bones are stored parents first, so one linear pass over them
+ *     finds every parent's model matrix already computed. The same pass
+ *     writes the palette entries, three rows of 4 floats per character,
+ *     straight into their destination.
+ *   - characters are independent, they're spread over the JobSystem.
+ *
+ *  update() maps a texture buffer (RGBA32F, 3 texels per bone, the
+ *  characters one after the other) and the jobs write into it directly;
+ *  shaders/skinnedvs.txt reads it. evaluate() writes to any memory.
+ *
+ *  With simd off every bone goes through glm quaternions and matrices,
+ *  which is what the float8 path is compared against.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+struct Skeleton
+{
+  // parent of every bone, -1 for roots; parents come before their children
+  std::vector<int> parents;
+  // model space to bone space in the bind pose
+  std::vector<glm::mat4> inverseBind;
+};
+
+class AnimationClip
+{
+public:
+  // rotation xyzw, translation xyz, scale xyz
+  static const int CHANNELS = 10;
+
+  // a looping clip, frame frameCount is frame 0 again
+  AnimationClip(unsigned int boneCount, unsigned int frameCount,
+                float frameRate);
+
+  void setKey(unsigned int frame, unsigned int bone,
+              const glm::quat &rotation, const glm::vec3 &translation,
+              const glm::vec3 &scale);
+  unsigned int boneCount() const;
+  // floats between two channels of a pose, boneCount padded to 8
+  unsigned int stride() const;
+  float duration() const;
+  // the two keys around time and the weight of the second one
+  void keys(float time, const float* &a, const float* &b,
+            float &weight) const;
+
+private:
+  unsigned int bones;
+  unsigned int paddedBones;
+  unsigned int frames;
+  float frameRate;
+  std::vector<float> data;
+};
+
+struct CharacterState
+{
+  const AnimationClip* clip;
+  float time;
+  // optional second clip mixed in with blendWeight
+  const AnimationClip* blendClip;
+  float blendTime;
+  float blendWeight;
+  // where the character stands, applied to the root bones
+  glm::mat4 world;
+};
+
+class AnimationSystem
+{
+public:
+  static const unsigned int MAX_BONES = 128;
+
+  bool simd;
+  // characters per job, rounded to groups of 8 on the float8 path
+  unsigned int chunkSize;
+
+  AnimationSystem(const Skeleton &skeleton, unsigned int maxCharacters);
+  ~AnimationSystem();
+  AnimationSystem(const AnimationSystem &) = delete;
+  AnimationSystem &operator=(const AnimationSystem &) = delete;
+
+  // palettes of all characters into palettes, 12 floats per bone
+  void evaluate(const std::vector<CharacterState> &characters,
+                float* palettes, JobSystem* jobs = nullptr);
+  // the same into the palette texture buffer; on an error the buffer keeps
+  // the previous palettes
+  void update(const std::vector<CharacterState> &characters,
+              JobSystem* jobs = nullptr);
+
+  unsigned int boneCount() const;
+  unsigned int paletteTexture() const;
+  // CPU time of the last evaluate()/update()
+  double cpuMilliseconds() const;
+
+private:
+  Skeleton skeleton;
+  unsigned int maxCharacters;
+  unsigned int paddedBones;
+  // the inverse bind matrices as 3x4 rows
+  std::vector<float> inverseBind;
+
+  unsigned int paletteBuffer;
+  unsigned int paletteBufferTexture;
+  double lastMilliseconds;
+
+  // every clip of the first count characters has this skeleton's bones
+  bool clipsMatch(const std::vector<CharacterState> &characters,
+                  size_t count) const;
+  void evaluateSimd(const CharacterState* characters, unsigned int count,
+                    float* palettes) const;
+  void evaluateScalar(const CharacterState &character, float* palette) const;
+};
+#endif //COORDINATESPACE_ANIMATION_H
@@ -0,0 +1,2877 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Benchmarks for the rendering building blocks.
+ *
+ *   CoordinateSpaceBench            runs every benchmark
+ *   CoordinateSpaceBench name ...   runs only the named ones
+ *
+ * GPU benchmarks render into an offscreen framebuffer of a hidden window,
+ * so the numbers don't depend on vsync or the window size. When no GL 3.3
+ * context can be created they're skipped and only the CPU ones run.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include <iostream>
+
+#include "gpuparticles.h"
+#include "cpuparticles.h"
+#include "simd.h"
+#include "terrain.h"
+#include "hud.h"
+#include "rendergraph.h"
+#include "spritebatch.h"
+#include "multiview.h"
+#include "gpuculling.h"
+#include "opaquepass.h"
+#include "dynamicresolution.h"
+#include "temporalupscale.h"
+#include "impostor.h"
+#include "staticbatch.h"
+#include "dynamicbatch.h"
+#include "packedinstance.h"
+#include "visibilitybuffer.h"
+#include "animation.h"
+#include "curves.h"
+#include "tween.h"
+#include "broadphase.h"
+#include "colorspace.h"
+#include "vertexweld.h"
+#include "tangentframes.h"
+#include "meshlod.h"
+#include "shadowmap.h"
+
+namespace
+{
+  const int BENCH_WIDTH = 1280;
+  const int BENCH_HEIGHT = 720;
+
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+
+  // color + depth render target standing in for the default framebuffer
+  struct OffscreenTarget
+  {
+    unsigned int FBO, color, depth;
+
+    OffscreenTarget(int width, int height)
+    {
+      glGenTextures(1, &color);
+      glBindTexture(GL_TEXTURE_2D, color);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA,
+                   GL_UNSIGNED_BYTE, NULL);
+      glGenRenderbuffers(1, &depth);
+      glBindRenderbuffer(GL_RENDERBUFFER, depth);
+      glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width,
+                            height);
+      glGenFramebuffers(1, &FBO);
+      glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+      glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                             GL_TEXTURE_2D, color, 0);
+      glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                                GL_RENDERBUFFER, depth);
+      glViewport(0, 0, width, height);
+    }
+
+    ~OffscreenTarget()
+    {
+      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      glDeleteFramebuffers(1, &FBO);
+      glDeleteRenderbuffers(1, &depth);
+      glDeleteTextures(1, &color);
+    }
+  };
+
+  void benchmarkGpuParticles()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 2.0f, 12.0f),
+                                 glm::vec3(0.0f, 2.0f, 0.0f),
+                                 glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f),
+                                            (float)BENCH_WIDTH / BENCH_HEIGHT,
+                                            0.1f, 100.0f);
+    const float deltaTime = 1.0f / 60.0f;
+    const unsigned int sizes[] = {1u << 20, 4u << 20};
+    for (unsigned int capacity : sizes)
+    {
+      GpuParticleSystem particles(capacity);
+      // enough emission to keep the whole pool alive
+      for (int e = 0; e < 4; e++)
+      {
+        ParticleEmitter emitter;
+        emitter.position = glm::vec3(-3.0f + 2.0f * e, 0.0f, 0.0f);
+        emitter.radius = 0.2f;
+        emitter.direction = glm::vec3(0.0f, 1.0f, 0.0f);
+        emitter.speed = 8.0f;
+        emitter.spread = 0.3f;
+        emitter.lifetime = 2.0f;
+        emitter.lifetimeJitter = 0.0f;
+        emitter.rate = capacity / (4.0f * emitter.lifetime);
+        emitter.accumulator = 0.0f;
+        particles.emitters.push_back(emitter);
+      }
+
+      // fill the pool first
+      for (int frame = 0; frame < 130; frame++)
+        particles.update(deltaTime);
+      glFinish();
+
+      // simulation alone, glFinish makes the wall clock include the GPU
+      // work even on drivers whose timestamps don't cover it
+      const int frames = 60;
+      double gpuTotal = 0.0;
+      double start = now();
+      for (int frame = 0; frame < frames; frame++)
+      {
+        particles.update(deltaTime);
+        glFinish();
+        gpuTotal += particles.updateMilliseconds();
+      }
+      double update = (now() - start) / frames;
+
+      const int renderFrames = 10;
+      start = now();
+      for (int frame = 0; frame < renderFrames; frame++)
+      {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        particles.render(view, projection);
+        glFinish();
+      }
+      double render = (now() - start) / renderFrames;
+
+      std::cout << "gpuparticles " << capacity << ": update " << update
+                << " ms (GPU timer " << gpuTotal / frames << " ms), render "
+                << render << " ms, "
+                << capacity / (update / 1000.0) / 1.0e6
+                << " M particles/s simulated" << std::endl;
+    }
+  }
+
+  void benchmarkCpuParticles()
+  {
+    const unsigned int capacity = 1u << 20;
+    const float deltaTime = 1.0f / 60.0f;
+    // stands in for the mapped instance buffer
+    float* instances = (float*)alignedAlloc(capacity * 4 * sizeof(float));
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    unsigned int threadCounts[] = {1, 0};
+    for (unsigned int threads : threadCounts)
+    {
+      JobSystem jobs(threads);
+      CpuParticlePool pool(capacity);
+      pool.colliders.push_back(glm::vec4(0.0f, 1.0f, 0.0f, 1.5f));
+      const int frames = 60;
+      double total = 0.0;
+      for (int frame = 0; frame < frames + 10; frame++)
+      {
+        // keep the pool full
+        while (pool.spawn(glm::vec3(unit(random), 4.0f, unit(random)),
+                          glm::vec3(unit(random), unit(random) * 5.0f,
+                                    unit(random)),
+                          2.0f + unit(random)))
+          ;
+        double start = now();
+        pool.update(jobs, deltaTime, instances);
+        // the first frames warm up caches and wake the threads
+        if (frame >= 10)
+          total += now() - start;
+      }
+      double update = total / frames;
+      std::cout << "cpuparticles " << capacity << " on "
+                << jobs.getThreadCount() << " threads: " << update
+                << " ms/frame, " << capacity / (update / 1000.0) / 1.0e6
+                << " M particles/s" << std::endl;
+    }
+    alignedFree(instances);
+  }
+
+  void benchmarkTerrain()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    JobSystem jobs;
+    // an endless procedural map: the camera flies in a straight line, so
+    // the part of the map it has seen keeps growing
+    Terrain terrain([](float x, float z)
+                    {
+                      return 40.0f * std::sin(x * 0.004f) *
+                             std::cos(z * 0.005f) +
+                             6.0f * std::sin(x * 0.05f + z * 0.03f);
+                    }, 1.0f, &jobs);
+    terrain.viewDistance = 1500.0f;
+    terrain.memoryBudget = 16u << 20;
+    float fovy = glm::radians(45.0f);
+    glm::mat4 projection = glm::perspective(fovy,
+                                            (float)BENCH_WIDTH / BENCH_HEIGHT,
+                                            0.5f, 3000.0f);
+    glEnable(GL_DEPTH_TEST);
+
+    const int frames = 600;
+    double total = 0.0, worst = 0.0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+      glm::vec3 camera(frame * 20.0f, 80.0f, frame * 5.0f);
+      glm::mat4 view = glm::lookAt(camera, camera + glm::vec3(1.0f, -0.2f,
+                                                              0.25f),
+                                   glm::vec3(0.0f, 1.0f, 0.0f));
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      double start = now();
+      terrain.update(camera);
+      terrain.render(view, projection, camera, fovy, (float)BENCH_HEIGHT);
+      double cpu = now() - start;
+      glFinish();
+      total += cpu;
+      if (frame >= 60)
+        worst = std::max(worst, cpu);
+      if (frame % 150 == 149)
+      {
+        std::cout << "terrain after " << frame * 20 / 1000 << " km: ";
+        terrain.printStats();
+      }
+    }
+    std::cout << "terrain: " << total / frames << " ms CPU per frame, worst "
+              << worst << " ms" << std::endl;
+    glDisable(GL_DEPTH_TEST);
+  }
+
+  void benchmarkHud()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    HudOverlay hud;
+    FrameStats stats;
+    stats.drawCalls = 1234;
+    stats.memoryBytes = 345u << 20;
+
+    const int frames = 1000;
+    double total = 0.0, worst = 0.0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+      stats.frame(16.0 + 8.0 * std::sin(frame * 0.1));
+      stats.setTiming("shadows", 1.5);
+      stats.setTiming("opaque", 4.25);
+      stats.setTiming("particles", 0.75);
+      stats.setTiming("post", 0.5);
+      glClear(GL_COLOR_BUFFER_BIT);
+      hud.begin(BENCH_WIDTH, BENCH_HEIGHT);
+      stats.draw(hud, 10.0f, 10.0f);
+      hud.end();
+      // a software rasterizer does the drawing inside the draw call, wait
+      // for it here so that it doesn't land in the next frame's numbers
+      glFinish();
+      total += hud.cpuMilliseconds();
+      if (frame >= 10)
+        worst = std::max(worst, hud.cpuMilliseconds());
+    }
+    std::cout << "hud: " << total / frames << " ms CPU per frame, worst "
+              << worst << " ms, 1 draw call" << std::endl;
+  }
+
+  void benchmarkRenderGraph()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    RenderGraph graph;
+    const RenderTargetDesc full = {BENCH_WIDTH, BENCH_HEIGHT, GL_RGBA16F};
+    const RenderTargetDesc half = {BENCH_WIDTH / 2, BENCH_HEIGHT / 2,
+                                   GL_RGBA16F};
+    const RenderTargetDesc depth = {BENCH_WIDTH, BENCH_HEIGHT,
+                                    GL_DEPTH24_STENCIL8};
+    const RenderTargetDesc ldr = {BENCH_WIDTH, BENCH_HEIGHT, GL_RGBA8};
+    RenderGraph::PassFunction clear = [](const RenderGraph &)
+    {
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    };
+
+    // a typical post chain: scene, bloom at half resolution, tonemapping
+    // and antialiasing into the back buffer, plus a debug view that nothing
+    // looks at
+    const int frames = 100;
+    double total = 0.0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+      double start = now();
+      graph.reset();
+      int backBuffer = graph.importTexture("back buffer", target.color, ldr);
+      int hdr = graph.createTexture("hdr", full);
+      int sceneDepth = graph.createTexture("depth", depth);
+      int bright = graph.createTexture("bright", half);
+      int blurX = graph.createTexture("blur x", half);
+      int blurY = graph.createTexture("blur y", half);
+      int toneMapped = graph.createTexture("tonemapped", ldr);
+      int debug = graph.createTexture("debug", ldr);
+
+      int scene = graph.addPass("scene", clear);
+      graph.write(scene, hdr);
+      graph.write(scene, sceneDepth);
+      int brightPass = graph.addPass("bright pass", clear);
+      graph.read(brightPass, hdr);
+      graph.write(brightPass, bright);
+      int blurXPass = graph.addPass("blur x", clear);
+      graph.read(blurXPass, bright);
+      graph.write(blurXPass, blurX);
+      int blurYPass = graph.addPass("blur y", clear);
+      graph.read(blurYPass, blurX);
+      graph.write(blurYPass, blurY);
+      int debugPass = graph.addPass("depth debug", clear);
+      graph.read(debugPass, sceneDepth);
+      graph.write(debugPass, debug);
+      int toneMap = graph.addPass("tonemap", clear);
+      graph.read(toneMap, hdr);
+      graph.read(toneMap, blurY);
+      graph.write(toneMap, toneMapped);
+      int fxaa = graph.addPass("fxaa", clear);
+      graph.read(fxaa, toneMapped);
+      graph.write(fxaa, backBuffer);
+      graph.markOutput(backBuffer);
+
+      graph.compile();
+      graph.execute();
+      total += now() - start;
+      glFinish();
+    }
+    graph.printStats();
+    std::cout << "render graph: " << total / frames
+              << " ms CPU per frame to build, compile and run" << std::endl;
+  }
+
+  void benchmarkSprites()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    // four array textures with four small images each
+    const int textureCount = 4, layers = 4, size = 16;
+    unsigned int textures[textureCount];
+    glGenTextures(textureCount, textures);
+    std::vector<unsigned char> pixels(size * size * 4 * layers);
+    for (int t = 0; t < textureCount; t++)
+    {
+      for (size_t i = 0; i < pixels.size(); i++)
+        pixels[i] = (unsigned char)(64 + (i * 37 + t * 91) % 192);
+      glBindTexture(GL_TEXTURE_2D_ARRAY, textures[t]);
+      glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, size, size, layers, 0,
+                   GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+      glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+
+    const unsigned int count = 200000;
+    std::mt19937 random(82);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<glm::vec4> placement(count);
+    std::vector<int> textureOf(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+      placement[i] = glm::vec4(unit(random) * BENCH_WIDTH,
+                               unit(random) * BENCH_HEIGHT,
+                               4.0f + unit(random) * 8.0f,
+                               unit(random) * 6.2831853f);
+      textureOf[i] = (int)(random() % (textureCount * layers));
+    }
+
+    SpriteBatch batch(count);
+    glm::mat4 projection = glm::ortho(0.0f, (float)BENCH_WIDTH, 0.0f,
+                                      (float)BENCH_HEIGHT, -1.0f, 1.0f);
+    struct Scenario
+    {
+      const char* name;
+      bool sort, rotate;
+    };
+    const Scenario scenarios[] = {{"sorted, rotated", true, true},
+                                  {"sorted, axis aligned", true, false},
+                                  {"submission order, rotated", false, true}};
+    for (const Scenario &scenario : scenarios)
+    {
+      batch.sortByTexture = scenario.sort;
+      const int frames = 20;
+      double record = 0.0, build = 0.0, submit = 0.0;
+      for (int frame = 0; frame < frames; frame++)
+      {
+        glClear(GL_COLOR_BUFFER_BIT);
+        double start = now();
+        batch.begin(projection);
+        for (unsigned int i = 0; i < count; i++)
+        {
+          const glm::vec4 &p = placement[i];
+          batch.draw(textures[textureOf[i] / layers], textureOf[i] % layers,
+                     glm::vec2(p.x, p.y), glm::vec2(p.z),
+                     scenario.rotate ? p.w + frame * 0.01f : 0.0f);
+        }
+        double recorded = now();
+        batch.end();
+        double ended = now();
+        record += recorded - start;
+        build += batch.cpuMilliseconds();
+        submit += ended - recorded - batch.cpuMilliseconds();
+        // a software rasterizer draws in the background, keep that out of
+        // the next frame
+        glFinish();
+      }
+      // sprites/s counts the batcher's own work: recording, sorting,
+      // transforming and writing vertices. The driver's share of the draw
+      // calls is listed separately, on a software rasterizer it includes
+      // the vertex processing.
+      double ms = (record + build) / frames;
+      std::cout << "sprites (" << scenario.name << "): " << ms
+                << " ms CPU for " << count << " sprites ("
+                << record / frames << " record, " << build / frames
+                << " build), " << count / ms / 1000.0 << " M sprites/s, "
+                << batch.drawCalls() << " draw calls, "
+                << submit / frames << " ms in the driver" << std::endl;
+    }
+    glDeleteTextures(textureCount, textures);
+  }
+
+  // indexed mesh with positions only, for benchmarks that draw shapes
+  unsigned int makeMesh(const std::vector<float> &positions,
+                        const std::vector<unsigned int> &indices)
+  {
+    unsigned int VAO, VBO, EBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(float),
+                 positions.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
+                 indices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float),
+                          (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    return VAO;
+  }
+
+  void benchmarkMultiView()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    unsigned int cube = makeMesh(
+            {-0.5f, -0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, -0.5f,
+             -0.5f, 0.5f, -0.5f, -0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f,
+             0.5f, 0.5f, 0.5f, -0.5f, 0.5f, 0.5f},
+            {0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4, 0, 4, 7, 7, 3, 0,
+             1, 5, 6, 6, 2, 1, 3, 2, 6, 6, 7, 3, 0, 1, 5, 5, 4, 0});
+    unsigned int pyramid = makeMesh(
+            {-0.5f, -0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, -0.5f, 0.5f,
+             -0.5f, -0.5f, 0.5f, 0.0f, 0.5f, 0.0f},
+            {0, 1, 2, 2, 3, 0, 0, 1, 4, 1, 2, 4, 2, 3, 4, 3, 0, 4});
+
+    // a 600 x 600 field of 40000 objects
+    std::vector<RenderObject> objects;
+    const int side = 200;
+    for (int z = 0; z < side; z++)
+    {
+      for (int x = 0; x < side; x++)
+      {
+        RenderObject object;
+        bool isCube = (x * 7 + z * 3) % 5 != 0;
+        object.VAO = isCube ? cube : pyramid;
+        object.indexCount = isCube ? 36 : 18;
+        glm::vec3 position((x - side / 2) * 3.0f, 0.0f,
+                           (z - side / 2) * 3.0f);
+        object.model = glm::translate(glm::mat4(1.0f), position);
+        AABB unit = {glm::vec3(-0.5f), glm::vec3(0.5f)};
+        object.bounds = transformAABB(unit, object.model);
+        objects.push_back(object);
+      }
+    }
+
+    MultiViewRenderer renderer;
+    glEnable(GL_DEPTH_TEST);
+    const int viewCounts[] = {1, 2, 4, 8};
+    for (int viewCount : viewCounts)
+    {
+      // consoles watching the same area from around it, tiled over the
+      // target
+      std::vector<CameraView> views(viewCount);
+      int columns = (int)std::ceil(std::sqrt((float)viewCount));
+      int rows = (viewCount + columns - 1) / columns;
+      for (int v = 0; v < viewCount; v++)
+      {
+        float angle = v * 6.2831853f / viewCount;
+        glm::vec3 eye(std::cos(angle) * 60.0f, 30.0f, std::sin(angle) * 60.0f);
+        CameraView &view = views[v];
+        view.width = BENCH_WIDTH / columns;
+        view.height = BENCH_HEIGHT / rows;
+        view.x = v % columns * view.width;
+        view.y = v / columns * view.height;
+        view.view = glm::lookAt(eye, glm::vec3(0.0f),
+                                glm::vec3(0.0f, 1.0f, 0.0f));
+        view.projection = glm::perspective(glm::radians(50.0f),
+                                           (float)view.width / view.height,
+                                           0.5f, 150.0f);
+      }
+
+      for (int shared = 1; shared >= 0; shared--)
+      {
+        renderer.shareAcrossViews = shared != 0;
+        const int frames = 10;
+        double prepare = 0.0, draw = 0.0;
+        for (int frame = 0; frame < frames; frame++)
+        {
+          glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+          renderer.render(objects, views);
+          prepare += renderer.prepareMilliseconds();
+          draw += renderer.drawMilliseconds();
+          glFinish();
+        }
+        renderer.printStats();
+        std::cout << "  " << prepare / frames << " ms cull/sort/upload, "
+                  << draw / frames << " ms issuing draws" << std::endl;
+      }
+    }
+    glDisable(GL_DEPTH_TEST);
+  }
+
+  void benchmarkGpuCulling()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    unsigned int cube = makeMesh(
+            {-0.5f, -0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, -0.5f,
+             -0.5f, 0.5f, -0.5f, -0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f,
+             0.5f, 0.5f, 0.5f, -0.5f, 0.5f, 0.5f},
+            {0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4, 0, 4, 7, 7, 3, 0,
+             1, 5, 6, 6, 2, 1, 3, 2, 6, 6, 7, 3, 0, 1, 5, 5, 4, 0});
+    glm::mat4 projection = glm::perspective(glm::radians(50.0f),
+                                            (float)BENCH_WIDTH / BENCH_HEIGHT,
+                                            0.5f, 80.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 20.0f, 0.0f),
+                                 glm::vec3(30.0f, 0.0f, 30.0f),
+                                 glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 viewProjection = projection * view;
+    glEnable(GL_DEPTH_TEST);
+    // what render() does on the CPU is the same for any object count: six
+    // planes, a 20 byte command reset and a few calls. A software renderer
+    // runs the shaders inside those calls though, so with it the time in
+    // render() includes the culling work itself.
+    std::cout << "gpuculling: renderer " << glGetString(GL_RENDERER)
+              << std::endl;
+
+    const unsigned int counts[] = {10000, 100000, 1000000};
+    for (unsigned int count : counts)
+    {
+      // a square field of cubes, the camera sees a corner of it
+      std::vector<RenderObject> objects(count);
+      int side = (int)std::ceil(std::sqrt((double)count));
+      for (unsigned int i = 0; i < count; i++)
+      {
+        glm::vec3 position((float)(i % side) * 2.0f, 0.0f,
+                           (float)(i / side) * 2.0f);
+        objects[i].VAO = cube;
+        objects[i].indexCount = 36;
+        objects[i].model = glm::translate(glm::mat4(1.0f), position);
+        AABB unit = {glm::vec3(-0.5f), glm::vec3(0.5f)};
+        objects[i].bounds = transformAABB(unit, objects[i].model);
+      }
+
+      // what culling the same objects on the CPU costs
+      Frustum frustum(viewProjection);
+      double start = now();
+      unsigned int cpuVisible = 0;
+      for (const RenderObject &object : objects)
+        cpuVisible += frustum.intersects(object.bounds) ? 1 : 0;
+      double cpuCull = now() - start;
+
+      GpuCuller culler(cube, 36, count);
+      culler.setObjects(objects);
+      for (int compute = 1; compute >= 0; compute--)
+      {
+        if (compute && !culler.computeSupported())
+          continue;
+        culler.useCompute = compute != 0;
+        culler.render(viewProjection);
+        glFinish();
+
+        const int frames = 10;
+        double submit = 0.0, total = 0.0;
+        for (int frame = 0; frame < frames; frame++)
+        {
+          glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+          start = now();
+          culler.render(viewProjection);
+          double submitted = now();
+          glFinish();
+          submit += submitted - start;
+          total += now() - start;
+        }
+        std::cout << "gpuculling " << (compute ? "compute" : "transform feedback")
+                  << ", " << count << " objects: " << submit / frames
+                  << " ms in render(), " << total / frames
+                  << " ms until finished, " << culler.readVisibleCount()
+                  << " visible (CPU culling: " << cpuVisible << " in "
+                  << cpuCull << " ms)" << std::endl;
+      }
+    }
+    glDisable(GL_DEPTH_TEST);
+  }
+
+  // a wall of lit cubes 16 layers deep in random order, seen by the camera
+  // from (0, 0, 14). Shading uses 36 vertices with face normals, the depth
+  // stream the welded 8 corners.
+  std::vector<RenderObject> makeCubeWall()
+  {
+    const std::vector<float> corners = {
+            -0.5f, -0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, -0.5f,
+            -0.5f, 0.5f, -0.5f, -0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f,
+            0.5f, 0.5f, 0.5f, -0.5f, 0.5f, 0.5f};
+    const std::vector<unsigned int> cubeIndices = {
+            0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4, 0, 4, 7, 7, 3, 0,
+            1, 5, 6, 6, 2, 1, 3, 2, 6, 6, 7, 3, 0, 1, 5, 5, 4, 0};
+    unsigned int depthCube = makeMesh(corners, cubeIndices);
+    std::vector<float> shaded;
+    std::vector<unsigned int> shadedIndices;
+    for (size_t t = 0; t < cubeIndices.size(); t += 3)
+    {
+      glm::vec3 p[3];
+      for (int k = 0; k < 3; k++)
+        p[k] = glm::vec3(corners[cubeIndices[t + k] * 3],
+                         corners[cubeIndices[t + k] * 3 + 1],
+                         corners[cubeIndices[t + k] * 3 + 2]);
+      glm::vec3 normal = glm::normalize(glm::cross(p[1] - p[0], p[2] - p[0]));
+      // the index order doesn't wind consistently, point outwards
+      if (glm::dot(normal, p[0] + p[1] + p[2]) < 0.0f)
+        normal = -normal;
+      for (int k = 0; k < 3; k++)
+      {
+        shadedIndices.push_back((unsigned int)(shaded.size() / 6));
+        shaded.insert(shaded.end(), {p[k].x, p[k].y, p[k].z,
+                                     normal.x, normal.y, normal.z});
+      }
+    }
+    unsigned int cube, VBO, EBO;
+    glGenVertexArrays(1, &cube);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+    glBindVertexArray(cube);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, shaded.size() * sizeof(float),
+                 shaded.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 shadedIndices.size() * sizeof(unsigned int),
+                 shadedIndices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),
+                          (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),
+                          (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+
+    // rows of cubes one behind the other in front of the camera, in random
+    // order, so most pixels are covered by several layers
+    std::vector<RenderObject> objects;
+    for (int z = 0; z < 16; z++)
+      for (int y = -6; y <= 6; y++)
+        for (int x = -12; x <= 12; x++)
+        {
+          RenderObject object;
+          object.VAO = cube;
+          object.depthVAO = depthCube;
+          object.indexCount = 36;
+          glm::vec3 position(x * 2.0f + (z % 2), y * 2.0f + (z % 3) * 0.6f,
+                             -z * 2.5f);
+          object.model = glm::scale(glm::translate(glm::mat4(1.0f), position),
+                                    glm::vec3(1.6f));
+          AABB unit = {glm::vec3(-0.5f), glm::vec3(0.5f)};
+          object.bounds = transformAABB(unit, object.model);
+          objects.push_back(object);
+        }
+    std::shuffle(objects.begin(), objects.end(), std::mt19937(5));
+    return objects;
+  }
+
+  // lights spread over the cube wall
+  std::vector<PointLight> makeLights(int count)
+  {
+    std::vector<PointLight> lights;
+    for (int i = 0; i < count; i++)
+    {
+      PointLight light;
+      light.position = glm::vec3(-20.0f + 40.0f * i / count, 8.0f,
+                                 4.0f - 2.0f * i);
+      light.color = 0.5f + 0.5f * glm::cos(glm::vec3(0.0f, 2.0f, 4.0f) +
+                                           (float)i);
+      light.radius = 60.0f;
+      lights.push_back(light);
+    }
+    return lights;
+  }
+
+  void benchmarkDepthPrepass()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    std::vector<RenderObject> objects = makeCubeWall();
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 14.0f),
+                                 glm::vec3(0.0f, 0.0f, 0.0f),
+                                 glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f),
+                                            (float)BENCH_WIDTH / BENCH_HEIGHT,
+                                            0.5f, 100.0f);
+
+    OpaqueRenderer renderer;
+    const int lightCounts[] = {1, OpaqueRenderer::MAX_LIGHTS};
+    for (int lightCount : lightCounts)
+    {
+      renderer.lights = makeLights(lightCount);
+
+      // the prepass mode first, its shading pass counts the covered pixels
+      long long covered = 0;
+      const bool modes[][2] = {{true, true}, {true, false}, {false, false},
+                               {false, true}};
+      for (const bool* mode : modes)
+      {
+        renderer.depthPrepass = mode[0];
+        renderer.frontToBack = mode[1];
+        const int frames = 4;
+        double total = 0.0, depthGpu = 0.0, shadingGpu = 0.0;
+        for (int frame = 0; frame <= frames; frame++)
+        {
+          glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+          glFinish();
+          double start = now();
+          renderer.render(objects, view, projection);
+          glFinish();
+          // the first frame warms up
+          if (frame == 0)
+            continue;
+          total += now() - start;
+          depthGpu += std::max(renderer.prepassGpuMilliseconds(), 0.0);
+          shadingGpu += renderer.shadingGpuMilliseconds();
+        }
+        long long shadedSamples = renderer.shadedSamples();
+        if (renderer.depthPrepass && covered == 0)
+          covered = shadedSamples;
+        std::cout << "depthprepass " << lightCount << " lights, "
+                  << (renderer.depthPrepass ? "prepass" : "no prepass")
+                  << (renderer.frontToBack ? ", front to back: "
+                                           : ", unsorted: ")
+                  << total / frames << " ms (GPU " << depthGpu / frames
+                  << " depth + " << shadingGpu / frames << " shading), "
+                  << shadedSamples << " samples shaded, overdraw "
+                  << (double)shadedSamples / std::max(covered, 1LL)
+                  << std::endl;
+      }
+      renderer.printStats();
+    }
+  }
+
+  void benchmarkDynamicResolution()
+  {
+    // the controller alone on a made up load: 12 ms at full resolution,
+    // 30 ms during a spike from frame 60 to 140, the cost following the
+    // pixel count. Fed the times of the frame before, like timer queries.
+    {
+      ResolutionController controller;
+      controller.budgetMilliseconds = 16.0;
+      controller.logChanges = false;
+      int missedFixed = 0, missedDynamic = 0, changes = 0;
+      float previous = controller.scale();
+      double last = 0.0;
+      for (int frame = 0; frame < ResolutionController::HISTORY; frame++)
+      {
+        double fullResolution = frame >= 60 && frame < 140 ? 30.0 : 12.0;
+        float scale = controller.update(last);
+        last = fullResolution * scale * scale;
+        missedFixed += fullResolution > controller.budgetMilliseconds;
+        missedDynamic += last > controller.budgetMilliseconds;
+        changes += scale != previous;
+        previous = scale;
+      }
+      std::cout << "dynres controller, 240 frames with an 80 frame spike: "
+                << missedFixed << " over budget at full resolution, "
+                << missedDynamic << " with dynamic resolution, " << changes
+                << " scale changes, scale history";
+      for (int age = ResolutionController::HISTORY - 1; age >= 0; age -= 20)
+        std::cout << " " << controller.history(age);
+      std::cout << std::endl;
+    }
+
+    // the cube wall through the offscreen target. A software renderer
+    // doesn't time rasterization with its timestamps, so this feeds the
+    // controller with wall clock times of finished frames instead.
+    std::vector<RenderObject> objects = makeCubeWall();
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 14.0f),
+                                 glm::vec3(0.0f, 0.0f, 0.0f),
+                                 glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f),
+                                            (float)BENCH_WIDTH / BENCH_HEIGHT,
+                                            0.5f, 100.0f);
+    OffscreenTarget output(BENCH_WIDTH, BENCH_HEIGHT);
+    DynamicResolution resolution(BENCH_WIDTH, BENCH_HEIGHT);
+    resolution.useGpuTimer = false;
+    resolution.controller.settleFrames = 5;
+    OpaqueRenderer renderer;
+    renderer.depthPrepass = false;
+
+    // a budget that 4 lights fit at full resolution, 16 lights don't
+    renderer.lights = makeLights(4);
+    double fullResolution = 0.0;
+    for (int frame = 0; frame < 3; frame++)
+    {
+      resolution.beginScene();
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      glFinish();
+      double start = now();
+      renderer.render(objects, view, projection);
+      glFinish();
+      fullResolution = now() - start;
+      resolution.endScene();
+    }
+    resolution.controller.budgetMilliseconds = fullResolution * 1.25;
+    std::cout << "dynres: " << fullResolution << " ms at full resolution "
+              << "with 4 lights, budget "
+              << resolution.controller.budgetMilliseconds << " ms"
+              << std::endl;
+
+    const int frames = 60;
+    double last = 0.0;
+    int missed = 0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+      renderer.lights = makeLights(frame >= 10 && frame < 40 ? 16 : 4);
+      resolution.controller.update(last);
+      resolution.beginScene();
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      glFinish();
+      double start = now();
+      renderer.render(objects, view, projection);
+      glFinish();
+      last = now() - start;
+      resolution.endScene();
+      resolution.present(output.FBO);
+      missed += last > resolution.controller.budgetMilliseconds;
+    }
+    std::cout << "dynres: 16 lights from frame 10 to 40, " << missed
+              << " of " << frames << " frames over budget, final scale "
+              << resolution.controller.scale() << " ("
+              << resolution.renderWidth() << " x " << resolution.renderHeight()
+              << ")" << std::endl;
+
+    // what the upscale itself costs at 1280 x 720
+    const DynamicResolution::Filter filters[] = {
+            DynamicResolution::BILINEAR, DynamicResolution::EDGE_AWARE};
+    for (DynamicResolution::Filter filter : filters)
+    {
+      resolution.filter = filter;
+      resolution.present(output.FBO);
+      glFinish();
+      const int presents = 20;
+      double start = now();
+      for (int i = 0; i < presents; i++)
+        resolution.present(output.FBO);
+      glFinish();
+      std::cout << "dynres upscale "
+                << (filter == DynamicResolution::BILINEAR ? "bilinear"
+                                                          : "edge aware")
+                << ": " << (now() - start) / presents << " ms" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  }
+
+  // peak signal to noise ratio of the bound read framebuffer against
+  // reference, both RGBA8 of BENCH_WIDTH x BENCH_HEIGHT
+  double psnr(const std::vector<unsigned char> &reference)
+  {
+    std::vector<unsigned char> pixels(reference.size());
+    glReadPixels(0, 0, BENCH_WIDTH, BENCH_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE,
+                 pixels.data());
+    double error = 0.0;
+    for (size_t i = 0; i < pixels.size(); i++)
+    {
+      if (i % 4 == 3)
+        continue;
+      double d = (double)pixels[i] - reference[i];
+      error += d * d;
+    }
+    error /= pixels.size() / 4 * 3;
+    return error > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / error) : 99.0;
+  }
+
+  void benchmarkTemporalUpscale()
+  {
+    std::vector<RenderObject> objects = makeCubeWall();
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f),
+                                            (float)BENCH_WIDTH / BENCH_HEIGHT,
+                                            0.5f, 100.0f);
+    OpaqueRenderer renderer;
+    renderer.lights = makeLights(OpaqueRenderer::MAX_LIGHTS);
+    // the camera pans sideways by a tenth of a unit per frame
+    auto cameraAt = [](int frame)
+    {
+      glm::vec3 eye(-0.1f * frame, 0.0f, 14.0f);
+      return glm::lookAt(eye, eye - glm::vec3(0.0f, 0.0f, 14.0f),
+                         glm::vec3(0.0f, 1.0f, 0.0f));
+    };
+    const int frames = 16;
+
+    // native rendering at the output resolution, and the reference images
+    // for the first and the last camera position. The wall clock times wait
+    // for the frame with glFinish, so they are the GPU time on a software
+    // renderer too; its timestamp queries don't cover the rasterization.
+    OffscreenTarget native(BENCH_WIDTH, BENCH_HEIGHT);
+    std::vector<unsigned char> still(BENCH_WIDTH * BENCH_HEIGHT * 4);
+    std::vector<unsigned char> moved(still.size());
+    double nativeTime = 0.0, nativeGpu = 0.0;
+    for (int frame = 0; frame <= frames; frame++)
+    {
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      glFinish();
+      double start = now();
+      renderer.render(objects, cameraAt(frame), projection);
+      glFinish();
+      // the first frame warms up
+      if (frame > 0)
+      {
+        nativeTime += now() - start;
+        nativeGpu += renderer.shadingGpuMilliseconds() +
+                     std::max(renderer.prepassGpuMilliseconds(), 0.0);
+      }
+      if (frame == 0 || frame == frames)
+        glReadPixels(0, 0, BENCH_WIDTH, BENCH_HEIGHT, GL_RGBA,
+                     GL_UNSIGNED_BYTE, frame == 0 ? still.data()
+                                                  : moved.data());
+    }
+    std::cout << "temporal: native " << BENCH_WIDTH << " x " << BENCH_HEIGHT
+              << ": " << nativeTime / frames << " ms per frame (GPU timers "
+              << nativeGpu / frames << " ms)" << std::endl;
+
+    OffscreenTarget output(BENCH_WIDTH, BENCH_HEIGHT);
+    TemporalUpscaler upscaler(BENCH_WIDTH, BENCH_HEIGHT);
+    for (int moving = 0; moving <= 1; moving++)
+    {
+      upscaler.reset();
+      double sceneTime = 0.0, resolveTime = 0.0, gpuTime = 0.0;
+      double firstFrame = 0.0;
+      for (int frame = 0; frame <= frames; frame++)
+      {
+        glm::mat4 view = cameraAt(moving ? frame : 0);
+        upscaler.beginScene(view, projection);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFinish();
+        double start = now();
+        renderer.render(objects, view, upscaler.jitteredProjection());
+        glFinish();
+        double rendered = now();
+        upscaler.endScene();
+        upscaler.resolve(output.FBO);
+        glFinish();
+        if (frame == 0)
+        {
+          // no history yet: a plain spatial upscale of one frame
+          firstFrame = psnr(still);
+          continue;
+        }
+        sceneTime += rendered - start;
+        resolveTime += now() - rendered;
+        gpuTime += std::max(upscaler.sceneGpuMilliseconds(), 0.0) +
+                   std::max(upscaler.resolveGpuMilliseconds(), 0.0);
+      }
+      std::cout << "temporal " << (moving ? "panning" : "still") << ", "
+                << upscaler.renderWidth() << " x " << upscaler.renderHeight()
+                << " upscaled: " << (sceneTime + resolveTime) / frames
+                << " ms per frame (" << sceneTime / frames << " scene + "
+                << resolveTime / frames << " resolve, GPU timers "
+                << gpuTime / frames << " ms), PSNR against native "
+                << psnr(moving ? moved : still) << " dB after " << frames
+                << " frames";
+      if (!moving)
+        std::cout << ", " << firstFrame << " dB for a single frame";
+      std::cout << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  }
+
+  // surface of revolution around the y axis through the (radius, height)
+  // profile points, appended to an indexed position-only mesh
+  void appendLathe(std::vector<float> &positions,
+                   std::vector<unsigned int> &indices,
+                   const std::vector<glm::vec2> &profile, int segments)
+  {
+    unsigned int base = (unsigned int)(positions.size() / 3);
+    for (const glm::vec2 &point : profile)
+      for (int s = 0; s < segments; s++)
+      {
+        float angle = 6.2831853f * s / segments;
+        positions.insert(positions.end(),
+                         {point.x * std::cos(angle), point.y,
+                          point.x * std::sin(angle)});
+      }
+    for (size_t ring = 0; ring + 1 < profile.size(); ring++)
+      for (int s = 0; s < segments; s++)
+      {
+        unsigned int a = base + (unsigned int)ring * segments + s;
+        unsigned int b = base + (unsigned int)ring * segments +
+                         (s + 1) % segments;
+        indices.insert(indices.end(), {a, b, b + segments, b + segments,
+                                       a + segments, a});
+      }
+  }
+
+  void appendBox(std::vector<float> &positions,
+                 std::vector<unsigned int> &indices, const glm::vec3 &min,
+                 const glm::vec3 &max)
+  {
+    unsigned int base = (unsigned int)(positions.size() / 3);
+    for (int corner = 0; corner < 8; corner++)
+      positions.insert(positions.end(),
+                       {corner & 1 ? max.x : min.x, corner & 2 ? max.y : min.y,
+                        corner & 4 ? max.z : min.z});
+    const unsigned int faces[] = {0, 1, 3, 3, 2, 0, 4, 6, 7, 7, 5, 4,
+                                  0, 4, 5, 5, 1, 0, 2, 3, 7, 7, 6, 2,
+                                  0, 2, 6, 6, 4, 0, 1, 5, 7, 7, 3, 1};
+    for (unsigned int index : faces)
+      indices.push_back(base + index);
+  }
+
+  struct SceneMesh
+  {
+    unsigned int VAO;
+    unsigned int indexCount;
+    AABB bounds;
+  };
+
+  SceneMesh makeSceneMesh(const std::vector<float> &positions,
+                          const std::vector<unsigned int> &indices)
+  {
+    SceneMesh mesh = {makeMesh(positions, indices),
+                      (unsigned int)indices.size(),
+                      {glm::vec3(1e30f), glm::vec3(-1e30f)}};
+    for (size_t i = 0; i < positions.size(); i += 3)
+    {
+      glm::vec3 p(positions[i], positions[i + 1], positions[i + 2]);
+      mesh.bounds.min = glm::min(mesh.bounds.min, p);
+      mesh.bounds.max = glm::max(mesh.bounds.max, p);
+    }
+    return mesh;
+  }
+
+  void benchmarkShadows()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // a 32 x 32 field of buildings plus a ring of crates circling the start
+    // of the street the camera drives down
+    std::vector<float> positions;
+    std::vector<unsigned int> indices;
+    appendBox(positions, indices, glm::vec3(-0.5f, 0.0f, -0.5f),
+              glm::vec3(0.5f, 1.0f, 0.5f));
+    SceneMesh box = makeSceneMesh(positions, indices);
+
+    std::vector<RenderObject> casters;
+    for (int z = 0; z < 32; z++)
+      for (int x = 0; x < 32; x++)
+      {
+        if (x == 16)
+          continue;
+        glm::vec3 size(3.0f, 2.0f + 10.0f * unit(random), 3.0f);
+        glm::vec3 position((x - 16) * 6.0f, 0.0f, z * 6.0f);
+        RenderObject object;
+        object.VAO = box.VAO;
+        object.indexCount = box.indexCount;
+        object.model = glm::translate(glm::mat4(1.0f), position) *
+                       glm::scale(glm::mat4(1.0f), size);
+        object.bounds = transformAABB(box.bounds, object.model);
+        casters.push_back(object);
+      }
+    const size_t firstCrate = casters.size();
+    const int crates = 8;
+    for (int i = 0; i < crates; i++)
+      casters.push_back(casters[0]);
+
+    const int cascadeCount = 4;
+    CascadedShadowMap shadows(cascadeCount, 2048);
+    glm::vec3 lightDir = glm::normalize(glm::vec3(-0.4f, -1.0f, -0.3f));
+    float aspect = (float)BENCH_WIDTH / (float)BENCH_HEIGHT;
+
+    // the camera drives, then stops while the crates keep moving, then
+    // everything stops
+    const char* phases[] = {"camera moving", "crates moving", "still"};
+    const int framesPerPhase = 8;
+    float cameraZ = -10.0f;
+    float crateAngle = 0.0f;
+    for (int phase = 0; phase < 3; phase++)
+    {
+      int rendered[CascadedShadowMap::MAX_CASCADES] = {};
+      double cpu = 0.0;
+      for (int frame = 0; frame < framesPerPhase; frame++)
+      {
+        if (phase == 0)
+          cameraZ += 1.5f;
+        if (phase <= 1)
+          crateAngle += 0.1f;
+        for (int i = 0; i < crates; i++)
+        {
+          float angle = crateAngle + 6.2831853f * i / crates;
+          glm::vec3 position(4.0f * std::cos(angle), 0.0f,
+                             8.0f + 4.0f * std::sin(angle));
+          RenderObject &crate = casters[firstCrate + i];
+          crate.model = glm::translate(glm::mat4(1.0f), position);
+          crate.bounds = transformAABB(box.bounds, crate.model);
+        }
+        glm::vec3 eye(0.0f, 2.0f, cameraZ);
+        glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(0.0f, -0.2f, 1.0f),
+                                     glm::vec3(0.0f, 1.0f, 0.0f));
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFinish();
+        double start = now();
+        shadows.update(view, glm::radians(60.0f), aspect, 0.5f, 500.0f,
+                       lightDir, casters);
+        for (int c = 0; c < cascadeCount; c++)
+          if (shadows.cascades[c].needsRender)
+            rendered[c]++;
+        shadows.render(casters);
+        glFinish();
+        cpu += now() - start;
+      }
+
+      std::cout << "shadows " << phases[phase] << ", " << framesPerPhase
+                << " frames: " << cpu / framesPerPhase << " ms a frame"
+                << std::endl;
+      for (int c = 0; c < cascadeCount; c++)
+      {
+        const CascadedShadowMap::Cascade &cascade = shadows.cascades[c];
+        std::cout << "  cascade " << c << " [" << cascade.splitNear << ", "
+                  << cascade.splitFar << "]: " << cascade.casters.size()
+                  << " casters, rendered " << rendered[c] << ", cached "
+                  << framesPerPhase - rendered[c] << ", GPU ";
+        double gpu = shadows.cascadeMilliseconds(c);
+        if (gpu < 0.0)
+          std::cout << "n/a";
+        else
+          std::cout << gpu << " ms";
+        std::cout << std::endl;
+      }
+    }
+    shadows.printStats();
+  }
+
+  void benchmarkImpostors()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // a conifer: a trunk and three stacked cones, about 3k triangles
+    std::vector<float> positions;
+    std::vector<unsigned int> indices;
+    appendLathe(positions, indices, {{0.35f, 0.0f}, {0.25f, 3.0f}}, 16);
+    for (int layer = 0; layer < 3; layer++)
+    {
+      std::vector<glm::vec2> cone;
+      float bottom = 2.0f + layer * 2.2f, radius = 2.6f - layer * 0.6f;
+      for (int ring = 0; ring <= 8; ring++)
+      {
+        float t = ring / 8.0f;
+        cone.push_back(glm::vec2(radius * (1.0f - t) + 0.01f,
+                                 bottom + t * 3.2f));
+      }
+      appendLathe(positions, indices, cone, 64);
+    }
+    std::vector<SceneMesh> trees = {makeSceneMesh(positions, indices)};
+
+    // three office blocks with protruding window frames, 2-4k triangles
+    std::vector<SceneMesh> buildings;
+    for (int floors = 6; floors <= 12; floors += 3)
+    {
+      positions.clear();
+      indices.clear();
+      float height = floors * 3.0f;
+      appendBox(positions, indices, glm::vec3(-5.0f, 0.0f, -5.0f),
+                glm::vec3(5.0f, height, 5.0f));
+      for (int floor = 0; floor < floors; floor++)
+        for (int column = 0; column < 4; column++)
+          for (int side = 0; side < 4; side++)
+          {
+            float along = -3.75f + column * 2.5f, y = floor * 3.0f + 0.8f;
+            glm::vec3 min(along - 0.7f, y, 5.0f);
+            glm::vec3 max(along + 0.7f, y + 1.6f, 5.3f);
+            if (side >= 2)
+            {
+              min = glm::vec3(min.z, min.y, min.x);
+              max = glm::vec3(max.z, max.y, max.x);
+            }
+            if (side % 2 == 1)
+            {
+              glm::vec3 flip(side >= 2 ? -1.0f : 1.0f, 1.0f,
+                             side >= 2 ? 1.0f : -1.0f);
+              glm::vec3 a = min * flip, b = max * flip;
+              min = glm::min(a, b);
+              max = glm::max(a, b);
+            }
+            appendBox(positions, indices, min, max);
+          }
+      buildings.push_back(makeSceneMesh(positions, indices));
+    }
+
+    // a forest of 10000 trees and a city of 2500 blocks, both seen from
+    // near the ground looking across
+    struct Scene
+    {
+      const char* name;
+      const std::vector<SceneMesh>* meshes;
+      int side;
+      float spacing;
+      glm::vec3 eye;
+    };
+    const Scene scenes[] = {
+            {"forest", &trees, 100, 7.0f, glm::vec3(0.0f, 10.0f, -20.0f)},
+            {"city", &buildings, 50, 18.0f, glm::vec3(0.0f, 70.0f, -60.0f)}};
+    std::vector<PointLight> lights(1);
+    lights[0].position = glm::vec3(-300.0f, 800.0f, -400.0f);
+    lights[0].color = glm::vec3(1.0f);
+    lights[0].radius = 5000.0f;
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f),
+                                            (float)BENCH_WIDTH / BENCH_HEIGHT,
+                                            0.5f, 1500.0f);
+
+    for (const Scene &scene : scenes)
+    {
+      std::vector<RenderObject> objects;
+      for (int z = 0; z < scene.side; z++)
+        for (int x = 0; x < scene.side; x++)
+        {
+          const SceneMesh &mesh = (*scene.meshes)[random() %
+                                                  scene.meshes->size()];
+          glm::vec3 position((x - scene.side / 2 + 0.3f * unit(random)) *
+                             scene.spacing, 0.0f,
+                             (z + 0.3f * unit(random)) * scene.spacing);
+          RenderObject object;
+          object.VAO = mesh.VAO;
+          object.indexCount = mesh.indexCount;
+          object.model = glm::translate(glm::mat4(1.0f), position) *
+                         glm::rotate(glm::mat4(1.0f), 6.2831853f * unit(random),
+                                     glm::vec3(0.0f, 1.0f, 0.0f)) *
+                         glm::scale(glm::mat4(1.0f),
+                                    glm::vec3(0.8f + 0.4f * unit(random)));
+          object.bounds = transformAABB(mesh.bounds, object.model);
+          objects.push_back(object);
+        }
+      glm::vec3 lookAt(0.0f, 0.0f, scene.side * scene.spacing * 0.5f);
+      glm::mat4 view = glm::lookAt(scene.eye, lookAt,
+                                   glm::vec3(0.0f, 1.0f, 0.0f));
+
+      OpaqueRenderer meshRenderer;
+      meshRenderer.depthPrepass = false;
+      meshRenderer.lights = lights;
+      ImpostorRenderer impostors;
+      impostors.lights = lights;
+      for (const SceneMesh &mesh : *scene.meshes)
+        impostors.bake(mesh.VAO, mesh.indexCount, mesh.bounds);
+
+      Frustum frustum(projection * view);
+      size_t meshTriangles = 0;
+      for (const RenderObject &object : objects)
+        if (frustum.intersects(object.bounds))
+          meshTriangles += object.indexCount / 3;
+
+      for (int useImpostors = 0; useImpostors <= 1; useImpostors++)
+      {
+        const int frames = 4;
+        double total = 0.0;
+        size_t triangles = meshTriangles;
+        unsigned int draws = 0;
+        for (int frame = 0; frame <= frames; frame++)
+        {
+          glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+          glFinish();
+          double start = now();
+          if (useImpostors)
+          {
+            impostors.prepare(objects, view, projection, BENCH_HEIGHT);
+            meshRenderer.render(impostors.meshObjects(), view, projection);
+            impostors.render();
+          }
+          else
+            meshRenderer.render(objects, view, projection);
+          glFinish();
+          // the first frame warms up
+          if (frame > 0)
+            total += now() - start;
+        }
+        draws = meshRenderer.drawCalls();
+        if (useImpostors)
+        {
+          triangles = impostors.impostorCount() * 2;
+          for (const RenderObject &object : impostors.meshObjects())
+            triangles += object.indexCount / 3;
+          draws += impostors.drawCalls();
+        }
+        std::cout << "impostors " << scene.name << ", " << objects.size()
+                  << " objects, "
+                  << (useImpostors ? "impostors beyond 48 px: "
+                                   : "meshes only: ")
+                  << total / frames << " ms, " << triangles
+                  << " triangles in " << draws << " draws";
+        if (useImpostors)
+          std::cout << " (" << impostors.meshObjects().size() << " meshes, "
+                    << impostors.impostorCount() << " impostors, baked in "
+                    << impostors.bakeMilliseconds() << " ms, "
+                    << impostors.atlasBytes() / (1024.0 * 1024.0)
+                    << " MiB of atlases)";
+        std::cout << std::endl;
+      }
+    }
+  }
+
+  // position/normal mesh for the static batcher, normals averaged over the
+  // faces around each vertex
+  void makeStaticMesh(StaticMesh &mesh, const std::vector<float> &positions,
+                      const std::vector<unsigned int> &indices,
+                      bool withNormals)
+  {
+    std::vector<glm::vec3> points(positions.size() / 3);
+    for (size_t i = 0; i < points.size(); i++)
+      points[i] = glm::vec3(positions[i * 3], positions[i * 3 + 1],
+                            positions[i * 3 + 2]);
+    std::vector<glm::vec3> normals;
+    if (withNormals)
+    {
+      normals.assign(points.size(), glm::vec3(0.0f));
+      for (size_t i = 0; i + 2 < indices.size(); i += 3)
+      {
+        const glm::vec3 &a = points[indices[i]], &b = points[indices[i + 1]],
+                &c = points[indices[i + 2]];
+        glm::vec3 face = glm::cross(b - a, c - a);
+        for (int k = 0; k < 3; k++)
+          normals[indices[i + k]] += face;
+      }
+    }
+    mesh.setVertices(points, normals);
+    mesh.indices = indices;
+  }
+
+  void benchmarkStaticBatching()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    // overlapping props: without the depth test every fragment is shaded
+    // and written, which is not what either path costs in a real frame
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    glEnable(GL_DEPTH_TEST);
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // a few small props of 50-300 triangles: a rock, a column, a barrel
+    // and a crate (the crate without normals)
+    std::vector<std::vector<float> > positions(4);
+    std::vector<std::vector<unsigned int> > indices(4);
+    appendLathe(positions[0], indices[0],
+                {{0.1f, 0.0f}, {1.2f, 0.2f}, {1.0f, 0.9f}, {0.4f, 1.3f},
+                 {0.05f, 1.4f}}, 7);
+    appendLathe(positions[1], indices[1],
+                {{0.7f, 0.0f}, {0.7f, 0.4f}, {0.5f, 0.5f}, {0.45f, 4.0f},
+                 {0.6f, 4.2f}, {0.6f, 4.5f}}, 16);
+    appendLathe(positions[2], indices[2],
+                {{0.01f, 0.0f}, {0.55f, 0.0f}, {0.65f, 0.6f}, {0.55f, 1.2f},
+                 {0.01f, 1.2f}}, 24);
+    appendBox(positions[3], indices[3], glm::vec3(-0.6f, 0.0f, -0.6f),
+              glm::vec3(0.6f, 1.2f, 0.6f));
+    std::vector<StaticMesh> meshes(4);
+    std::vector<SceneMesh> sceneMeshes;
+    for (size_t m = 0; m < meshes.size(); m++)
+    {
+      makeStaticMesh(meshes[m], positions[m], indices[m], m != 3);
+      sceneMeshes.push_back(makeSceneMesh(positions[m], indices[m]));
+    }
+
+    // 20000 props scattered over 560 x 560 units, every mesh in every
+    // material
+    StaticBatcher batcher;
+    batcher.materialColors = {glm::vec3(0.55f, 0.5f, 0.45f),
+                              glm::vec3(0.75f, 0.72f, 0.65f),
+                              glm::vec3(0.5f, 0.3f, 0.15f),
+                              glm::vec3(0.35f, 0.45f, 0.3f)};
+    std::vector<RenderObject> objects;
+    const int side = 140;
+    for (int z = 0; z < side; z++)
+      for (int x = 0; x < side; x++)
+      {
+        unsigned int m = random() % meshes.size();
+        glm::vec3 position((x - side / 2 + 0.8f * unit(random)) * 4.0f, 0.0f,
+                           (z + 0.8f * unit(random)) * 4.0f);
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), position) *
+                          glm::rotate(glm::mat4(1.0f),
+                                      6.2831853f * unit(random),
+                                      glm::vec3(0.0f, 1.0f, 0.0f)) *
+                          glm::scale(glm::mat4(1.0f),
+                                     glm::vec3(0.7f + 0.6f * unit(random),
+                                               0.7f + 0.6f * unit(random),
+                                               0.7f + 0.6f * unit(random)));
+        batcher.add(meshes[m], random() % 4, model);
+        RenderObject object;
+        object.VAO = sceneMeshes[m].VAO;
+        object.indexCount = sceneMeshes[m].indexCount;
+        object.model = model;
+        object.bounds = transformAABB(sceneMeshes[m].bounds, model);
+        objects.push_back(object);
+      }
+
+    // the build: one vertex at a time, with float8, with float8 on all
+    // threads. The last one stays for rendering.
+    JobSystem jobs;
+    const char* builds[] = {"scalar", "float8", "float8 + jobs"};
+    for (int build = 0; build < 3; build++)
+    {
+      batcher.simd = build > 0;
+      batcher.build(build == 2 ? &jobs : NULL);
+      std::cout << "staticbatch build " << builds[build] << " ("
+                << (build == 2 ? jobs.getThreadCount() : 1) << " threads): "
+                << batcher.buildMilliseconds() << " ms, "
+                << batcher.transformMilliseconds() << " ms of it transforming"
+                << std::endl;
+    }
+
+    std::vector<PointLight> lights(1);
+    lights[0].position = glm::vec3(-300.0f, 800.0f, -400.0f);
+    lights[0].color = glm::vec3(1.0f);
+    lights[0].radius = 5000.0f;
+    OpaqueRenderer perObject;
+    perObject.depthPrepass = false;
+    perObject.lights = lights;
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f),
+                                            (float)BENCH_WIDTH / BENCH_HEIGHT,
+                                            0.5f, 1000.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 25.0f, -30.0f),
+                                 glm::vec3(0.0f, 0.0f, 120.0f),
+                                 glm::vec3(0.0f, 1.0f, 0.0f));
+
+    for (int batched = 0; batched <= 1; batched++)
+    {
+      const int frames = 4;
+      double submit = 0.0, total = 0.0;
+      for (int frame = 0; frame <= frames; frame++)
+      {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFinish();
+        double start = now();
+        if (batched)
+          batcher.render(projection * view);
+        else
+          perObject.render(objects, view, projection);
+        double submitted = now();
+        glFinish();
+        // the first frame warms up
+        if (frame > 0)
+        {
+          submit += submitted - start;
+          total += now() - start;
+        }
+      }
+      if (batched)
+        std::cout << "staticbatch batched: " << batcher.drawCalls()
+                  << " draws for " << batcher.drawnInstances()
+                  << " visible instances";
+      else
+        std::cout << "staticbatch per object: " << perObject.drawCalls()
+                  << " draws";
+      std::cout << ", " << submit / frames << " ms to submit, "
+                << total / frames << " ms per frame" << std::endl;
+    }
+    batcher.printReport();
+    if (!depthTest)
+      glDisable(GL_DEPTH_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  }
+
+  void benchmarkDynamicBatching()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    glEnable(GL_DEPTH_TEST);
+    std::mt19937 random(9);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // four small meshes of 8-200 vertices and a 900 vertex one, which is
+    // always instanced
+    std::vector<std::vector<float> > positions(5);
+    std::vector<std::vector<unsigned int> > indices(5);
+    appendLathe(positions[0], indices[0],
+                {{0.05f, 0.0f}, {0.4f, 0.1f}, {0.3f, 0.4f}, {0.05f, 0.5f}}, 6);
+    appendLathe(positions[1], indices[1],
+                {{0.01f, 0.0f}, {0.3f, 0.0f}, {0.35f, 0.3f}, {0.3f, 0.6f},
+                 {0.01f, 0.6f}}, 16);
+    appendLathe(positions[2], indices[2],
+                {{0.01f, -0.3f}, {0.2f, -0.25f}, {0.3f, 0.0f}, {0.2f, 0.25f},
+                 {0.01f, 0.3f}}, 40);
+    appendBox(positions[3], indices[3], glm::vec3(-0.3f), glm::vec3(0.3f));
+    std::vector<glm::vec2> vase;
+    for (int ring = 0; ring < 15; ring++)
+      vase.push_back(glm::vec2(0.3f + 0.15f * std::sin(ring * 0.6f),
+                               ring * 0.08f));
+    appendLathe(positions[4], indices[4], vase, 60);
+
+    JobSystem jobs;
+    DynamicBatcher batcher(1 << 20, &jobs);
+    batcher.materialColors = {glm::vec3(0.8f, 0.3f, 0.2f),
+                              glm::vec3(0.3f, 0.7f, 0.3f),
+                              glm::vec3(0.3f, 0.4f, 0.8f),
+                              glm::vec3(0.8f, 0.7f, 0.3f)};
+    std::vector<SceneMesh> sceneMeshes;
+    for (size_t m = 0; m < positions.size(); m++)
+    {
+      StaticMesh mesh;
+      makeStaticMesh(mesh, positions[m], indices[m], m != 3);
+      batcher.addMesh(mesh);
+      sceneMeshes.push_back(makeSceneMesh(positions[m], indices[m]));
+    }
+
+    // 10000 objects tumbling over a 100 x 100 field, a few of them large
+    struct Mover
+    {
+      unsigned int mesh, material;
+      glm::vec3 position, axis;
+      float spin;
+    };
+    std::vector<Mover> movers;
+    for (int z = 0; z < 100; z++)
+      for (int x = 0; x < 100; x++)
+      {
+        Mover mover;
+        mover.mesh = random() % 50 == 0 ? 4 : random() % 4;
+        mover.material = random() % 4;
+        mover.position = glm::vec3((x - 50 + unit(random)) * 1.0f,
+                                   1.0f + unit(random),
+                                   (z + unit(random)) * 1.0f);
+        mover.axis = glm::normalize(glm::vec3(unit(random) - 0.5f, 1.0f,
+                                              unit(random) - 0.5f));
+        mover.spin = 1.0f + 3.0f * unit(random);
+        movers.push_back(mover);
+      }
+    std::vector<RenderObject> objects(movers.size());
+    std::vector<PointLight> lights(1);
+    lights[0].position = glm::vec3(-300.0f, 800.0f, -400.0f);
+    lights[0].color = glm::vec3(1.0f);
+    lights[0].radius = 5000.0f;
+    OpaqueRenderer perObject;
+    perObject.depthPrepass = false;
+    perObject.lights = lights;
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f),
+                                            (float)BENCH_WIDTH / BENCH_HEIGHT,
+                                            0.1f, 300.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 18.0f, -12.0f),
+                                 glm::vec3(0.0f, 0.0f, 40.0f),
+                                 glm::vec3(0.0f, 1.0f, 0.0f));
+    const char* names[] = {"one draw per object", "always instanced",
+                           "always batched", "automatic"};
+    const DynamicBatcher::Mode modes[] = {DynamicBatcher::AUTOMATIC,
+                                          DynamicBatcher::ALWAYS_INSTANCE,
+                                          DynamicBatcher::ALWAYS_BATCH,
+                                          DynamicBatcher::AUTOMATIC};
+    for (int run = 0; run < 4; run++)
+    {
+      batcher.mode = modes[run];
+      // the first frames warm up, and let the automatic mode measure both
+      // paths once
+      const int warmup = 3, frames = 4;
+      double cpu = 0.0, total = 0.0;
+      unsigned int draws = 0;
+      for (int frame = 0; frame < warmup + frames; frame++)
+      {
+        float time = frame / 60.0f;
+        for (size_t i = 0; i < movers.size(); i++)
+        {
+          const Mover &mover = movers[i];
+          glm::mat4 model = glm::translate(glm::mat4(1.0f), mover.position) *
+                            glm::rotate(glm::mat4(1.0f), mover.spin * time,
+                                        mover.axis);
+          if (run == 0)
+          {
+            const SceneMesh &mesh = sceneMeshes[mover.mesh];
+            objects[i].VAO = mesh.VAO;
+            objects[i].indexCount = mesh.indexCount;
+            objects[i].model = model;
+            objects[i].bounds = transformAABB(mesh.bounds, model);
+          }
+          else
+            batcher.draw(mover.mesh, mover.material, model);
+        }
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFinish();
+        double start = now();
+        if (run == 0)
+          perObject.render(objects, view, projection);
+        else
+          batcher.render(projection * view);
+        double submitted = now();
+        glFinish();
+        if (frame >= warmup)
+        {
+          cpu += submitted - start;
+          total += now() - start;
+        }
+        draws = run == 0 ? perObject.drawCalls() : batcher.drawCalls();
+      }
+      std::cout << "dynamicbatch " << names[run] << ": " << draws
+                << " draws, " << cpu / frames << " ms CPU, " << total / frames
+                << " ms per frame" << std::endl;
+      if (run > 0)
+        batcher.printStats();
+    }
+    glDisable(GL_DEPTH_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  }
+
+  void benchmarkPackedInstances()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    glEnable(GL_DEPTH_TEST);
+    unsigned int cube = makeMesh(
+            {-0.5f, -0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, -0.5f,
+             -0.5f, 0.5f, -0.5f, -0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f,
+             0.5f, 0.5f, 0.5f, -0.5f, 0.5f, 0.5f},
+            {0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4, 0, 4, 7, 7, 3, 0,
+             1, 5, 6, 6, 2, 1, 3, 2, 6, 6, 7, 3, 0, 1, 5, 5, 4, 0});
+
+    // 100000 spinning cubes on a 400 x 250 grid, seen from above
+    const unsigned int count = 100000;
+    PackedInstanceRenderer renderer(cube, 36, count);
+    renderer.setCount(count);
+    std::mt19937 random(17);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<glm::vec3> axes(count);
+    for (glm::vec3 &axis : axes)
+      axis = glm::normalize(glm::vec3(unit(random), unit(random),
+                                      unit(random)) - 0.5f);
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f),
+                                            (float)BENCH_WIDTH / BENCH_HEIGHT,
+                                            1.0f, 1000.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 190.0f, -40.0f),
+                                 glm::vec3(0.0f, 0.0f, 0.0f),
+                                 glm::vec3(0.0f, 1.0f, 0.0f));
+
+    struct Run
+    {
+      const char* name;
+      PackedInstanceRenderer::Format format;
+      bool simd;
+    };
+    const Run runs[] = {
+            {"matrices", PackedInstanceRenderer::MATRIX, false},
+            {"packed, scalar", PackedInstanceRenderer::PACKED, false},
+            {"packed, float8", PackedInstanceRenderer::PACKED, true}};
+    std::vector<unsigned char> reference(BENCH_WIDTH * BENCH_HEIGHT * 4);
+    for (const Run &run : runs)
+    {
+      renderer.format = run.format;
+      renderer.simd = run.simd;
+      const int frames = 8;
+      double pack = 0.0, upload = 0.0, total = 0.0;
+      for (int frame = 0; frame <= frames; frame++)
+      {
+        float time = frame / 60.0f;
+        for (unsigned int i = 0; i < count; i++)
+          renderer.setInstance(i, glm::vec3((i % 400) - 200.0f, 0.0f,
+                                            (i / 400) - 125.0f),
+                               glm::angleAxis(time * (1.0f + axes[i].x),
+                                              axes[i]),
+                               0.6f + 0.2f * axes[i].y);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFinish();
+        double start = now();
+        renderer.render(projection * view);
+        glFinish();
+        // the first frame warms up
+        if (frame > 0)
+        {
+          total += now() - start;
+          pack += renderer.packMilliseconds();
+          upload += renderer.uploadMilliseconds();
+        }
+      }
+      std::cout << "instances " << run.name << ": "
+                << renderer.uploadedBytes() / count << " bytes each, "
+                << renderer.uploadedBytes() / (1024.0 * 1024.0)
+                << " MiB per frame, pack " << pack / frames << " ms, upload "
+                << upload / frames << " ms, " << total / frames
+                << " ms per frame";
+      if (run.format == PackedInstanceRenderer::MATRIX)
+        glReadPixels(0, 0, BENCH_WIDTH, BENCH_HEIGHT, GL_RGBA,
+                     GL_UNSIGNED_BYTE, reference.data());
+      else
+        std::cout << ", PSNR against matrices " << psnr(reference) << " dB";
+      std::cout << std::endl;
+    }
+    glDisable(GL_DEPTH_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  }
+
+  void benchmarkVisibilityBuffer()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    glEnable(GL_DEPTH_TEST);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 6.0f, 26.0f),
+                                 glm::vec3(0.0f, 0.0f, 0.0f),
+                                 glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f),
+                                            (float)BENCH_WIDTH / BENCH_HEIGHT,
+                                            0.5f, 100.0f);
+
+    // the ground under the spheres runs up to the plane through the eye
+    // (z = 26 + 42 / 26 at y = -1), so its near corners have w = 0 and its
+    // triangles cross the near plane
+    std::vector<float> groundPositions = {-60.0f, -1.0f, -60.0f,
+                                          60.0f, -1.0f, -60.0f,
+                                          60.0f, -1.0f, 27.6153846f,
+                                          -60.0f, -1.0f, 27.6153846f};
+    std::vector<unsigned int> groundIndices = {0, 2, 1, 0, 3, 2};
+    SceneMesh ground = makeSceneMesh(groundPositions, groundIndices);
+
+    // the same field of spheres at two tessellations: a few pixels per
+    // triangle and a few hundred
+    struct Scene
+    {
+      const char* name;
+      int rings, segments;
+    };
+    const Scene scenes[] = {{"dense", 64, 96}, {"coarse", 8, 12}};
+    for (const Scene &scene : scenes)
+    {
+      std::vector<glm::vec2> profile;
+      for (int r = 0; r <= scene.rings; r++)
+      {
+        float angle = 3.14159265f * r / scene.rings;
+        profile.push_back(glm::vec2(std::sin(angle), -std::cos(angle)));
+      }
+      std::vector<float> positions;
+      std::vector<unsigned int> indices;
+      appendLathe(positions, indices, profile, scene.segments);
+      SceneMesh mesh = makeSceneMesh(positions, indices);
+
+      std::vector<RenderObject> objects;
+      for (int z = 0; z < 12; z++)
+        for (int x = 0; x < 24; x++)
+        {
+          glm::vec3 offset(x * 2.2f - 25.3f, 0.0f, z * -2.2f + 8.0f);
+          RenderObject object = {mesh.VAO, mesh.indexCount,
+                                 glm::translate(glm::mat4(1.0f), offset),
+                                 {mesh.bounds.min + offset,
+                                  mesh.bounds.max + offset}};
+          objects.push_back(object);
+        }
+      objects.push_back({ground.VAO, ground.indexCount, glm::mat4(1.0f),
+                         ground.bounds});
+      size_t triangles = 0;
+      for (const RenderObject &object : objects)
+        triangles += object.indexCount / 3;
+
+      OpaqueRenderer forward;
+      forward.lights = makeLights(OpaqueRenderer::MAX_LIGHTS);
+      VisibilityBufferRenderer visibility(BENCH_WIDTH, BENCH_HEIGHT);
+      visibility.lights = forward.lights;
+      visibility.addMesh(mesh.VAO, positions, std::vector<float>(), indices);
+      visibility.addMesh(ground.VAO, groundPositions, std::vector<float>(),
+                         groundIndices);
+
+      std::vector<unsigned char> reference(BENCH_WIDTH * BENCH_HEIGHT * 4);
+      const char* modes[] = {"forward + prepass", "forward",
+                             "visibility buffer"};
+      for (int mode = 0; mode < 3; mode++)
+      {
+        forward.depthPrepass = mode == 0;
+        const int frames = 4;
+        double total = 0.0, firstGpu = 0.0, secondGpu = 0.0;
+        for (int frame = 0; frame <= frames; frame++)
+        {
+          glBindFramebuffer(GL_FRAMEBUFFER, target.FBO);
+          glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+          glFinish();
+          double start = now();
+          if (mode < 2)
+            forward.render(objects, view, projection);
+          else
+            visibility.render(objects, view, projection, target.FBO);
+          glFinish();
+          // the first frame warms up
+          if (frame == 0)
+            continue;
+          total += now() - start;
+          if (mode < 2)
+          {
+            firstGpu += std::max(forward.prepassGpuMilliseconds(), 0.0);
+            secondGpu += forward.shadingGpuMilliseconds();
+          }
+          else
+          {
+            firstGpu += visibility.visibilityGpuMilliseconds();
+            secondGpu += visibility.shadingGpuMilliseconds();
+          }
+        }
+        std::cout << "visbuffer " << scene.name << " ("
+                  << triangles << " triangles), "
+                  << modes[mode] << ": " << total / frames << " ms (GPU "
+                  << firstGpu / frames << " + " << secondGpu / frames
+                  << ")";
+        if (mode == 0)
+          glReadPixels(0, 0, BENCH_WIDTH, BENCH_HEIGHT, GL_RGBA,
+                       GL_UNSIGNED_BYTE, reference.data());
+        else
+          std::cout << ", PSNR against the prepass " << psnr(reference)
+                    << " dB";
+        std::cout << std::endl;
+      }
+      visibility.printStats();
+    }
+    glDisable(GL_DEPTH_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  }
+
+  void benchmarkSkeletalAnimation()
+  {
+    // a 60 bone skeleton: a spine of 10 and five limbs of 10 hanging off it
+    const unsigned int boneCount = 60;
+    Skeleton skeleton;
+    std::vector<glm::vec3> offsets(boneCount);
+    std::vector<glm::mat4> bind(boneCount);
+    for (unsigned int bone = 0; bone < boneCount; bone++)
+    {
+      int parent;
+      if (bone < 10)
+      {
+        parent = (int)bone - 1;
+        offsets[bone] = glm::vec3(0.0f, bone == 0 ? 0.0f : 0.15f, 0.0f);
+      }
+      else
+      {
+        unsigned int limb = (bone - 10) / 10;
+        float angle = 6.2831853f * limb / 5.0f;
+        parent = (bone - 10) % 10 == 0 ? (int)(limb * 2 + 1) : (int)bone - 1;
+        offsets[bone] = 0.1f * glm::vec3(std::cos(angle), -0.3f,
+                                         std::sin(angle));
+      }
+      skeleton.parents.push_back(parent);
+      bind[bone] = glm::translate(parent < 0 ? glm::mat4(1.0f) : bind[parent],
+                                  offsets[bone]);
+      skeleton.inverseBind.push_back(glm::inverse(bind[bone]));
+    }
+
+    // two looping clips swinging every bone about different axes
+    AnimationClip walk(boneCount, 30, 30.0f), wave(boneCount, 24, 30.0f);
+    for (unsigned int bone = 0; bone < boneCount; bone++)
+    {
+      for (unsigned int frame = 0; frame < 30; frame++)
+        walk.setKey(frame, bone,
+                    glm::angleAxis(0.3f * std::sin(6.2831853f * frame / 30.0f +
+                                                   bone * 0.5f),
+                                   glm::vec3(1.0f, 0.0f, 0.0f)),
+                    offsets[bone], glm::vec3(1.0f));
+      for (unsigned int frame = 0; frame < 24; frame++)
+        wave.setKey(frame, bone,
+                    glm::angleAxis(0.4f * std::sin(6.2831853f * frame / 24.0f +
+                                                   bone * 0.9f),
+                                   glm::normalize(glm::vec3(0.3f, 0.2f,
+                                                            1.0f))),
+                    offsets[bone], glm::vec3(1.0f + 0.05f * (bone % 3)));
+    }
+
+    // 1000 characters on a 40 x 25 grid, all of them blending both clips
+    const unsigned int count = 1000;
+    std::vector<CharacterState> characters(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+      CharacterState &character = characters[i];
+      character.clip = &walk;
+      character.blendClip = &wave;
+      character.blendWeight = (i % 11) / 10.0f;
+      character.world = glm::rotate(
+              glm::translate(glm::mat4(1.0f),
+                             glm::vec3((i % 40) * 1.5f - 29.25f, 0.0f,
+                                       (i / 40) * -1.5f)),
+              i * 0.7f, glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+    AnimationSystem animation(skeleton, count);
+
+    // the float8 path against glm on the same poses
+    std::vector<float> scalar(count * boneCount * 12);
+    std::vector<float> vectorized(count * boneCount * 12);
+    for (CharacterState &character : characters)
+    {
+      character.time = 0.37f;
+      character.blendTime = 0.81f;
+    }
+    animation.simd = false;
+    animation.evaluate(characters, scalar.data());
+    animation.simd = true;
+    animation.evaluate(characters, vectorized.data());
+    float maxError = 0.0f;
+    for (size_t i = 0; i < scalar.size(); i++)
+      maxError = std::max(maxError, std::abs(scalar[i] - vectorized[i]));
+    std::cout << "animation float8 against glm: max difference " << maxError
+              << std::endl;
+
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    struct Run
+    {
+      const char* name;
+      bool simd;
+      unsigned int threads;
+    };
+    const Run runs[] = {{"glm, 1 thread", false, 1},
+                        {"float8, 1 thread", true, 1},
+                        {"float8, all threads", true, 0}};
+    for (const Run &run : runs)
+    {
+      JobSystem jobs(run.threads);
+      animation.simd = run.simd;
+      const int frames = 60;
+      double total = 0.0;
+      for (int frame = 0; frame < frames + 10; frame++)
+      {
+        for (unsigned int i = 0; i < count; i++)
+        {
+          characters[i].time = frame / 60.0f + i * 0.013f;
+          characters[i].blendTime = frame / 60.0f + i * 0.029f;
+        }
+        animation.update(characters, &jobs);
+        // the first frames warm up caches and wake the threads
+        if (frame >= 10)
+          total += animation.cpuMilliseconds();
+      }
+      std::cout << "animation " << count << " characters x " << boneCount
+                << " bones, " << run.name << " (" << jobs.getThreadCount()
+                << "): " << total / frames << " ms/frame" << std::endl;
+    }
+
+    // a box around every bone, skinned to that bone only
+    struct SkinnedVertex
+    {
+      float position[3];
+      int bones[4];
+      float weights[4];
+    };
+    std::vector<SkinnedVertex> vertices;
+    std::vector<unsigned int> indices;
+    for (unsigned int bone = 0; bone < boneCount; bone++)
+    {
+      std::vector<float> box;
+      glm::vec3 center(bind[bone][3]);
+      appendBox(box, indices, center - 0.04f, center + 0.04f);
+      // appendBox numbers the vertices from the positions it was given
+      for (size_t i = indices.size() - 36; i < indices.size(); i++)
+        indices[i] += (unsigned int)vertices.size();
+      for (size_t v = 0; v < box.size(); v += 3)
+      {
+        SkinnedVertex vertex = {{box[v], box[v + 1], box[v + 2]},
+                                {(int)bone, 0, 0, 0},
+                                {1.0f, 0.0f, 0.0f, 0.0f}};
+        vertices.push_back(vertex);
+      }
+    }
+    unsigned int VAO, VBO, EBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(SkinnedVertex),
+                 vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
+                 indices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex),
+                          (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribIPointer(1, 4, GL_INT, sizeof(SkinnedVertex),
+                           (void*)offsetof(SkinnedVertex, bones));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SkinnedVertex),
+                          (void*)offsetof(SkinnedVertex, weights));
+    glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
+
+    Shader shader("shaders/skinnedvs.txt", "shaders/multiviewfs.txt");
+    shader.use();
+    shader.setMat4("viewProjection",
+                   glm::perspective(glm::radians(60.0f),
+                                    (float)BENCH_WIDTH / BENCH_HEIGHT, 0.5f,
+                                    100.0f) *
+                   glm::lookAt(glm::vec3(0.0f, 12.0f, 14.0f),
+                               glm::vec3(0.0f, 0.0f, -18.0f),
+                               glm::vec3(0.0f, 1.0f, 0.0f)));
+    shader.setInt("palettes", 0);
+    shader.setInt("boneCount", (int)boneCount);
+    shader.setInt("firstCharacter", 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, animation.paletteTexture());
+    glEnable(GL_DEPTH_TEST);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glFinish();
+    double start = now();
+    glBindVertexArray(VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)indices.size(),
+                            GL_UNSIGNED_INT, 0, count);
+    glFinish();
+    std::cout << "animation skinned draw of " << count << " characters: "
+              << now() - start << " ms" << std::endl;
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glDisable(GL_DEPTH_TEST);
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    glDeleteProgram(shader.ID);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  }
+
+  void benchmarkCurves()
+  {
+    // 20000 curves of 8 keys at uneven times, like camera paths and
+    // animated properties
+    const unsigned int count = 20000;
+    CurveSet curves;
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (unsigned int c = 0; c < count; c++)
+    {
+      std::vector<float> times;
+      std::vector<glm::vec3> points;
+      float time = 0.0f;
+      for (int k = 0; k < 8; k++)
+      {
+        times.push_back(time);
+        points.push_back(glm::vec3(unit(random), unit(random),
+                                   unit(random)) * 10.0f);
+        time += 0.2f + unit(random);
+      }
+      curves.addCurve(times, points);
+    }
+    std::vector<float> times(count), x(count), y(count), z(count);
+    std::vector<float> referenceX(count), referenceY(count),
+                       referenceZ(count);
+
+    // 240 frames at 60 Hz, time only moves forward
+    struct Run
+    {
+      const char* name;
+      bool simd, cache;
+    };
+    const Run runs[] = {{"glm, binary search", false, false},
+                        {"glm, cached segment", false, true},
+                        {"float8, cached segment", true, true}};
+    for (const Run &run : runs)
+    {
+      curves.simd = run.simd;
+      curves.cacheSegments = run.cache;
+      const int frames = 240;
+      unsigned int searches = 0;
+      double start = now();
+      for (int frame = 0; frame < frames; frame++)
+      {
+        for (unsigned int c = 0; c < count; c++)
+          times[c] = frame / 60.0f + c * 1e-4f;
+        curves.evaluate(times.data(), x.data(), y.data(), z.data());
+        searches += curves.segmentSearches();
+      }
+      double total = (now() - start) / frames;
+      std::cout << "curves " << count << " " << run.name << ": " << total
+                << " ms/frame, " << count / (total / 1000.0) / 1.0e6
+                << " M points/s, " << searches / frames
+                << " searches/frame";
+      if (!run.simd && !run.cache)
+      {
+        referenceX = x;
+        referenceY = y;
+        referenceZ = z;
+      }
+      else
+      {
+        float difference = 0.0f;
+        for (unsigned int c = 0; c < count; c++)
+          difference = std::max(difference,
+                                glm::length(glm::vec3(x[c], y[c], z[c]) -
+                                            glm::vec3(referenceX[c],
+                                                      referenceY[c],
+                                                      referenceZ[c])));
+        std::cout << ", max difference " << difference;
+      }
+      std::cout << std::endl;
+    }
+
+    // constant speed: the distance each curve covers per frame
+    double start = now();
+    curves.buildArcLengths();
+    std::cout << "curves arc length tables: " << now() - start << " ms"
+              << std::endl;
+    std::vector<float> distances(count), previousTimes(count);
+    double lookup = 0.0, evaluate = 0.0;
+    float minStep = 1e30f, maxStep = 0.0f;
+    double deviation = 0.0;
+    const int frames = 60;
+    for (int frame = 0; frame <= frames; frame++)
+    {
+      for (unsigned int c = 0; c < count; c++)
+        distances[c] = curves.length(c) * frame / frames;
+      start = now();
+      curves.timesAtDistances(distances.data(), times.data());
+      double looked = now();
+      curves.evaluate(times.data(), x.data(), y.data(), z.data());
+      lookup += looked - start;
+      evaluate += now() - looked;
+      // the path length covered this frame against the distance asked
+      // for, measured on the first 1000 curves in small steps (a chord
+      // would cut across hairpin turns)
+      if (frame > 0)
+        for (unsigned int c = 0; c < 1000; c++)
+        {
+          float covered = 0.0f;
+          glm::vec3 previous = curves.evaluate(c, previousTimes[c]);
+          for (int k = 1; k <= 16; k++)
+          {
+            glm::vec3 point = curves.evaluate(
+                    c, previousTimes[c] +
+                       (times[c] - previousTimes[c]) * k / 16.0f);
+            covered += glm::length(point - previous);
+            previous = point;
+          }
+          float step = covered / (curves.length(c) / frames);
+          minStep = std::min(minStep, step);
+          maxStep = std::max(maxStep, step);
+          deviation += std::abs(step - 1.0f);
+        }
+      previousTimes = times;
+    }
+    std::cout << "curves constant speed: lookup " << lookup / (frames + 1)
+              << " ms + evaluate " << evaluate / (frames + 1)
+              << " ms per frame, step length " << minStep << " to "
+              << maxStep << " of the requested, "
+              << 100.0 * deviation / (frames * 1000) << "% off on average"
+              << std::endl;
+  }
+
+  void benchmarkTweens()
+  {
+    // the component storage: four animated fields per UI element
+    struct UiElement
+    {
+      float x, y, alpha, scale;
+    };
+    const unsigned int count = 100000;
+    std::vector<UiElement> elements(count / 4);
+    std::vector<UiElement> reference;
+
+    const bool modes[] = {false, true};
+    for (bool simd : modes)
+    {
+      TweenEngine tweens;
+      tweens.simd = simd;
+      std::mt19937 random(3);
+      std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+      std::fill(elements.begin(), elements.end(),
+                UiElement{0.0f, 0.0f, 0.0f, 0.0f});
+      // keeps count tweens running, whatever finishes is restarted on a
+      // random field with a random easing
+      auto start = [&](unsigned int tweensToAdd)
+      {
+        for (unsigned int i = 0; i < tweensToAdd; i++)
+        {
+          UiElement &element = elements[random() % elements.size()];
+          float* fields[] = {&element.x, &element.y, &element.alpha,
+                             &element.scale};
+          tweens.add((TweenEngine::Easing)(random() %
+                                           TweenEngine::EASING_COUNT),
+                     fields[random() % 4], unit(random) * 100.0f,
+                     unit(random) * 100.0f, 0.2f + 1.8f * unit(random));
+        }
+      };
+      start(count);
+      const int frames = 300;
+      double total = 0.0;
+      unsigned int finished = 0;
+      for (int frame = 0; frame < frames; frame++)
+      {
+        tweens.update(1.0f / 60.0f);
+        total += tweens.cpuMilliseconds();
+        finished += tweens.finishedLastUpdate();
+        start(count - tweens.activeCount());
+      }
+      std::cout << "tweens " << count << (simd ? " float8" : " glm scalar")
+                << ": " << total / frames << " ms/frame, "
+                << count / (total / frames / 1000.0) / 1.0e6
+                << " M tweens/s, " << finished / frames
+                << " finished and restarted per frame";
+      if (!simd)
+        reference = elements;
+      else
+      {
+        float difference = 0.0f;
+        for (size_t i = 0; i < elements.size(); i++)
+          difference = std::max(
+                  {difference, std::abs(elements[i].x - reference[i].x),
+                   std::abs(elements[i].y - reference[i].y),
+                   std::abs(elements[i].alpha - reference[i].alpha),
+                   std::abs(elements[i].scale - reference[i].scale)});
+        std::cout << ", max difference " << difference;
+      }
+      std::cout << std::endl;
+    }
+  }
+
+  void benchmarkBroadphase()
+  {
+    const unsigned int count = 200000;
+    const float bounds = 100.0f;
+    // two seconds of movement, the tree ages over it
+    const int frames = 40;
+    JobSystem jobs;
+    JobSystem singleThread(1);
+
+    const char* workloads[] = {"uniform", "clustered"};
+    for (int workload = 0; workload < 2; workload++)
+    {
+      std::mt19937 random(11);
+      std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+      std::vector<glm::vec3> positions(count), velocities(count), sizes(count);
+      // clustered: 200 clumps of 1000 objects, a few units across
+      std::vector<glm::vec3> clumps(200);
+      for (glm::vec3 &clump : clumps)
+        clump = glm::vec3(unit(random), unit(random), unit(random)) *
+                (bounds - 20.0f) + 10.0f;
+      for (unsigned int i = 0; i < count; i++)
+      {
+        glm::vec3 offset(unit(random), unit(random), unit(random));
+        positions[i] = workload == 0
+                       ? offset * bounds
+                       : clumps[i % clumps.size()] + (offset - 0.5f) * 12.0f;
+        velocities[i] = (glm::vec3(unit(random), unit(random), unit(random)) -
+                         0.5f) * 6.0f;
+        sizes[i] = glm::vec3(0.5f) + glm::vec3(unit(random), unit(random),
+                                               unit(random));
+      }
+      std::vector<AABB> boxes(count);
+      auto updateBoxes = [&](float deltaTime)
+      {
+        for (unsigned int i = 0; i < count; i++)
+        {
+          positions[i] += velocities[i] * deltaTime;
+          for (int axis = 0; axis < 3; axis++)
+            if (positions[i][axis] < 0.0f || positions[i][axis] > bounds)
+              velocities[i][axis] = -velocities[i][axis];
+          boxes[i].min = positions[i] - sizes[i] * 0.5f;
+          boxes[i].max = positions[i] + sizes[i] * 0.5f;
+        }
+      };
+      updateBoxes(0.0f);
+
+      SpatialHashGrid grid(3.0f);
+      BoundingVolumeHierarchy bvh;
+      bvh.build(boxes);
+      std::cout << "broadphase " << workloads[workload] << " " << count
+                << ": bvh build " << bvh.buildMilliseconds() << " ms, "
+                << bvh.nodeCount() << " nodes" << std::endl;
+
+      std::vector<ObjectPair> gridPairs, bvhPairs, singlePairs;
+      double gridBuild = 0.0, gridPair = 0.0, refit = 0.0, bvhPair = 0.0;
+      double firstBvhPair = 0.0;
+      size_t pairCount = 0;
+      bool same = true, deterministic = true;
+      for (int frame = 0; frame < frames; frame++)
+      {
+        updateBoxes(1.0f / 20.0f);
+        grid.build(boxes, &jobs);
+        grid.findPairs(gridPairs, &jobs);
+        gridBuild += grid.buildMilliseconds();
+        gridPair += grid.pairMilliseconds();
+        bvh.refit(boxes);
+        bvh.findPairs(bvhPairs, &jobs);
+        refit += bvh.refitMilliseconds();
+        bvhPair += bvh.pairMilliseconds();
+        if (frame == 0)
+          firstBvhPair = bvh.pairMilliseconds();
+        pairCount += gridPairs.size();
+
+        std::vector<ObjectPair> sortedGrid = gridPairs;
+        std::sort(sortedGrid.begin(), sortedGrid.end());
+        std::sort(bvhPairs.begin(), bvhPairs.end());
+        same = same && sortedGrid == bvhPairs;
+        if (frame == 0)
+        {
+          grid.build(boxes, &singleThread);
+          grid.findPairs(singlePairs, &singleThread);
+          deterministic = singlePairs == gridPairs;
+        }
+      }
+      std::cout << "broadphase " << workloads[workload] << " grid: build "
+                << gridBuild / frames << " ms + pairs " << gridPair / frames
+                << " ms = " << (gridBuild + gridPair) / frames
+                << " ms/frame, table " << grid.tableSize() << std::endl;
+      std::cout << "broadphase " << workloads[workload] << " bvh: refit "
+                << refit / frames << " ms + pairs " << bvhPair / frames
+                << " ms = " << (refit + bvhPair) / frames
+                << " ms/frame, pairs " << firstBvhPair
+                << " ms in the first frame and " << bvh.pairMilliseconds()
+                << " ms in the last" << std::endl;
+      std::cout << "broadphase " << workloads[workload] << ": "
+                << pairCount / frames << " pairs/frame on "
+                << jobs.getThreadCount() << " threads, grid and bvh "
+                << (same ? "agree" : "DIFFER") << ", grid order on 1 thread "
+                << (deterministic ? "identical" : "DIFFERS") << std::endl;
+    }
+  }
+
+  void benchmarkColorSpace()
+  {
+    const size_t pixels = 2048 * 2048;
+    std::mt19937 random(5);
+    std::vector<unsigned char> image(pixels * 4);
+    for (unsigned char &value : image)
+      value = (unsigned char)(random() & 0xff);
+    ColorConverter converter;
+    std::vector<float> linear(pixels * 4);
+    converter.srgbToLinear(image.data(), linear.data(), pixels);
+
+    std::vector<unsigned char> bytes(pixels * 4), referenceBytes;
+    std::vector<float> floats(pixels * 4), referenceFloats;
+    const char* names[] = {"sRGB8 -> linear", "linear -> sRGB8",
+                           "sRGB -> linear float", "linear -> sRGB float",
+                           "gamma 2.2", "premultiply float",
+                           "unpremultiply float", "premultiply 8 bit",
+                           "unpremultiply 8 bit"};
+    // bytes read and written per pixel
+    const int traffic[] = {20, 20, 32, 32, 32, 32, 32, 8, 8};
+    // the in place kernels start from a fresh copy every time, not timed
+    auto prepare = [&](int kernel)
+    {
+      if (kernel >= 2 && kernel <= 6)
+        floats = linear;
+      else if (kernel >= 7)
+        bytes = image;
+    };
+    auto run = [&](int kernel)
+    {
+      switch (kernel)
+      {
+        case 0:
+          converter.srgbToLinear(image.data(), floats.data(), pixels);
+          break;
+        case 1:
+          converter.linearToSrgb(linear.data(), bytes.data(), pixels);
+          break;
+        case 2:
+          converter.srgbToLinear(floats.data(), pixels);
+          break;
+        case 3:
+          converter.linearToSrgb(floats.data(), pixels);
+          break;
+        case 4:
+          converter.applyGamma(floats.data(), pixels, 2.2f);
+          break;
+        case 5:
+          converter.premultiply(floats.data(), pixels);
+          break;
+        case 6:
+          converter.unpremultiply(floats.data(), pixels);
+          break;
+        case 7:
+          converter.premultiply(bytes.data(), pixels);
+          break;
+        default:
+          converter.unpremultiply(bytes.data(), pixels);
+          break;
+      }
+    };
+
+    const int repeats = 5;
+    for (int kernel = 0; kernel < 9; kernel++)
+    {
+      double times[2];
+      for (int simd = 0; simd < 2; simd++)
+      {
+        converter.simd = simd == 1;
+        double best = 1e30;
+        for (int repeat = 0; repeat < repeats; repeat++)
+        {
+          prepare(kernel);
+          double start = now();
+          run(kernel);
+          best = std::min(best, now() - start);
+        }
+        times[simd] = best;
+        if (simd == 0)
+        {
+          referenceBytes = bytes;
+          referenceFloats = floats;
+        }
+      }
+      double gigabytes = (double)traffic[kernel] * pixels / 1.0e9;
+      std::cout << "colorspace " << names[kernel] << ": glm scalar "
+                << times[0] << " ms (" << gigabytes / (times[0] / 1000.0)
+                << " GB/s), float8 " << times[1] << " ms ("
+                << gigabytes / (times[1] / 1000.0) << " GB/s), ";
+      bool eightBitOutput = kernel == 1 || kernel >= 7;
+      if (eightBitOutput)
+        std::cout << (bytes == referenceBytes ? "identical" : "DIFFERENT");
+      else
+      {
+        float difference = 0.0f;
+        for (size_t i = 0; i < floats.size(); i++)
+          difference = std::max(difference,
+                                std::abs(floats[i] - referenceFloats[i]));
+        std::cout << "max difference " << difference;
+      }
+      std::cout << std::endl;
+    }
+
+    // 8 bit pixels through linear and back must come out unchanged, and
+    // floats all over [0, 1] (every 7th bit pattern) must round like glm
+    converter.simd = true;
+    converter.srgbToLinear(image.data(), linear.data(), pixels);
+    converter.linearToSrgb(linear.data(), bytes.data(), pixels);
+    bool roundTrip = bytes == image;
+    ColorConverter reference;
+    reference.simd = false;
+    size_t checked = 0, wrong = 0;
+    for (uint32_t bits = 0; bits < 0x3f800000u;
+         bits += 7 * (uint32_t)linear.size())
+    {
+      for (size_t i = 0; i < linear.size(); i++)
+      {
+        uint32_t value = std::min(bits + 7 * (uint32_t)i, 0x3f800000u);
+        std::memcpy(&linear[i], &value, sizeof(float));
+      }
+      converter.linearToSrgb(linear.data(), bytes.data(), pixels);
+      reference.linearToSrgb(linear.data(), referenceBytes.data(), pixels);
+      for (size_t i = 0; i < bytes.size(); i++)
+        wrong += bytes[i] != referenceBytes[i];
+      checked += bytes.size();
+    }
+    std::cout << "colorspace 8 bit round trip "
+              << (roundTrip ? "unchanged" : "CHANGED") << ", " << checked
+              << " floats encoded, " << wrong << " differ from glm"
+              << std::endl;
+  }
+
+  void benchmarkVertexWeld()
+  {
+    // a heightfield written out OBJ style: six corners per quad, every
+    // inner vertex shows up six times
+    const unsigned int grid = 1291;
+    const float spacing = 100.0f / grid;
+    auto gridVertex = [&](unsigned int x, unsigned int z)
+    {
+      float height = std::sin(x * 0.05f) * std::cos(z * 0.07f);
+      glm::vec3 normal = glm::normalize(glm::vec3(
+              -0.05f * std::cos(x * 0.05f) * std::cos(z * 0.07f), spacing,
+              0.07f * std::sin(x * 0.05f) * std::sin(z * 0.07f)));
+      return MeshVertex{glm::vec3(x * spacing, height, z * spacing), normal,
+                        glm::vec2(x, z) / (float)grid};
+    };
+    std::vector<MeshVertex> vertices;
+    vertices.reserve(6 * grid * grid);
+    const unsigned int corners[6][2] = {{0, 0}, {1, 0}, {1, 1},
+                                        {0, 0}, {1, 1}, {0, 1}};
+    for (unsigned int z = 0; z < grid; z++)
+      for (unsigned int x = 0; x < grid; x++)
+        for (const auto &corner : corners)
+          vertices.push_back(gridVertex(x + corner[0], z + corner[1]));
+    // the same mesh after each triangle was transformed on its own: every
+    // corner off by a unit in the last place here and there
+    std::vector<MeshVertex> noisy = vertices;
+    std::mt19937 random(8);
+    for (MeshVertex &vertex : noisy)
+    {
+      float* values = &vertex.position.x;
+      for (int i = 0; i < 8; i++)
+        if (random() % 4 == 0)
+          values[i] = std::nextafter(values[i], random() % 2 ? 1e30f : -1e30f);
+    }
+
+    JobSystem jobs;
+    struct Run
+    {
+      const char* name;
+      const std::vector<MeshVertex>* input;
+      bool flatTable;
+      float epsilon;
+      bool threads;
+    };
+    const Run runs[] = {
+            {"exact, unordered_map", &vertices, false, 0.0f, false},
+            {"exact, flat 1 thread", &vertices, true, 0.0f, false},
+            {"exact, flat all threads", &vertices, true, 0.0f, true},
+            {"noisy exact, flat all threads", &noisy, true, 0.0f, true},
+            {"noisy epsilon 1e-3, unordered_map", &noisy, false, 1e-3f,
+             false},
+            {"noisy epsilon 1e-3, flat all threads", &noisy, true, 1e-3f,
+             true}};
+    std::vector<MeshVertex> unique, referenceUnique;
+    std::vector<unsigned int> indices, referenceIndices;
+    for (const Run &run : runs)
+    {
+      VertexWelder welder;
+      welder.flatTable = run.flatTable;
+      welder.epsilon = run.epsilon;
+      welder.weld(*run.input, unique, indices,
+                  run.threads ? &jobs : nullptr);
+      double ms = welder.milliseconds();
+      std::cout << "vertexweld " << run.input->size() << " " << run.name
+                << ": " << ms << " ms, "
+                << run.input->size() / (ms / 1000.0) / 1.0e6
+                << " M vertices/s, " << unique.size() << " unique";
+      if (!run.flatTable)
+      {
+        referenceUnique = unique;
+        referenceIndices = indices;
+      }
+      else if (run.epsilon == 0.0f && run.input != &vertices)
+        std::cout << " (the noise splits them)";
+      else
+      {
+        bool same = indices == referenceIndices &&
+                    unique.size() == referenceUnique.size() &&
+                    std::memcmp(unique.data(), referenceUnique.data(),
+                                unique.size() * sizeof(MeshVertex)) == 0;
+        std::cout << ", " << (same ? "same as" : "DIFFERENT from")
+                  << " unordered_map";
+      }
+      std::cout << std::endl;
+    }
+    std::cout << "vertexweld threads " << jobs.getThreadCount() << ", "
+              << (grid + 1) * (grid + 1) << " vertices in the grid"
+              << std::endl;
+  }
+
+  void benchmarkTangentFrames()
+  {
+    // a torus of 1024 x 512 quads, the seams duplicated like an importer
+    // writes them so the texture coordinates don't wrap: 1M triangles
+    const unsigned int around = 1024, tube = 512;
+    const float ringRadius = 1.0f, tubeRadius = 0.4f;
+    const float twoPi = 6.28318531f;
+    std::vector<glm::vec3> positions, exactNormals;
+    std::vector<glm::vec2> uvs;
+    for (unsigned int j = 0; j <= tube; j++)
+      for (unsigned int i = 0; i <= around; i++)
+      {
+        float u = twoPi * i / around, v = twoPi * j / tube;
+        glm::vec3 normal(std::cos(v) * std::cos(u), std::sin(v),
+                         std::cos(v) * std::sin(u));
+        exactNormals.push_back(normal);
+        positions.push_back(ringRadius * glm::vec3(std::cos(u), 0.0f,
+                                                   std::sin(u)) +
+                            tubeRadius * normal);
+        uvs.push_back(glm::vec2((float)i / around, (float)j / tube));
+      }
+    std::vector<unsigned int> indices;
+    for (unsigned int j = 0; j < tube; j++)
+      for (unsigned int i = 0; i < around; i++)
+      {
+        unsigned int a = j * (around + 1) + i, b = a + 1;
+        unsigned int c = a + around + 1, d = c + 1;
+        unsigned int quad[6] = {a, c, d, a, d, b};
+        indices.insert(indices.end(), quad, quad + 6);
+      }
+
+    // the angle between two packed vectors in degrees, and whether their
+    // w (the tangent's side) agree
+    auto degrees = [](uint32_t a, uint32_t b)
+    {
+      glm::vec3 x = glm::normalize(glm::vec3(glm::unpackSnorm3x10_1x2(a)));
+      glm::vec3 y = glm::normalize(glm::vec3(glm::unpackSnorm3x10_1x2(b)));
+      return glm::degrees(std::acos(glm::clamp(glm::dot(x, y), -1.0f, 1.0f)));
+    };
+
+    JobSystem jobs;
+    const TangentFrameGenerator::Weighting weightings[] = {
+            TangentFrameGenerator::AREA, TangentFrameGenerator::ANGLE};
+    for (TangentFrameGenerator::Weighting weighting : weightings)
+    {
+      const char* name = weighting == TangentFrameGenerator::AREA ? "area"
+                                                                  : "angle";
+      std::vector<uint32_t> referenceNormals, referenceTangents;
+      std::vector<uint32_t> singleNormals, singleTangents;
+      std::vector<uint32_t> normals, tangents;
+      struct Run
+      {
+        const char* name;
+        bool simd;
+        bool threads;
+        std::vector<uint32_t>* normals;
+        std::vector<uint32_t>* tangents;
+      };
+      const Run runs[] = {
+              {"scalar", false, false, &referenceNormals,
+               &referenceTangents},
+              {"simd 1 thread", true, false, &singleNormals, &singleTangents},
+              {"simd all threads", true, true, &normals, &tangents}};
+      for (const Run &run : runs)
+      {
+        TangentFrameGenerator generator;
+        generator.weighting = weighting;
+        generator.simd = run.simd;
+        // the first call allocates
+        generator.generate(positions, uvs, indices, *run.normals,
+                           *run.tangents, run.threads ? &jobs : nullptr);
+        double ms = 0.0;
+        const int repeats = 5;
+        for (int i = 0; i < repeats; i++)
+        {
+          generator.generate(positions, uvs, indices, *run.normals,
+                             *run.tangents, run.threads ? &jobs : nullptr);
+          ms += generator.milliseconds() / repeats;
+        }
+        std::cout << "tangentframes " << name << " " << run.name << ": "
+                  << indices.size() / 3 << " triangles " << ms << " ms, "
+                  << indices.size() / 3 / (ms / 1000.0) / 1.0e6
+                  << " M triangles/s" << std::endl;
+      }
+
+      float normalError = 0.0f, tangentError = 0.0f, exactError = 0.0f;
+      size_t sides = 0;
+      for (size_t v = 0; v < positions.size(); v++)
+      {
+        normalError = std::max(normalError,
+                               degrees(normals[v], referenceNormals[v]));
+        tangentError = std::max(tangentError,
+                                degrees(tangents[v], referenceTangents[v]));
+        exactError = std::max(exactError,
+                              degrees(normals[v], glm::packSnorm3x10_1x2(
+                                      glm::vec4(exactNormals[v], 0.0f))));
+        sides += (tangents[v] >> 30) != (referenceTangents[v] >> 30);
+      }
+      bool deterministic = normals == singleNormals &&
+                           tangents == singleTangents;
+      std::cout << "tangentframes " << name << " simd vs scalar: normals "
+                << normalError << " degrees, tangents " << tangentError
+                << " degrees, " << sides << " sides differ; "
+                << exactError << " degrees from the exact torus normal; "
+                << (deterministic ? "same" : "DIFFERENT")
+                << " for 1 and all threads" << std::endl;
+    }
+    std::cout << "tangentframes threads " << jobs.getThreadCount() << ", "
+              << positions.size() << " vertices" << std::endl;
+  }
+
+  void benchmarkMeshLod()
+  {
+    OffscreenTarget target(BENCH_WIDTH, BENCH_HEIGHT);
+    std::mt19937 random(12);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // a fluted vase, 80k triangles: a smooth belly with fine ridges
+    std::vector<glm::vec2> profile;
+    for (int ring = 0; ring < 160; ring++)
+    {
+      float t = ring / 159.0f;
+      profile.push_back(glm::vec2(
+              0.5f + 0.35f * std::sin(3.1415927f * 1.4f * t) +
+              0.02f * std::sin(60.0f * t), 3.0f * t));
+    }
+    std::vector<float> positions;
+    std::vector<unsigned int> indices;
+    appendLathe(positions, indices, profile, 256);
+    LodMesh vase(positions, indices);
+    std::cout << "meshlod vase levels, built in " << vase.buildMilliseconds()
+              << " ms:";
+    for (unsigned int l = 0; l < vase.levelCount(); l++)
+      std::cout << " " << vase.level(l).indexCount / 3 << " triangles (error "
+                << vase.level(l).error << ")";
+    std::cout << std::endl;
+
+    // a 10 x 10 field of vases
+    std::vector<RenderObject> objects;
+    for (int z = 0; z < 10; z++)
+      for (int x = 0; x < 10; x++)
+      {
+        glm::vec3 position((x - 4.5f) * 4.0f, 0.0f, (z - 4.5f) * 4.0f);
+        RenderObject object;
+        object.VAO = vase.level(0).VAO;
+        object.indexCount = vase.level(0).indexCount;
+        object.model = glm::translate(glm::mat4(1.0f), position) *
+                       glm::rotate(glm::mat4(1.0f), 6.2831853f * unit(random),
+                                   glm::vec3(0.0f, 1.0f, 0.0f)) *
+                       glm::scale(glm::mat4(1.0f),
+                                  glm::vec3(0.8f + 0.4f * unit(random)));
+        object.bounds = transformAABB(vase.bounds(), object.model);
+        objects.push_back(object);
+      }
+    std::vector<PointLight> lights(1);
+    lights[0].position = glm::vec3(-300.0f, 800.0f, -400.0f);
+    lights[0].color = glm::vec3(1.0f);
+    lights[0].radius = 5000.0f;
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f),
+                                            (float)BENCH_WIDTH / BENCH_HEIGHT,
+                                            0.5f, 2000.0f);
+    auto viewFrom = [](float distance)
+    {
+      return glm::lookAt(glm::vec3(0.0f, 0.4f * distance, -distance),
+                         glm::vec3(0.0f, 1.5f, 0.0f),
+                         glm::vec3(0.0f, 1.0f, 0.0f));
+    };
+
+    // the camera backs away from the field; full meshes against the
+    // levels at 1 pixel of error
+    OpaqueRenderer renderer;
+    renderer.depthPrepass = false;
+    renderer.lights = lights;
+    LodSelector selector;
+    selector.add(&vase);
+    const float distances[] = {10.0f, 25.0f, 50.0f, 100.0f, 200.0f, 400.0f};
+    for (float distance : distances)
+    {
+      glm::mat4 view = viewFrom(distance);
+      for (int useLod = 0; useLod <= 1; useLod++)
+      {
+        const int frames = 3;
+        double total = 0.0;
+        size_t triangles = 0;
+        for (int frame = 0; frame <= frames; frame++)
+        {
+          glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+          glFinish();
+          double start = now();
+          if (useLod)
+          {
+            selector.prepare(objects, view, projection, BENCH_HEIGHT);
+            renderer.render(selector.lodObjects(), view, projection);
+            triangles = selector.triangleCount();
+          }
+          else
+          {
+            renderer.render(objects, view, projection);
+            Frustum frustum(projection * view);
+            triangles = 0;
+            for (const RenderObject &object : objects)
+              if (frustum.intersects(object.bounds))
+                triangles += object.indexCount / 3;
+          }
+          glFinish();
+          // the first frame warms up
+          if (frame > 0)
+            total += now() - start;
+        }
+        double ms = total / frames;
+        std::cout << "meshlod distance " << distance << ", "
+                  << (useLod ? "lod: " : "full: ") << ms << " ms, "
+                  << triangles << " triangles, "
+                  << triangles / (ms / 1000.0) / 1.0e6 << " M triangles/s";
+        if (useLod)
+        {
+          std::cout << ", objects per level";
+          for (unsigned int count : selector.levelHistogram())
+            std::cout << " " << count;
+        }
+        std::cout << std::endl;
+      }
+    }
+
+    // a camera slowly backing away from 50 to 400 with a little shake:
+    // near the distances where levels meet, every change of level is a
+    // visible pop
+    const float hysteresisValues[] = {0.0f, 0.25f};
+    for (float hysteresis : hysteresisValues)
+    {
+      LodSelector drifting;
+      drifting.add(&vase);
+      drifting.hysteresis = hysteresis;
+      unsigned int changes = 0;
+      const int steps = 400;
+      for (int step = 0; step < steps; step++)
+      {
+        float distance = 50.0f * std::pow(8.0f, (float)step / steps) *
+                         (1.0f + 0.03f * std::sin(step * 1.7f));
+        drifting.prepare(objects, viewFrom(distance), projection,
+                         BENCH_HEIGHT);
+        changes += drifting.levelChanges();
+      }
+      std::cout << "meshlod hysteresis " << hysteresis << ": " << changes
+                << " level changes for " << objects.size()
+                << " objects over " << steps
+                << " frames backing away with 3% shake" << std::endl;
+    }
+  }
+
+  struct Benchmark
+  {
+    const char* name;
+    bool needsGL;
+    void (*run)();
+  };
+
+  const Benchmark benchmarks[] = {
+          {"shadows", true, benchmarkShadows},
+          {"gpuparticles", true, benchmarkGpuParticles},
+          {"cpuparticles", false, benchmarkCpuParticles},
+          {"terrain", true, benchmarkTerrain},
+          {"hud", true, benchmarkHud},
+          {"rendergraph", true, benchmarkRenderGraph},
+          {"sprites", true, benchmarkSprites},
+          {"multiview", true, benchmarkMultiView},
+          {"gpuculling", true, benchmarkGpuCulling},
+          {"depthprepass", true, benchmarkDepthPrepass},
+          {"dynres", true, benchmarkDynamicResolution},
+          {"temporal", true, benchmarkTemporalUpscale},
+          {"impostors", true, benchmarkImpostors},
+          {"staticbatch", true, benchmarkStaticBatching},
+          {"dynamicbatch", true, benchmarkDynamicBatching},
+          {"instances", true, benchmarkPackedInstances},
+          {"visbuffer", true, benchmarkVisibilityBuffer},
+          {"animation", true, benchmarkSkeletalAnimation},
+          {"curves", false, benchmarkCurves},
+          {"tweens", false, benchmarkTweens},
+          {"broadphase", false, benchmarkBroadphase},
+          {"colorspace", false, benchmarkColorSpace},
+          {"vertexweld", false, benchmarkVertexWeld},
+          {"tangentframes", false, benchmarkTangentFrames},
+          {"meshlod", true, benchmarkMeshLod},
+  };
+}
+
+int main(int argc, char** argv)
+{
+  glfwInit();
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+  glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+  bool haveGL = false;
+  GLFWwindow* window = glfwCreateWindow(64, 64, "bench", NULL, NULL);
+  if (window != NULL)
+  {
+    glfwMakeContextCurrent(window);
+    haveGL = gladLoadGLLoader((GLADloadproc)glfwGetProcAddress) != 0;
+  }
+  if (!haveGL)
+    std::cout << "no GL 3.3 context, skipping GPU benchmarks" << std::endl;
+  else
+    std::cout << "renderer: " << glGetString(GL_RENDERER) << std::endl;
+
+  for (const Benchmark &benchmark : benchmarks)
+  {
+    bool selected = argc < 2;
+    for (int i = 1; i < argc; i++)
+      selected = selected || std::strcmp(argv[i], benchmark.name) == 0;
+    if (!selected || (benchmark.needsGL && !haveGL))
+      continue;
+    benchmark.run();
+  }
+
+  glfwTerminate();
+  return 0;
+}
@@ -0,0 +1,413 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include "broadphase.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+  // objects per chunk of pair output, fixed so the joined list doesn't
+  // depend on the thread count
+  const unsigned int PAIR_CHUNK = 1024;
+
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+
+  bool overlaps(const AABB &a, const AABB &b)
+  {
+    return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+           a.min.y <= b.max.y && a.max.y >= b.min.y &&
+           a.min.z <= b.max.z && a.max.z >= b.min.z;
+  }
+
+  // pairsOf(begin, end, out) appends the pairs of the objects [begin, end);
+  // chunks of objects run in parallel and are joined in order
+  template <typename PairsOf>
+  void collectPairs(size_t count, JobSystem* jobs,
+                    std::vector<std::vector<ObjectPair> > &chunkPairs,
+                    std::vector<ObjectPair> &pairs, PairsOf pairsOf)
+  {
+    size_t chunks = (count + PAIR_CHUNK - 1) / PAIR_CHUNK;
+    chunkPairs.resize(chunks);
+    parallelFor(jobs, chunks, 1, [&](size_t begin, size_t end)
+    {
+      for (size_t chunk = begin; chunk < end; chunk++)
+      {
+        std::vector<ObjectPair> &out = chunkPairs[chunk];
+        out.clear();
+        pairsOf((unsigned int)(chunk * PAIR_CHUNK),
+                (unsigned int)std::min(count, (chunk + 1) * PAIR_CHUNK), out);
+      }
+    });
+    size_t total = 0;
+    for (size_t chunk = 0; chunk < chunks; chunk++)
+      total += chunkPairs[chunk].size();
+    pairs.clear();
+    pairs.reserve(total);
+    for (size_t chunk = 0; chunk < chunks; chunk++)
+      pairs.insert(pairs.end(), chunkPairs[chunk].begin(),
+                   chunkPairs[chunk].end());
+  }
+}
+
+SpatialHashGrid::SpatialHashGrid(float cellSize)
+  : cellSize(cellSize), boxes(nullptr), maxHalfExtent(0.0f), mask(0),
+    countsSize(0), buildTime(0.0), pairTime(0.0)
+{
+}
+
+unsigned int SpatialHashGrid::key(int x, int y, int z) const
+{
+  return ((unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u ^
+          (unsigned int)z * 83492791u) & mask;
+}
+
+glm::ivec3 SpatialHashGrid::cell(const glm::vec3 &point) const
+{
+  return glm::ivec3(glm::floor(point / cellSize));
+}
+
+void SpatialHashGrid::build(const std::vector<AABB> &boxes, JobSystem* jobs)
+{
+  double start = now();
+  this->boxes = &boxes;
+  size_t count = boxes.size();
+  maxHalfExtent = glm::vec3(0.0f);
+  for (const AABB &box : boxes)
+    maxHalfExtent = glm::max(maxHalfExtent, box.extent());
+
+  // a power of two at least as large as the object count
+  unsigned int size = 1;
+  while (size < count)
+    size *= 2;
+  mask = size - 1;
+  if (countsSize < size)
+  {
+    counts.reset(new std::atomic<unsigned int>[size]);
+    countsSize = size;
+  }
+  keys.resize(count);
+  sorted.resize(count);
+  sortedBoxes.resize(count);
+  cellStart.resize(size + 1);
+
+  parallelFor(jobs, size, 16384, [this](size_t begin, size_t end)
+  {
+    for (size_t k = begin; k < end; k++)
+      counts[k].store(0, std::memory_order_relaxed);
+  });
+  parallelFor(jobs, count, 4096, [this, &boxes](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; i++)
+    {
+      glm::ivec3 c = cell(boxes[i].center());
+      keys[i] = key(c.x, c.y, c.z);
+      counts[keys[i]].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+  // the counts turn into the insertion cursor of every range
+  unsigned int offset = 0;
+  for (unsigned int k = 0; k < size; k++)
+  {
+    cellStart[k] = offset;
+    offset += counts[k].load(std::memory_order_relaxed);
+    counts[k].store(cellStart[k], std::memory_order_relaxed);
+  }
+  cellStart[size] = offset;
+  parallelFor(jobs, count, 4096, [this](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; i++)
+      sorted[counts[keys[i]].fetch_add(1, std::memory_order_relaxed)] =
+              (unsigned int)i;
+  });
+  // the atomics handed out the slots in any order, the ranges are tiny
+  parallelFor(jobs, size, 16384, [this, &boxes](size_t begin, size_t end)
+  {
+    for (size_t k = begin; k < end; k++)
+    {
+      if (cellStart[k + 1] - cellStart[k] > 1)
+        std::sort(sorted.begin() + cellStart[k],
+                  sorted.begin() + cellStart[k + 1]);
+      for (unsigned int s = cellStart[k]; s < cellStart[k + 1]; s++)
+        sortedBoxes[s] = boxes[sorted[s]];
+    }
+  });
+  buildTime = now() - start;
+}
+
+template <typename Visit>
+void SpatialHashGrid::visitCells(const AABB &box,
+                                 std::vector<unsigned int> &visited,
+                                 Visit visit) const
+{
+  glm::ivec3 low = cell(box.min - maxHalfExtent);
+  glm::ivec3 high = cell(box.max + maxHalfExtent);
+  visited.clear();
+  for (int z = low.z; z <= high.z; z++)
+    for (int y = low.y; y <= high.y; y++)
+      for (int x = low.x; x <= high.x; x++)
+      {
+        unsigned int k = key(x, y, z);
+        if (std::find(visited.begin(), visited.end(), k) != visited.end())
+          continue;
+        visited.push_back(k);
+        for (unsigned int s = cellStart[k]; s < cellStart[k + 1]; s++)
+          visit(sorted[s], sortedBoxes[s]);
+      }
+}
+
+void SpatialHashGrid::query(const AABB &box,
+                            std::vector<unsigned int> &results) const
+{
+  results.clear();
+  if (boxes == nullptr)
+    return;
+  std::vector<unsigned int> visited;
+  visitCells(box, visited,
+             [&box, &results](unsigned int object, const AABB &other)
+             {
+               if (overlaps(box, other))
+                 results.push_back(object);
+             });
+}
+
+void SpatialHashGrid::findPairs(std::vector<ObjectPair> &pairs,
+                                JobSystem* jobs)
+{
+  double start = now();
+  if (boxes == nullptr)
+  {
+    pairs.clear();
+    return;
+  }
+  // objects in the order of the cells, the next object is often in the
+  // same cell and meets the same neighbours still in the cache
+  collectPairs(sorted.size(), jobs, chunkPairs, pairs,
+               [this](unsigned int begin, unsigned int end,
+                      std::vector<ObjectPair> &out)
+               {
+                 std::vector<unsigned int> visited;
+                 for (unsigned int slot = begin; slot < end; slot++)
+                 {
+                   unsigned int a = sorted[slot];
+                   const AABB &box = sortedBoxes[slot];
+                   visitCells(box, visited,
+                              [a, &box, &out](unsigned int b,
+                                              const AABB &other)
+                              {
+                                if (b > a && overlaps(box, other))
+                                  out.push_back(ObjectPair(a, b));
+                              });
+                 }
+               });
+  pairTime = now() - start;
+}
+
+unsigned int SpatialHashGrid::tableSize() const
+{
+  return mask + 1;
+}
+
+double SpatialHashGrid::buildMilliseconds() const
+{
+  return buildTime;
+}
+
+double SpatialHashGrid::pairMilliseconds() const
+{
+  return pairTime;
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy()
+  : boxes(nullptr), buildTime(0.0), refitTime(0.0), pairTime(0.0)
+{
+}
+
+void BoundingVolumeHierarchy::buildNode(unsigned int node, unsigned int begin,
+                                        unsigned int end,
+                                        const std::vector<glm::vec3> &centers)
+{
+  AABB bounds = {glm::vec3(1e30f), glm::vec3(-1e30f)};
+  AABB centerBounds = bounds;
+  for (unsigned int i = begin; i < end; i++)
+  {
+    const AABB &box = (*boxes)[objects[i]];
+    bounds.min = glm::min(bounds.min, box.min);
+    bounds.max = glm::max(bounds.max, box.max);
+    centerBounds.min = glm::min(centerBounds.min, centers[objects[i]]);
+    centerBounds.max = glm::max(centerBounds.max, centers[objects[i]]);
+  }
+  nodes[node].bounds = bounds;
+  if (end - begin <= LEAF_SIZE)
+  {
+    nodes[node].first = begin;
+    nodes[node].count = end - begin;
+    return;
+  }
+
+  // median of the centers along the longest axis
+  glm::vec3 size = centerBounds.max - centerBounds.min;
+  int axis = size.x > size.y ? (size.x > size.z ? 0 : 2)
+                             : (size.y > size.z ? 1 : 2);
+  unsigned int middle = begin + (end - begin) / 2;
+  std::nth_element(objects.begin() + begin, objects.begin() + middle,
+                   objects.begin() + end,
+                   [&centers, axis](unsigned int a, unsigned int b)
+                   {
+                     return centers[a][axis] < centers[b][axis];
+                   });
+  unsigned int children = (unsigned int)nodes.size();
+  nodes[node].first = children;
+  nodes[node].count = 0;
+  nodes.resize(nodes.size() + 2);
+  buildNode(children, begin, middle, centers);
+  buildNode(children + 1, middle, end, centers);
+}
+
+void BoundingVolumeHierarchy::build(const std::vector<AABB> &boxes)
+{
+  double start = now();
+  this->boxes = &boxes;
+  std::vector<glm::vec3> centers(boxes.size());
+  objects.resize(boxes.size());
+  for (size_t i = 0; i < boxes.size(); i++)
+  {
+    centers[i] = boxes[i].center();
+    objects[i] = (unsigned int)i;
+  }
+  nodes.clear();
+  nodes.reserve(2 * boxes.size() / LEAF_SIZE + 1);
+  nodes.resize(1);
+  buildNode(0, 0, (unsigned int)boxes.size(), centers);
+  leafBoxes.resize(boxes.size());
+  for (size_t i = 0; i < boxes.size(); i++)
+    leafBoxes[i] = boxes[objects[i]];
+  buildTime = now() - start;
+}
+
+void BoundingVolumeHierarchy::refit(const std::vector<AABB> &boxes)
+{
+  double start = now();
+  if (boxes.size() != objects.size())
+  {
+    build(boxes);
+    return;
+  }
+  this->boxes = &boxes;
+  for (size_t i = 0; i < boxes.size(); i++)
+    leafBoxes[i] = boxes[objects[i]];
+  // children come after their parents, backwards every child is done
+  // before its parent
+  for (size_t n = nodes.size(); n-- > 0;)
+  {
+    Node &node = nodes[n];
+    AABB bounds = {glm::vec3(1e30f), glm::vec3(-1e30f)};
+    if (node.count > 0)
+      for (unsigned int i = node.first; i < node.first + node.count; i++)
+      {
+        bounds.min = glm::min(bounds.min, leafBoxes[i].min);
+        bounds.max = glm::max(bounds.max, leafBoxes[i].max);
+      }
+    else
+      for (unsigned int c = node.first; c < node.first + 2; c++)
+      {
+        bounds.min = glm::min(bounds.min, nodes[c].bounds.min);
+        bounds.max = glm::max(bounds.max, nodes[c].bounds.max);
+      }
+    node.bounds = bounds;
+  }
+  refitTime = now() - start;
+}
+
+template <typename Visit>
+void BoundingVolumeHierarchy::visitOverlaps(const AABB &box,
+                                            Visit visit) const
+{
+  if (nodes.empty() || objects.empty())
+    return;
+  // median splits keep the depth at log2 of the leaf count
+  unsigned int stack[64];
+  int top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+  {
+    const Node &node = nodes[stack[--top]];
+    if (!overlaps(node.bounds, box))
+      continue;
+    if (node.count > 0)
+    {
+      for (unsigned int i = node.first; i < node.first + node.count; i++)
+        if (overlaps(leafBoxes[i], box))
+          visit(objects[i]);
+    }
+    else
+    {
+      stack[top++] = node.first + 1;
+      stack[top++] = node.first;
+    }
+  }
+}
+
+void BoundingVolumeHierarchy::query(const AABB &box,
+                                    std::vector<unsigned int> &results) const
+{
+  results.clear();
+  visitOverlaps(box, [&results](unsigned int object)
+  {
+    results.push_back(object);
+  });
+}
+
+void BoundingVolumeHierarchy::findPairs(std::vector<ObjectPair> &pairs,
+                                        JobSystem* jobs)
+{
+  double start = now();
+  if (boxes == nullptr)
+  {
+    pairs.clear();
+    return;
+  }
+  // objects in the order of the leaves, like the grid
+  collectPairs(objects.size(), jobs, chunkPairs, pairs,
+               [this](unsigned int begin, unsigned int end,
+                      std::vector<ObjectPair> &out)
+               {
+                 for (unsigned int i = begin; i < end; i++)
+                 {
+                   unsigned int a = objects[i];
+                   visitOverlaps(leafBoxes[i], [a, &out](unsigned int b)
+                   {
+                     if (b > a)
+                       out.push_back(ObjectPair(a, b));
+                   });
+                 }
+               });
+  pairTime = now() - start;
+}
+
+unsigned int BoundingVolumeHierarchy::nodeCount() const
+{
+  return (unsigned int)nodes.size();
+}
+
+double BoundingVolumeHierarchy::buildMilliseconds() const
+{
+  return buildTime;
+}
+
+double BoundingVolumeHierarchy::refitMilliseconds() const
+{
+  return refitTime;
+}
+
+double BoundingVolumeHierarchy::pairMilliseconds() const
+{
+  return pairTime;
+}
@@ -0,0 +1,148 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_BROADPHASE_H
+#define COORDINATESPACE_BROADPHASE_H
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "frustum.h"
+#include "jobsystem.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Broadphase
+ *  Which of N moving objects are close to each other? Testing every pair
+ *  is N^2 / 2 box tests, 20 billion for 200k objects. A broadphase keeps
+ *  the objects in a spatial structure so each one only meets its
+ *  neighbours; the exact test comes afterwards.
+ *
+ *  SpatialHashGrid
+ *   Space is cut into cubes of cellSize, each object is filed under the
+ *   cell its center falls into. Only occupied cells matter, so the cell
+ *   coordinates are hashed into a table about as large as the object
+ *   count. The grid is rebuilt from scratch every frame as a counting sort
+ *   by hash key:
+ *     1. every object computes its key and counts it (atomically, in
+ *        parallel),
+ *     2. a prefix sum over the counts gives every key its range,
+ *     3. every object takes a slot in its range (atomically again), and
+ *        each range is then sorted by object index, which puts the result
+ *        in the same order whatever the threads did.
+ *   A query visits the cells overlapping the query box grown by the
+ *   largest half extent of any object (an object's center can be that far
+ *   outside the box and it still overlaps). Two cells can share a key, a
+ *   key is only visited once per query.
+ *   cellSize should be about twice the size of a typical object: much
+ *   smaller and a query visits many cells, much larger and it meets many
+ *   objects.
+ *
+ *  BoundingVolumeHierarchy
+ *   The other common answer: a binary tree of boxes built once (median
+ *   split on the longest axis) and refit every frame, each node's box
+ *   recomputed from its children bottom up. Refitting is cheap but the
+ *   tree keeps the grouping of the frame it was built in, so as objects
+ *   drift apart the boxes grow and overlap more.
+ *
+ *  findPairs() of both reports every overlapping pair once as (a, b) with
+ *  a < b. The objects are visited in the order the structure keeps them
+ *  (by cell, by leaf), which only depends on the boxes, in fixed chunks
+ *  that collect their pairs separately and are joined in chunk order, so
+ *  the list is the same with any number of threads.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+typedef std::pair<unsigned int, unsigned int> ObjectPair;
+
+class SpatialHashGrid
+{
+public:
+  float cellSize;
+
+  explicit SpatialHashGrid(float cellSize);
+
+  void build(const std::vector<AABB> &boxes, JobSystem* jobs = nullptr);
+  // indices of the objects overlapping box, of the last build()
+  void query(const AABB &box, std::vector<unsigned int> &results) const;
+  void findPairs(std::vector<ObjectPair> &pairs, JobSystem* jobs = nullptr);
+
+  unsigned int tableSize() const;
+  double buildMilliseconds() const;
+  double pairMilliseconds() const;
+
+private:
+  const std::vector<AABB>* boxes;
+  glm::vec3 maxHalfExtent;
+  unsigned int mask;
+  std::vector<unsigned int> keys;
+  // start of every key's range in sorted, one more entry at the end
+  std::vector<unsigned int> cellStart;
+  std::unique_ptr<std::atomic<unsigned int>[]> counts;
+  unsigned int countsSize;
+  std::vector<unsigned int> sorted;
+  // the boxes in the order of sorted, a cell's boxes are side by side
+  std::vector<AABB> sortedBoxes;
+  std::vector<std::vector<ObjectPair> > chunkPairs;
+  double buildTime;
+  double pairTime;
+
+  unsigned int key(int x, int y, int z) const;
+  glm::ivec3 cell(const glm::vec3 &point) const;
+  // calls visit(object, box) for every object filed in a cell overlapping
+  // box
+  template <typename Visit>
+  void visitCells(const AABB &box, std::vector<unsigned int> &visited,
+                  Visit visit) const;
+};
+
+class BoundingVolumeHierarchy
+{
+public:
+  // objects per leaf
+  static const unsigned int LEAF_SIZE = 4;
+
+  BoundingVolumeHierarchy();
+
+  void build(const std::vector<AABB> &boxes);
+  // the same objects, moved; keeps the tree and recomputes its boxes
+  void refit(const std::vector<AABB> &boxes);
+  void query(const AABB &box, std::vector<unsigned int> &results) const;
+  void findPairs(std::vector<ObjectPair> &pairs, JobSystem* jobs = nullptr);
+
+  unsigned int nodeCount() const;
+  double buildMilliseconds() const;
+  double refitMilliseconds() const;
+  double pairMilliseconds() const;
+
+private:
+  // leaves have count > 0 and their objects at first in objects, inner
+  // nodes have count 0 and their children at first and first + 1. Children
+  // always come after their parent.
+  struct Node
+  {
+    AABB bounds;
+    unsigned int first;
+    unsigned int count;
+  };
+
+  const std::vector<AABB>* boxes;
+  std::vector<Node> nodes;
+  std::vector<unsigned int> objects;
+  // the boxes in the order of objects, a leaf's boxes are side by side
+  std::vector<AABB> leafBoxes;
+  std::vector<std::vector<ObjectPair> > chunkPairs;
+  double buildTime;
+  double refitTime;
+  double pairTime;
+
+  void buildNode(unsigned int node, unsigned int begin, unsigned int end,
+                 const std::vector<glm::vec3> &centers);
+  template <typename Visit>
+  void visitOverlaps(const AABB &box, Visit visit) const;
+};
+#endif //COORDINATESPACE_BROADPHASE_H
@@ -0,0 +1,297 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include "colorspace.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <glm/glm.hpp>
+#include <glm/gtc/color_space.hpp>
+
+namespace
+{
+  float encode(float c)
+  {
+    return glm::convertLinearToSRGB(glm::vec1(c)).x;
+  }
+
+  float decode(float c)
+  {
+    return glm::convertSRGBToLinear(glm::vec1(c)).x;
+  }
+
+  unsigned char toUnorm8(float c)
+  {
+    return (unsigned char)std::lrint(glm::clamp(c, 0.0f, 1.0f) * 255.0f);
+  }
+
+  // glm's formulas with the pow as exp2(log2); the lanes of the straight
+  // segment compute a pow of garbage that select() throws away
+  float8 encodeLanes(float8 c)
+  {
+    c = min(max(c, float8(0.0f)), float8(1.0f));
+    float8 curve = fmadd(exp2(log2(c) * float8(0.41666f)), float8(1.055f),
+                         float8(-0.055f));
+    return select(c < float8(0.0031308f), c * float8(12.92f), curve);
+  }
+
+  float8 decodeLanes(float8 s)
+  {
+    float8 curve = exp2(log2((s + float8(0.055f)) *
+                             float8(0.947867298578f)) * float8(2.4f));
+    return select(s <= float8(0.04045f), s * float8(0.0773993808f), curve);
+  }
+}
+
+ColorConverter::ColorConverter()
+  : simd(true)
+{
+  for (int i = 0; i < 256; i++)
+    toLinear[i] = decode(i / 255.0f);
+
+  // binary search over the bit patterns of [0, 1], positive floats sort
+  // like their bits
+  codeStart[0] = -1.0f;
+  for (int code = 1; code < 256; code++)
+  {
+    uint32_t low = 0, high = 0x3f800000u;
+    while (low < high)
+    {
+      uint32_t middle = low + (high - low) / 2;
+      float value;
+      std::memcpy(&value, &middle, sizeof(value));
+      if (toUnorm8(encode(value)) >= code)
+        high = middle;
+      else
+        low = middle + 1;
+    }
+    std::memcpy(&codeStart[code], &low, sizeof(float));
+  }
+  codeStart[256] = 2.0f;
+}
+
+void ColorConverter::srgbToLinear(const unsigned char* in, float* out,
+                                  size_t pixels) const
+{
+  size_t i = 0;
+  if (simd)
+    for (; i + 8 <= pixels; i += 8)
+    {
+      float8 r, g, b, a;
+      loadUnorm8Deinterleaved4(in + i * 4, r, g, b, a);
+      storeInterleaved4(out + i * 4, gather(toLinear, r), gather(toLinear, g),
+                        gather(toLinear, b), a / float8(255.0f));
+    }
+  for (; i < pixels; i++)
+  {
+    glm::vec4 color = glm::convertSRGBToLinear(
+            glm::vec4(in[i * 4], in[i * 4 + 1], in[i * 4 + 2],
+                      in[i * 4 + 3]) / 255.0f);
+    for (int c = 0; c < 4; c++)
+      out[i * 4 + c] = color[c];
+  }
+}
+
+void ColorConverter::linearToSrgb(const float* in, unsigned char* out,
+                                  size_t pixels) const
+{
+  const float8 zero(0.0f), one(1.0f), half(0.5f), byte(255.0f);
+  const float8 edge(0.49f);
+  size_t i = 0;
+  if (simd)
+    for (; i + 8 <= pixels; i += 8)
+    {
+      float8 channels[4];
+      loadDeinterleaved4(in + i * 4, channels[0], channels[1], channels[2],
+                         channels[3]);
+      for (int c = 0; c < 3; c++)
+      {
+        // max() first turns NaN into 0
+        float8 linear = min(max(channels[c], zero), one);
+        float8 scaled = encodeLanes(linear) * byte;
+        float8 code = floor(scaled + half);
+        // the pow is off by far less than 0.01 of a step, only a lane that
+        // close to an edge can be on the wrong side; one step either way
+        if (moveMask(abs(scaled - code) > edge) != 0)
+        {
+          code = min(max(code, zero), byte);
+          code = code + (one & (linear >= gather(codeStart, code + one))) -
+                 (one & (linear < gather(codeStart, code)));
+        }
+        channels[c] = code;
+      }
+      storeUnorm8Interleaved4(out + i * 4, channels[0], channels[1],
+                              channels[2],
+                              min(max(channels[3], zero), one) * byte);
+    }
+  for (; i < pixels; i++)
+  {
+    for (int c = 0; c < 3; c++)
+      out[i * 4 + c] = toUnorm8(encode(in[i * 4 + c]));
+    out[i * 4 + 3] = toUnorm8(in[i * 4 + 3]);
+  }
+}
+
+void ColorConverter::srgbToLinear(float* rgba, size_t pixels) const
+{
+  size_t i = 0;
+  if (simd)
+    for (; i + 8 <= pixels; i += 8)
+    {
+      float8 r, g, b, a;
+      loadDeinterleaved4(rgba + i * 4, r, g, b, a);
+      storeInterleaved4(rgba + i * 4, decodeLanes(r), decodeLanes(g),
+                        decodeLanes(b), a);
+    }
+  for (; i < pixels; i++)
+    for (int c = 0; c < 3; c++)
+      rgba[i * 4 + c] = decode(rgba[i * 4 + c]);
+}
+
+void ColorConverter::linearToSrgb(float* rgba, size_t pixels) const
+{
+  size_t i = 0;
+  if (simd)
+    for (; i + 8 <= pixels; i += 8)
+    {
+      float8 r, g, b, a;
+      loadDeinterleaved4(rgba + i * 4, r, g, b, a);
+      storeInterleaved4(rgba + i * 4, encodeLanes(r), encodeLanes(g),
+                        encodeLanes(b), a);
+    }
+  for (; i < pixels; i++)
+    for (int c = 0; c < 3; c++)
+      rgba[i * 4 + c] = encode(rgba[i * 4 + c]);
+}
+
+void ColorConverter::applyGamma(float* rgba, size_t pixels,
+                                float gamma) const
+{
+  size_t i = 0;
+  if (simd)
+  {
+    const float8 zero(0.0f), exponent(gamma);
+    for (; i + 8 <= pixels; i += 8)
+    {
+      float8 channels[4];
+      loadDeinterleaved4(rgba + i * 4, channels[0], channels[1], channels[2],
+                         channels[3]);
+      for (int c = 0; c < 3; c++)
+        channels[c] = select(channels[c] > zero,
+                             exp2(log2(channels[c]) * exponent), zero);
+      storeInterleaved4(rgba + i * 4, channels[0], channels[1], channels[2],
+                        channels[3]);
+    }
+  }
+  for (; i < pixels; i++)
+    for (int c = 0; c < 3; c++)
+    {
+      float value = rgba[i * 4 + c];
+      rgba[i * 4 + c] = value > 0.0f ? std::pow(value, gamma) : 0.0f;
+    }
+}
+
+void ColorConverter::premultiply(float* rgba, size_t pixels) const
+{
+  size_t i = 0;
+  if (simd)
+    for (; i + 8 <= pixels; i += 8)
+    {
+      float8 r, g, b, a;
+      loadDeinterleaved4(rgba + i * 4, r, g, b, a);
+      storeInterleaved4(rgba + i * 4, r * a, g * a, b * a, a);
+    }
+  for (; i < pixels; i++)
+    for (int c = 0; c < 3; c++)
+      rgba[i * 4 + c] *= rgba[i * 4 + 3];
+}
+
+void ColorConverter::unpremultiply(float* rgba, size_t pixels) const
+{
+  size_t i = 0;
+  if (simd)
+  {
+    const float8 zero(0.0f);
+    for (; i + 8 <= pixels; i += 8)
+    {
+      float8 r, g, b, a;
+      loadDeinterleaved4(rgba + i * 4, r, g, b, a);
+      float8 visible = a > zero;
+      storeInterleaved4(rgba + i * 4, select(visible, r / a, zero),
+                        select(visible, g / a, zero),
+                        select(visible, b / a, zero), a);
+    }
+  }
+  for (; i < pixels; i++)
+  {
+    float a = rgba[i * 4 + 3];
+    for (int c = 0; c < 3; c++)
+      rgba[i * 4 + c] = a > 0.0f ? rgba[i * 4 + c] / a : 0.0f;
+  }
+}
+
+void ColorConverter::premultiply(unsigned char* rgba, size_t pixels) const
+{
+  size_t i = 0;
+  if (simd)
+  {
+    // c * a / 255 is never a half (255 is odd) and at least 1 / 510 away
+    // from one, the few units in the last place the float product is off
+    // can't move it across
+    const float8 inverse(1.0f / 255.0f);
+    for (; i + 8 <= pixels; i += 8)
+    {
+      float8 r, g, b, a;
+      loadUnorm8Deinterleaved4(rgba + i * 4, r, g, b, a);
+      float8 scale = a * inverse;
+      storeUnorm8Interleaved4(rgba + i * 4, r * scale, g * scale, b * scale,
+                              a);
+    }
+  }
+  for (; i < pixels; i++)
+  {
+    unsigned int a = rgba[i * 4 + 3];
+    for (int c = 0; c < 3; c++)
+    {
+      // c * a / 255 rounded to nearest
+      unsigned int t = rgba[i * 4 + c] * a + 128;
+      rgba[i * 4 + c] = (unsigned char)((t + (t >> 8)) >> 8);
+    }
+  }
+}
+
+void ColorConverter::unpremultiply(unsigned char* rgba, size_t pixels) const
+{
+  size_t i = 0;
+  if (simd)
+  {
+    // here halves do happen (1 * 255 / 2), the quotient is exact then and
+    // floor(x + 0.5) rounds it up like the integer formula
+    const float8 zero(0.0f), half(0.5f), byte(255.0f);
+    for (; i + 8 <= pixels; i += 8)
+    {
+      float8 channels[4];
+      loadUnorm8Deinterleaved4(rgba + i * 4, channels[0], channels[1],
+                               channels[2], channels[3]);
+      float8 a = channels[3];
+      float8 visible = a > zero;
+      for (int c = 0; c < 3; c++)
+        channels[c] = select(visible,
+                             floor(min(channels[c] * byte / a, byte) + half),
+                             zero);
+      storeUnorm8Interleaved4(rgba + i * 4, channels[0], channels[1],
+                              channels[2], a);
+    }
+  }
+  for (; i < pixels; i++)
+  {
+    unsigned int a = rgba[i * 4 + 3];
+    for (int c = 0; c < 3; c++)
+      rgba[i * 4 + c] = a == 0 ? 0 : (unsigned char)std::min(
+              255u, (rgba[i * 4 + c] * 510u + a) / (2 * a));
+  }
+}
@@ -0,0 +1,79 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_COLORSPACE_H
+#define COORDINATESPACE_COLORSPACE_H
+
+#include <cstddef>
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Color space conversion
+ *  Blending, filtering and averaging are only right on linear light, but
+ *  images are stored sRGB encoded. Generating mip levels or thumbnails on
+ *  the CPU, or converting a readback, means decoding every pixel to linear,
+ *  working on it and encoding it again. glm::convertSRGBToLinear and
+ *  convertLinearToSRGB (glm/gtc/color_space.hpp) do that with a pow per
+ *  component, which is most of the time spent.
+ *
+ *  The ColorConverter works on spans of RGBA pixels, sRGB applies to rgb,
+ *  alpha is always linear:
+ *
+ *   - 8 bit sRGB to linear: there are only 256 inputs, a table holds
+ *     glm's result for each, so it is exactly glm's value.
+ *   - linear to 8 bit sRGB: a float8 pow (exp2 and log2 polynomials from
+ *     simd.h) gets within a fraction of a step of the right code. A second
+ *     table holds, for every code, the smallest linear value glm rounds to
+ *     it; where a lane lands close to a rounding edge, comparing against
+ *     the two neighbouring entries puts it on the right side. The result is
+ *     the code glm::convertLinearToSRGB(c) * 255 rounds to, for every
+ *     input, and decoding and encoding 8 bit pixels gives them back
+ *     unchanged.
+ *   - float to float sRGB, in place: the same pow, within a few units in
+ *     the last place of glm (which has an error of its own: it encodes
+ *     with an exponent of 0.41666, not 1 / 2.4).
+ *   - premultiplied alpha: rgb * alpha and back. On 8 bit pixels the
+ *     float8 math rounds exactly like the integer formulas (c * a / 255
+ *     to nearest, the other way c * 255 / a), alpha 0 unpremultiplies to
+ *     black.
+ *   - gamma: rgb to any power, exp2(gamma * log2(c)).
+ *
+ *  Eight pixels go through at once: loaded, split into r, g, b and a
+ *  float8 lanes, converted and interleaved again on the way out. A span
+ *  that isn't a multiple of 8 finishes on the scalar path, which is the
+ *  glm functions pixel by pixel (what simd off runs for everything).
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class ColorConverter
+{
+public:
+  bool simd;
+
+  ColorConverter();
+
+  // 8 bit sRGB RGBA to linear float RGBA (alpha / 255)
+  void srgbToLinear(const unsigned char* in, float* out,
+                    size_t pixels) const;
+  // linear float RGBA to 8 bit sRGB RGBA (alpha * 255)
+  void linearToSrgb(const float* in, unsigned char* out,
+                    size_t pixels) const;
+  // float RGBA in place
+  void srgbToLinear(float* rgba, size_t pixels) const;
+  void linearToSrgb(float* rgba, size_t pixels) const;
+  // rgb to the power of gamma, rgb below 0 becomes 0
+  void applyGamma(float* rgba, size_t pixels, float gamma) const;
+
+  void premultiply(float* rgba, size_t pixels) const;
+  void unpremultiply(float* rgba, size_t pixels) const;
+  void premultiply(unsigned char* rgba, size_t pixels) const;
+  void unpremultiply(unsigned char* rgba, size_t pixels) const;
+
+private:
+  float toLinear[256];
+  // the smallest linear value encoded as code c or above; 0 has no lower
+  // edge and 256 lies past 1
+  float codeStart[257];
+};
+#endif //COORDINATESPACE_COLORSPACE_H
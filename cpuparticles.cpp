@@ -0,0 +1,301 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "cpuparticles.h"
+#include "simd.h"
+
+#include <algorithm>
+
+namespace
+{
+  // particles per job, a multiple of 8 so only the last chunk has a tail
+  const size_t CHUNK_SIZE = 16384;
+}
+
+CpuParticlePool::CpuParticlePool(unsigned int capacity)
+  : gravity(0.0f, -9.81f, 0.0f), drag(0.1f), groundHeight(0.0f),
+    restitution(0.5f), count(0), capacity((capacity + 7) & ~7u)
+{
+  float** arrays[] = {&positionX, &positionY, &positionZ, &velocityX,
+                      &velocityY, &velocityZ, &age, &lifetime};
+  for (float** array : arrays)
+  {
+    *array = (float*)alignedAlloc(this->capacity * sizeof(float));
+    std::fill(*array, *array + this->capacity, 0.0f);
+  }
+}
+
+CpuParticlePool::~CpuParticlePool()
+{
+  float* arrays[] = {positionX, positionY, positionZ, velocityX, velocityY,
+                     velocityZ, age, lifetime};
+  for (float* array : arrays)
+    alignedFree(array);
+}
+
+bool CpuParticlePool::spawn(const glm::vec3 &position,
+                            const glm::vec3 &velocity, float lifetime)
+{
+  if (count == capacity)
+    return false;
+  positionX[count] = position.x;
+  positionY[count] = position.y;
+  positionZ[count] = position.z;
+  velocityX[count] = velocity.x;
+  velocityY[count] = velocity.y;
+  velocityZ[count] = velocity.z;
+  age[count] = 0.0f;
+  this->lifetime[count] = lifetime;
+  count++;
+  return true;
+}
+
+unsigned int CpuParticlePool::update(JobSystem &jobs, float deltaTime,
+                                     float* instances)
+{
+  unsigned int updated = count;
+  size_t chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  if (deadPerChunk.size() < chunks)
+    deadPerChunk.resize(chunks);
+
+  jobs.parallelFor(count, CHUNK_SIZE, [&](size_t begin, size_t end)
+  {
+    std::vector<unsigned int> &dead = deadPerChunk[begin / CHUNK_SIZE];
+    dead.clear();
+    updateRange(begin, end, deltaTime, instances, dead);
+  });
+
+  removeDead();
+  return updated;
+}
+
+void CpuParticlePool::updateRange(size_t begin, size_t end, float deltaTime,
+                                  float* instances,
+                                  std::vector<unsigned int> &dead)
+{
+  const float8 dt(deltaTime);
+  const float8 damping(std::max(1.0f - drag * deltaTime, 0.0f));
+  const float8 gravityX(gravity.x * deltaTime);
+  const float8 gravityY(gravity.y * deltaTime);
+  const float8 gravityZ(gravity.z * deltaTime);
+  const float8 ground(groundHeight);
+  const float8 bounce(-restitution);
+  const float8 zero(0.0f);
+  const float8 one(1.0f);
+
+  // the arrays are padded to a multiple of 8, so the last group can run
+  // over end; only its instance output has to be cut short
+  for (size_t i = begin; i < end; i += 8)
+  {
+    float8 vx = (float8::load(velocityX + i) + gravityX) * damping;
+    float8 vy = (float8::load(velocityY + i) + gravityY) * damping;
+    float8 vz = (float8::load(velocityZ + i) + gravityZ) * damping;
+    float8 px = fmadd(vx, dt, float8::load(positionX + i));
+    float8 py = fmadd(vy, dt, float8::load(positionY + i));
+    float8 pz = fmadd(vz, dt, float8::load(positionZ + i));
+
+    // ground plane
+    float8 below = py < ground;
+    py = select(below, ground, py);
+    vy = select(below & (vy < zero), vy * bounce, vy);
+
+    // sphere colliders: push out along the normal and reflect the part of
+    // the velocity going into the sphere
+    for (size_t c = 0; c < colliders.size(); c++)
+    {
+      const glm::vec4 &sphere = colliders[c];
+      float8 dx = px - float8(sphere.x);
+      float8 dy = py - float8(sphere.y);
+      float8 dz = pz - float8(sphere.z);
+      float8 distance2 = dx * dx + dy * dy + dz * dz;
+      float8 inside = distance2 < float8(sphere.w * sphere.w);
+      if (moveMask(inside) == 0)
+        continue;
+      float8 inverse = one / sqrt(max(distance2, float8(1e-12f)));
+      float8 nx = dx * inverse, ny = dy * inverse, nz = dz * inverse;
+      float8 radius(sphere.w);
+      px = select(inside, fmadd(nx, radius, float8(sphere.x)), px);
+      py = select(inside, fmadd(ny, radius, float8(sphere.y)), py);
+      pz = select(inside, fmadd(nz, radius, float8(sphere.z)), pz);
+      float8 into = vx * nx + vy * ny + vz * nz;
+      float8 impulse = select(inside & (into < zero),
+                              into * float8(-(1.0f + restitution)), zero);
+      vx = fmadd(impulse, nx, vx);
+      vy = fmadd(impulse, ny, vy);
+      vz = fmadd(impulse, nz, vz);
+    }
+
+    float8 a = float8::load(age + i) + dt;
+    float8 l = float8::load(lifetime + i);
+    vx.store(velocityX + i);
+    vy.store(velocityY + i);
+    vz.store(velocityZ + i);
+    px.store(positionX + i);
+    py.store(positionY + i);
+    pz.store(positionZ + i);
+    a.store(age + i);
+
+    float8 life = max(one - a / l, zero);
+    size_t lanes = std::min(end - i, (size_t)8);
+    if (instances != NULL)
+    {
+      if (lanes == 8)
+      {
+        storeInterleaved4(instances + i * 4, px, py, pz, life);
+      }
+      else
+      {
+        float tail[32];
+        storeInterleaved4(tail, px, py, pz, life);
+        std::copy(tail, tail + lanes * 4, instances + i * 4);
+      }
+    }
+
+    int died = moveMask(a >= l) & ((1 << lanes) - 1);
+    while (died != 0)
+    {
+      int lane = 0;
+      while (!(died & (1 << lane)))
+        lane++;
+      died &= ~(1 << lane);
+      dead.push_back((unsigned int)(i + lane));
+    }
+  }
+}
+
+void CpuParticlePool::removeDead()
+{
+  float* arrays[] = {positionX, positionY, positionZ, velocityX, velocityY,
+                     velocityZ, age, lifetime};
+  // highest index first: everything above the current hole is then alive,
+  // so the last particle is always a live one (or the hole itself)
+  for (size_t c = deadPerChunk.size(); c-- > 0;)
+  {
+    std::vector<unsigned int> &dead = deadPerChunk[c];
+    for (size_t d = dead.size(); d-- > 0;)
+    {
+      unsigned int hole = dead[d];
+      unsigned int last = --count;
+      for (float* array : arrays)
+        array[hole] = array[last];
+    }
+    dead.clear();
+  }
+}
+
+void CpuParticlePool::queryRadius(const glm::vec3 &center, float radius,
+                                  std::vector<unsigned int> &result) const
+{
+  const float8 cx(center.x), cy(center.y), cz(center.z);
+  const float8 radius2(radius * radius);
+  for (unsigned int i = 0; i < count; i += 8)
+  {
+    float8 dx = float8::load(positionX + i) - cx;
+    float8 dy = float8::load(positionY + i) - cy;
+    float8 dz = float8::load(positionZ + i) - cz;
+    int hits = moveMask(dx * dx + dy * dy + dz * dz <= radius2);
+    for (int lane = 0; hits != 0; lane++, hits >>= 1)
+    {
+      if ((hits & 1) && i + lane < count)
+        result.push_back(i + lane);
+    }
+  }
+}
+
+unsigned int CpuParticlePool::getCount() const
+{
+  return count;
+}
+
+unsigned int CpuParticlePool::getCapacity() const
+{
+  return capacity;
+}
+
+CpuParticleRenderer::CpuParticleRenderer(unsigned int capacity)
+  : particleSize(0.05f), color(0.3f, 0.6f, 1.0f), capacity(capacity),
+    instanceCount(0),
+    shader("shaders/cpuparticlevs.txt", "shaders/particlefs.txt")
+{
+  float corners[] = {
+          -1.0f, -1.0f,
+          1.0f, -1.0f,
+          -1.0f,  1.0f,
+          1.0f,  1.0f
+  };
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &quadVBO);
+  glGenBuffers(1, &instanceVBO);
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+  glEnableVertexAttribArray(0);
+
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)capacity * 4 * sizeof(float),
+               NULL, GL_STREAM_DRAW);
+  glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+  glEnableVertexAttribArray(1);
+  glVertexAttribDivisor(1, 1);
+  glBindVertexArray(0);
+}
+
+CpuParticleRenderer::~CpuParticleRenderer()
+{
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &quadVBO);
+  glDeleteBuffers(1, &instanceVBO);
+  glDeleteProgram(shader.ID);
+}
+
+float* CpuParticleRenderer::map(unsigned int count)
+{
+  instanceCount = std::min(count, capacity);
+  if (instanceCount == 0)
+    return NULL;
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  // invalidating orphans last frame's storage, so the GPU can keep reading
+  // it while we write the new one
+  return (float*)glMapBufferRange(GL_ARRAY_BUFFER, 0,
+                                  (GLsizeiptr)instanceCount * 4 *
+                                  sizeof(float),
+                                  GL_MAP_WRITE_BIT |
+                                  GL_MAP_INVALIDATE_BUFFER_BIT);
+}
+
+void CpuParticleRenderer::unmap()
+{
+  if (instanceCount == 0)
+    return;
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  if (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE)
+  {
+    // the contents got lost (e.g. a display mode change), skip a frame
+    std::cout << "ERROR::CPUPARTICLES::UNMAP_FAILED" << std::endl;
+    instanceCount = 0;
+  }
+}
+
+void CpuParticleRenderer::render(const glm::mat4 &view,
+                                 const glm::mat4 &projection)
+{
+  if (instanceCount == 0)
+    return;
+  shader.use();
+  shader.setMat4("view", view);
+  shader.setMat4("projection", projection);
+  shader.setFloat("particleSize", particleSize);
+  shader.setVec3("color", color);
+
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_ONE, GL_ONE);
+  glDepthMask(GL_FALSE);
+  glBindVertexArray(VAO);
+  glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)instanceCount);
+  glBindVertexArray(0);
+  glDepthMask(GL_TRUE);
+  glDisable(GL_BLEND);
+}
@@ -0,0 +1,122 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_CPUPARTICLES_H
+#define COORDINATESPACE_CPUPARTICLES_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "jobsystem.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * CPU particles
+ *  Particles that gameplay code has to see (collisions, "is anything
+ *  burning near me" queries) can't live on the GPU only. To keep a million
+ *  of them cheap on the CPU the pool is stored as a structure of arrays:
+ *  one array per attribute instead of one struct per particle. Updating
+ *  then streams through memory linearly and eight particles at a time fit
+ *  in one float8 (simd.h), with no locking: the pool is cut into chunks and
+ *  each chunk is integrated by one JobSystem thread.
+ *
+ *  Dead particles are removed with swap-remove: the last particle is moved
+ *  into the hole, so the live particles stay packed in [0, count) without
+ *  shifting the whole array. The order of the particles isn't stable.
+ *
+ *  The update writes the instance data for rendering (xyz position and the
+ *  remaining life fraction) straight into the destination passed in, which
+ *  is meant to be a mapped GL buffer (CpuParticleRenderer::map), so the
+ *  data isn't first gathered into a temporary array and copied again.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class CpuParticlePool
+{
+public:
+  // structure of arrays, capacity rounded up to a multiple of 8 and every
+  // array 32 byte aligned
+  float* positionX;
+  float* positionY;
+  float* positionZ;
+  float* velocityX;
+  float* velocityY;
+  float* velocityZ;
+  float* age;
+  float* lifetime;
+
+  glm::vec3 gravity;
+  float drag;
+  // particles bounce off the plane y = groundHeight
+  float groundHeight;
+  float restitution;
+  // xyz center, w radius; particles are pushed out of these spheres
+  std::vector<glm::vec4> colliders;
+
+  explicit CpuParticlePool(unsigned int capacity);
+  ~CpuParticlePool();
+  CpuParticlePool(const CpuParticlePool &) = delete;
+  CpuParticlePool &operator=(const CpuParticlePool &) = delete;
+
+  // returns false when the pool is full
+  bool spawn(const glm::vec3 &position, const glm::vec3 &velocity,
+             float lifetime);
+  // advance all particles, write an instance of 4 floats per particle to
+  // instances (may be NULL) and remove the particles that died. Particles
+  // that died this frame are written with a life of 0 so they're skipped
+  // when drawing. Returns the number of instances written, the particle
+  // count from before the update.
+  unsigned int update(JobSystem &jobs, float deltaTime, float* instances);
+  // indices of the live particles within radius of center
+  void queryRadius(const glm::vec3 &center, float radius,
+                   std::vector<unsigned int> &result) const;
+
+  unsigned int getCount() const;
+  unsigned int getCapacity() const;
+
+private:
+  unsigned int count;
+  unsigned int capacity;
+  // dead particle indices found by each chunk, ascending within a chunk
+  std::vector<std::vector<unsigned int> > deadPerChunk;
+
+  void updateRange(size_t begin, size_t end, float deltaTime,
+                   float* instances, std::vector<unsigned int> &dead);
+  void removeDead();
+};
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Draws a CpuParticlePool as instanced camera facing quads. The instance
+ * buffer is orphaned and mapped once per frame, the pool update writes into
+ * the mapping directly.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class CpuParticleRenderer
+{
+public:
+  float particleSize;
+  glm::vec3 color;
+
+  explicit CpuParticleRenderer(unsigned int capacity);
+  ~CpuParticleRenderer();
+  CpuParticleRenderer(const CpuParticleRenderer &) = delete;
+  CpuParticleRenderer &operator=(const CpuParticleRenderer &) = delete;
+
+  // write only mapping for count instances of 4 floats
+  float* map(unsigned int count);
+  void unmap();
+  void render(const glm::mat4 &view, const glm::mat4 &projection);
+
+private:
+  unsigned int capacity;
+  unsigned int instanceCount;
+  unsigned int VAO;
+  unsigned int quadVBO;
+  unsigned int instanceVBO;
+  Shader shader;
+};
+#endif //COORDINATESPACE_CPUPARTICLES_H
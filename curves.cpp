@@ -0,0 +1,265 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "curves.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <iostream>
+#include <glm/gtx/spline.hpp>
+
+CurveSet::CurveSet()
+  : simd(true), cacheSegments(true), searches(0)
+{
+}
+
+unsigned int CurveSet::addCurve(const std::vector<float> &times,
+                                const std::vector<glm::vec3> &points)
+{
+  if (times.size() < 2 || times.size() != points.size())
+  {
+    std::cout << "ERROR::CURVES::NEED_TWO_KEYS_WITH_TIMES" << std::endl;
+    return (unsigned int)-1;
+  }
+  for (size_t i = 1; i < times.size(); i++)
+    if (times[i] <= times[i - 1])
+    {
+      std::cout << "ERROR::CURVES::TIMES_NOT_INCREASING" << std::endl;
+      return (unsigned int)-1;
+    }
+  firstKey.push_back((unsigned int)keyTime.size());
+  keyCount.push_back((unsigned int)times.size());
+  lastSegment.push_back(0);
+  for (size_t i = 0; i < times.size(); i++)
+  {
+    keyTime.push_back(times[i]);
+    keyX.push_back(points[i].x);
+    keyY.push_back(points[i].y);
+    keyZ.push_back(points[i].z);
+  }
+  // the tables no longer cover every curve
+  lengths.clear();
+  arcFirst.clear();
+  arcTimes.clear();
+  return curveCount() - 1;
+}
+
+unsigned int CurveSet::curveCount() const
+{
+  return (unsigned int)firstKey.size();
+}
+
+float CurveSet::startTime(unsigned int curve) const
+{
+  return keyTime[firstKey[curve]];
+}
+
+float CurveSet::endTime(unsigned int curve) const
+{
+  return keyTime[firstKey[curve] + keyCount[curve] - 1];
+}
+
+unsigned int CurveSet::findSegment(unsigned int curve, float time)
+{
+  const float* times = &keyTime[firstKey[curve]];
+  unsigned int last = keyCount[curve] - 2;
+  unsigned int segment = lastSegment[curve];
+  if (cacheSegments && time >= times[segment])
+  {
+    // forward from where the curve was last frame
+    while (segment < last && time >= times[segment + 1])
+      segment++;
+  }
+  else
+  {
+    searches++;
+    segment = (unsigned int)(std::upper_bound(times + 1, times + last + 1,
+                                              time) - (times + 1));
+  }
+  lastSegment[curve] = segment;
+  return segment;
+}
+
+void CurveSet::controlPoints(unsigned int curve, unsigned int segment,
+                             unsigned int indices[4]) const
+{
+  // the ends repeat the first and last key
+  unsigned int first = firstKey[curve];
+  unsigned int last = first + keyCount[curve] - 1;
+  unsigned int k = first + segment;
+  indices[0] = k > first ? k - 1 : first;
+  indices[1] = k;
+  indices[2] = k + 1;
+  indices[3] = std::min(k + 2, last);
+}
+
+glm::vec3 CurveSet::evaluate(unsigned int curve, float time)
+{
+  unsigned int segment = findSegment(curve, time);
+  unsigned int k[4];
+  controlPoints(curve, segment, k);
+  float s = (time - keyTime[k[1]]) / (keyTime[k[2]] - keyTime[k[1]]);
+  s = std::min(std::max(s, 0.0f), 1.0f);
+  glm::vec3 p[4];
+  for (int i = 0; i < 4; i++)
+    p[i] = glm::vec3(keyX[k[i]], keyY[k[i]], keyZ[k[i]]);
+  return glm::catmullRom(p[0], p[1], p[2], p[3], s);
+}
+
+void CurveSet::evaluate(const float* times, float* x, float* y, float* z)
+{
+  searches = 0;
+  unsigned int count = curveCount();
+  if (!simd)
+  {
+    for (unsigned int c = 0; c < count; c++)
+    {
+      glm::vec3 p = evaluate(c, times[c]);
+      x[c] = p.x;
+      y[c] = p.y;
+      z[c] = p.z;
+    }
+    return;
+  }
+
+  const float8 zero(0.0f), one(1.0f), two(2.0f), three(3.0f), four(4.0f),
+               five(5.0f), half(0.5f);
+  for (unsigned int i = 0; i < count; i += 8)
+  {
+    // gather the control points of 8 curves, a short last group repeats
+    // its last curve
+    float px[4][8], py[4][8], pz[4][8], lane[8];
+    for (unsigned int j = 0; j < 8; j++)
+    {
+      unsigned int c = std::min(i + j, count - 1);
+      float time = times[c];
+      unsigned int k[4];
+      controlPoints(c, findSegment(c, time), k);
+      for (int p = 0; p < 4; p++)
+      {
+        px[p][j] = keyX[k[p]];
+        py[p][j] = keyY[k[p]];
+        pz[p][j] = keyZ[k[p]];
+      }
+      lane[j] = (time - keyTime[k[1]]) / (keyTime[k[2]] - keyTime[k[1]]);
+    }
+    float8 s = min(max(float8::load(lane), zero), one);
+    float8 s2 = s * s, s3 = s2 * s;
+    // glm::catmullRom's weights with the division by 2 folded in
+    float8 weights[4] = {
+            half * (two * s2 - s3 - s),
+            half * (three * s3 - five * s2 + two),
+            half * (four * s2 - three * s3 + s),
+            half * (s3 - s2)};
+    float8 rx(0.0f), ry(0.0f), rz(0.0f);
+    for (int p = 0; p < 4; p++)
+    {
+      rx = fmadd(weights[p], float8::load(px[p]), rx);
+      ry = fmadd(weights[p], float8::load(py[p]), ry);
+      rz = fmadd(weights[p], float8::load(pz[p]), rz);
+    }
+    if (i + 8 <= count)
+    {
+      rx.store(x + i);
+      ry.store(y + i);
+      rz.store(z + i);
+    }
+    else
+    {
+      float lx[8], ly[8], lz[8];
+      rx.store(lx);
+      ry.store(ly);
+      rz.store(lz);
+      std::copy(lx, lx + (count - i), x + i);
+      std::copy(ly, ly + (count - i), y + i);
+      std::copy(lz, lz + (count - i), z + i);
+    }
+  }
+}
+
+void CurveSet::buildArcLengths(unsigned int samplesPerSegment)
+{
+  unsigned int count = curveCount();
+  samplesPerSegment = std::max(samplesPerSegment, 1u);
+  lengths.resize(count);
+  arcFirst.resize(count);
+  unsigned int entries = 0;
+  for (unsigned int c = 0; c < count; c++)
+  {
+    arcFirst[c] = entries;
+    entries += (keyCount[c] - 1) * ARC_TABLE_SIZE + 1;
+  }
+  arcTimes.resize(entries);
+  std::vector<float> sampleTimes, distances;
+  for (unsigned int c = 0; c < count; c++)
+  {
+    // distance covered at densely spaced times, samplesPerSegment between
+    // every two keys however far apart they are in time
+    unsigned int segments = keyCount[c] - 1;
+    unsigned int samples = segments * samplesPerSegment;
+    const float* keys = &keyTime[firstKey[c]];
+    sampleTimes.resize(samples + 1);
+    distances.resize(samples + 1);
+    glm::vec3 previous = evaluate(c, keys[0]);
+    float distance = 0.0f;
+    for (unsigned int k = 0; k <= samples; k++)
+    {
+      unsigned int segment = std::min(k / samplesPerSegment, segments - 1);
+      float t = (float)(k - segment * samplesPerSegment) / samplesPerSegment;
+      float time = keys[segment] + (keys[segment + 1] - keys[segment]) * t;
+      glm::vec3 point = evaluate(c, time);
+      distance += glm::length(point - previous);
+      previous = point;
+      sampleTimes[k] = time;
+      distances[k] = distance;
+    }
+    lengths[c] = distance;
+
+    // inverted: the time at evenly spaced distances
+    float* table = &arcTimes[arcFirst[c]];
+    unsigned int size = segments * ARC_TABLE_SIZE;
+    unsigned int k = 0;
+    for (unsigned int m = 0; m <= size; m++)
+    {
+      float target = distance * m / size;
+      while (k + 1 < samples && distances[k + 1] < target)
+        k++;
+      float span = distances[k + 1] - distances[k];
+      float t = span > 0.0f ? (target - distances[k]) / span : 0.0f;
+      t = std::min(std::max(t, 0.0f), 1.0f);
+      table[m] = sampleTimes[k] + (sampleTimes[k + 1] - sampleTimes[k]) * t;
+    }
+    lastSegment[c] = 0;
+  }
+}
+
+float CurveSet::length(unsigned int curve) const
+{
+  return curve < lengths.size() ? lengths[curve] : 0.0f;
+}
+
+void CurveSet::timesAtDistances(const float* distances, float* times) const
+{
+  if (lengths.size() != curveCount())
+  {
+    std::cout << "ERROR::CURVES::ARC_LENGTHS_NOT_BUILT" << std::endl;
+    return;
+  }
+  for (unsigned int c = 0; c < curveCount(); c++)
+  {
+    const float* table = &arcTimes[arcFirst[c]];
+    unsigned int size = (keyCount[c] - 1) * ARC_TABLE_SIZE;
+    float position = lengths[c] > 0.0f ? distances[c] / lengths[c] : 0.0f;
+    position = std::min(std::max(position, 0.0f), 1.0f) * size;
+    unsigned int m = std::min((unsigned int)position, size - 1);
+    float t = position - m;
+    times[c] = table[m] + (table[m + 1] - table[m]) * t;
+  }
+}
+
+unsigned int CurveSet::segmentSearches() const
+{
+  return searches;
+}
@@ -0,0 +1,102 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_CURVES_H
+#define COORDINATESPACE_CURVES_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Batched curve sampling
+ *  glm/gtx/spline.hpp evaluates one point of one curve per call, and
+ *  before it can be called someone has to find the segment the time falls
+ *  into (a binary search over the key times). Camera paths, moving
+ *  platforms and animated properties sample thousands of curves every
+ *  frame, always a little later than the frame before.
+ *
+ *  A CurveSet holds many Catmull-Rom curves through keys at arbitrary
+ *  times, the key times and positions of all curves structure of arrays in
+ *  flat arrays. evaluate() samples every curve at once:
+ *
+ *   - each curve remembers the segment it was last sampled in. Time
+ *     mostly moves forward a little, so the segment is either the same or
+ *     one of the next few; only when time jumps back does a binary search
+ *     run.
+ *   - the four control points of 8 curves are gathered into float8 lanes
+ *     and the cubic basis (the same weights glm::catmullRom uses) is
+ *     evaluated for all 8 together.
+ *
+ *  The first and the last key are repeated as the outer control points, so
+ *  a curve passes through all of its keys and stops at the ends.
+ *
+ *  Moving along a curve at constant speed needs the time at which it has
+ *  covered a given distance. buildArcLengths() samples every segment
+ *  densely once, between its own two keys, integrates the length and
+ *  inverts that into a table of times at evenly spaced distances,
+ *  ARC_TABLE_SIZE of them per segment so a curve with more keys gets a
+ *  longer table; timesAtDistances() then is a multiply and one lerp per
+ *  curve, no search. The lerp is least accurate where a curve
+ *  almost stops in a sharp turn: there time runs much faster than
+ *  distance. ARC_TABLE_SIZE trades memory for that.
+ *
+ *  With simd off every point goes through glm::catmullRom, and with
+ *  cacheSegments off every lookup is a binary search; both off is how a
+ *  single curve would be sampled otherwise.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class CurveSet
+{
+public:
+  // distances per segment in the arc length tables, a curve's table has
+  // one more entry than its segments times this
+  static const unsigned int ARC_TABLE_SIZE = 64;
+
+  bool simd;
+  // remember each curve's last segment; off searches every time
+  bool cacheSegments;
+
+  CurveSet();
+
+  // times must increase, at least two keys; returns the curve's index
+  unsigned int addCurve(const std::vector<float> &times,
+                        const std::vector<glm::vec3> &points);
+  unsigned int curveCount() const;
+  float startTime(unsigned int curve) const;
+  float endTime(unsigned int curve) const;
+
+  // the position of every curve at its entry of times (curveCount each)
+  void evaluate(const float* times, float* x, float* y, float* z);
+  // a single curve, through glm::catmullRom
+  glm::vec3 evaluate(unsigned int curve, float time);
+
+  // samplesPerSegment points per segment approximate the length
+  void buildArcLengths(unsigned int samplesPerSegment = 32);
+  float length(unsigned int curve) const;
+  // the time at which every curve has covered its entry of distances
+  void timesAtDistances(const float* distances, float* times) const;
+
+  // binary searches during the last evaluate()
+  unsigned int segmentSearches() const;
+
+private:
+  std::vector<unsigned int> firstKey;
+  std::vector<unsigned int> keyCount;
+  std::vector<float> keyTime;
+  std::vector<float> keyX, keyY, keyZ;
+  std::vector<unsigned int> lastSegment;
+  unsigned int searches;
+
+  std::vector<float> lengths;
+  // where each curve's table starts in arcTimes
+  std::vector<unsigned int> arcFirst;
+  std::vector<float> arcTimes;
+
+  unsigned int findSegment(unsigned int curve, float time);
+  void controlPoints(unsigned int curve, unsigned int segment,
+                     unsigned int indices[4]) const;
+};
+#endif //COORDINATESPACE_CURVES_H
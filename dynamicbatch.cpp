@@ -0,0 +1,470 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "dynamicbatch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+
+  // instances per job, a few thousand vertices
+  const size_t INSTANCES_PER_JOB = 16;
+
+  // running average of a measured cost, negative while there's none
+  void average(double &cost, double sample)
+  {
+    cost = cost < 0.0 ? sample : cost + 0.1 * (sample - cost);
+  }
+}
+
+DynamicBatcher::DynamicBatcher(unsigned int maxVertices, JobSystem* jobs)
+  : mode(AUTOMATIC), maxBatchVertices(300), calibrationInterval(120),
+    simd(true), maxVertices(std::max((maxVertices + 7) & ~7u, 1024u)),
+    maxIndices(this->maxVertices * 6), jobs(jobs), ringVertex(0),
+    ringIndex(0),
+    batchShader("shaders/staticbatchvs.txt", "shaders/staticbatchfs.txt"),
+    instanceShader("shaders/instancedvs.txt", "shaders/staticbatchfs.txt"),
+    frame(0), vertexCost(-1.0), drawCost(-1.0), instanceCost(-1.0),
+    draws(0), batchedCount(0), instancedCount(0), cpuTime(0.0)
+{
+  materialColors.push_back(glm::vec3(0.8f));
+
+  // world space vertices as float4 positions and normals in two buffers,
+  // the ring offset goes into the draws as base vertex
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &positionBuffer);
+  glGenBuffers(1, &normalBuffer);
+  glGenBuffers(1, &indexBuffer);
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, positionBuffer);
+  glBufferData(GL_ARRAY_BUFFER, this->maxVertices * 4 * sizeof(float), NULL,
+               GL_STREAM_DRAW);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                        (void*)0);
+  glEnableVertexAttribArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, normalBuffer);
+  glBufferData(GL_ARRAY_BUFFER, this->maxVertices * 4 * sizeof(float), NULL,
+               GL_STREAM_DRAW);
+  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                        (void*)0);
+  glEnableVertexAttribArray(1);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, maxIndices * sizeof(unsigned int),
+               NULL, GL_STREAM_DRAW);
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+DynamicBatcher::~DynamicBatcher()
+{
+  for (Mesh &mesh : meshes)
+  {
+    glDeleteVertexArrays(1, &mesh.VAO);
+    glDeleteBuffers(1, &mesh.VBO);
+    glDeleteBuffers(1, &mesh.EBO);
+    glDeleteBuffers(1, &mesh.instanceVBO);
+  }
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &positionBuffer);
+  glDeleteBuffers(1, &normalBuffer);
+  glDeleteBuffers(1, &indexBuffer);
+  glDeleteProgram(batchShader.ID);
+  glDeleteProgram(instanceShader.ID);
+}
+
+unsigned int DynamicBatcher::addMesh(const StaticMesh &source)
+{
+  Mesh mesh;
+  mesh.source = source;
+  mesh.batched = false;
+
+  // the instanced copy: the mesh in its own space, in the same layout as
+  // the streaming buffer
+  size_t padded = source.x.size();
+  std::vector<float> vertices(padded * 8);
+  transformMesh(source, glm::mat4(1.0f), simd, vertices.data(),
+                vertices.data() + padded * 4);
+  size_t block = padded * 4 * sizeof(float);
+
+  glGenVertexArrays(1, &mesh.VAO);
+  glGenBuffers(1, &mesh.VBO);
+  glGenBuffers(1, &mesh.EBO);
+  glGenBuffers(1, &mesh.instanceVBO);
+  glBindVertexArray(mesh.VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+  glBufferData(GL_ARRAY_BUFFER, 2 * block, vertices.data(), GL_STATIC_DRAW);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                        (void*)0);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                        (void*)block);
+  glEnableVertexAttribArray(1);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+               source.indices.size() * sizeof(unsigned int),
+               source.indices.data(), GL_STATIC_DRAW);
+  // the model matrix as four vec4 columns per instance
+  glBindBuffer(GL_ARRAY_BUFFER, mesh.instanceVBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(glm::mat4), NULL, GL_STREAM_DRAW);
+  for (int column = 0; column < 4; column++)
+  {
+    glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE,
+                          sizeof(glm::mat4),
+                          (void*)(column * sizeof(glm::vec4)));
+    glEnableVertexAttribArray(2 + column);
+    glVertexAttribDivisor(2 + column, 1);
+  }
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  meshes.push_back(mesh);
+  return (unsigned int)meshes.size() - 1;
+}
+
+void DynamicBatcher::draw(unsigned int mesh, unsigned int material,
+                          const glm::mat4 &model)
+{
+  if (mesh >= meshes.size())
+  {
+    std::cout << "ERROR::DYNAMICBATCH::UNKNOWN_MESH " << mesh << std::endl;
+    return;
+  }
+  Queued queued = {mesh, material, model};
+  queue.push_back(queued);
+}
+
+void DynamicBatcher::decide(const std::vector<unsigned int> &visible)
+{
+  // the first two frames of every interval measure one path each
+  unsigned int phase = calibrationInterval > 0 ?
+                       frame % calibrationInterval : 2;
+  batched.clear();
+  instanced.clear();
+  for (size_t first = 0; first < visible.size();)
+  {
+    unsigned int meshIndex = queue[visible[first]].mesh;
+    Mesh &mesh = meshes[meshIndex];
+    size_t last = first;
+    unsigned int materials = 0;
+    for (; last < visible.size() && queue[visible[last]].mesh == meshIndex;
+         last++)
+      if (last == first ||
+          queue[visible[last]].material != queue[visible[last - 1]].material)
+        materials++;
+
+    double instances = (double)(last - first);
+    // a mesh the rings can't hold on its own (padded) is never batched,
+    // whatever maxBatchVertices says
+    bool fits = mesh.source.x.size() <= maxVertices &&
+                mesh.source.indices.size() <= maxIndices;
+    bool batch;
+    if (mesh.source.vertexCount > maxBatchVertices || !fits ||
+        mode == ALWAYS_INSTANCE)
+      batch = false;
+    else if (mode == ALWAYS_BATCH || vertexCost < 0.0)
+      batch = true;
+    else if (drawCost < 0.0 || instanceCost < 0.0)
+      batch = false;
+    else if (phase < 2)
+      batch = phase == 0;
+    else
+      batch = instances * mesh.source.x.size() * vertexCost <
+              materials * drawCost + instances * instanceCost;
+    mesh.batched = batch;
+
+    std::vector<unsigned int> &target = batch ? batched : instanced;
+    target.insert(target.end(), visible.begin() + first,
+                  visible.begin() + last);
+    first = last;
+  }
+
+  // batches are by material across all meshes
+  std::stable_sort(batched.begin(), batched.end(),
+                   [this](unsigned int a, unsigned int b)
+                   {
+                     return queue[a].material < queue[b].material;
+                   });
+}
+
+double DynamicBatcher::drawSegment(size_t begin, size_t end,
+                                   unsigned int vertexCount,
+                                   unsigned int indexCount,
+                                   int colorLocation)
+{
+  double start = now();
+  // unsynchronized appends into the rings, orphaned when they run full
+  if (ringVertex + vertexCount > maxVertices)
+  {
+    unsigned int buffers[] = {positionBuffer, normalBuffer};
+    for (unsigned int buffer : buffers)
+    {
+      glBindBuffer(GL_ARRAY_BUFFER, buffer);
+      glBufferData(GL_ARRAY_BUFFER, maxVertices * 4 * sizeof(float), NULL,
+                   GL_STREAM_DRAW);
+    }
+    ringVertex = 0;
+  }
+  if (ringIndex + indexCount > maxIndices)
+  {
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, maxIndices * sizeof(unsigned int),
+                 NULL, GL_STREAM_DRAW);
+    ringIndex = 0;
+  }
+  GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                      GL_MAP_UNSYNCHRONIZED_BIT;
+  glBindBuffer(GL_ARRAY_BUFFER, positionBuffer);
+  float* positions = (float*)glMapBufferRange(
+          GL_ARRAY_BUFFER, ringVertex * 4 * sizeof(float),
+          vertexCount * 4 * sizeof(float), access);
+  glBindBuffer(GL_ARRAY_BUFFER, normalBuffer);
+  float* normals = (float*)glMapBufferRange(
+          GL_ARRAY_BUFFER, ringVertex * 4 * sizeof(float),
+          vertexCount * 4 * sizeof(float), access);
+  unsigned int* indices = (unsigned int*)glMapBufferRange(
+          GL_ELEMENT_ARRAY_BUFFER, ringIndex * sizeof(unsigned int),
+          indexCount * sizeof(unsigned int), access);
+
+  // every instance writes its own range of the mapped buffers
+  JobSystem::RangeFunction transformRange = [&](size_t first, size_t last)
+  {
+    for (size_t p = first; p < last; p++)
+    {
+      const Placement &placement = placements[p];
+      const Queued &queued = queue[placement.queued];
+      const StaticMesh &mesh = meshes[queued.mesh].source;
+      transformMesh(mesh, queued.model, simd,
+                    positions + placement.firstVertex * 4,
+                    normals + placement.firstVertex * 4);
+      unsigned int* out = indices + placement.firstIndex;
+      for (size_t k = 0; k < mesh.indices.size(); k++)
+        out[k] = mesh.indices[k] + placement.firstVertex;
+    }
+  };
+  parallelFor(jobs, placements.size(), INSTANCES_PER_JOB, transformRange);
+
+  glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+  glUnmapBuffer(GL_ARRAY_BUFFER);
+  glBindBuffer(GL_ARRAY_BUFFER, positionBuffer);
+  glUnmapBuffer(GL_ARRAY_BUFFER);
+  double written = now() - start;
+
+  // one draw per material in the segment
+  for (size_t first = begin; first < end;)
+  {
+    unsigned int material = queue[batched[first]].material;
+    size_t last = first;
+    while (last < end && queue[batched[last]].material == material)
+      last++;
+    size_t firstIndex = placements[first - begin].firstIndex;
+    size_t lastIndex = last < end ? placements[last - begin].firstIndex :
+                       indexCount;
+    glm::vec3 color = materialColors[material % materialColors.size()];
+    glUniform3f(colorLocation, color.x, color.y, color.z);
+    glDrawElementsBaseVertex(
+            GL_TRIANGLES, (GLsizei)(lastIndex - firstIndex), GL_UNSIGNED_INT,
+            (void*)((ringIndex + firstIndex) * sizeof(unsigned int)),
+            (GLint)ringVertex);
+    draws++;
+    first = last;
+  }
+
+  ringVertex += vertexCount;
+  ringIndex += indexCount;
+  return written;
+}
+
+void DynamicBatcher::renderBatched(const glm::mat4 &viewProjection)
+{
+  if (batched.empty())
+    return;
+  batchShader.use();
+  batchShader.setMat4("viewProjection", viewProjection);
+  int colorLocation = glGetUniformLocation(batchShader.ID, "color");
+  glBindVertexArray(VAO);
+
+  // segments of what fits into the rings
+  double written = 0.0;
+  size_t vertices = 0;
+  size_t begin = 0;
+  unsigned int vertexCount = 0, indexCount = 0;
+  placements.clear();
+  for (size_t k = 0; k <= batched.size(); k++)
+  {
+    const StaticMesh* mesh = k < batched.size() ?
+                             &meshes[queue[batched[k]].mesh].source : NULL;
+    if (mesh == NULL ||
+        vertexCount + mesh->x.size() > maxVertices ||
+        indexCount + mesh->indices.size() > maxIndices)
+    {
+      if (k > begin)
+        written += drawSegment(begin, k, vertexCount, indexCount,
+                               colorLocation);
+      vertices += vertexCount;
+      begin = k;
+      vertexCount = 0;
+      indexCount = 0;
+      placements.clear();
+      if (mesh == NULL)
+        break;
+    }
+    Placement placement = {batched[k], vertexCount, indexCount};
+    placements.push_back(placement);
+    vertexCount += (unsigned int)mesh->x.size();
+    indexCount += (unsigned int)mesh->indices.size();
+  }
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  average(vertexCost, written * 1000.0 / vertices);
+}
+
+void DynamicBatcher::renderInstanced(const glm::mat4 &viewProjection)
+{
+  if (instanced.empty())
+    return;
+  instanceShader.use();
+  instanceShader.setMat4("viewProjection", viewProjection);
+  int colorLocation = glGetUniformLocation(instanceShader.ID, "color");
+
+  double uploadTime = 0.0, drawTime = 0.0;
+  unsigned int instanceDraws = 0;
+  for (size_t first = 0; first < instanced.size();)
+  {
+    double start = now();
+    const Mesh &mesh = meshes[queue[instanced[first]].mesh];
+    size_t last = first;
+    models.clear();
+    for (; last < instanced.size() &&
+           &meshes[queue[instanced[last]].mesh] == &mesh; last++)
+      models.push_back(queue[instanced[last]].model);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, models.size() * sizeof(glm::mat4),
+                 models.data(), GL_STREAM_DRAW);
+    double uploaded = now();
+    uploadTime += uploaded - start;
+
+    // one draw per material, the instance attributes point at its range
+    glBindVertexArray(mesh.VAO);
+    for (size_t k = first; k < last;)
+    {
+      unsigned int material = queue[instanced[k]].material;
+      size_t end = k;
+      while (end < last && queue[instanced[end]].material == material)
+        end++;
+      for (int column = 0; column < 4; column++)
+        glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE,
+                              sizeof(glm::mat4),
+                              (void*)((k - first) * sizeof(glm::mat4) +
+                                      column * sizeof(glm::vec4)));
+      glm::vec3 color = materialColors[material % materialColors.size()];
+      glUniform3f(colorLocation, color.x, color.y, color.z);
+      glDrawElementsInstanced(GL_TRIANGLES,
+                              (GLsizei)mesh.source.indices.size(),
+                              GL_UNSIGNED_INT, 0, (GLsizei)(end - k));
+      instanceDraws++;
+      k = end;
+    }
+    drawTime += now() - uploaded;
+    first = last;
+  }
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  draws += instanceDraws;
+  average(drawCost, drawTime * 1000.0 / instanceDraws);
+  average(instanceCost, uploadTime * 1000.0 / instanced.size());
+}
+
+void DynamicBatcher::render(const glm::mat4 &viewProjection)
+{
+  double start = now();
+  Frustum frustum(viewProjection);
+  std::vector<unsigned int> visible;
+  for (size_t i = 0; i < queue.size(); i++)
+    if (frustum.intersects(transformAABB(meshes[queue[i].mesh].source.bounds,
+                                         queue[i].model)))
+      visible.push_back((unsigned int)i);
+  // by mesh and material, so decide() sees every mesh as one run
+  std::sort(visible.begin(), visible.end(),
+            [this](unsigned int a, unsigned int b)
+            {
+              const Queued &x = queue[a], &y = queue[b];
+              if (x.mesh != y.mesh)
+                return x.mesh < y.mesh;
+              if (x.material != y.material)
+                return x.material < y.material;
+              return a < b;
+            });
+  decide(visible);
+
+  draws = 0;
+  renderBatched(viewProjection);
+  renderInstanced(viewProjection);
+  batchedCount = (unsigned int)batched.size();
+  instancedCount = (unsigned int)instanced.size();
+  queue.clear();
+  frame++;
+  cpuTime = now() - start;
+}
+
+bool DynamicBatcher::isBatched(unsigned int mesh) const
+{
+  return mesh < meshes.size() && meshes[mesh].batched;
+}
+
+unsigned int DynamicBatcher::drawCalls() const
+{
+  return draws;
+}
+
+unsigned int DynamicBatcher::batchedInstances() const
+{
+  return batchedCount;
+}
+
+unsigned int DynamicBatcher::instancedInstances() const
+{
+  return instancedCount;
+}
+
+double DynamicBatcher::cpuMilliseconds() const
+{
+  return cpuTime;
+}
+
+double DynamicBatcher::vertexMicroseconds() const
+{
+  return vertexCost;
+}
+
+double DynamicBatcher::drawMicroseconds() const
+{
+  return drawCost;
+}
+
+double DynamicBatcher::instanceMicroseconds() const
+{
+  return instanceCost;
+}
+
+void DynamicBatcher::printStats() const
+{
+  std::cout << "dynamic batching: " << batchedCount << " batched and "
+            << instancedCount << " instanced objects in " << draws
+            << " draws, " << cpuTime << " ms; measured " << vertexCost
+            << " us per vertex, " << drawCost << " us per draw, "
+            << instanceCost << " us per instance; batched meshes:";
+  for (size_t i = 0; i < meshes.size(); i++)
+    if (meshes[i].batched)
+      std::cout << " " << i;
+  std::cout << std::endl;
+}
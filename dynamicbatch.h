@@ -0,0 +1,155 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_DYNAMICBATCH_H
+#define COORDINATESPACE_DYNAMICBATCH_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "jobsystem.h"
+#include "staticbatch.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Dynamic batching
+ *  Small moving meshes (debris, pickups, props being pushed around) can't
+ *  be merged at load time like the StaticBatcher does, and drawn one by
+ *  one each of them costs a draw call for a few hundred vertices. There
+ *  are two ways around that:
+ *
+ *   - instancing: one draw per mesh and material, the model matrices go
+ *     into an instance buffer. Cheap per object, but every mesh still
+ *     costs its own draws.
+ *   - dynamic batching: every frame the vertices of all small meshes are
+ *     transformed into world space on the CPU (with float8, spread over
+ *     the JobSystem) and written straight into a mapped streaming buffer;
+ *     then everything of one material is a single draw, whichever meshes
+ *     it's made of. Cheap per draw, but it costs CPU time per vertex.
+ *
+ *  Which one wins depends on the mesh (its vertex count, how many copies
+ *  are visible, in how many materials) and on the machine. So both costs
+ *  are measured while rendering: the transform time per vertex, the time
+ *  of an instanced draw and the upload time per instance, each a running
+ *  average. Every frame each mesh takes the cheaper path by
+ *
+ *    batching:    instances * vertices * perVertex
+ *    instancing:  materials * perDraw + instances * perInstance
+ *
+ *  Only CPU time counts, the GPU gets the same triangles either way. (A
+ *  software rasterizer runs the shading inside the draw call, so there
+ *  perDraw includes it and the choice leans towards batching.)
+ *
+ *  Meshes above maxBatchVertices, or too large for the streaming buffer
+ *  on their own, are always instanced. Every calibrationInterval frames
+ *  all small meshes take one path for a frame and the other one for the
+ *  next, so both estimates stay current even when one of the paths isn't
+ *  chosen for a while.
+ *
+ *  Meshes use the StaticMesh layout. The streaming buffer is a ring like
+ *  the SpriteBatch one: unsynchronized appends, orphaned when it's full.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class DynamicBatcher
+{
+public:
+  enum Mode
+  {
+    AUTOMATIC,
+    ALWAYS_BATCH,
+    ALWAYS_INSTANCE
+  };
+
+  Mode mode;
+  // meshes with more vertices are always instanced
+  unsigned int maxBatchVertices;
+  unsigned int calibrationInterval;
+  // the vertex transform with float8, or one vertex at a time
+  bool simd;
+  // color of each material index
+  std::vector<glm::vec3> materialColors;
+
+  // maxVertices is the size of the streaming buffer, jobs may be NULL
+  DynamicBatcher(unsigned int maxVertices, JobSystem* jobs);
+  ~DynamicBatcher();
+  DynamicBatcher(const DynamicBatcher &) = delete;
+  DynamicBatcher &operator=(const DynamicBatcher &) = delete;
+
+  // copies the mesh, returns its handle for draw()
+  unsigned int addMesh(const StaticMesh &mesh);
+  // queues a copy of the mesh for the next render()
+  void draw(unsigned int mesh, unsigned int material,
+            const glm::mat4 &model);
+  // culls the queued meshes against the frustum, draws them and clears
+  // the queue
+  void render(const glm::mat4 &viewProjection);
+
+  // of the last render()
+  bool isBatched(unsigned int mesh) const;
+  unsigned int drawCalls() const;
+  unsigned int batchedInstances() const;
+  unsigned int instancedInstances() const;
+  double cpuMilliseconds() const;
+  // the measured costs, in microseconds; negative until measured
+  double vertexMicroseconds() const;
+  double drawMicroseconds() const;
+  double instanceMicroseconds() const;
+  void printStats() const;
+
+private:
+  struct Mesh
+  {
+    StaticMesh source;
+    unsigned int VAO, VBO, EBO, instanceVBO;
+    bool batched;
+  };
+
+  struct Queued
+  {
+    unsigned int mesh;
+    unsigned int material;
+    glm::mat4 model;
+  };
+
+  // a batched instance's place in the current segment of the ring
+  struct Placement
+  {
+    unsigned int queued;
+    unsigned int firstVertex;
+    unsigned int firstIndex;
+  };
+
+  unsigned int maxVertices;
+  unsigned int maxIndices;
+  JobSystem* jobs;
+  std::vector<Mesh> meshes;
+  std::vector<Queued> queue;
+  std::vector<unsigned int> batched;
+  std::vector<unsigned int> instanced;
+  std::vector<Placement> placements;
+  std::vector<glm::mat4> models;
+
+  unsigned int VAO, positionBuffer, normalBuffer, indexBuffer;
+  unsigned int ringVertex, ringIndex;
+  Shader batchShader;
+  Shader instanceShader;
+
+  unsigned int frame;
+  double vertexCost, drawCost, instanceCost;
+  unsigned int draws;
+  unsigned int batchedCount;
+  unsigned int instancedCount;
+  double cpuTime;
+
+  void decide(const std::vector<unsigned int> &visible);
+  void renderBatched(const glm::mat4 &viewProjection);
+  void renderInstanced(const glm::mat4 &viewProjection);
+  // transforms and draws batched[begin, end) with the placements, returns
+  // the milliseconds spent writing the vertices
+  double drawSegment(size_t begin, size_t end, unsigned int vertexCount,
+                     unsigned int indexCount, int colorLocation);
+};
+#endif //COORDINATESPACE_DYNAMICBATCH_H
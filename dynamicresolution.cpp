@@ -0,0 +1,223 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "dynamicresolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+  const float SCALE_STEP = 0.05f;
+}
+
+ResolutionController::ResolutionController()
+  : minScale(0.5f), maxScale(1.0f), budgetMilliseconds(16.0),
+    hysteresis(0.15f), settleFrames(30), logChanges(true), currentScale(1.0f),
+    frameCount(0), framesUnder(0), ignoreFrames(0)
+{
+  std::fill(scales, scales + HISTORY, 1.0f);
+}
+
+float ResolutionController::update(double milliseconds)
+{
+  float previous = currentScale;
+  currentScale = std::min(std::max(currentScale, minScale), maxScale);
+  if (ignoreFrames > 0)
+    ignoreFrames--;
+  else if (milliseconds > 0.0)
+  {
+    // the scale that would just fit the budget, pixels cost scale^2
+    float ideal = currentScale *
+                  (float)std::sqrt(budgetMilliseconds / milliseconds);
+    float next = currentScale;
+    if (milliseconds > budgetMilliseconds)
+    {
+      next = std::floor(ideal / SCALE_STEP) * SCALE_STEP;
+      framesUnder = 0;
+    }
+    else if (milliseconds < budgetMilliseconds * (1.0 - hysteresis))
+    {
+      // grow toward the scale that fits, but stay under the budget and
+      // only after settling
+      if (++framesUnder >= settleFrames)
+      {
+        next = std::max(std::floor(ideal / SCALE_STEP) * SCALE_STEP,
+                        currentScale);
+        framesUnder = 0;
+      }
+    }
+    else
+      framesUnder = 0;
+    currentScale = std::min(std::max(next, minScale), maxScale);
+  }
+
+  if (std::fabs(currentScale - previous) > SCALE_STEP * 0.5f)
+  {
+    ignoreFrames = LATENCY_FRAMES;
+    if (logChanges)
+      std::cout << "dynamic resolution: frame " << frameCount << ", "
+                << milliseconds << " ms for a " << budgetMilliseconds
+                << " ms budget, scale " << previous << " -> "
+                << currentScale << std::endl;
+  }
+  scales[frameCount % HISTORY] = currentScale;
+  frameCount++;
+  return currentScale;
+}
+
+float ResolutionController::scale() const
+{
+  return currentScale;
+}
+
+float ResolutionController::history(int age) const
+{
+  if (age < 0 || age >= std::min(frameCount, HISTORY))
+    return currentScale;
+  return scales[(frameCount - 1 - age) % HISTORY];
+}
+
+int ResolutionController::frames() const
+{
+  return frameCount;
+}
+
+DynamicResolution::DynamicResolution(int outputWidth, int outputHeight)
+  : filter(EDGE_AWARE), useGpuTimer(true), outputWidth(outputWidth),
+    outputHeight(outputHeight), targetWidth(0), targetHeight(0),
+    width(outputWidth), height(outputHeight), FBO(0), color(0), depth(0),
+    shader("shaders/upscalevs.txt", "shaders/upscalefs.txt"),
+    firstPassAtScale(0)
+{
+  // the upscale triangle is generated from gl_VertexID, but core profile
+  // still wants a vertex array bound
+  glGenVertexArrays(1, &VAO);
+  createTarget();
+}
+
+DynamicResolution::~DynamicResolution()
+{
+  deleteTarget();
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteProgram(shader.ID);
+}
+
+void DynamicResolution::createTarget()
+{
+  targetWidth = std::max((int)std::ceil(outputWidth * controller.maxScale), 1);
+  targetHeight = std::max((int)std::ceil(outputHeight * controller.maxScale),
+                          1);
+  glGenTextures(1, &color);
+  glBindTexture(GL_TEXTURE_2D, color);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, targetWidth, targetHeight, 0,
+               GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glGenRenderbuffers(1, &depth);
+  glBindRenderbuffer(GL_RENDERBUFFER, depth);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, targetWidth,
+                        targetHeight);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+  glGenFramebuffers(1, &FBO);
+  glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                         color, 0);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                            GL_RENDERBUFFER, depth);
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    std::cout << "ERROR::DYNAMICRESOLUTION::FRAMEBUFFER_INCOMPLETE"
+              << std::endl;
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void DynamicResolution::deleteTarget()
+{
+  glDeleteFramebuffers(1, &FBO);
+  glDeleteRenderbuffers(1, &depth);
+  glDeleteTextures(1, &color);
+}
+
+void DynamicResolution::setOutputSize(int width, int height)
+{
+  // minimizing the window reports 0 x 0, keep the old target then
+  if (width <= 0 || height <= 0 ||
+      (width == outputWidth && height == outputHeight))
+    return;
+  outputWidth = width;
+  outputHeight = height;
+  deleteTarget();
+  createTarget();
+}
+
+void DynamicResolution::beginScene()
+{
+  if (useGpuTimer)
+  {
+    // every finished frame once, a few frames late; frames drawn before
+    // the last scale change or older than the timer's ring don't say
+    // anything about the current scale
+    double milliseconds;
+    unsigned int pass;
+    if (timer.newMilliseconds(milliseconds, pass) &&
+        pass >= firstPassAtScale &&
+        timer.passes() - pass <= (unsigned int)GpuTimer::LATENCY + 1)
+    {
+      float previous = controller.scale();
+      controller.update(milliseconds);
+      if (controller.scale() != previous)
+        firstPassAtScale = timer.passes();
+    }
+  }
+  float scale = std::min(controller.scale(), controller.maxScale);
+  width = std::min(std::max((int)std::ceil(outputWidth * scale), 1),
+                   targetWidth);
+  height = std::min(std::max((int)std::ceil(outputHeight * scale), 1),
+                    targetHeight);
+  glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+  glViewport(0, 0, width, height);
+  timer.begin();
+}
+
+void DynamicResolution::endScene()
+{
+  timer.end();
+}
+
+void DynamicResolution::present(unsigned int framebuffer)
+{
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  glViewport(0, 0, outputWidth, outputHeight);
+  bool depthTest = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+  glDisable(GL_DEPTH_TEST);
+  shader.use();
+  shader.setInt("scene", 0);
+  shader.setInt("edgeAware", filter == EDGE_AWARE ? 1 : 0);
+  glUniform2i(glGetUniformLocation(shader.ID, "renderSize"), width, height);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, color);
+  glBindVertexArray(VAO);
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+  glBindVertexArray(0);
+  if (depthTest)
+    glEnable(GL_DEPTH_TEST);
+}
+
+int DynamicResolution::renderWidth() const
+{
+  return width;
+}
+
+int DynamicResolution::renderHeight() const
+{
+  return height;
+}
+
+double DynamicResolution::sceneGpuMilliseconds()
+{
+  return timer.milliseconds();
+}
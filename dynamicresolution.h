@@ -0,0 +1,132 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_DYNAMICRESOLUTION_H
+#define COORDINATESPACE_DYNAMICRESOLUTION_H
+
+#include "shader.h"
+#include "gputimer.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Dynamic resolution
+ *  The fragment work of a frame grows with the number of pixels. When the
+ *  GPU can't finish a frame in its budget (16.7 ms at 60 Hz) the scene is
+ *  rendered into an offscreen target at a lower resolution instead, and
+ *  then stretched over the window. A little blur is a lot less noticeable
+ *  than a missed frame.
+ *
+ *  The ResolutionController picks the scale, a factor applied to both
+ *  width and height, from the measured GPU time of the scene:
+ *
+ *   - the cost is roughly proportional to the pixel count, scale^2, so the
+ *     scale that would hit the budget is scale * sqrt(budget / time),
+ *   - over the budget it shrinks right away, missing frames is what we
+ *     want to avoid,
+ *   - it only grows again once the time stayed below budget * (1 -
+ *     hysteresis) for settleFrames frames in a row. Without that band the
+ *     scale would flip between two values every few frames, which is very
+ *     visible,
+ *   - timer results arrive a few frames late, so after every change the
+ *     measurements of the frames still in flight are ignored.
+ *     DynamicResolution feeds each finished frame once, and only frames
+ *     drawn at the current scale no more than GpuTimer::LATENCY + 1
+ *     frames ago,
+ *   - the scale moves in steps of 0.05 between minScale and maxScale.
+ *
+ *  Each change is logged to stdout with the frame number and the time that
+ *  caused it, and the last HISTORY scales are kept for graphs.
+ *
+ *  DynamicResolution owns the offscreen target. It's allocated for
+ *  maxScale and the scene is drawn into the lower left part of it, so
+ *  changing the scale never reallocates anything; only a new window size
+ *  (setOutputSize(), called from the framebuffer size callback) does.
+ *  present() upscales that part to the window with either bilinear
+ *  filtering or an edge-aware filter that weighs the 2x2 texels by how
+ *  close their brightness is to the nearest one, so edges stay sharp
+ *  instead of being smeared over a wide band.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class ResolutionController
+{
+public:
+  static const int HISTORY = 240;
+  // frames between a change and the first measurement that reflects it
+  static const int LATENCY_FRAMES = 4;
+
+  float minScale;
+  float maxScale;
+  double budgetMilliseconds;
+  // fraction of the budget the time has to fall below before growing
+  float hysteresis;
+  int settleFrames;
+  bool logChanges;
+
+  ResolutionController();
+
+  // feed the GPU time of the last finished frame, returns the scale for
+  // the next one
+  float update(double milliseconds);
+  float scale() const;
+  // scale of the frame age frames ago, 0 is the newest
+  float history(int age) const;
+  int frames() const;
+
+private:
+  float currentScale;
+  float scales[HISTORY];
+  int frameCount;
+  int framesUnder;
+  int ignoreFrames;
+};
+
+class DynamicResolution
+{
+public:
+  enum Filter
+  {
+    BILINEAR,
+    EDGE_AWARE
+  };
+
+  ResolutionController controller;
+  Filter filter;
+  // when false nothing is fed to the controller, the caller passes its
+  // own frame times to controller.update()
+  bool useGpuTimer;
+
+  DynamicResolution(int outputWidth, int outputHeight);
+  ~DynamicResolution();
+  DynamicResolution(const DynamicResolution &) = delete;
+  DynamicResolution &operator=(const DynamicResolution &) = delete;
+
+  void setOutputSize(int width, int height);
+  // binds the offscreen target with the viewport at the current scale
+  void beginScene();
+  void endScene();
+  // upscale into framebuffer, which covers the whole output size
+  void present(unsigned int framebuffer = 0);
+
+  int renderWidth() const;
+  int renderHeight() const;
+  double sceneGpuMilliseconds();
+
+private:
+  int outputWidth, outputHeight;
+  int targetWidth, targetHeight;
+  int width, height;
+  unsigned int FBO;
+  unsigned int color;
+  unsigned int depth;
+  unsigned int VAO;
+  Shader shader;
+  GpuTimer timer;
+  // the timer pass of the first frame drawn at the current scale
+  unsigned int firstPassAtScale;
+
+  void createTarget();
+  void deleteTarget();
+};
+#endif //COORDINATESPACE_DYNAMICRESOLUTION_H
@@ -0,0 +1,94 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include "frustum.h"
+
+AABB transformAABB(const AABB &box, const glm::mat4 &matrix)
+{
+  glm::vec3 center = glm::vec3(matrix * glm::vec4(box.center(), 1.0f));
+  glm::vec3 extent = box.extent();
+  glm::vec3 newExtent(0.0f);
+  // each output axis is the sum of the absolute contributions of the input
+  // axes, the same as transforming all 8 corners and taking min/max
+  for (int col = 0; col < 3; col++)
+    newExtent += glm::abs(glm::vec3(matrix[col])) * extent[col];
+  AABB result;
+  result.min = center - newExtent;
+  result.max = center + newExtent;
+  return result;
+}
+
+Frustum::Frustum()
+{
+  for (int i = 0; i < PLANE_COUNT; i++)
+    planes[i] = glm::vec4(0.0f);
+}
+
+Frustum::Frustum(const glm::mat4 &viewProjection)
+{
+  extract(viewProjection);
+}
+
+void Frustum::extract(const glm::mat4 &viewProjection)
+{
+  // glm is column major, viewProjection[c][r]; gather the rows first
+  glm::vec4 row[4];
+  for (int r = 0; r < 4; r++)
+    row[r] = glm::vec4(viewProjection[0][r], viewProjection[1][r],
+                       viewProjection[2][r], viewProjection[3][r]);
+
+  planes[LEFT_PLANE] = row[3] + row[0];
+  planes[RIGHT_PLANE] = row[3] - row[0];
+  planes[BOTTOM_PLANE] = row[3] + row[1];
+  planes[TOP_PLANE] = row[3] - row[1];
+  planes[NEAR_PLANE] = row[3] + row[2];
+  planes[FAR_PLANE] = row[3] - row[2];
+
+  for (int i = 0; i < PLANE_COUNT; i++)
+    planes[i] /= glm::length(glm::vec3(planes[i]));
+}
+
+bool Frustum::intersects(const AABB &box) const
+{
+  glm::vec3 center = box.center();
+  glm::vec3 extent = box.extent();
+  for (int i = 0; i < PLANE_COUNT; i++)
+  {
+    glm::vec3 normal = glm::vec3(planes[i]);
+    // distance of the box center and the projected radius of the box onto
+    // the plane normal
+    float distance = glm::dot(normal, center) + planes[i].w;
+    float radius = glm::dot(glm::abs(normal), extent);
+    if (distance + radius < 0.0f)
+      return false;
+  }
+  return true;
+}
+
+bool Frustum::intersectsSphere(const glm::vec3 &center, float radius) const
+{
+  for (int i = 0; i < PLANE_COUNT; i++)
+  {
+    if (glm::dot(glm::vec3(planes[i]), center) + planes[i].w < -radius)
+      return false;
+  }
+  return true;
+}
+
+void Frustum::corners(const glm::mat4 &viewProjection, glm::vec3 out[8])
+{
+  glm::mat4 inverse = glm::inverse(viewProjection);
+  const glm::vec2 ndc[4] = {
+          glm::vec2(-1.0f, -1.0f), glm::vec2(1.0f, -1.0f),
+          glm::vec2(1.0f, 1.0f), glm::vec2(-1.0f, 1.0f)
+  };
+  for (int z = 0; z < 2; z++)
+  {
+    for (int i = 0; i < 4; i++)
+    {
+      glm::vec4 p = inverse * glm::vec4(ndc[i], z == 0 ? -1.0f : 1.0f, 1.0f);
+      out[z * 4 + i] = glm::vec3(p) / p.w;
+    }
+  }
+}
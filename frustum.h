@@ -0,0 +1,57 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_FRUSTUM_H
+#define COORDINATESPACE_FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Anything outside the clip space volume gets clipped anyway, so there's no
+ * point in sending it to the GPU at all. The six planes of that volume can
+ * be read straight out of a projection * view matrix (Gribb/Hartmann): a
+ * world-space point p is inside when -w <= x,y,z <= w for
+ * (x,y,z,w) = M * p, and each of those inequalities is a plane equation
+ * made of two rows of M.
+ *
+ * Objects are tested with their world-space axis aligned bounding box. The
+ * test is conservative: a box is only rejected when it lies completely on
+ * the outside of a single plane.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+struct AABB
+{
+  glm::vec3 min;
+  glm::vec3 max;
+
+  glm::vec3 center() const { return (min + max) * 0.5f; }
+  glm::vec3 extent() const { return (max - min) * 0.5f; }
+};
+
+// bounds of box after transforming it by matrix (Arvo's method)
+AABB transformAABB(const AABB &box, const glm::mat4 &matrix);
+
+class Frustum
+{
+public:
+  enum { LEFT_PLANE = 0, RIGHT_PLANE, BOTTOM_PLANE, TOP_PLANE, NEAR_PLANE,
+         FAR_PLANE, PLANE_COUNT };
+
+  // plane equations, xyz is the inward facing normal and w the distance
+  glm::vec4 planes[PLANE_COUNT];
+
+  Frustum();
+  explicit Frustum(const glm::mat4 &viewProjection);
+
+  void extract(const glm::mat4 &viewProjection);
+  bool intersects(const AABB &box) const;
+  bool intersectsSphere(const glm::vec3 &center, float radius) const;
+
+  // world space corners of the volume described by viewProjection; near
+  // plane first, then far plane, each counter clockwise from bottom left
+  static void corners(const glm::mat4 &viewProjection, glm::vec3 out[8]);
+};
+#endif //COORDINATESPACE_FRUSTUM_H
@@ -0,0 +1,267 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "gpuculling.h"
+#include "frustum.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+  bool hasComputeShaders()
+  {
+    int major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    // the compute shader is written against GLSL 4.30
+    return GLAD_GL_ARB_compute_shader &&
+           GLAD_GL_ARB_shader_storage_buffer_object &&
+           GLAD_GL_ARB_shader_image_load_store && GLAD_GL_ARB_draw_indirect &&
+           (major > 4 || (major == 4 && minor >= 3));
+  }
+}
+
+GpuCuller::GpuCuller(unsigned int VAO, unsigned int indexCount,
+                     unsigned int maxObjects)
+  : VAO(VAO), indexCount(indexCount), maxObjects(maxObjects), objectCount(0),
+    computeAvailable(hasComputeShaders()), cullCompute(NULL),
+    cullPoints("shaders/cullpointsvs.txt", "shaders/cullpointsgs.txt",
+               "shaders/cullpointsfs.txt",
+               std::vector<const char*>{"visibleId"}),
+    copyCount("shaders/cullcountvs.txt",
+              std::vector<const char*>{"instanceCount"}),
+    drawShader("shaders/gpudrivenvs.txt", "shaders/multiviewfs.txt")
+{
+  useCompute = computeAvailable;
+  if (computeAvailable)
+    cullCompute = new Shader("shaders/cullcs.txt");
+
+  // per object: box center and extent as two vec4s
+  glGenBuffers(1, &boundsBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, boundsBuffer);
+  glBufferData(GL_ARRAY_BUFFER, maxObjects * 2 * sizeof(glm::vec4), NULL,
+               GL_STATIC_DRAW);
+  glGenVertexArrays(1, &pointsVAO);
+  glBindVertexArray(pointsVAO);
+  glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec4),
+                        (void*)0);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec4),
+                        (void*)sizeof(glm::vec4));
+  glEnableVertexAttribArray(1);
+  glBindVertexArray(0);
+
+  glGenBuffers(1, &modelBuffer);
+  glBindBuffer(GL_TEXTURE_BUFFER, modelBuffer);
+  glBufferData(GL_TEXTURE_BUFFER, maxObjects * sizeof(glm::mat4), NULL,
+               GL_STATIC_DRAW);
+  glGenTextures(1, &modelTexture);
+  glBindTexture(GL_TEXTURE_BUFFER, modelTexture);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, modelBuffer);
+
+  glGenBuffers(1, &visibleBuffer);
+  glBindBuffer(GL_TEXTURE_BUFFER, visibleBuffer);
+  glBufferData(GL_TEXTURE_BUFFER, maxObjects * sizeof(unsigned int), NULL,
+               GL_DYNAMIC_COPY);
+  glGenTextures(1, &visibleTexture);
+  glBindTexture(GL_TEXTURE_BUFFER, visibleTexture);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, visibleBuffer);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+  glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+  DrawElementsIndirectCommand command = {indexCount, 0, 0, 0, 0};
+  glGenBuffers(1, &commandBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, commandBuffer);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(command), &command, GL_DYNAMIC_COPY);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  // 1x1 target the visible points are counted in
+  glGenTextures(1, &counterTexture);
+  glBindTexture(GL_TEXTURE_2D, counterTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, 1, 1, 0, GL_RED, GL_FLOAT, NULL);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glGenFramebuffers(1, &counterFBO);
+  glBindFramebuffer(GL_FRAMEBUFFER, counterFBO);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                         counterTexture, 0);
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    std::cout << "ERROR::GPUCULLING::COUNTER_FRAMEBUFFER_INCOMPLETE"
+              << std::endl;
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  // texture units never change, set them once
+  drawShader.use();
+  drawShader.setInt("models", 0);
+  drawShader.setInt("visible", 1);
+  copyCount.use();
+  copyCount.setInt("counter", 0);
+}
+
+GpuCuller::~GpuCuller()
+{
+  unsigned int buffers[] = {boundsBuffer, modelBuffer, visibleBuffer,
+                            commandBuffer};
+  glDeleteBuffers(4, buffers);
+  unsigned int textures[] = {modelTexture, visibleTexture, counterTexture};
+  glDeleteTextures(3, textures);
+  glDeleteFramebuffers(1, &counterFBO);
+  glDeleteVertexArrays(1, &pointsVAO);
+  glDeleteProgram(cullPoints.ID);
+  glDeleteProgram(copyCount.ID);
+  glDeleteProgram(drawShader.ID);
+  if (cullCompute != NULL)
+  {
+    glDeleteProgram(cullCompute->ID);
+    delete cullCompute;
+  }
+}
+
+bool GpuCuller::computeSupported() const
+{
+  return computeAvailable;
+}
+
+void GpuCuller::setObjects(const std::vector<RenderObject> &objects)
+{
+  objectCount = (unsigned int)std::min(objects.size(), (size_t)maxObjects);
+  std::vector<glm::vec4> bounds(objectCount * 2);
+  std::vector<glm::mat4> models(objectCount);
+  for (unsigned int i = 0; i < objectCount; i++)
+  {
+    bounds[i * 2] = glm::vec4(objects[i].bounds.center(), 0.0f);
+    bounds[i * 2 + 1] = glm::vec4(objects[i].bounds.extent(), 0.0f);
+    models[i] = objects[i].model;
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, boundsBuffer);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, bounds.size() * sizeof(glm::vec4),
+                  bounds.data());
+  glBindBuffer(GL_ARRAY_BUFFER, modelBuffer);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, models.size() * sizeof(glm::mat4),
+                  models.data());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GpuCuller::cullWithCompute(const glm::vec4 planes[6])
+{
+  // the counter starts every frame at zero
+  DrawElementsIndirectCommand command = {indexCount, 0, 0, 0, 0};
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+  glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(command), &command);
+
+  cullCompute->use();
+  glUniform4fv(glGetUniformLocation(cullCompute->ID, "planes"), 6,
+               &planes[0].x);
+  glUniform1ui(glGetUniformLocation(cullCompute->ID, "objectCount"),
+               objectCount);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, boundsBuffer);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, visibleBuffer);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, commandBuffer);
+  glDispatchCompute((objectCount + 63) / 64, 1, 1);
+  // the draw reads the command and, through a buffer texture, the list
+  glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+void GpuCuller::cullWithTransformFeedback(const glm::vec4 planes[6])
+{
+  int framebuffer, viewport[4];
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  bool depthTest = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+
+  // compact the visible indices and count them in the same pass
+  glBindFramebuffer(GL_FRAMEBUFFER, counterFBO);
+  glViewport(0, 0, 1, 1);
+  const float zero[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  glClearBufferfv(GL_COLOR, 0, zero);
+  glDisable(GL_DEPTH_TEST);
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_ONE, GL_ONE);
+  cullPoints.use();
+  glUniform4fv(glGetUniformLocation(cullPoints.ID, "planes"), 6,
+               &planes[0].x);
+  glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, visibleBuffer);
+  glBindVertexArray(pointsVAO);
+  glBeginTransformFeedback(GL_POINTS);
+  glDrawArrays(GL_POINTS, 0, objectCount);
+  glEndTransformFeedback();
+  glDisable(GL_BLEND);
+  // the copy samples the counter, which must not be attached to the
+  // framebuffer it runs with, even with the rasterizer discarding
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+  if (GLAD_GL_ARB_draw_indirect)
+  {
+    // one more point copies the count into the draw command's
+    // instanceCount, 4 bytes into the buffer
+    glEnable(GL_RASTERIZER_DISCARD);
+    copyCount.use();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, counterTexture);
+    glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, commandBuffer,
+                      sizeof(unsigned int), sizeof(unsigned int));
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, 1);
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+  }
+  glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+  glBindVertexArray(0);
+  if (depthTest)
+    glEnable(GL_DEPTH_TEST);
+}
+
+void GpuCuller::render(const glm::mat4 &viewProjection)
+{
+  if (objectCount == 0)
+    return;
+  Frustum frustum(viewProjection);
+  if (useCompute && computeAvailable)
+    cullWithCompute(frustum.planes);
+  else
+    cullWithTransformFeedback(frustum.planes);
+
+  drawShader.use();
+  drawShader.setMat4("viewProjection", viewProjection);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_BUFFER, modelTexture);
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_BUFFER, visibleTexture);
+  glActiveTexture(GL_TEXTURE0);
+  glBindVertexArray(VAO);
+  if (GLAD_GL_ARB_draw_indirect)
+  {
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  }
+  else
+  {
+    glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0,
+                            readVisibleCount());
+  }
+  glBindVertexArray(0);
+}
+
+unsigned int GpuCuller::readVisibleCount()
+{
+  if (useCompute && computeAvailable)
+  {
+    DrawElementsIndirectCommand command;
+    glBindBuffer(GL_ARRAY_BUFFER, commandBuffer);
+    glGetBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(command), &command);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return command.instanceCount;
+  }
+  int framebuffer;
+  glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &framebuffer);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, counterFBO);
+  float count = 0.0f;
+  glReadPixels(0, 0, 1, 1, GL_RED, GL_FLOAT, &count);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+  return (unsigned int)(count + 0.5f);
+}
@@ -0,0 +1,105 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_GPUCULLING_H
+#define COORDINATESPACE_GPUCULLING_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "renderobject.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * GPU driven culling
+ *  Frustum culling on the CPU costs time for every object, every frame,
+ *  and so does building the list of draws from the result. Here the object
+ *  bounds and model matrices stay in GPU buffers and the GPU does both:
+ *
+ *   - with compute shaders (GL 4.3) one invocation per object tests its
+ *     box against the frustum planes and appends the object's index to the
+ *     visible list with an atomic counter. That counter is the
+ *     instanceCount of an indirect draw command living in a buffer.
+ *
+ *   - on GL 3.3 the objects are drawn as points; the geometry shader only
+ *     emits the visible ones, transform feedback writes their indices out
+ *     packed one after the other. The same points are rasterized into a
+ *     1x1 float target with additive blending, which counts them. A second
+ *     one-point transform feedback pass copies that count into the indirect
+ *     command (a float target counts exactly up to 2^24 objects).
+ *
+ *  Either way the mesh is then drawn once with glDrawElementsIndirect: the
+ *  vertex shader takes the object index from the visible list with
+ *  gl_InstanceID and reads the object's model matrix from a buffer
+ *  texture. The CPU only sets six planes and issues a constant handful of
+ *  calls, however many objects there are; nothing is read back.
+ *
+ *  Indirect draws need ARB_draw_indirect (GL 4.0). Without it the count is
+ *  read back from the 1x1 target, which stalls until culling finished.
+ *
+ *  A GpuCuller handles instances of one mesh (all objects passed to
+ *  setObjects() are drawn with the culler's VAO).
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class GpuCuller
+{
+public:
+  // starts true when compute shaders are available, can be switched off
+  // to use the transform feedback path
+  bool useCompute;
+
+  GpuCuller(unsigned int VAO, unsigned int indexCount,
+            unsigned int maxObjects);
+  ~GpuCuller();
+  GpuCuller(const GpuCuller &) = delete;
+  GpuCuller &operator=(const GpuCuller &) = delete;
+
+  bool computeSupported() const;
+  // upload bounds and model matrices, only needed when they change
+  void setObjects(const std::vector<RenderObject> &objects);
+  // cull against the frustum and draw the visible instances
+  void render(const glm::mat4 &viewProjection);
+  // reads the number of visible objects back, this waits for the GPU so
+  // it's meant for tests and statistics only
+  unsigned int readVisibleCount();
+
+private:
+  struct DrawElementsIndirectCommand
+  {
+    unsigned int count;
+    unsigned int instanceCount;
+    unsigned int firstIndex;
+    int baseVertex;
+    unsigned int baseInstance;
+  };
+
+  unsigned int VAO;
+  unsigned int indexCount;
+  unsigned int maxObjects;
+  unsigned int objectCount;
+  bool computeAvailable;
+
+  unsigned int boundsBuffer;
+  unsigned int modelBuffer;
+  unsigned int modelTexture;
+  unsigned int visibleBuffer;
+  unsigned int visibleTexture;
+  unsigned int commandBuffer;
+
+  // transform feedback path
+  unsigned int pointsVAO;
+  unsigned int counterTexture;
+  unsigned int counterFBO;
+
+  Shader* cullCompute;
+  Shader cullPoints;
+  Shader copyCount;
+  Shader drawShader;
+
+  void cullWithCompute(const glm::vec4 planes[6]);
+  void cullWithTransformFeedback(const glm::vec4 planes[6]);
+};
+#endif //COORDINATESPACE_GPUCULLING_H
@@ -0,0 +1,209 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "gpuparticles.h"
+
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+namespace
+{
+  // layout of the Emitters uniform block, std140 arrays of vec4/ivec4 have
+  // a 16 byte stride so this matches the GLSL side byte for byte
+  struct EmitterBlock
+  {
+    glm::vec4 positionRadius[GpuParticleSystem::MAX_EMITTERS];
+    glm::vec4 directionSpeed[GpuParticleSystem::MAX_EMITTERS];
+    glm::vec4 spreadLifetime[GpuParticleSystem::MAX_EMITTERS];
+    glm::ivec4 spawnEnd[GpuParticleSystem::MAX_EMITTERS];
+    glm::ivec4 spawn;
+  };
+
+  // a particle slot: position and age, velocity and lifetime
+  const int PARTICLE_STRIDE = 8 * sizeof(float);
+}
+
+GpuParticleSystem::GpuParticleSystem(unsigned int capacity)
+  : gravity(0.0f, -9.81f, 0.0f), drag(0.1f), particleSize(0.05f),
+    color(1.0f, 0.6f, 0.2f), capacity(std::max(capacity, 1u)), current(0),
+    spawnCursor(0), spawnedLastFrame(0), frame(0),
+    updateShader("shaders/particleupdatevs.txt",
+                 std::vector<const char*>{"outPositionAge",
+                                          "outVelocityLifetime"}),
+    renderShader("shaders/particlevs.txt", "shaders/particlefs.txt")
+{
+  // every slot starts out dead: age 1, lifetime 0
+  std::vector<float> initial((size_t)this->capacity * 8, 0.0f);
+  for (size_t i = 0; i < this->capacity; i++)
+    initial[i * 8 + 3] = 1.0f;
+
+  float corners[] = {
+          -1.0f, -1.0f,
+          1.0f, -1.0f,
+          -1.0f,  1.0f,
+          1.0f,  1.0f
+  };
+  glGenBuffers(1, &quadVBO);
+  glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+
+  glGenBuffers(2, particleBuffers);
+  glGenVertexArrays(2, updateVAO);
+  glGenVertexArrays(2, renderVAO);
+  for (int i = 0; i < 2; i++)
+  {
+    glBindBuffer(GL_ARRAY_BUFFER, particleBuffers[i]);
+    glBufferData(GL_ARRAY_BUFFER, initial.size() * sizeof(float),
+                 initial.data(), GL_DYNAMIC_COPY);
+
+    // update pass: one point per particle
+    glBindVertexArray(updateVAO[i]);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, PARTICLE_STRIDE, (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, PARTICLE_STRIDE,
+                          (void*)(4 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // render pass: a quad per particle, the particle advances per instance
+    glBindVertexArray(renderVAO[i]);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float),
+                          (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, particleBuffers[i]);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, PARTICLE_STRIDE, (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, PARTICLE_STRIDE,
+                          (void*)(4 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+  }
+  glBindVertexArray(0);
+
+  glGenBuffers(1, &emitterUBO);
+  glBindBuffer(GL_UNIFORM_BUFFER, emitterUBO);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(EmitterBlock), NULL, GL_STREAM_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  unsigned int blockIndex = glGetUniformBlockIndex(updateShader.ID,
+                                                   "Emitters");
+  glUniformBlockBinding(updateShader.ID, blockIndex, 0);
+}
+
+GpuParticleSystem::~GpuParticleSystem()
+{
+  glDeleteVertexArrays(2, updateVAO);
+  glDeleteVertexArrays(2, renderVAO);
+  glDeleteBuffers(2, particleBuffers);
+  glDeleteBuffers(1, &quadVBO);
+  glDeleteBuffers(1, &emitterUBO);
+  glDeleteProgram(updateShader.ID);
+  glDeleteProgram(renderShader.ID);
+}
+
+void GpuParticleSystem::update(float deltaTime)
+{
+  // hand every emitter its share of the next slots after the cursor
+  EmitterBlock block;
+  int emitterCount = std::min((int)emitters.size(), (int)MAX_EMITTERS);
+  unsigned int spawnCount = 0;
+  for (int e = 0; e < emitterCount; e++)
+  {
+    ParticleEmitter &emitter = emitters[e];
+    emitter.accumulator += emitter.rate * deltaTime;
+    unsigned int count = (unsigned int)emitter.accumulator;
+    emitter.accumulator -= (float)count;
+    count = std::min(count, capacity - spawnCount);
+    spawnCount += count;
+
+    block.positionRadius[e] = glm::vec4(emitter.position, emitter.radius);
+    block.directionSpeed[e] = glm::vec4(glm::normalize(emitter.direction),
+                                        emitter.speed);
+    block.spreadLifetime[e] = glm::vec4(emitter.spread, emitter.lifetime,
+                                        emitter.lifetimeJitter, 0.0f);
+    block.spawnEnd[e] = glm::ivec4((int)spawnCount, 0, 0, 0);
+  }
+  block.spawn = glm::ivec4((int)spawnCursor, (int)spawnCount, (int)capacity,
+                           emitterCount);
+  spawnCursor = (spawnCursor + spawnCount) % capacity;
+  spawnedLastFrame = spawnCount;
+
+  // only the used part of the block goes over the bus, the tail with the
+  // spawn range is always needed
+  glBindBuffer(GL_UNIFORM_BUFFER, emitterUBO);
+  size_t arrayBytes = sizeof(glm::vec4) * MAX_EMITTERS;
+  size_t usedBytes = sizeof(glm::vec4) * emitterCount;
+  for (int a = 0; a < 4; a++)
+    glBufferSubData(GL_UNIFORM_BUFFER, a * arrayBytes, usedBytes,
+                    (const char*)&block + a * arrayBytes);
+  glBufferSubData(GL_UNIFORM_BUFFER, offsetof(EmitterBlock, spawn),
+                  sizeof(glm::ivec4), &block.spawn);
+  glBindBufferBase(GL_UNIFORM_BUFFER, 0, emitterUBO);
+
+  updateTimer.begin();
+  updateShader.use();
+  updateShader.setFloat("deltaTime", deltaTime);
+  updateShader.setVec3("gravity", gravity);
+  updateShader.setFloat("drag", drag);
+  updateShader.setInt("seed", (int)frame++);
+
+  int next = 1 - current;
+  glEnable(GL_RASTERIZER_DISCARD);
+  glBindVertexArray(updateVAO[current]);
+  glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, particleBuffers[next]);
+  glBeginTransformFeedback(GL_POINTS);
+  glDrawArrays(GL_POINTS, 0, (GLsizei)capacity);
+  glEndTransformFeedback();
+  glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+  glBindVertexArray(0);
+  glDisable(GL_RASTERIZER_DISCARD);
+  updateTimer.end();
+
+  current = next;
+}
+
+void GpuParticleSystem::render(const glm::mat4 &view,
+                               const glm::mat4 &projection)
+{
+  renderTimer.begin();
+  renderShader.use();
+  renderShader.setMat4("view", view);
+  renderShader.setMat4("projection", projection);
+  renderShader.setFloat("particleSize", particleSize);
+  renderShader.setVec3("color", color);
+
+  // additive, so the order particles are drawn in doesn't matter and they
+  // don't have to be sorted
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_ONE, GL_ONE);
+  glDepthMask(GL_FALSE);
+  glBindVertexArray(renderVAO[current]);
+  glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)capacity);
+  glBindVertexArray(0);
+  glDepthMask(GL_TRUE);
+  glDisable(GL_BLEND);
+  renderTimer.end();
+}
+
+unsigned int GpuParticleSystem::getCapacity() const
+{
+  return capacity;
+}
+
+unsigned int GpuParticleSystem::getSpawnedLastFrame() const
+{
+  return spawnedLastFrame;
+}
+
+double GpuParticleSystem::updateMilliseconds()
+{
+  return updateTimer.milliseconds();
+}
+
+double GpuParticleSystem::renderMilliseconds()
+{
+  return renderTimer.milliseconds();
+}
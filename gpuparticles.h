@@ -0,0 +1,104 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_GPUPARTICLES_H
+#define COORDINATESPACE_GPUPARTICLES_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "gputimer.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * GPU particles
+ *  Moving particles on the CPU means touching every particle every frame
+ *  and uploading all of them again afterwards, which caps out at a few tens
+ *  of thousands. Here the particle state never leaves the GPU.
+ *
+ *  Transform feedback lets a vertex shader write its outputs into a buffer
+ *  instead of (or before) rasterizing them. The update pass draws the
+ *  particle buffer as points with GL_RASTERIZER_DISCARD enabled; the vertex
+ *  shader integrates one particle and its outputs are captured into a second
+ *  buffer. The next frame reads from that one and writes the first again
+ *  (ping-pong), a buffer can't be read and captured at the same time.
+ *
+ *  The buffer is a fixed pool of slots. Every frame the emitters claim the
+ *  next run of slots after a ring cursor and the update shader respawns the
+ *  particles in those slots from the emitter parameters, which are the only
+ *  thing uploaded per frame (a small uniform block). Particles that
+ *  outlived their lifetime just sit in their slot until the cursor comes
+ *  around again; the CPU never has to know how many are alive, so nothing
+ *  is ever read back.
+ *
+ *  Rendering draws one camera facing quad per slot with instancing, the
+ *  particle buffer is bound as a per-instance attribute stream and dead
+ *  particles collapse to a degenerate quad in the vertex shader.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+struct ParticleEmitter
+{
+  glm::vec3 position;
+  // particles spawn inside a sphere of this radius around position
+  float radius;
+  glm::vec3 direction;
+  float speed;
+  // 0 emits along direction, 1 scatters in every direction
+  float spread;
+  float lifetime;
+  // +- random variation on lifetime
+  float lifetimeJitter;
+  // particles per second
+  float rate;
+  // fractional particles carried over to the next frame
+  float accumulator;
+};
+
+class GpuParticleSystem
+{
+public:
+  static const int MAX_EMITTERS = 16;
+
+  glm::vec3 gravity;
+  float drag;
+  float particleSize;
+  glm::vec3 color;
+  std::vector<ParticleEmitter> emitters;
+
+  explicit GpuParticleSystem(unsigned int capacity);
+  ~GpuParticleSystem();
+  GpuParticleSystem(const GpuParticleSystem &) = delete;
+  GpuParticleSystem &operator=(const GpuParticleSystem &) = delete;
+
+  // spawn from the emitters and advance every particle by deltaTime
+  void update(float deltaTime);
+  // additive camera facing quads into the bound framebuffer
+  void render(const glm::mat4 &view, const glm::mat4 &projection);
+
+  unsigned int getCapacity() const;
+  // particles spawned by the last update
+  unsigned int getSpawnedLastFrame() const;
+  double updateMilliseconds();
+  double renderMilliseconds();
+
+private:
+  unsigned int capacity;
+  unsigned int particleBuffers[2];
+  unsigned int updateVAO[2];
+  unsigned int renderVAO[2];
+  unsigned int quadVBO;
+  unsigned int emitterUBO;
+  // the buffer holding the latest particle state
+  int current;
+  unsigned int spawnCursor;
+  unsigned int spawnedLastFrame;
+  unsigned int frame;
+  Shader updateShader;
+  Shader renderShader;
+  GpuTimer updateTimer;
+  GpuTimer renderTimer;
+};
+#endif //COORDINATESPACE_GPUPARTICLES_H
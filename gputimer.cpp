@@ -0,0 +1,148 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "gputimer.h"
+
+GpuTimer::GpuTimer()
+  : current(0), active(false), passCount(0), lastPass(0), unread(false),
+    lastMilliseconds(-1.0)
+{
+  for (int i = 0; i < LATENCY; i++)
+  {
+    glGenQueries(2, queries[i]);
+    slotPass[i] = 0;
+    pending[i] = false;
+  }
+}
+
+GpuTimer::~GpuTimer()
+{
+  for (int i = 0; i < LATENCY; i++)
+    glDeleteQueries(2, queries[i]);
+}
+
+void GpuTimer::begin()
+{
+  collect();
+  unsigned int pass = passCount++;
+  // every query pair is still in flight; skip this sample rather than
+  // waiting on the GPU
+  if (pending[current])
+    return;
+  slotPass[current] = pass;
+  glQueryCounter(queries[current][0], GL_TIMESTAMP);
+  active = true;
+}
+
+void GpuTimer::end()
+{
+  if (!active)
+    return;
+  glQueryCounter(queries[current][1], GL_TIMESTAMP);
+  pending[current] = true;
+  active = false;
+  current = (current + 1) % LATENCY;
+}
+
+double GpuTimer::milliseconds()
+{
+  collect();
+  return lastMilliseconds;
+}
+
+bool GpuTimer::newMilliseconds(double &milliseconds, unsigned int &pass)
+{
+  collect();
+  if (!unread)
+    return false;
+  unread = false;
+  milliseconds = lastMilliseconds;
+  pass = lastPass;
+  return true;
+}
+
+unsigned int GpuTimer::passes() const
+{
+  return passCount;
+}
+
+void GpuTimer::collect()
+{
+  // walk the ring from the oldest slot so lastMilliseconds ends up holding
+  // the newest finished pair
+  for (int n = 0; n < LATENCY; n++)
+  {
+    int i = (current + n) % LATENCY;
+    if (!pending[i])
+      continue;
+    GLint available = 0;
+    glGetQueryObjectiv(queries[i][1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+      continue;
+    GLuint64 start = 0, stop = 0;
+    glGetQueryObjectui64v(queries[i][0], GL_QUERY_RESULT, &start);
+    glGetQueryObjectui64v(queries[i][1], GL_QUERY_RESULT, &stop);
+    lastMilliseconds = (double)(stop - start) / 1000000.0;
+    lastPass = slotPass[i];
+    unread = true;
+    pending[i] = false;
+  }
+}
+
+SampleCounter::SampleCounter()
+  : current(0), active(false), lastSamples(-1)
+{
+  glGenQueries(LATENCY, queries);
+  for (int i = 0; i < LATENCY; i++)
+    pending[i] = false;
+}
+
+SampleCounter::~SampleCounter()
+{
+  glDeleteQueries(LATENCY, queries);
+}
+
+void SampleCounter::begin()
+{
+  collect();
+  if (pending[current])
+    return;
+  glBeginQuery(GL_SAMPLES_PASSED, queries[current]);
+  active = true;
+}
+
+void SampleCounter::end()
+{
+  if (!active)
+    return;
+  glEndQuery(GL_SAMPLES_PASSED);
+  pending[current] = true;
+  active = false;
+  current = (current + 1) % LATENCY;
+}
+
+long long SampleCounter::samples()
+{
+  collect();
+  return lastSamples;
+}
+
+void SampleCounter::collect()
+{
+  for (int n = 0; n < LATENCY; n++)
+  {
+    int i = (current + n) % LATENCY;
+    if (!pending[i])
+      continue;
+    GLint available = 0;
+    glGetQueryObjectiv(queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+      continue;
+    GLuint64 count = 0;
+    glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &count);
+    lastSamples = (long long)count;
+    pending[i] = false;
+  }
+}
@@ -0,0 +1,91 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_GPUTIMER_H
+#define COORDINATESPACE_GPUTIMER_H
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Measuring how long the GPU spends on a pass can't be done with a CPU
+ * clock, the draw calls return long before the GPU has executed them. GL
+ * 3.3 gives us timer queries for this: glQueryCounter(GL_TIMESTAMP) records
+ * the GPU clock once every command issued before it has finished.
+ *
+ * We bracket a pass with two timestamps instead of a GL_TIME_ELAPSED query
+ * because elapsed-time queries can't be nested, timestamps can. The results
+ * only become available a frame or two later, so each timer keeps a small
+ * ring of query pairs and only ever reads pairs that are already done;
+ * asking for a result never stalls the pipeline.
+ *
+ * A SampleCounter works the same way with GL_SAMPLES_PASSED occlusion
+ * queries: it counts the samples that passed the depth test while it was
+ * active, which is how many fragments a pass actually shaded.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class GpuTimer
+{
+public:
+  // query pairs in the ring, a pass is read back at most this many passes
+  // after it began
+  static const int LATENCY = 4;
+
+  GpuTimer();
+  ~GpuTimer();
+  GpuTimer(const GpuTimer &) = delete;
+  GpuTimer &operator=(const GpuTimer &) = delete;
+
+  // record the start/end timestamps of a pass
+  void begin();
+  void end();
+  // GPU time of the most recent finished pass in milliseconds, -1 if none
+  // has finished yet
+  double milliseconds();
+  // the same, but each finished pass only once: false when none finished
+  // since the last call. pass is the number of the begin() that started it
+  bool newMilliseconds(double &milliseconds, unsigned int &pass);
+  // begin() calls so far, including the ones skipped on a full ring
+  unsigned int passes() const;
+
+private:
+  unsigned int queries[LATENCY][2];
+  unsigned int slotPass[LATENCY];
+  bool pending[LATENCY];
+  int current;
+  bool active;
+  unsigned int passCount;
+  unsigned int lastPass;
+  bool unread;
+  double lastMilliseconds;
+
+  void collect();
+};
+
+class SampleCounter
+{
+public:
+  SampleCounter();
+  ~SampleCounter();
+  SampleCounter(const SampleCounter &) = delete;
+  SampleCounter &operator=(const SampleCounter &) = delete;
+
+  // count the samples passing between these two calls, occlusion queries
+  // can't be nested so only one counter may be active at a time
+  void begin();
+  void end();
+  // samples of the most recent finished pass, -1 if none has finished yet
+  long long samples();
+
+private:
+  static const int LATENCY = 4;
+
+  unsigned int queries[LATENCY];
+  bool pending[LATENCY];
+  int current;
+  bool active;
+  long long lastSamples;
+
+  void collect();
+};
+#endif //COORDINATESPACE_GPUTIMER_H
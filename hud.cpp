@@ -0,0 +1,429 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "hud.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+  // 5x7 glyphs for ' ' to '~', one byte per row from the top, bit 4 is the
+  // leftmost pixel
+  const unsigned char FONT[95][7] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // space
+    {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04}, // !
+    {0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00}, // "
+    {0x0a, 0x0a, 0x1f, 0x0a, 0x1f, 0x0a, 0x0a}, // #
+    {0x04, 0x0f, 0x14, 0x0e, 0x05, 0x1e, 0x04}, // $
+    {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}, // %
+    {0x0c, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0d}, // &
+    {0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00}, // '
+    {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}, // (
+    {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}, // )
+    {0x00, 0x04, 0x15, 0x0e, 0x15, 0x04, 0x00}, // *
+    {0x00, 0x04, 0x04, 0x1f, 0x04, 0x04, 0x00}, // +
+    {0x00, 0x00, 0x00, 0x00, 0x0c, 0x04, 0x08}, // ,
+    {0x00, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x00}, // -
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x0c}, // .
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}, // /
+    {0x0e, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0e}, // 0
+    {0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0e}, // 1
+    {0x0e, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1f}, // 2
+    {0x1f, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0e}, // 3
+    {0x02, 0x06, 0x0a, 0x12, 0x1f, 0x02, 0x02}, // 4
+    {0x1f, 0x10, 0x1e, 0x01, 0x01, 0x11, 0x0e}, // 5
+    {0x06, 0x08, 0x10, 0x1e, 0x11, 0x11, 0x0e}, // 6
+    {0x1f, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, // 7
+    {0x0e, 0x11, 0x11, 0x0e, 0x11, 0x11, 0x0e}, // 8
+    {0x0e, 0x11, 0x11, 0x0f, 0x01, 0x02, 0x0c}, // 9
+    {0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x0c, 0x00}, // :
+    {0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x04, 0x08}, // ;
+    {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02}, // <
+    {0x00, 0x00, 0x1f, 0x00, 0x1f, 0x00, 0x00}, // =
+    {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08}, // >
+    {0x0e, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04}, // ?
+    {0x0e, 0x11, 0x01, 0x0d, 0x15, 0x15, 0x0e}, // @
+    {0x0e, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11}, // A
+    {0x1e, 0x11, 0x11, 0x1e, 0x11, 0x11, 0x1e}, // B
+    {0x0e, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0e}, // C
+    {0x1c, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1c}, // D
+    {0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x1f}, // E
+    {0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x10}, // F
+    {0x0e, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0f}, // G
+    {0x11, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11}, // H
+    {0x0e, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e}, // I
+    {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0c}, // J
+    {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, // K
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1f}, // L
+    {0x11, 0x1b, 0x15, 0x15, 0x11, 0x11, 0x11}, // M
+    {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, // N
+    {0x0e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e}, // O
+    {0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10, 0x10}, // P
+    {0x0e, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0d}, // Q
+    {0x1e, 0x11, 0x11, 0x1e, 0x14, 0x12, 0x11}, // R
+    {0x0f, 0x10, 0x10, 0x0e, 0x01, 0x01, 0x1e}, // S
+    {0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // T
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e}, // U
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x0a, 0x04}, // V
+    {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0a}, // W
+    {0x11, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x11}, // X
+    {0x11, 0x11, 0x0a, 0x04, 0x04, 0x04, 0x04}, // Y
+    {0x1f, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1f}, // Z
+    {0x07, 0x04, 0x04, 0x04, 0x04, 0x04, 0x07}, // [
+    {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00}, // backslash
+    {0x1c, 0x04, 0x04, 0x04, 0x04, 0x04, 0x1c}, // ]
+    {0x04, 0x0a, 0x11, 0x00, 0x00, 0x00, 0x00}, // ^
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f}, // _
+    {0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00}, // `
+    {0x00, 0x00, 0x0e, 0x01, 0x0f, 0x11, 0x0f}, // a
+    {0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1e}, // b
+    {0x00, 0x00, 0x0e, 0x10, 0x10, 0x11, 0x0e}, // c
+    {0x01, 0x01, 0x0d, 0x13, 0x11, 0x11, 0x0f}, // d
+    {0x00, 0x00, 0x0e, 0x11, 0x1f, 0x10, 0x0e}, // e
+    {0x06, 0x09, 0x08, 0x1c, 0x08, 0x08, 0x08}, // f
+    {0x00, 0x0f, 0x11, 0x11, 0x0f, 0x01, 0x0e}, // g
+    {0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11}, // h
+    {0x04, 0x00, 0x0c, 0x04, 0x04, 0x04, 0x0e}, // i
+    {0x02, 0x00, 0x06, 0x02, 0x02, 0x12, 0x0c}, // j
+    {0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12}, // k
+    {0x0c, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e}, // l
+    {0x00, 0x00, 0x1a, 0x15, 0x15, 0x11, 0x11}, // m
+    {0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11}, // n
+    {0x00, 0x00, 0x0e, 0x11, 0x11, 0x11, 0x0e}, // o
+    {0x00, 0x00, 0x1e, 0x11, 0x1e, 0x10, 0x10}, // p
+    {0x00, 0x00, 0x0d, 0x13, 0x0f, 0x01, 0x01}, // q
+    {0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10}, // r
+    {0x00, 0x00, 0x0e, 0x10, 0x0e, 0x01, 0x1e}, // s
+    {0x08, 0x08, 0x1c, 0x08, 0x08, 0x09, 0x06}, // t
+    {0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0d}, // u
+    {0x00, 0x00, 0x11, 0x11, 0x11, 0x0a, 0x04}, // v
+    {0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0a}, // w
+    {0x00, 0x00, 0x11, 0x0a, 0x04, 0x0a, 0x11}, // x
+    {0x00, 0x00, 0x11, 0x11, 0x0f, 0x01, 0x0e}, // y
+    {0x00, 0x00, 0x1f, 0x02, 0x04, 0x08, 0x1f}, // z
+    {0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02}, // {
+    {0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // |
+    {0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08}, // }
+    {0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00}, // ~
+  };
+
+  const int FIRST_CHAR = 32;
+  const int GLYPH_WIDTH = 5;
+  const int GLYPH_HEIGHT = 7;
+  // atlas layout: 16 x 6 cells of 8 x 8 texels, the last cell is white
+  const int CELL = 8;
+  const int ATLAS_COLUMNS = 16;
+  const int ATLAS_WIDTH = ATLAS_COLUMNS * CELL;
+  const int ATLAS_HEIGHT = 6 * CELL;
+  const int WHITE_CELL = 95;
+
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+}
+
+HudOverlay::HudOverlay(unsigned int maxQuads)
+  : enabled(true), scale(2.0f),
+    maxQuads(std::min(maxQuads, 16384u)),
+    shader("shaders/hudvs.txt", "shaders/hudfs.txt"), width(1), height(1), ringOffset(0),
+    beginTime(0.0), lastCpuMilliseconds(0.0)
+{
+  vertices.reserve(this->maxQuads * 4);
+
+  // bake the font into the atlas
+  std::vector<unsigned char> pixels(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+  for (int glyph = 0; glyph < 95; glyph++)
+  {
+    int cellX = glyph % ATLAS_COLUMNS * CELL;
+    int cellY = glyph / ATLAS_COLUMNS * CELL;
+    for (int row = 0; row < GLYPH_HEIGHT; row++)
+      for (int col = 0; col < GLYPH_WIDTH; col++)
+        if (FONT[glyph][row] & (0x10 >> col))
+          pixels[(cellY + row) * ATLAS_WIDTH + cellX + col] = 255;
+  }
+  int whiteX = WHITE_CELL % ATLAS_COLUMNS * CELL;
+  int whiteY = WHITE_CELL / ATLAS_COLUMNS * CELL;
+  for (int row = 0; row < CELL; row++)
+    for (int col = 0; col < CELL; col++)
+      pixels[(whiteY + row) * ATLAS_WIDTH + whiteX + col] = 255;
+
+  glGenTextures(1, &atlas);
+  glBindTexture(GL_TEXTURE_2D, atlas);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_RED,
+               GL_UNSIGNED_BYTE, pixels.data());
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  // nearest keeps the font pixels crisp at integer scales
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+  // the index pattern is the same for every quad, so it's built once
+  std::vector<unsigned short> indices(this->maxQuads * 6);
+  for (unsigned int q = 0; q < this->maxQuads; q++)
+  {
+    unsigned short base = (unsigned short)(q * 4);
+    unsigned short pattern[] = {0, 1, 2, 2, 3, 0};
+    for (int i = 0; i < 6; i++)
+      indices[q * 6 + i] = base + pattern[i];
+  }
+
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &VBO);
+  glGenBuffers(1, &EBO);
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glBufferData(GL_ARRAY_BUFFER, this->maxQuads * 4 * sizeof(Vertex), NULL,
+               GL_STREAM_DRAW);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                        (void*)(2 * sizeof(float)));
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex),
+                        (void*)(4 * sizeof(float)));
+  glEnableVertexAttribArray(2);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned short),
+               indices.data(), GL_STATIC_DRAW);
+  glBindVertexArray(0);
+}
+
+HudOverlay::~HudOverlay()
+{
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &VBO);
+  glDeleteBuffers(1, &EBO);
+  glDeleteTextures(1, &atlas);
+  glDeleteProgram(shader.ID);
+}
+
+void HudOverlay::begin(int width, int height)
+{
+  beginTime = now();
+  this->width = std::max(width, 1);
+  this->height = std::max(height, 1);
+  vertices.clear();
+}
+
+void HudOverlay::quad(float x, float y, float w, float h, float u, float v,
+                      float uw, float vh, const glm::vec4 &color)
+{
+  if (vertices.size() >= maxQuads * 4)
+    return;
+  Vertex vertex;
+  glm::vec4 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+  vertex.color[0] = (unsigned char)c.r;
+  vertex.color[1] = (unsigned char)c.g;
+  vertex.color[2] = (unsigned char)c.b;
+  vertex.color[3] = (unsigned char)c.a;
+
+  vertex.x = x; vertex.y = y; vertex.u = u; vertex.v = v;
+  vertices.push_back(vertex);
+  vertex.x = x + w; vertex.u = u + uw;
+  vertices.push_back(vertex);
+  vertex.y = y + h; vertex.v = v + vh;
+  vertices.push_back(vertex);
+  vertex.x = x; vertex.u = u;
+  vertices.push_back(vertex);
+}
+
+void HudOverlay::rect(float x, float y, float w, float h,
+                      const glm::vec4 &color)
+{
+  // sample the middle of the white cell
+  float u = (WHITE_CELL % ATLAS_COLUMNS * CELL + CELL * 0.5f) / ATLAS_WIDTH;
+  float v = (WHITE_CELL / ATLAS_COLUMNS * CELL + CELL * 0.5f) / ATLAS_HEIGHT;
+  quad(x, y, w, h, u, v, 0.0f, 0.0f, color);
+}
+
+float HudOverlay::text(float x, float y, const char* text,
+                       const glm::vec4 &color)
+{
+  float startX = x;
+  for (const char* c = text; *c != '\0'; c++)
+  {
+    if (*c == '\n')
+    {
+      x = startX;
+      y += lineHeight();
+      continue;
+    }
+    int glyph = (unsigned char)*c - FIRST_CHAR;
+    if (glyph < 0 || glyph >= 95)
+      glyph = '?' - FIRST_CHAR;
+    if (glyph != 0)
+    {
+      float u = (float)(glyph % ATLAS_COLUMNS * CELL) / ATLAS_WIDTH;
+      float v = (float)(glyph / ATLAS_COLUMNS * CELL) / ATLAS_HEIGHT;
+      quad(x, y, GLYPH_WIDTH * scale, GLYPH_HEIGHT * scale, u, v,
+           (float)GLYPH_WIDTH / ATLAS_WIDTH,
+           (float)GLYPH_HEIGHT / ATLAS_HEIGHT, color);
+    }
+    x += charWidth();
+  }
+  return x;
+}
+
+void HudOverlay::end()
+{
+  if (!vertices.empty())
+  {
+    // the vertex buffer is used as a ring: every frame appends behind the
+    // previous one with an unsynchronized map, so the driver never has to
+    // wait for a draw still reading the buffer. Only when the ring is full
+    // the storage is orphaned and we start over at the front.
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    unsigned int count = (unsigned int)vertices.size();
+    if (ringOffset + count > maxQuads * 4)
+    {
+      glBufferData(GL_ARRAY_BUFFER, maxQuads * 4 * sizeof(Vertex), NULL,
+                   GL_STREAM_DRAW);
+      ringOffset = 0;
+    }
+    void* mapped = glMapBufferRange(GL_ARRAY_BUFFER,
+                                    ringOffset * sizeof(Vertex),
+                                    count * sizeof(Vertex),
+                                    GL_MAP_WRITE_BIT |
+                                    GL_MAP_INVALIDATE_RANGE_BIT |
+                                    GL_MAP_UNSYNCHRONIZED_BIT);
+    std::memcpy(mapped, vertices.data(), count * sizeof(Vertex));
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+
+    shader.use();
+    shader.setMat4("projection", glm::ortho(0.0f, (float)width,
+                                            (float)height, 0.0f));
+    shader.setInt("atlas", 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, atlas);
+
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(VAO);
+    glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)(count / 4 * 6),
+                             GL_UNSIGNED_SHORT, 0, (GLint)ringOffset);
+    ringOffset += count;
+    glBindVertexArray(0);
+    glDisable(GL_BLEND);
+  }
+  lastCpuMilliseconds = now() - beginTime;
+}
+
+float HudOverlay::lineHeight() const
+{
+  return (GLYPH_HEIGHT + 3) * scale;
+}
+
+float HudOverlay::charWidth() const
+{
+  return (GLYPH_WIDTH + 1) * scale;
+}
+
+double HudOverlay::cpuMilliseconds() const
+{
+  return lastCpuMilliseconds;
+}
+
+FrameStats::FrameStats()
+  : drawCalls(0), memoryBytes(0), next(0), samples(0), timingCount(0)
+{
+  for (int i = 0; i < HISTORY; i++)
+    history[i] = 0.0;
+}
+
+void FrameStats::frame(double frameMilliseconds)
+{
+  history[next] = frameMilliseconds;
+  next = (next + 1) % HISTORY;
+  samples = std::min(samples + 1, (int)HISTORY);
+}
+
+void FrameStats::setTiming(const char* name, double milliseconds)
+{
+  for (int i = 0; i < timingCount; i++)
+  {
+    if (timingNames[i] == name)
+    {
+      timings[i] = milliseconds;
+      return;
+    }
+  }
+  if (timingCount == MAX_TIMINGS)
+    return;
+  timingNames[timingCount] = name;
+  timings[timingCount] = milliseconds;
+  timingCount++;
+}
+
+void FrameStats::draw(HudOverlay &hud, float x, float y) const
+{
+  double total = 0.0, worst = 0.0;
+  for (int i = 0; i < samples; i++)
+  {
+    total += history[i];
+    worst = std::max(worst, history[i]);
+  }
+  double average = samples > 0 ? total / samples : 0.0;
+
+  const float graphHeight = 40.0f;
+  const float barWidth = 2.0f;
+  float line = hud.lineHeight();
+  float padding = 6.0f;
+  int lines = 5 + timingCount;
+  float panelWidth = std::max(HISTORY * barWidth, 30 * hud.charWidth());
+  hud.rect(x, y, panelWidth + 2 * padding,
+           lines * line + graphHeight + 3 * padding,
+           glm::vec4(0.0f, 0.0f, 0.0f, 0.6f));
+  x += padding;
+  y += padding;
+
+  const glm::vec4 white(1.0f);
+  char buffer[96];
+  std::snprintf(buffer, sizeof(buffer), "%5.1f fps %6.2f ms",
+                average > 0.0 ? 1000.0 / average : 0.0, average);
+  hud.text(x, y, buffer, white);
+  y += line;
+  std::snprintf(buffer, sizeof(buffer), "worst %6.2f ms", worst);
+  hud.text(x, y, buffer, white);
+  y += line;
+
+  // frame time graph, oldest on the left; the full height is 33 ms
+  for (int i = 0; i < samples; i++)
+  {
+    double ms = history[(next - samples + i + HISTORY) % HISTORY];
+    float h = (float)std::min(ms / 33.3, 1.0) * graphHeight;
+    glm::vec4 color = ms < 17.0 ? glm::vec4(0.2f, 0.9f, 0.2f, 1.0f)
+                    : ms < 34.0 ? glm::vec4(0.9f, 0.8f, 0.2f, 1.0f)
+                                : glm::vec4(0.9f, 0.2f, 0.2f, 1.0f);
+    hud.rect(x + i * barWidth, y + graphHeight - h, barWidth, h, color);
+  }
+  y += graphHeight + padding;
+
+  for (int i = 0; i < timingCount; i++)
+  {
+    std::snprintf(buffer, sizeof(buffer), "%-18.18s %6.3f ms",
+                  timingNames[i], timings[i]);
+    hud.text(x, y, buffer, white);
+    y += line;
+  }
+  std::snprintf(buffer, sizeof(buffer), "draw calls %u", drawCalls);
+  hud.text(x, y, buffer, white);
+  y += line;
+  std::snprintf(buffer, sizeof(buffer), "memory %.1f MiB",
+                memoryBytes / (1024.0 * 1024.0));
+  hud.text(x, y, buffer, white);
+  y += line;
+  std::snprintf(buffer, sizeof(buffer), "hud %.3f ms", hud.cpuMilliseconds());
+  hud.text(x, y, buffer, glm::vec4(0.7f, 0.7f, 0.7f, 1.0f));
+}
@@ -0,0 +1,115 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_HUD_H
+#define COORDINATESPACE_HUD_H
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * HUD overlay
+ *  2D text and rectangles drawn on top of the scene in screen pixels. This
+ *  is where the orthographic projection from the notes in main.cpp comes
+ *  in: glm::ortho maps (0, 0)-(width, height) straight onto the window. We
+ *  swap bottom and top so y grows downwards, which is how lines of text
+ *  are laid out.
+ *
+ *  All glyphs of a small built-in 5x7 pixel font are packed into a single
+ *  texture (the glyph atlas), together with one solid white cell for
+ *  rectangles. Every character or rectangle is a quad into that atlas, so
+ *  the whole overlay needs one texture, one vertex buffer and one draw
+ *  call. The quads are collected on the CPU between begin() and end() and
+ *  end() streams them into the vertex buffer and draws them.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class HudOverlay
+{
+public:
+  bool enabled;
+  // size of a font pixel in screen pixels
+  float scale;
+
+  explicit HudOverlay(unsigned int maxQuads = 8192);
+  ~HudOverlay();
+  HudOverlay(const HudOverlay &) = delete;
+  HudOverlay &operator=(const HudOverlay &) = delete;
+
+  void begin(int width, int height);
+  void rect(float x, float y, float w, float h, const glm::vec4 &color);
+  // draws text with its top left corner at x, y; '\n' starts a new line.
+  // Returns the x coordinate after the last character.
+  float text(float x, float y, const char* text, const glm::vec4 &color);
+  // upload and draw everything since begin() in a single draw call
+  void end();
+
+  float lineHeight() const;
+  float charWidth() const;
+  // CPU time spent from the last begin() to the end of its end()
+  double cpuMilliseconds() const;
+
+private:
+  struct Vertex
+  {
+    float x, y;
+    float u, v;
+    unsigned char color[4];
+  };
+
+  unsigned int maxQuads;
+  std::vector<Vertex> vertices;
+  unsigned int VAO;
+  unsigned int VBO;
+  unsigned int EBO;
+  unsigned int atlas;
+  Shader shader;
+  int width;
+  int height;
+  // first free vertex in the streaming ring
+  unsigned int ringOffset;
+  double beginTime;
+  double lastCpuMilliseconds;
+
+  void quad(float x, float y, float w, float h, float u, float v, float uw,
+            float vh, const glm::vec4 &color);
+};
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Collects the numbers shown on the stats panel: a history of frame times,
+ * named GPU (or CPU) pass timings and whatever counters the renderer fills
+ * in each frame.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class FrameStats
+{
+public:
+  static const int HISTORY = 120;
+  static const int MAX_TIMINGS = 16;
+
+  unsigned int drawCalls;
+  size_t memoryBytes;
+
+  FrameStats();
+
+  void frame(double frameMilliseconds);
+  // name has to stay valid, timings are drawn in the order first set
+  void setTiming(const char* name, double milliseconds);
+  void draw(HudOverlay &hud, float x, float y) const;
+
+private:
+  double history[HISTORY];
+  int next;
+  int samples;
+  const char* timingNames[MAX_TIMINGS];
+  double timings[MAX_TIMINGS];
+  int timingCount;
+};
+#endif //COORDINATESPACE_HUD_H
@@ -0,0 +1,340 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "impostor.h"
+#include "frustum.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+
+  // must match octahedralDecode() in impostorvs.txt
+  glm::vec3 octahedralDecode(glm::vec2 uv)
+  {
+    glm::vec2 p = uv * 2.0f - 1.0f;
+    glm::vec3 d(p, 1.0f - std::fabs(p.x) - std::fabs(p.y));
+    if (d.z < 0.0f)
+    {
+      glm::vec2 folded = (1.0f - glm::abs(glm::vec2(d.y, d.x))) *
+                         glm::vec2(d.x >= 0.0f ? 1.0f : -1.0f,
+                                   d.y >= 0.0f ? 1.0f : -1.0f);
+      d.x = folded.x;
+      d.y = folded.y;
+    }
+    return glm::normalize(d);
+  }
+}
+
+ImpostorRenderer::ImpostorRenderer()
+  : framesPerSide(8), frameSize(128), thresholdPixels(48.0f),
+    viewProjection(1.0f), cameraPosition(0.0f),
+    bakeShader("shaders/impostorbakevs.txt", "shaders/impostorbakefs.txt"),
+    shader("shaders/impostorvs.txt", "shaders/impostorfs.txt"),
+    instanceCapacity(0), draws(0), bakeTime(0.0)
+{
+  // the quad comes from gl_VertexID, the instance matrices from a buffer
+  // that's re-pointed for every impostor's range
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &instanceBuffer);
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+  for (int column = 0; column < 4; column++)
+  {
+    glEnableVertexAttribArray(1 + column);
+    glVertexAttribDivisor(1 + column, 1);
+  }
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+ImpostorRenderer::~ImpostorRenderer()
+{
+  for (const Impostor &impostor : impostors)
+  {
+    glDeleteTextures(1, &impostor.color);
+    glDeleteTextures(1, &impostor.normalDepth);
+  }
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &instanceBuffer);
+  glDeleteProgram(bakeShader.ID);
+  glDeleteProgram(shader.ID);
+}
+
+int ImpostorRenderer::bake(unsigned int VAO, unsigned int indexCount,
+                           const AABB &localBounds)
+{
+  std::pair<unsigned int, unsigned int> key(VAO, indexCount);
+  std::map<std::pair<unsigned int, unsigned int>, int>::iterator found =
+          impostorOf.find(key);
+  if (found != impostorOf.end())
+    return found->second;
+  double start = now();
+
+  Impostor impostor;
+  impostor.center = 0.5f * (localBounds.min + localBounds.max);
+  impostor.radius = std::max(glm::length(localBounds.max - impostor.center),
+                             1e-4f);
+  impostor.framesPerSide = std::max(framesPerSide, 1);
+  int size = impostor.framesPerSide * frameSize;
+  impostor.atlasSize = size;
+
+  // baking can happen in the middle of a frame, leave its state as it was
+  int previousFramebuffer = 0;
+  int previousViewport[4];
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+  glGetIntegerv(GL_VIEWPORT, previousViewport);
+  bool depthTest = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+
+  unsigned int textures[2];
+  glGenTextures(2, textures);
+  for (unsigned int texture : textures)
+  {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, NULL);
+  }
+  impostor.color = textures[0];
+  impostor.normalDepth = textures[1];
+  unsigned int depth, FBO;
+  glGenRenderbuffers(1, &depth);
+  glBindRenderbuffer(GL_RENDERBUFFER, depth);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size, size);
+  glGenFramebuffers(1, &FBO);
+  glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                         impostor.color, 0);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D,
+                         impostor.normalDepth, 0);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                            GL_RENDERBUFFER, depth);
+  unsigned int attachments[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+  glDrawBuffers(2, attachments);
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    std::cout << "ERROR::IMPOSTOR::FRAMEBUFFER_INCOMPLETE" << std::endl;
+
+  // empty texels: no coverage, the normal/depth of the sphere's center so
+  // filtering at the silhouettes doesn't pull the depth to the front
+  float clearColor[] = {0.0f, 0.0f, 0.0f, 0.0f};
+  float clearNormalDepth[] = {0.5f, 0.5f, 0.5f, 0.5f};
+  glClearBufferfv(GL_COLOR, 0, clearColor);
+  glClearBufferfv(GL_COLOR, 1, clearNormalDepth);
+  glClear(GL_DEPTH_BUFFER_BIT);
+  glEnable(GL_DEPTH_TEST);
+
+  bakeShader.use();
+  // meshes without vertex colors read this instead of attribute 2
+  glVertexAttrib4f(2, 1.0f, 1.0f, 1.0f, 1.0f);
+  glBindVertexArray(VAO);
+  float r = impostor.radius;
+  glm::mat4 projection = glm::ortho(-r, r, -r, r, r, 3.0f * r);
+  for (int y = 0; y < impostor.framesPerSide; y++)
+  {
+    for (int x = 0; x < impostor.framesPerSide; x++)
+    {
+      glm::vec3 direction = octahedralDecode(
+              (glm::vec2(x, y) + 0.5f) / (float)impostor.framesPerSide);
+      glm::vec3 up = std::fabs(direction.y) > 0.99f
+                     ? glm::vec3(0.0f, 0.0f, 1.0f)
+                     : glm::vec3(0.0f, 1.0f, 0.0f);
+      glm::mat4 view = glm::lookAt(impostor.center + direction * 2.0f * r,
+                                   impostor.center, up);
+      bakeShader.setMat4("viewProjection", projection * view);
+      glViewport(x * frameSize, y * frameSize, frameSize, frameSize);
+      glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+    }
+  }
+  glBindVertexArray(0);
+
+  // a few mip levels for the far end; the cells have empty borders, so
+  // they don't bleed into each other until the smallest levels
+  for (unsigned int texture : textures)
+  {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                    GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 4);
+    glGenerateMipmap(GL_TEXTURE_2D);
+  }
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  glDeleteFramebuffers(1, &FBO);
+  glDeleteRenderbuffers(1, &depth);
+  glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+  glViewport(previousViewport[0], previousViewport[1], previousViewport[2],
+             previousViewport[3]);
+  if (!depthTest)
+    glDisable(GL_DEPTH_TEST);
+
+  impostors.push_back(impostor);
+  instances.resize(impostors.size());
+  int index = (int)impostors.size() - 1;
+  impostorOf[key] = index;
+  bakeTime += now() - start;
+  return index;
+}
+
+int ImpostorRenderer::impostorFor(const RenderObject &object)
+{
+  std::pair<unsigned int, unsigned int> key(object.VAO, object.indexCount);
+  std::map<std::pair<unsigned int, unsigned int>, int>::iterator found =
+          impostorOf.find(key);
+  if (found != impostorOf.end())
+    return found->second;
+  // the object space box from the world one, exact for objects that are
+  // only translated and scaled, a little loose for rotated ones
+  return bake(object.VAO, object.indexCount,
+              transformAABB(object.bounds, glm::inverse(object.model)));
+}
+
+void ImpostorRenderer::prepare(const std::vector<RenderObject> &objects,
+                               const glm::mat4 &view,
+                               const glm::mat4 &projection,
+                               int viewportHeight)
+{
+  viewProjection = projection * view;
+  cameraPosition = glm::vec3(glm::inverse(view)[3]);
+  Frustum frustum(viewProjection);
+  meshes.clear();
+  for (std::vector<glm::mat4> &list : instances)
+    list.clear();
+
+  // a sphere of radius r at distance d covers about
+  // 2 r / d * projection[1][1] * height / 2 pixels
+  float pixelsPerSlope = projection[1][1] * viewportHeight * 0.5f;
+  for (const RenderObject &object : objects)
+  {
+    if (!frustum.intersects(object.bounds))
+      continue;
+    glm::vec3 center = 0.5f * (object.bounds.min + object.bounds.max);
+    float radius = glm::length(object.bounds.max - center);
+    float distance = std::max(glm::length(center - cameraPosition), 1e-4f);
+    if (2.0f * radius / distance * pixelsPerSlope >= thresholdPixels)
+    {
+      meshes.push_back(object);
+      continue;
+    }
+    instances[impostorFor(object)].push_back(object.model);
+  }
+}
+
+const std::vector<RenderObject> &ImpostorRenderer::meshObjects() const
+{
+  return meshes;
+}
+
+void ImpostorRenderer::render()
+{
+  draws = 0;
+  size_t total = 0;
+  for (const std::vector<glm::mat4> &list : instances)
+    total += list.size();
+  if (total == 0)
+    return;
+
+  // all instances in one upload, grown by orphaning when needed
+  glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+  if (total > instanceCapacity)
+    instanceCapacity = std::max(total, instanceCapacity * 2);
+  glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(glm::mat4), NULL,
+               GL_STREAM_DRAW);
+  std::vector<size_t> first(instances.size());
+  size_t offset = 0;
+  for (size_t i = 0; i < instances.size(); i++)
+  {
+    first[i] = offset;
+    glBufferSubData(GL_ARRAY_BUFFER, offset * sizeof(glm::mat4),
+                    instances[i].size() * sizeof(glm::mat4),
+                    instances[i].data());
+    offset += instances[i].size();
+  }
+
+  shader.use();
+  shader.setMat4("viewProjection", viewProjection);
+  shader.setVec3("cameraPos", cameraPosition);
+  shader.setVec3("viewPos", cameraPosition);
+  shader.setInt("colorAtlas", 0);
+  shader.setInt("normalDepthAtlas", 1);
+  int lightCount = (int)std::min(lights.size(),
+                                 (size_t)OpaqueRenderer::MAX_LIGHTS);
+  shader.setInt("lightCount", lightCount);
+  for (int i = 0; i < lightCount; i++)
+  {
+    std::string index = "[" + std::to_string(i) + "]";
+    shader.setVec4("lightPositions" + index,
+                   glm::vec4(lights[i].position, lights[i].radius));
+    shader.setVec3("lightColors" + index, lights[i].color);
+  }
+
+  bool depthTest = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+  glEnable(GL_DEPTH_TEST);
+  glBindVertexArray(VAO);
+  for (size_t i = 0; i < instances.size(); i++)
+  {
+    if (instances[i].empty())
+      continue;
+    const Impostor &impostor = impostors[i];
+    shader.setVec3("center", impostor.center);
+    shader.setFloat("radius", impostor.radius);
+    shader.setInt("framesPerSide", impostor.framesPerSide);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, impostor.color);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, impostor.normalDepth);
+    // GL 3.3 has no base instance, point the attributes at the range
+    for (int column = 0; column < 4; column++)
+      glVertexAttribPointer(1 + column, 4, GL_FLOAT, GL_FALSE,
+                            sizeof(glm::mat4),
+                            (void*)(first[i] * sizeof(glm::mat4) +
+                                    column * sizeof(glm::vec4)));
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4,
+                          (GLsizei)instances[i].size());
+    draws++;
+  }
+  glBindVertexArray(0);
+  glActiveTexture(GL_TEXTURE0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  if (!depthTest)
+    glDisable(GL_DEPTH_TEST);
+}
+
+unsigned int ImpostorRenderer::impostorCount() const
+{
+  unsigned int count = 0;
+  for (const std::vector<glm::mat4> &list : instances)
+    count += (unsigned int)list.size();
+  return count;
+}
+
+unsigned int ImpostorRenderer::drawCalls() const
+{
+  return draws;
+}
+
+double ImpostorRenderer::bakeMilliseconds() const
+{
+  return bakeTime;
+}
+
+size_t ImpostorRenderer::atlasBytes() const
+{
+  // two RGBA8 textures each, plus about a third for the mip levels
+  size_t bytes = 0;
+  for (const Impostor &impostor : impostors)
+    bytes += (size_t)impostor.atlasSize * impostor.atlasSize * 4 * 2 * 4 / 3;
+  return bytes;
+}
@@ -0,0 +1,119 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_IMPOSTOR_H
+#define COORDINATESPACE_IMPOSTOR_H
+
+#include <map>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "renderobject.h"
+#include "opaquepass.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Impostors
+ *  A detailed tree a few hundred meters away covers a dozen pixels but
+ *  still runs its thousands of vertices through the vertex shader. An
+ *  impostor replaces it with a single quad showing a picture of the mesh,
+ *  taken beforehand from the direction the camera looks at it.
+ *
+ *  Baking renders the mesh from framesPerSide^2 directions spread over the
+ *  whole sphere with an octahedral mapping: a direction is projected onto
+ *  the octahedron |x| + |y| + |z| = 1, the lower half is folded out over
+ *  the corners and the result flattened to a square. Each cell of a grid
+ *  over that square is one view, rendered orthographically around the
+ *  mesh's bounding sphere into its cell of two atlas textures:
+ *   - color: the vertex color (white for meshes without one) and coverage
+ *     in alpha,
+ *   - normal and depth: the object space normal in rgb and the depth
+ *     within the bounding sphere along the view in alpha.
+ *
+ *  This happens on first use (or earlier with bake()) once per mesh, all
+ *  objects using the same VAO and index count share the impostor.
+ *
+ *  Per frame prepare() estimates each visible object's size on screen from
+ *  its bounding sphere. Objects larger than thresholdPixels keep their
+ *  mesh, the rest become impostor instances, drawn with one instanced
+ *  draw per impostor. The vertex shader turns the camera direction into
+ *  object space, picks the closest baked view from its octahedral
+ *  coordinates and spans the quad perpendicular to that view. The
+ *  fragment shader lights the baked normal like the mesh would be lit and
+ *  writes the baked depth so impostors intersect each other and the
+ *  meshes correctly.
+ *
+ *  Picking the single closest view makes the image jump a little when the
+ *  camera crosses from one cell to the next; at the distances impostors
+ *  are used at that isn't noticeable with 8 x 8 views or more.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class ImpostorRenderer
+{
+public:
+  // read when an impostor is baked
+  int framesPerSide;
+  int frameSize;
+  // objects whose bounding sphere is smaller than this on screen (diameter
+  // in pixels) are drawn as impostors
+  float thresholdPixels;
+  // lit like OpaqueRenderer lights its meshes
+  std::vector<PointLight> lights;
+
+  ImpostorRenderer();
+  ~ImpostorRenderer();
+  ImpostorRenderer(const ImpostorRenderer &) = delete;
+  ImpostorRenderer &operator=(const ImpostorRenderer &) = delete;
+
+  // bake the impostor for a mesh now instead of on first use, localBounds
+  // is the box of its vertices
+  int bake(unsigned int VAO, unsigned int indexCount,
+           const AABB &localBounds);
+  // cull and split the objects into meshes and impostor instances
+  void prepare(const std::vector<RenderObject> &objects,
+               const glm::mat4 &view, const glm::mat4 &projection,
+               int viewportHeight);
+  // the objects that are close enough to keep their mesh
+  const std::vector<RenderObject> &meshObjects() const;
+  // draw this frame's impostor instances
+  void render();
+
+  unsigned int impostorCount() const;
+  unsigned int drawCalls() const;
+  double bakeMilliseconds() const;
+  size_t atlasBytes() const;
+
+private:
+  struct Impostor
+  {
+    unsigned int color;
+    unsigned int normalDepth;
+    glm::vec3 center;
+    float radius;
+    int framesPerSide;
+    int atlasSize;
+  };
+
+  std::map<std::pair<unsigned int, unsigned int>, int> impostorOf;
+  std::vector<Impostor> impostors;
+  std::vector<RenderObject> meshes;
+  // this frame's model matrices grouped by impostor
+  std::vector<std::vector<glm::mat4> > instances;
+  glm::mat4 viewProjection;
+  glm::vec3 cameraPosition;
+
+  Shader bakeShader;
+  Shader shader;
+  unsigned int VAO;
+  unsigned int instanceBuffer;
+  size_t instanceCapacity;
+  unsigned int draws;
+  double bakeTime;
+
+  int impostorFor(const RenderObject &object);
+};
+#endif //COORDINATESPACE_IMPOSTOR_H
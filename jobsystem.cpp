@@ -0,0 +1,116 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include "jobsystem.h"
+
+#include <algorithm>
+
+JobSystem::JobSystem(unsigned int threadCount)
+  : quit(false), generation(0), activeWorkers(0), task(NULL), taskCount(0),
+    taskChunkSize(1), chunkCount(0), nextChunk(0)
+{
+  if (threadCount == 0)
+    threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+  // the calling thread is one of them
+  for (unsigned int i = 1; i < threadCount; i++)
+    workers.push_back(std::thread(&JobSystem::workerLoop, this));
+}
+
+JobSystem::~JobSystem()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    quit = true;
+  }
+  wake.notify_all();
+  for (size_t i = 0; i < workers.size(); i++)
+    workers[i].join();
+}
+
+unsigned int JobSystem::getThreadCount() const
+{
+  return (unsigned int)workers.size() + 1;
+}
+
+void JobSystem::parallelFor(size_t count, size_t chunkSize,
+                            const RangeFunction &func)
+{
+  if (count == 0)
+    return;
+  chunkSize = std::max(chunkSize, (size_t)1);
+  // not worth waking anybody up for a single chunk
+  if (workers.empty() || count <= chunkSize)
+  {
+    func(0, count);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    task = &func;
+    taskCount = count;
+    taskChunkSize = chunkSize;
+    chunkCount = (count + chunkSize - 1) / chunkSize;
+    nextChunk.store(0);
+    generation++;
+  }
+  wake.notify_all();
+
+  runChunks(func, count, chunkSize, chunkCount);
+
+  // the last chunks may still be running on a worker
+  std::unique_lock<std::mutex> lock(mutex);
+  finished.wait(lock, [this] { return activeWorkers == 0; });
+  task = NULL;
+}
+
+void JobSystem::workerLoop()
+{
+  unsigned int seen = 0;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    wake.wait(lock, [&] { return quit || generation != seen; });
+    if (quit)
+      return;
+    seen = generation;
+    // woke up after the parallelFor already finished without us
+    if (task == NULL)
+      continue;
+    const RangeFunction &func = *task;
+    size_t count = taskCount, chunkSize = taskChunkSize;
+    size_t chunks = chunkCount;
+    activeWorkers++;
+    lock.unlock();
+
+    runChunks(func, count, chunkSize, chunks);
+
+    lock.lock();
+    activeWorkers--;
+    if (activeWorkers == 0)
+      finished.notify_all();
+  }
+}
+
+void JobSystem::runChunks(const RangeFunction &func, size_t count,
+                          size_t chunkSize, size_t chunks)
+{
+  while (true)
+  {
+    size_t chunk = nextChunk.fetch_add(1);
+    if (chunk >= chunks)
+      break;
+    size_t begin = chunk * chunkSize;
+    func(begin, std::min(begin + chunkSize, count));
+  }
+}
+
+void parallelFor(JobSystem* jobs, size_t count, size_t chunkSize,
+                 const JobSystem::RangeFunction &func)
+{
+  if (jobs != NULL)
+    jobs->parallelFor(count, chunkSize, func);
+  else
+    func(0, count);
+}
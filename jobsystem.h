@@ -0,0 +1,72 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_JOBSYSTEM_H
+#define COORDINATESPACE_JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * A small pool of worker threads for data parallel CPU work. The only
+ * operation is parallelFor: the range [0, count) is cut into chunks and
+ * the workers, together with the calling thread, grab chunks off a shared
+ * atomic counter until none are left. Grabbing chunks instead of handing
+ * every thread a fixed share keeps all threads busy when some chunks turn
+ * out more expensive than others.
+ *
+ * The workers sleep on a condition variable between calls, parallelFor
+ * blocks until every chunk has finished. Chunks run concurrently so the
+ * function must only write to data owned by its own chunk.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class JobSystem
+{
+public:
+  typedef std::function<void(size_t begin, size_t end)> RangeFunction;
+
+  // 0 uses one thread per hardware thread, including the caller
+  explicit JobSystem(unsigned int threadCount = 0);
+  ~JobSystem();
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+
+  // threads working on a parallelFor, the calling thread included
+  unsigned int getThreadCount() const;
+  void parallelFor(size_t count, size_t chunkSize, const RangeFunction &func);
+
+private:
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable finished;
+  bool quit;
+  unsigned int generation;
+  unsigned int activeWorkers;
+
+  // the current parallelFor, NULL in between; only changed while no worker
+  // is active
+  const RangeFunction* task;
+  size_t taskCount;
+  size_t taskChunkSize;
+  size_t chunkCount;
+  std::atomic<size_t> nextChunk;
+
+  void workerLoop();
+  void runChunks(const RangeFunction &func, size_t count, size_t chunkSize,
+                 size_t chunks);
+};
+
+// jobs->parallelFor, or the whole range on the calling thread when jobs is
+// NULL, for code that takes an optional JobSystem
+void parallelFor(JobSystem* jobs, size_t count, size_t chunkSize,
+                 const JobSystem::RangeFunction &func);
+#endif //COORDINATESPACE_JOBSYSTEM_H
@@ -326,9 +326,20 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 
+#include "hud.h"
+#include "dynamicresolution.h"
+
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void key_callback(GLFWwindow* window, int key, int scancode, int action,
+                  int mods);
 void processInput(GLFWwindow *window);
 
+// F1 shows and hides the stats overlay
+bool showHud = true;
+// the scene renders at a resolution that follows the GPU load, the window
+// size reaches it through framebuffer_size_callback
+DynamicResolution* dynamicResolution = NULL;
+
 // settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
@@ -357,6 +368,7 @@ int main()
   }
   glfwMakeContextCurrent(window);
   glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+  glfwSetKeyCallback(window, key_callback);
 
   // glad: load all OpenGL function pointers
   // ---------------------------------------
@@ -434,19 +446,39 @@ int main()
   }
   stbi_image_free(data);
 
+  // stats overlay, drawn last in screen space
+  HudOverlay hud;
+  FrameStats stats;
+
+  // a 60 Hz budget, the scene may drop to half the window resolution
+  int framebufferWidth, framebufferHeight;
+  glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+  DynamicResolution resolution(framebufferWidth, framebufferHeight);
+  resolution.controller.budgetMilliseconds = 16.0;
+  resolution.controller.minScale = 0.5f;
+  dynamicResolution = &resolution;
+  double lastFrame = glfwGetTime();
 
   // render loop
   // -----------
   while (!glfwWindowShouldClose(window))
   {
+    double currentFrame = glfwGetTime();
+    stats.frame((currentFrame - lastFrame) * 1000.0);
+    lastFrame = currentFrame;
+
     // input
     // -----
     processInput(window);
 
     // render
     // ------
+    resolution.beginScene();
     glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // opaque geometry is depth tested, the HUD turns it off again for
+    // itself at the end of the frame
+    glEnable(GL_DEPTH_TEST);
 
     // bind Texture
     glBindTexture(GL_TEXTURE_2D, texture);
@@ -493,6 +525,23 @@ int main()
 
     glBindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    resolution.endScene();
+    resolution.present();
+
+    // the HUD uses the orthographic projection: one unit is one pixel
+    hud.enabled = showHud;
+    if (hud.enabled)
+    {
+      glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+      stats.drawCalls = 3;
+      stats.memoryBytes = sizeof(vertices) + sizeof(indices) +
+                          (size_t)width * height * nrChannels * 4 / 3 +
+                          (size_t)framebufferWidth * framebufferHeight * 8;
+      stats.setTiming("scene gpu", resolution.sceneGpuMilliseconds());
+      hud.begin(framebufferWidth, framebufferHeight);
+      stats.draw(hud, 10.0f, 10.0f);
+      hud.end();
+    }
 
     // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
     // -------------------------------------------------------------------------------
@@ -505,6 +554,7 @@ int main()
   glDeleteVertexArrays(1, &VAO);
   glDeleteBuffers(1, &VBO);
   glDeleteBuffers(1, &EBO);
+  dynamicResolution = NULL;
 
   // glfw: terminate, clearing all previously allocated GLFW resources.
   // ------------------------------------------------------------------
@@ -520,6 +570,16 @@ void processInput(GLFWwindow *window)
     glfwSetWindowShouldClose(window, true);
 }
 
+// glfw: key events arrive once per press, unlike polling in processInput, so
+// toggles go here
+// ---------------------------------------------------------------------------
+void key_callback(GLFWwindow* window, int key, int scancode, int action,
+                  int mods)
+{
+  if (key == GLFW_KEY_F1 && action == GLFW_PRESS)
+    showHud = !showHud;
+}
+
 // glfw: whenever the window size changed (by OS or user resize) this callback function executes
 // ---------------------------------------------------------------------------------------------
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
@@ -527,4 +587,7 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
   // make sure the viewport matches the new window dimensions; note that width and
   // height will be significantly larger than specified on retina displays.
   glViewport(0, 0, width, height);
+  // the offscreen scene target follows the window
+  if (dynamicResolution != NULL)
+    dynamicResolution->setOutputSize(width, height);
 }
\ No newline at end of file
@@ -0,0 +1,546 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "meshlod.h"
+#include "frustum.h"
+#include "vertexweld.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+
+namespace
+{
+  // the outline of an open mesh counts this many times a triangle's plane
+  const double BOUNDARY_WEIGHT = 10.0;
+
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+
+  uint64_t edgeKey(unsigned int a, unsigned int b)
+  {
+    return (uint64_t)std::min(a, b) << 32 | std::max(a, b);
+  }
+
+  glm::dvec3 faceNormal(const glm::dvec3 &a, const glm::dvec3 &b,
+                        const glm::dvec3 &c)
+  {
+    return glm::cross(b - a, c - a);
+  }
+
+  // weight * the squared distance to the plane n . p + d = 0, n unit length
+  void addPlane(double q[10], const glm::dvec3 &n, double d, double weight)
+  {
+    q[0] += weight * n.x * n.x;
+    q[1] += weight * n.x * n.y;
+    q[2] += weight * n.x * n.z;
+    q[3] += weight * n.x * d;
+    q[4] += weight * n.y * n.y;
+    q[5] += weight * n.y * n.z;
+    q[6] += weight * n.y * d;
+    q[7] += weight * n.z * n.z;
+    q[8] += weight * n.z * d;
+    q[9] += weight * d * d;
+  }
+}
+
+MeshSimplifier::MeshSimplifier(const std::vector<glm::vec3> &positions,
+                               const std::vector<unsigned int> &indices)
+  : largestCost(0.0)
+{
+  // join the vertices that share a position, a seam of the texture or the
+  // normals is no edge of the surface
+  std::vector<MeshVertex> vertices(positions.size());
+  for (size_t i = 0; i < positions.size(); i++)
+    vertices[i] = MeshVertex{positions[i], glm::vec3(0.0f), glm::vec2(0.0f)};
+  std::vector<MeshVertex> unique;
+  std::vector<unsigned int> joined;
+  VertexWelder welder;
+  welder.weld(vertices, unique, joined);
+  points.resize(unique.size());
+  representative.assign(unique.size(), ~0u);
+  for (size_t i = 0; i < positions.size(); i++)
+    if (representative[joined[i]] == ~0u)
+    {
+      representative[joined[i]] = (unsigned int)i;
+      points[joined[i]] = glm::dvec3(positions[i]);
+    }
+
+  for (size_t i = 0; i + 2 < indices.size(); i += 3)
+  {
+    unsigned int a = joined[indices[i]], b = joined[indices[i + 1]];
+    unsigned int c = joined[indices[i + 2]];
+    if (a != b && b != c && c != a)
+      triangles.insert(triangles.end(), {a, b, c});
+  }
+
+  // every triangle's plane goes to its corners
+  quadrics.assign(points.size(), Quadric());
+  for (Quadric &q : quadrics)
+    std::fill(q.a, q.a + 10, 0.0);
+  for (size_t t = 0; t < triangles.size(); t += 3)
+  {
+    const glm::dvec3 &p = points[triangles[t]];
+    glm::dvec3 n = faceNormal(p, points[triangles[t + 1]],
+                              points[triangles[t + 2]]);
+    double length = glm::length(n);
+    if (length == 0.0)
+      continue;
+    n /= length;
+    for (int k = 0; k < 3; k++)
+      addPlane(quadrics[triangles[t + k]].a, n, -glm::dot(n, p), 1.0);
+  }
+
+  // the edges only one triangle uses are the outline: a plane through the
+  // edge, standing on the triangle, holds them in place
+  std::vector<std::pair<uint64_t, unsigned int> > edges;
+  for (size_t t = 0; t < triangles.size(); t += 3)
+    for (int k = 0; k < 3; k++)
+      edges.push_back(std::make_pair(
+              edgeKey(triangles[t + k], triangles[t + (k + 1) % 3]),
+              (unsigned int)t));
+  std::sort(edges.begin(), edges.end());
+  for (size_t i = 0; i < edges.size(); i++)
+  {
+    bool single = (i == 0 || edges[i - 1].first != edges[i].first) &&
+                  (i + 1 == edges.size() ||
+                   edges[i + 1].first != edges[i].first);
+    if (!single)
+      continue;
+    unsigned int t = edges[i].second;
+    unsigned int a = (unsigned int)(edges[i].first >> 32);
+    unsigned int b = (unsigned int)edges[i].first;
+    glm::dvec3 face = faceNormal(points[triangles[t]],
+                                 points[triangles[t + 1]],
+                                 points[triangles[t + 2]]);
+    glm::dvec3 n = glm::cross(points[b] - points[a], face);
+    double length = glm::length(n);
+    if (length == 0.0)
+      continue;
+    n /= length;
+    double d = -glm::dot(n, points[a]);
+    addPlane(quadrics[a].a, n, d, BOUNDARY_WEIGHT);
+    addPlane(quadrics[b].a, n, d, BOUNDARY_WEIGHT);
+  }
+}
+
+double MeshSimplifier::cost(const Quadric &q, const glm::dvec3 &p) const
+{
+  const double* a = q.a;
+  double value = a[0] * p.x * p.x + 2.0 * a[1] * p.x * p.y +
+                 2.0 * a[2] * p.x * p.z + 2.0 * a[3] * p.x +
+                 a[4] * p.y * p.y + 2.0 * a[5] * p.y * p.z +
+                 2.0 * a[6] * p.y + a[7] * p.z * p.z + 2.0 * a[8] * p.z +
+                 a[9];
+  // rounding can take it a little below 0
+  return std::max(value, 0.0);
+}
+
+void MeshSimplifier::buildAdjacency()
+{
+  adjacencyStart.assign(points.size() + 1, 0);
+  for (unsigned int vertex : triangles)
+    adjacencyStart[vertex + 1]++;
+  for (size_t v = 0; v < points.size(); v++)
+    adjacencyStart[v + 1] += adjacencyStart[v];
+  adjacency.resize(triangles.size());
+  std::vector<unsigned int> next(adjacencyStart.begin(),
+                                 adjacencyStart.end() - 1);
+  for (size_t i = 0; i < triangles.size(); i++)
+    adjacency[next[triangles[i]]++] = (unsigned int)(i / 3 * 3);
+}
+
+bool MeshSimplifier::flips(unsigned int from, unsigned int to) const
+{
+  for (unsigned int i = adjacencyStart[from]; i < adjacencyStart[from + 1];
+       i++)
+  {
+    const unsigned int* t = &triangles[adjacency[i]];
+    if (t[0] == to || t[1] == to || t[2] == to)
+      continue;
+    glm::dvec3 corners[3], moved[3];
+    for (int k = 0; k < 3; k++)
+    {
+      corners[k] = points[t[k]];
+      moved[k] = t[k] == from ? points[to] : corners[k];
+    }
+    glm::dvec3 before = faceNormal(corners[0], corners[1], corners[2]);
+    glm::dvec3 after = faceNormal(moved[0], moved[1], moved[2]);
+    if (glm::dot(before, after) <= 0.0)
+      return true;
+  }
+  return false;
+}
+
+bool MeshSimplifier::joinsSheets(unsigned int from, unsigned int to) const
+{
+  // the edge's triangles have one neighbour of both ends each; any other
+  // common neighbour would end up with two edges to the same vertex
+  std::vector<unsigned int> around[2];
+  unsigned int ends[2] = {from, to};
+  unsigned int shared = 0;
+  for (int e = 0; e < 2; e++)
+    for (unsigned int i = adjacencyStart[ends[e]];
+         i < adjacencyStart[ends[e] + 1]; i++)
+    {
+      const unsigned int* t = &triangles[adjacency[i]];
+      bool both = false;
+      for (int k = 0; k < 3; k++)
+      {
+        both = both || t[k] == ends[1 - e];
+        if (t[k] != from && t[k] != to)
+          around[e].push_back(t[k]);
+      }
+      if (e == 0 && both)
+        shared++;
+    }
+  for (std::vector<unsigned int> &list : around)
+  {
+    std::sort(list.begin(), list.end());
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+  }
+  std::vector<unsigned int> common;
+  std::set_intersection(around[0].begin(), around[0].end(), around[1].begin(),
+                        around[1].end(), std::back_inserter(common));
+  return common.size() > shared;
+}
+
+void MeshSimplifier::simplify(size_t targetTriangles)
+{
+  struct Collapse
+  {
+    double cost;
+    unsigned int from;
+    unsigned int to;
+
+    bool operator<(const Collapse &other) const
+    {
+      return cost < other.cost;
+    }
+  };
+  std::vector<uint64_t> edges;
+  std::vector<Collapse> collapses;
+  std::vector<unsigned int> target(points.size());
+  std::vector<char> locked(points.size());
+
+  while (triangles.size() / 3 > targetTriangles)
+  {
+    buildAdjacency();
+    edges.clear();
+    for (size_t t = 0; t < triangles.size(); t += 3)
+      for (int k = 0; k < 3; k++)
+        edges.push_back(edgeKey(triangles[t + k],
+                                triangles[t + (k + 1) % 3]));
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    // each edge in its cheaper direction
+    collapses.clear();
+    for (uint64_t key : edges)
+    {
+      unsigned int a = (unsigned int)(key >> 32), b = (unsigned int)key;
+      Quadric sum;
+      for (int i = 0; i < 10; i++)
+        sum.a[i] = quadrics[a].a[i] + quadrics[b].a[i];
+      double toB = cost(sum, points[b]), toA = cost(sum, points[a]);
+      collapses.push_back(toB <= toA ? Collapse{toB, a, b}
+                                     : Collapse{toA, b, a});
+    }
+    std::sort(collapses.begin(), collapses.end());
+
+    // the cheapest ones whose triangles don't overlap, the others wait for
+    // the next pass with their costs updated. A collapse removes about two
+    // triangles; the ones beyond what's needed only get a chance in later
+    // passes, when the cheap ones around them are gone
+    size_t needed = (triangles.size() / 3 - targetTriangles + 1) / 2;
+    double costLimit = collapses[std::min(needed, collapses.size() - 1)].cost;
+    for (size_t v = 0; v < target.size(); v++)
+      target[v] = (unsigned int)v;
+    std::fill(locked.begin(), locked.end(), 0);
+    size_t remaining = triangles.size() / 3;
+    bool collapsed = false;
+    for (Collapse collapse : collapses)
+    {
+      if (remaining <= targetTriangles || collapse.cost > costLimit)
+        break;
+      if (locked[collapse.from] || locked[collapse.to])
+        continue;
+      if (flips(collapse.from, collapse.to) ||
+          joinsSheets(collapse.from, collapse.to))
+      {
+        // the other way round may still work, at its own cost
+        std::swap(collapse.from, collapse.to);
+        if (flips(collapse.from, collapse.to) ||
+            joinsSheets(collapse.from, collapse.to))
+          continue;
+        Quadric sum;
+        for (int i = 0; i < 10; i++)
+          sum.a[i] = quadrics[collapse.from].a[i] +
+                     quadrics[collapse.to].a[i];
+        collapse.cost = cost(sum, points[collapse.to]);
+        if (collapse.cost > costLimit)
+          continue;
+      }
+
+      target[collapse.from] = collapse.to;
+      for (int i = 0; i < 10; i++)
+        quadrics[collapse.to].a[i] += quadrics[collapse.from].a[i];
+      largestCost = std::max(largestCost, collapse.cost);
+      collapsed = true;
+      unsigned int ends[2] = {collapse.from, collapse.to};
+      for (unsigned int end : ends)
+        for (unsigned int i = adjacencyStart[end];
+             i < adjacencyStart[end + 1]; i++)
+        {
+          const unsigned int* t = &triangles[adjacency[i]];
+          for (int k = 0; k < 3; k++)
+            locked[t[k]] = 1;
+          if (end == collapse.from &&
+              (t[0] == collapse.to || t[1] == collapse.to ||
+               t[2] == collapse.to))
+            remaining--;
+        }
+    }
+    if (!collapsed)
+      break;
+
+    size_t kept = 0;
+    for (size_t t = 0; t < triangles.size(); t += 3)
+    {
+      unsigned int a = target[triangles[t]], b = target[triangles[t + 1]];
+      unsigned int c = target[triangles[t + 2]];
+      if (a == b || b == c || c == a)
+        continue;
+      triangles[kept++] = a;
+      triangles[kept++] = b;
+      triangles[kept++] = c;
+    }
+    triangles.resize(kept);
+  }
+}
+
+std::vector<unsigned int> MeshSimplifier::indices() const
+{
+  std::vector<unsigned int> result(triangles.size());
+  for (size_t i = 0; i < triangles.size(); i++)
+    result[i] = representative[triangles[i]];
+  return result;
+}
+
+size_t MeshSimplifier::triangleCount() const
+{
+  return triangles.size() / 3;
+}
+
+float MeshSimplifier::error() const
+{
+  // the squared distances to several planes add up, their root is at
+  // least the distance to any one of them
+  return (float)std::sqrt(largestCost);
+}
+
+LodMesh::LodMesh(const std::vector<float> &positions,
+                 const std::vector<unsigned int> &indices,
+                 unsigned int maxLevels, float reduction,
+                 unsigned int minTriangles)
+  : VBO(0), localBounds{glm::vec3(1e30f), glm::vec3(-1e30f)}, buildTime(0.0)
+{
+  std::vector<glm::vec3> points(positions.size() / 3);
+  for (size_t i = 0; i < points.size(); i++)
+  {
+    points[i] = glm::vec3(positions[i * 3], positions[i * 3 + 1],
+                          positions[i * 3 + 2]);
+    localBounds.min = glm::min(localBounds.min, points[i]);
+    localBounds.max = glm::max(localBounds.max, points[i]);
+  }
+
+  double start = now();
+  std::vector<std::vector<unsigned int> > levelIndices(1, indices);
+  std::vector<float> errors(1, 0.0f);
+  MeshSimplifier simplifier(points, indices);
+  while (levelIndices.size() < maxLevels)
+  {
+    size_t previous = levelIndices.back().size() / 3;
+    size_t target = (size_t)(previous * reduction);
+    if (target < minTriangles)
+      break;
+    simplifier.simplify(target);
+    // stuck well above the target, the mesh can't get simpler
+    if (simplifier.triangleCount() > (previous + target) / 2)
+      break;
+    levelIndices.push_back(simplifier.indices());
+    errors.push_back(simplifier.error());
+  }
+  buildTime = now() - start;
+
+  glGenBuffers(1, &VBO);
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(float),
+               positions.data(), GL_STATIC_DRAW);
+  for (size_t i = 0; i < levelIndices.size(); i++)
+  {
+    Level level = {0, (unsigned int)levelIndices[i].size(), errors[i]};
+    unsigned int EBO;
+    glGenVertexArrays(1, &level.VAO);
+    glGenBuffers(1, &EBO);
+    glBindVertexArray(level.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 levelIndices[i].size() * sizeof(unsigned int),
+                 levelIndices[i].data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float),
+                          (void*)0);
+    glEnableVertexAttribArray(0);
+    levels.push_back(level);
+    EBOs.push_back(EBO);
+  }
+  glBindVertexArray(0);
+}
+
+LodMesh::~LodMesh()
+{
+  for (const Level &level : levels)
+    glDeleteVertexArrays(1, &level.VAO);
+  glDeleteBuffers((GLsizei)EBOs.size(), EBOs.data());
+  glDeleteBuffers(1, &VBO);
+}
+
+unsigned int LodMesh::levelCount() const
+{
+  return (unsigned int)levels.size();
+}
+
+const LodMesh::Level &LodMesh::level(unsigned int index) const
+{
+  return levels[std::min(index, (unsigned int)levels.size() - 1)];
+}
+
+const AABB &LodMesh::bounds() const
+{
+  return localBounds;
+}
+
+double LodMesh::buildMilliseconds() const
+{
+  return buildTime;
+}
+
+LodSelector::LodSelector()
+  : thresholdPixels(1.0f), hysteresis(0.25f), triangles(0), changes(0)
+{
+}
+
+void LodSelector::add(const LodMesh* mesh)
+{
+  if (mesh == nullptr || mesh->levelCount() == 0)
+  {
+    std::cout << "ERROR::LODSELECTOR::EMPTY_MESH" << std::endl;
+    return;
+  }
+  meshOf[mesh->level(0).VAO] = mesh;
+}
+
+void LodSelector::prepare(const std::vector<RenderObject> &objects,
+                          const glm::mat4 &view, const glm::mat4 &projection,
+                          int viewportHeight)
+{
+  Frustum frustum(projection * view);
+  glm::vec3 cameraPosition = glm::vec3(glm::inverse(view)[3]);
+  selected.clear();
+  std::fill(histogram.begin(), histogram.end(), 0);
+  triangles = 0;
+  changes = 0;
+  currentLevel.resize(objects.size(), -1);
+
+  // a sphere of radius r at distance d covers about
+  // 2 r / d * projection[1][1] * height / 2 pixels, a length e at the
+  // same distance e / 2r of that
+  float pixelsPerSlope = projection[1][1] * viewportHeight * 0.5f;
+  float coarserPixels = thresholdPixels * (1.0f - hysteresis);
+  for (size_t i = 0; i < objects.size(); i++)
+  {
+    const RenderObject &object = objects[i];
+    if (!frustum.intersects(object.bounds))
+      continue;
+    std::map<unsigned int, const LodMesh*>::const_iterator found =
+            meshOf.find(object.VAO);
+    if (found == meshOf.end())
+    {
+      selected.push_back(object);
+      triangles += object.indexCount / 3;
+      continue;
+    }
+    const LodMesh &mesh = *found->second;
+
+    glm::vec3 center = object.bounds.center();
+    float radius = glm::length(object.bounds.extent());
+    // the mesh's errors are in its own units, the world box tells the scale
+    float localRadius = std::max(glm::length(mesh.bounds().extent()), 1e-6f);
+    // the nearest point of the sphere, an error there looks largest
+    float distance = std::max(glm::length(center - cameraPosition) - radius,
+                              1e-4f);
+    float pixelsPerUnit = radius / localRadius * pixelsPerSlope / distance;
+
+    // the coarsest level within the threshold, and the coarsest within the
+    // tighter one for switching to a coarser level; an object keeps its
+    // level when that lies between the two
+    int coarsestAllowed = 0, coarsestToSwitch = 0;
+    for (unsigned int l = 1; l < mesh.levelCount(); l++)
+    {
+      float pixels = mesh.level(l).error * pixelsPerUnit;
+      if (pixels > thresholdPixels)
+        break;
+      coarsestAllowed = (int)l;
+      if (pixels <= coarserPixels)
+        coarsestToSwitch = (int)l;
+    }
+    int previous = currentLevel[i];
+    int chosen = previous < 0
+                 ? coarsestAllowed
+                 : std::min(std::max(previous, coarsestToSwitch),
+                            coarsestAllowed);
+    changes += previous >= 0 && chosen != previous;
+    currentLevel[i] = chosen;
+
+    const LodMesh::Level &level = mesh.level((unsigned int)chosen);
+    RenderObject drawn = object;
+    drawn.VAO = level.VAO;
+    drawn.indexCount = level.indexCount;
+    drawn.depthVAO = 0;
+    selected.push_back(drawn);
+    triangles += level.indexCount / 3;
+    if ((size_t)chosen >= histogram.size())
+      histogram.resize(chosen + 1, 0);
+    histogram[chosen]++;
+  }
+}
+
+const std::vector<RenderObject> &LodSelector::lodObjects() const
+{
+  return selected;
+}
+
+size_t LodSelector::triangleCount() const
+{
+  return triangles;
+}
+
+const std::vector<unsigned int> &LodSelector::levelHistogram() const
+{
+  return histogram;
+}
+
+unsigned int LodSelector::levelChanges() const
+{
+  return changes;
+}
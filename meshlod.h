@@ -0,0 +1,178 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_MESHLOD_H
+#define COORDINATESPACE_MESHLOD_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "renderobject.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Mesh levels of detail
+ *  A mesh far away is drawn with as many triangles as up close, most of
+ *  them smaller than a pixel. A mesh with levels of detail carries a few
+ *  simplified versions of itself, each about half the triangles of the
+ *  one before, and every frame each object is drawn with the coarsest one
+ *  that still looks the same.
+ *
+ *  The levels are made once, offline or at load, by quadric edge collapse
+ *  (Garland and Heckbert):
+ *
+ *   - every vertex gets a quadric, the sum of the squared distances to the
+ *     planes of the triangles around it, as a symmetric 4 x 4 matrix Q:
+ *     the squared distance of a point p to all those planes is p^T Q p,
+ *   - collapsing an edge moves one end onto the other and adds their
+ *     quadrics; the cost is the squared distance of the kept end to the
+ *     planes of both, so flat areas go first and silhouettes and creases
+ *     last,
+ *   - the edges of an open mesh get planes perpendicular to their
+ *     triangle, so its outline stays put,
+ *   - a collapse that would flip a triangle, or join two sheets of the
+ *     surface (the ends share more neighbours than the edge's triangles),
+ *     is skipped.
+ *
+ *  MeshSimplifier collapses in passes: all edges sorted by cost, the
+ *  cheapest ones that don't touch each other collapsed, repeat. The ends
+ *  always move onto existing vertices, so all levels share the vertex
+ *  buffer and only have their own index buffer. Each level keeps the
+ *  largest error collapsed into it so far, as a distance in mesh units.
+ *
+ *  At runtime LodSelector::prepare() looks at the size of each object's
+ *  bounding sphere on screen: radius r at distance d covers
+ *  2 r / d * projection[1][1] * height / 2 pixels with a glm::perspective
+ *  projection and a viewport height pixels high. A level whose error is e
+ *  is off by e / 2r of that (measured at the sphere's nearest point, where
+ *  an error looks largest), and the object gets the coarsest level off by
+ *  at most thresholdPixels.
+ *
+ *  An object right at the distance where two levels meet would switch
+ *  back and forth with every small camera movement, and every switch is a
+ *  visible pop. With hysteresis h, an object only changes to a coarser
+ *  level once that level is off by less than (1 - h) thresholdPixels; it
+ *  changes to a finer one as soon as its level is off by more than
+ *  thresholdPixels. Between the two it keeps what it had, so the level
+ *  depends on where the camera has been as well as on where it is.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class MeshSimplifier
+{
+public:
+  // duplicate positions (seams) are joined before simplifying; indices
+  // keep pointing into positions
+  MeshSimplifier(const std::vector<glm::vec3> &positions,
+                 const std::vector<unsigned int> &indices);
+
+  // collapse until at most targetTriangles are left or nothing can be
+  // collapsed anymore; can be called again with fewer
+  void simplify(size_t targetTriangles);
+
+  // the current triangles, indices into the positions given
+  std::vector<unsigned int> indices() const;
+  size_t triangleCount() const;
+  // the distance from the original surface collapsed into the mesh so far
+  float error() const;
+
+private:
+  struct Quadric
+  {
+    double a[10];
+  };
+
+  std::vector<glm::dvec3> points;
+  // the first input vertex at each joined position
+  std::vector<unsigned int> representative;
+  std::vector<unsigned int> triangles;
+  std::vector<Quadric> quadrics;
+  double largestCost;
+
+  // the triangles around every vertex, rebuilt every pass
+  std::vector<unsigned int> adjacencyStart;
+  std::vector<unsigned int> adjacency;
+
+  void buildAdjacency();
+  bool flips(unsigned int from, unsigned int to) const;
+  bool joinsSheets(unsigned int from, unsigned int to) const;
+  double cost(const Quadric &q, const glm::dvec3 &p) const;
+};
+
+class LodMesh
+{
+public:
+  struct Level
+  {
+    unsigned int VAO;
+    unsigned int indexCount;
+    // in mesh units, 0 for the full mesh
+    float error;
+  };
+
+  // positions as x, y, z triples like OpaqueRenderer draws them; level 0
+  // is the mesh itself, the next ones keep reduction of the triangles of
+  // the one before until maxLevels or minTriangles is reached
+  LodMesh(const std::vector<float> &positions,
+          const std::vector<unsigned int> &indices,
+          unsigned int maxLevels = 8, float reduction = 0.5f,
+          unsigned int minTriangles = 64);
+  ~LodMesh();
+  LodMesh(const LodMesh &) = delete;
+  LodMesh &operator=(const LodMesh &) = delete;
+
+  unsigned int levelCount() const;
+  const Level &level(unsigned int index) const;
+  // of the positions, for the radius of the bounding sphere
+  const AABB &bounds() const;
+  double buildMilliseconds() const;
+
+private:
+  std::vector<Level> levels;
+  unsigned int VBO;
+  std::vector<unsigned int> EBOs;
+  AABB localBounds;
+  double buildTime;
+};
+
+class LodSelector
+{
+public:
+  // the largest error allowed on screen, in pixels
+  float thresholdPixels;
+  // fraction of thresholdPixels an object has to be below before it
+  // changes to a coarser level, 0 switches right at the threshold
+  float hysteresis;
+
+  LodSelector();
+
+  // objects drawn with the mesh's level 0 VAO get its levels
+  void add(const LodMesh* mesh);
+  // cull the objects and pick their levels; objects are remembered by
+  // their index in the vector for the hysteresis
+  void prepare(const std::vector<RenderObject> &objects,
+               const glm::mat4 &view, const glm::mat4 &projection,
+               int viewportHeight);
+  // this frame's visible objects with their level's VAO and index count
+  const std::vector<RenderObject> &lodObjects() const;
+
+  // of the last prepare()
+  size_t triangleCount() const;
+  // visible objects per level
+  const std::vector<unsigned int> &levelHistogram() const;
+  // objects that drew a different level than the frame before
+  unsigned int levelChanges() const;
+
+private:
+  std::map<unsigned int, const LodMesh*> meshOf;
+  std::vector<RenderObject> selected;
+  // per object, -1 before it was first seen
+  std::vector<int> currentLevel;
+  std::vector<unsigned int> histogram;
+  size_t triangles;
+  unsigned int changes;
+};
+#endif //COORDINATESPACE_MESHLOD_H
@@ -0,0 +1,275 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "multiview.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+
+  bool overlaps(const AABB &a, const AABB &b)
+  {
+    return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+           a.min.y <= b.max.y && a.max.y >= b.min.y &&
+           a.min.z <= b.max.z && a.max.z >= b.min.z;
+  }
+}
+
+MultiViewRenderer::MultiViewRenderer()
+  : shareAcrossViews(true),
+    shader("shaders/multiviewvs.txt", "shaders/multiviewfs.txt"),
+    objectsTested(0), unionSurvivors(0), draws(0), uploadedBytes(0),
+    prepareTime(0.0), drawTime(0.0)
+{
+  glGenBuffers(1, &modelBuffer);
+  glGenBuffers(1, &instanceBuffer);
+  glGenTextures(1, &modelTexture);
+  glGenTextures(1, &instanceTexture);
+
+  // the buffers get their storage in upload(), a buffer texture follows
+  // its buffer through reallocations
+  glBindBuffer(GL_TEXTURE_BUFFER, modelBuffer);
+  glBufferData(GL_TEXTURE_BUFFER, sizeof(glm::mat4), NULL, GL_STREAM_DRAW);
+  glBindTexture(GL_TEXTURE_BUFFER, modelTexture);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, modelBuffer);
+  glBindBuffer(GL_TEXTURE_BUFFER, instanceBuffer);
+  glBufferData(GL_TEXTURE_BUFFER, sizeof(uint32_t), NULL, GL_STREAM_DRAW);
+  glBindTexture(GL_TEXTURE_BUFFER, instanceTexture);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, instanceBuffer);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+  glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+MultiViewRenderer::~MultiViewRenderer()
+{
+  glDeleteTextures(1, &modelTexture);
+  glDeleteTextures(1, &instanceTexture);
+  glDeleteBuffers(1, &modelBuffer);
+  glDeleteBuffers(1, &instanceBuffer);
+  glDeleteProgram(shader.ID);
+}
+
+void MultiViewRenderer::sortVisible(const std::vector<RenderObject> &objects)
+{
+  // by mesh, so every mesh is one run of instances
+  std::sort(visible.begin(), visible.end(),
+            [&objects](unsigned int a, unsigned int b)
+            {
+              const RenderObject &x = objects[a], &y = objects[b];
+              if (x.VAO != y.VAO)
+                return x.VAO < y.VAO;
+              if (x.indexCount != y.indexCount)
+                return x.indexCount < y.indexCount;
+              return a < b;
+            });
+}
+
+void MultiViewRenderer::addRanges(const std::vector<RenderObject> &objects,
+                                  unsigned int viewBit,
+                                  unsigned int modelBase)
+{
+  // viewBit 0 takes every visible object
+  size_t firstRange = drawRanges.size();
+  for (size_t k = 0; k < visible.size(); k++)
+  {
+    const RenderObject &object = objects[visible[k]];
+    if (viewBit != 0 && (visibility[visible[k]] & viewBit) == 0)
+      continue;
+    if (drawRanges.size() == firstRange ||
+        drawRanges.back().VAO != object.VAO ||
+        drawRanges.back().indexCount != object.indexCount)
+    {
+      DrawRange range = {object.VAO, object.indexCount,
+                         (unsigned int)instances.size(), 0};
+      drawRanges.push_back(range);
+    }
+    instances.push_back(modelBase + (uint32_t)k);
+    drawRanges.back().instanceCount++;
+  }
+}
+
+void MultiViewRenderer::prepareShared(
+        const std::vector<RenderObject> &objects,
+        const std::vector<CameraView> &views)
+{
+  size_t viewCount = std::min(views.size(), (size_t)MAX_VIEWS);
+  std::vector<Frustum> frusta(viewCount);
+  AABB unionBox = {glm::vec3(1e30f), glm::vec3(-1e30f)};
+  for (size_t v = 0; v < viewCount; v++)
+  {
+    glm::mat4 viewProjection = views[v].projection * views[v].view;
+    frusta[v].extract(viewProjection);
+    glm::vec3 corners[8];
+    Frustum::corners(viewProjection, corners);
+    for (const glm::vec3 &corner : corners)
+    {
+      unionBox.min = glm::min(unionBox.min, corner);
+      unionBox.max = glm::max(unionBox.max, corner);
+    }
+  }
+
+  visibility.resize(objects.size());
+  visible.clear();
+  unionSurvivors = 0;
+  for (size_t i = 0; i < objects.size(); i++)
+  {
+    uint32_t mask = 0;
+    if (overlaps(unionBox, objects[i].bounds))
+    {
+      unionSurvivors++;
+      for (size_t v = 0; v < viewCount; v++)
+        if (frusta[v].intersects(objects[i].bounds))
+          mask |= 1u << v;
+    }
+    visibility[i] = mask;
+    if (mask != 0)
+      visible.push_back((unsigned int)i);
+  }
+  objectsTested = (unsigned int)objects.size();
+
+  sortVisible(objects);
+  models.clear();
+  for (unsigned int i : visible)
+    models.push_back(objects[i].model);
+  for (size_t v = 0; v < viewCount; v++)
+  {
+    viewRangeStart.push_back((unsigned int)drawRanges.size());
+    addRanges(objects, 1u << v, 0);
+  }
+}
+
+void MultiViewRenderer::prepareIndependent(
+        const std::vector<RenderObject> &objects,
+        const std::vector<CameraView> &views)
+{
+  size_t viewCount = std::min(views.size(), (size_t)MAX_VIEWS);
+  models.clear();
+  objectsTested = 0;
+  unionSurvivors = 0;
+  for (size_t v = 0; v < viewCount; v++)
+  {
+    Frustum frustum(views[v].projection * views[v].view);
+    visible.clear();
+    for (size_t i = 0; i < objects.size(); i++)
+      if (frustum.intersects(objects[i].bounds))
+        visible.push_back((unsigned int)i);
+    objectsTested += (unsigned int)objects.size();
+    unionSurvivors += (unsigned int)visible.size();
+
+    sortVisible(objects);
+    unsigned int modelBase = (unsigned int)models.size();
+    for (unsigned int i : visible)
+      models.push_back(objects[i].model);
+    viewRangeStart.push_back((unsigned int)drawRanges.size());
+    addRanges(objects, 0, modelBase);
+  }
+}
+
+void MultiViewRenderer::upload()
+{
+  // orphan and refill, each buffer is written once per frame
+  size_t modelBytes = std::max(models.size(), (size_t)1) * sizeof(glm::mat4);
+  size_t instanceBytes = std::max(instances.size(), (size_t)1) *
+                         sizeof(uint32_t);
+  glBindBuffer(GL_TEXTURE_BUFFER, modelBuffer);
+  glBufferData(GL_TEXTURE_BUFFER, modelBytes, NULL, GL_STREAM_DRAW);
+  glBufferSubData(GL_TEXTURE_BUFFER, 0, models.size() * sizeof(glm::mat4),
+                  models.data());
+  glBindBuffer(GL_TEXTURE_BUFFER, instanceBuffer);
+  glBufferData(GL_TEXTURE_BUFFER, instanceBytes, NULL, GL_STREAM_DRAW);
+  glBufferSubData(GL_TEXTURE_BUFFER, 0, instances.size() * sizeof(uint32_t),
+                  instances.data());
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+  uploadedBytes = models.size() * sizeof(glm::mat4) +
+                  instances.size() * sizeof(uint32_t);
+}
+
+void MultiViewRenderer::render(const std::vector<RenderObject> &objects,
+                               const std::vector<CameraView> &views)
+{
+  double start = now();
+  instances.clear();
+  drawRanges.clear();
+  viewRangeStart.clear();
+  if (shareAcrossViews)
+    prepareShared(objects, views);
+  else
+    prepareIndependent(objects, views);
+  viewRangeStart.push_back((unsigned int)drawRanges.size());
+  upload();
+  double prepared = now();
+
+  shader.use();
+  shader.setInt("models", 0);
+  shader.setInt("instances", 1);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_BUFFER, modelTexture);
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_BUFFER, instanceTexture);
+  glActiveTexture(GL_TEXTURE0);
+  int firstInstanceLocation = glGetUniformLocation(shader.ID,
+                                                   "firstInstance");
+
+  draws = 0;
+  for (size_t v = 0; v + 1 < viewRangeStart.size(); v++)
+  {
+    const CameraView &view = views[v];
+    glViewport(view.x, view.y, view.width, view.height);
+    shader.setMat4("viewProjection", view.projection * view.view);
+    unsigned int boundVAO = 0;
+    for (unsigned int r = viewRangeStart[v]; r < viewRangeStart[v + 1]; r++)
+    {
+      const DrawRange &range = drawRanges[r];
+      if (range.VAO != boundVAO)
+      {
+        glBindVertexArray(range.VAO);
+        boundVAO = range.VAO;
+      }
+      glUniform1i(firstInstanceLocation, (int)range.firstInstance);
+      glDrawElementsInstanced(GL_TRIANGLES, range.indexCount,
+                              GL_UNSIGNED_INT, 0, range.instanceCount);
+      draws++;
+    }
+  }
+  glBindVertexArray(0);
+  double drawn = now();
+  prepareTime = prepared - start;
+  drawTime = drawn - prepared;
+}
+
+unsigned int MultiViewRenderer::drawCalls() const
+{
+  return draws;
+}
+
+double MultiViewRenderer::prepareMilliseconds() const
+{
+  return prepareTime;
+}
+
+double MultiViewRenderer::drawMilliseconds() const
+{
+  return drawTime;
+}
+
+void MultiViewRenderer::printStats() const
+{
+  std::cout << "multiview (" << (shareAcrossViews ? "shared" : "independent")
+            << "): " << viewRangeStart.size() - 1 << " views, "
+            << objectsTested << " box tests, " << unionSurvivors
+            << (shareAcrossViews ? " in the union, " : " visible, ")
+            << instances.size() << " instances in " << draws
+            << " draws, " << uploadedBytes / 1024.0 << " KiB uploaded"
+            << std::endl;
+}
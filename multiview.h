@@ -0,0 +1,118 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_MULTIVIEW_H
+#define COORDINATESPACE_MULTIVIEW_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "renderobject.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Multi-view rendering
+ *  lib/glfw/examples/splitview.c draws the same scene into four viewports,
+ *  each one from scratch. With 4-8 cameras looking at the same world most
+ *  of that work is repeated: the same objects are culled, sorted and their
+ *  matrices uploaded once per view.
+ *
+ *  Here all views are prepared together:
+ *   1. every object is tested once against the bounding box of all view
+ *      frusta (the union of the views); most of the world fails this
+ *      already,
+ *   2. the survivors are tested against each view's frustum and remember
+ *      the result as one bit per view,
+ *   3. objects visible in any view are sorted by mesh once and their model
+ *      matrices go into a single buffer, uploaded once for all views,
+ *   4. every view gets the list of its visible objects in that shared
+ *      order (just indices into the shared matrices) and draws each mesh
+ *      with one instanced draw call.
+ *
+ *  The vertex shader reads its object index from the view's list with
+ *  firstInstance + gl_InstanceID and the model matrix from the shared
+ *  buffer, both through texture buffers (core since GL 3.1).
+ *
+ *  With shareAcrossViews off every view does the full cull, sort and
+ *  upload on its own, which is how the cost compares to rendering the
+ *  views independently.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+struct CameraView
+{
+  glm::mat4 view;
+  glm::mat4 projection;
+  // viewport in framebuffer pixels
+  int x, y, width, height;
+};
+
+class MultiViewRenderer
+{
+public:
+  // one bit per view in the visibility masks
+  static const int MAX_VIEWS = 32;
+
+  bool shareAcrossViews;
+
+  MultiViewRenderer();
+  ~MultiViewRenderer();
+  MultiViewRenderer(const MultiViewRenderer &) = delete;
+  MultiViewRenderer &operator=(const MultiViewRenderer &) = delete;
+
+  // cull, sort and upload for all views, then draw each one into its
+  // viewport
+  void render(const std::vector<RenderObject> &objects,
+              const std::vector<CameraView> &views);
+
+  unsigned int drawCalls() const;
+  // CPU time of the last render() spent culling/sorting/uploading and
+  // issuing draws
+  double prepareMilliseconds() const;
+  double drawMilliseconds() const;
+  void printStats() const;
+
+private:
+  // instances of one mesh visible in one view
+  struct DrawRange
+  {
+    unsigned int VAO;
+    unsigned int indexCount;
+    unsigned int firstInstance;
+    unsigned int instanceCount;
+  };
+
+  std::vector<uint32_t> visibility;
+  std::vector<unsigned int> visible;
+  std::vector<glm::mat4> models;
+  std::vector<uint32_t> instances;
+  // per view ranges into drawRanges
+  std::vector<unsigned int> viewRangeStart;
+  std::vector<DrawRange> drawRanges;
+
+  unsigned int modelBuffer;
+  unsigned int modelTexture;
+  unsigned int instanceBuffer;
+  unsigned int instanceTexture;
+  Shader shader;
+
+  unsigned int objectsTested;
+  unsigned int unionSurvivors;
+  unsigned int draws;
+  size_t uploadedBytes;
+  double prepareTime;
+  double drawTime;
+
+  void prepareShared(const std::vector<RenderObject> &objects,
+                     const std::vector<CameraView> &views);
+  void prepareIndependent(const std::vector<RenderObject> &objects,
+                          const std::vector<CameraView> &views);
+  void sortVisible(const std::vector<RenderObject> &objects);
+  void addRanges(const std::vector<RenderObject> &objects,
+                 unsigned int viewBit, unsigned int modelBase);
+  void upload();
+};
+#endif //COORDINATESPACE_MULTIVIEW_H
@@ -0,0 +1,190 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "opaquepass.h"
+#include "frustum.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace
+{
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+}
+
+OpaqueRenderer::OpaqueRenderer()
+  : depthPrepass(true), frontToBack(true),
+    depthShader("shaders/depthprepassvs.txt", "shaders/shadowdepthfs.txt"),
+    shader("shaders/opaquevs.txt", "shaders/opaquefs.txt"),
+    draws(0), sortTime(0.0)
+{
+}
+
+OpaqueRenderer::~OpaqueRenderer()
+{
+  glDeleteProgram(depthShader.ID);
+  glDeleteProgram(shader.ID);
+}
+
+void OpaqueRenderer::render(const std::vector<RenderObject> &objects,
+                            const glm::mat4 &view,
+                            const glm::mat4 &projection)
+{
+  double start = now();
+  glm::mat4 viewProjection = projection * view;
+  Frustum frustum(viewProjection);
+  // distance along the view direction of each box center, the row of the
+  // view matrix that produces view space z (pointing away from the camera)
+  glm::vec4 depthRow(view[0][2], view[1][2], view[2][2], view[3][2]);
+  order.clear();
+  for (size_t i = 0; i < objects.size(); i++)
+  {
+    const AABB &box = objects[i].bounds;
+    if (!frustum.intersects(box))
+      continue;
+    glm::vec4 center(0.5f * (box.min + box.max), 1.0f);
+    order.push_back(std::make_pair(-glm::dot(depthRow, center),
+                                   (unsigned int)i));
+  }
+  if (frontToBack)
+    std::sort(order.begin(), order.end());
+  sortTime = now() - start;
+
+  bool depthTest = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+  glEnable(GL_DEPTH_TEST);
+  draws = 0;
+  if (depthPrepass)
+  {
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_TRUE);
+    glDepthFunc(GL_LESS);
+    depthTimer.begin();
+    depthSamples.begin();
+    drawDepth(objects, viewProjection);
+    depthSamples.end();
+    depthTimer.end();
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    // the closest surface is known, shade exactly that one per pixel
+    glDepthMask(GL_FALSE);
+    glDepthFunc(GL_EQUAL);
+  }
+  shadingTimer.begin();
+  shadingSamples.begin();
+  drawShaded(objects, viewProjection, view);
+  shadingSamples.end();
+  shadingTimer.end();
+
+  glDepthMask(GL_TRUE);
+  glDepthFunc(GL_LESS);
+  if (!depthTest)
+    glDisable(GL_DEPTH_TEST);
+}
+
+void OpaqueRenderer::drawDepth(const std::vector<RenderObject> &objects,
+                               const glm::mat4 &viewProjection)
+{
+  depthShader.use();
+  depthShader.setMat4("viewProjection", viewProjection);
+  int modelLocation = glGetUniformLocation(depthShader.ID, "model");
+  unsigned int boundVAO = 0;
+  for (const std::pair<float, unsigned int> &entry : order)
+  {
+    const RenderObject &object = objects[entry.second];
+    unsigned int VAO = object.depthVAO != 0 ? object.depthVAO : object.VAO;
+    if (VAO != boundVAO)
+    {
+      glBindVertexArray(VAO);
+      boundVAO = VAO;
+    }
+    glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &object.model[0][0]);
+    glDrawElements(GL_TRIANGLES, object.indexCount, GL_UNSIGNED_INT, 0);
+    draws++;
+  }
+  glBindVertexArray(0);
+}
+
+void OpaqueRenderer::drawShaded(const std::vector<RenderObject> &objects,
+                                const glm::mat4 &viewProjection,
+                                const glm::mat4 &view)
+{
+  shader.use();
+  shader.setMat4("viewProjection", viewProjection);
+  shader.setVec3("viewPos", glm::vec3(glm::inverse(view)[3]));
+  int lightCount = (int)std::min(lights.size(), (size_t)MAX_LIGHTS);
+  shader.setInt("lightCount", lightCount);
+  for (int i = 0; i < lightCount; i++)
+  {
+    std::string index = "[" + std::to_string(i) + "]";
+    shader.setVec4("lightPositions" + index,
+                   glm::vec4(lights[i].position, lights[i].radius));
+    shader.setVec3("lightColors" + index, lights[i].color);
+  }
+  int modelLocation = glGetUniformLocation(shader.ID, "model");
+  unsigned int boundVAO = 0;
+  for (const std::pair<float, unsigned int> &entry : order)
+  {
+    const RenderObject &object = objects[entry.second];
+    if (object.VAO != boundVAO)
+    {
+      glBindVertexArray(object.VAO);
+      boundVAO = object.VAO;
+    }
+    glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &object.model[0][0]);
+    glDrawElements(GL_TRIANGLES, object.indexCount, GL_UNSIGNED_INT, 0);
+    draws++;
+  }
+  glBindVertexArray(0);
+}
+
+unsigned int OpaqueRenderer::drawCalls() const
+{
+  return draws;
+}
+
+double OpaqueRenderer::sortMilliseconds() const
+{
+  return sortTime;
+}
+
+long long OpaqueRenderer::shadedSamples()
+{
+  return shadingSamples.samples();
+}
+
+long long OpaqueRenderer::prepassSamples()
+{
+  return depthPrepass ? depthSamples.samples() : -1;
+}
+
+double OpaqueRenderer::shadingGpuMilliseconds()
+{
+  return shadingTimer.milliseconds();
+}
+
+double OpaqueRenderer::prepassGpuMilliseconds()
+{
+  return depthPrepass ? depthTimer.milliseconds() : -1.0;
+}
+
+void OpaqueRenderer::printStats()
+{
+  std::cout << "opaque (" << (depthPrepass ? "depth prepass" : "no prepass")
+            << ", " << (frontToBack ? "front to back" : "unsorted") << "): "
+            << order.size() << " objects in " << draws << " draws, "
+            << shadedSamples() << " samples shaded";
+  long long depth = prepassSamples();
+  long long shaded = shadedSamples();
+  if (depth > 0 && shaded > 0)
+    std::cout << ", prepass " << depth << " samples (depth overdraw "
+              << (double)depth / shaded << ")";
+  std::cout << std::endl;
+}
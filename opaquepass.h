@@ -0,0 +1,111 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_OPAQUEPASS_H
+#define COORDINATESPACE_OPAQUEPASS_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "renderobject.h"
+#include "gputimer.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Opaque pass with depth prepass
+ *  With the depth test on, a fragment hidden behind something drawn
+ *  earlier is rejected before its fragment shader runs (early depth test).
+ *  Everything drawn before the closest surface is still shaded and then
+ *  overwritten though: that's overdraw, and with an expensive lighting
+ *  shader it's where the frame goes.
+ *
+ *  There are two ways of cutting it down:
+ *
+ *   - front-to-back order: the objects are sorted by their distance to the
+ *     camera, near ones first, so most hidden fragments fail the depth test
+ *     already. It's cheap but only as good as the sort; intersecting or
+ *     large objects still overdraw.
+ *
+ *   - depth prepass: the scene is drawn twice. The first pass only writes
+ *     depth, with color writes off, a trivial fragment shader and the
+ *     position-only vertex stream (RenderObject::depthVAO). When it's done
+ *     the depth buffer holds the closest surface of every pixel, so the
+ *     second pass can shade with glDepthFunc(GL_EQUAL) and depth writes off:
+ *     exactly one fragment per pixel passes, whatever the order.
+ *
+ *  GL_EQUAL only works if both passes compute bit-identical depths, so both
+ *  vertex shaders declare gl_Position invariant and compute it with the same
+ *  expression from the same uniforms.
+ *
+ *  The prepass costs a second round of vertex work and draw calls, which is
+ *  why it's a per scene switch: it pays off when shading is expensive and
+ *  the scene has a high depth complexity. To decide, each pass counts the
+ *  samples that passed its depth test with an occlusion query and is timed
+ *  with GPU timestamps. shadedSamples() divided by the number of covered
+ *  pixels is the overdraw; with the prepass on, the shading pass shades
+ *  each covered pixel once and prepassSamples() / shadedSamples() is the
+ *  overdraw the (cheap) depth pass had instead.
+ *
+ *  The shading shader lights the objects with up to MAX_LIGHTS point
+ *  lights, the number of lights is the knob for the fragment cost. It reads
+ *  normals from attribute 1; meshes without normals get face normals.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+struct PointLight
+{
+  glm::vec3 position;
+  glm::vec3 color;
+  float radius;
+};
+
+class OpaqueRenderer
+{
+public:
+  static const int MAX_LIGHTS = 16;
+
+  bool depthPrepass;
+  bool frontToBack;
+  std::vector<PointLight> lights;
+
+  OpaqueRenderer();
+  ~OpaqueRenderer();
+  OpaqueRenderer(const OpaqueRenderer &) = delete;
+  OpaqueRenderer &operator=(const OpaqueRenderer &) = delete;
+
+  // cull, sort and draw the objects with the depth test on, the caller
+  // clears depth beforehand
+  void render(const std::vector<RenderObject> &objects,
+              const glm::mat4 &view, const glm::mat4 &projection);
+
+  unsigned int drawCalls() const;
+  // CPU time of the last render() spent culling and sorting
+  double sortMilliseconds() const;
+  // results of the most recent finished frame, -1 while none has finished
+  long long shadedSamples();
+  long long prepassSamples();
+  double shadingGpuMilliseconds();
+  double prepassGpuMilliseconds();
+  void printStats();
+
+private:
+  Shader depthShader;
+  Shader shader;
+  // object index and view space distance of the visible objects
+  std::vector<std::pair<float, unsigned int> > order;
+
+  SampleCounter shadingSamples;
+  SampleCounter depthSamples;
+  GpuTimer shadingTimer;
+  GpuTimer depthTimer;
+  unsigned int draws;
+  double sortTime;
+
+  void drawDepth(const std::vector<RenderObject> &objects,
+                 const glm::mat4 &viewProjection);
+  void drawShaded(const std::vector<RenderObject> &objects,
+                  const glm::mat4 &viewProjection, const glm::mat4 &view);
+};
+#endif //COORDINATESPACE_OPAQUEPASS_H
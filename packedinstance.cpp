@@ -0,0 +1,230 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "packedinstance.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+
+  void makeBufferTexture(unsigned int &buffer, unsigned int &texture,
+                         size_t bytes, GLenum internalFormat)
+  {
+    glGenBuffers(1, &buffer);
+    glGenTextures(1, &texture);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, internalFormat, buffer);
+  }
+
+  // orphan and refill, the buffers are rewritten every frame
+  void upload(unsigned int buffer, size_t capacity, const void* data,
+              size_t bytes)
+  {
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, data);
+  }
+}
+
+PackedInstanceRenderer::PackedInstanceRenderer(unsigned int VAO,
+                                               unsigned int indexCount,
+                                               unsigned int maxInstances)
+  : format(PACKED), simd(true), VAO(VAO), indexCount(indexCount),
+    maxInstances((maxInstances + 7) & ~7u), count(0),
+    matrixShader("shaders/instancematrixvs.txt", "shaders/multiviewfs.txt"),
+    packedShader("shaders/instancepackedvs.txt", "shaders/multiviewfs.txt"),
+    uploaded(0), packTime(0.0), uploadTime(0.0)
+{
+  std::vector<float>* arrays[] = {&x, &y, &z, &qx, &qy, &qz};
+  for (std::vector<float>* array : arrays)
+    array->assign(this->maxInstances, 0.0f);
+  // the padding holds identity transforms
+  qw.assign(this->maxInstances, 1.0f);
+  scale.assign(this->maxInstances, 1.0f);
+  positionScale.resize(this->maxInstances * 4);
+  rotation.resize(this->maxInstances * 4);
+  matrices.resize(this->maxInstances);
+
+  makeBufferTexture(matrixBuffer, matrixTexture,
+                    this->maxInstances * sizeof(glm::mat4), GL_RGBA32F);
+  makeBufferTexture(positionBuffer, positionTexture,
+                    this->maxInstances * 4 * sizeof(float), GL_RGBA32F);
+  makeBufferTexture(rotationBuffer, rotationTexture,
+                    this->maxInstances * 4 * sizeof(int16_t), GL_RGBA16I);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+  glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+PackedInstanceRenderer::~PackedInstanceRenderer()
+{
+  unsigned int textures[] = {matrixTexture, positionTexture, rotationTexture};
+  unsigned int buffers[] = {matrixBuffer, positionBuffer, rotationBuffer};
+  glDeleteTextures(3, textures);
+  glDeleteBuffers(3, buffers);
+  glDeleteProgram(matrixShader.ID);
+  glDeleteProgram(packedShader.ID);
+}
+
+void PackedInstanceRenderer::setCount(unsigned int count)
+{
+  this->count = std::min(count, maxInstances);
+}
+
+void PackedInstanceRenderer::setInstance(unsigned int index,
+                                         const glm::vec3 &position,
+                                         const glm::quat &rotation,
+                                         float scale)
+{
+  if (index >= maxInstances)
+  {
+    std::cout << "ERROR::PACKEDINSTANCE::INDEX_OUT_OF_RANGE " << index
+              << std::endl;
+    return;
+  }
+  x[index] = position.x;
+  y[index] = position.y;
+  z[index] = position.z;
+  this->scale[index] = scale;
+  qx[index] = rotation.x;
+  qy[index] = rotation.y;
+  qz[index] = rotation.z;
+  qw[index] = rotation.w;
+}
+
+void PackedInstanceRenderer::packMatrices()
+{
+  for (unsigned int i = 0; i < count; i++)
+  {
+    glm::quat q = glm::normalize(glm::quat(qw[i], qx[i], qy[i], qz[i]));
+    glm::mat4 model = glm::mat4_cast(q);
+    model[0] *= scale[i];
+    model[1] *= scale[i];
+    model[2] *= scale[i];
+    model[3] = glm::vec4(x[i], y[i], z[i], 1.0f);
+    matrices[i] = model;
+  }
+}
+
+void PackedInstanceRenderer::packTransforms()
+{
+  if (simd)
+  {
+    // the arrays are padded, a partial last group packs a few identities
+    const float8 one(1.0f), tiny(1e-20f);
+    for (unsigned int i = 0; i < count; i += 8)
+    {
+      float8 rx = float8::load(qx.data() + i);
+      float8 ry = float8::load(qy.data() + i);
+      float8 rz = float8::load(qz.data() + i);
+      float8 rw = float8::load(qw.data() + i);
+      float8 inverse = one / sqrt(max(rx * rx + ry * ry + rz * rz + rw * rw,
+                                      tiny));
+      storeSnorm16Interleaved4(rotation.data() + i * 4, rx * inverse,
+                               ry * inverse, rz * inverse, rw * inverse);
+      storeInterleaved4(positionScale.data() + i * 4,
+                        float8::load(x.data() + i), float8::load(y.data() + i),
+                        float8::load(z.data() + i),
+                        float8::load(scale.data() + i));
+    }
+    return;
+  }
+  for (unsigned int i = 0; i < count; i++)
+  {
+    glm::quat q = glm::normalize(glm::quat(qw[i], qx[i], qy[i], qz[i]));
+    float components[] = {q.x, q.y, q.z, q.w};
+    for (int c = 0; c < 4; c++)
+      rotation[i * 4 + c] = (int16_t)std::lrint(
+              std::min(std::max(components[c], -1.0f), 1.0f) * 32767.0f);
+    positionScale[i * 4 + 0] = x[i];
+    positionScale[i * 4 + 1] = y[i];
+    positionScale[i * 4 + 2] = z[i];
+    positionScale[i * 4 + 3] = scale[i];
+  }
+}
+
+void PackedInstanceRenderer::render(const glm::mat4 &viewProjection)
+{
+  double start = now();
+  if (format == PACKED)
+    packTransforms();
+  else
+    packMatrices();
+  double packed = now();
+
+  Shader &shader = format == PACKED ? packedShader : matrixShader;
+  shader.use();
+  shader.setMat4("viewProjection", viewProjection);
+  if (format == PACKED)
+  {
+    upload(positionBuffer, maxInstances * 4 * sizeof(float),
+           positionScale.data(), count * 4 * sizeof(float));
+    upload(rotationBuffer, maxInstances * 4 * sizeof(int16_t),
+           rotation.data(), count * 4 * sizeof(int16_t));
+    uploaded = count * (4 * sizeof(float) + 4 * sizeof(int16_t));
+    shader.setInt("positionScales", 0);
+    shader.setInt("rotations", 1);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, positionTexture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_BUFFER, rotationTexture);
+    glActiveTexture(GL_TEXTURE0);
+  }
+  else
+  {
+    upload(matrixBuffer, maxInstances * sizeof(glm::mat4), matrices.data(),
+           count * sizeof(glm::mat4));
+    uploaded = count * sizeof(glm::mat4);
+    shader.setInt("models", 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, matrixTexture);
+  }
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+  double uploadedAt = now();
+
+  glBindVertexArray(VAO);
+  glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0,
+                          count);
+  glBindVertexArray(0);
+  packTime = packed - start;
+  uploadTime = uploadedAt - packed;
+}
+
+size_t PackedInstanceRenderer::uploadedBytes() const
+{
+  return uploaded;
+}
+
+double PackedInstanceRenderer::packMilliseconds() const
+{
+  return packTime;
+}
+
+double PackedInstanceRenderer::uploadMilliseconds() const
+{
+  return uploadTime;
+}
+
+void PackedInstanceRenderer::printStats() const
+{
+  std::cout << "instances (" << (format == PACKED ? "packed" : "matrices")
+            << "): " << count << " in one draw, "
+            << uploaded / (1024.0 * 1024.0) << " MiB uploaded ("
+            << (count > 0 ? uploaded / count : 0) << " bytes each), packed in "
+            << packTime << " ms, uploaded in " << uploadTime << " ms"
+            << std::endl;
+}
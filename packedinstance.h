@@ -0,0 +1,104 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_PACKEDINSTANCE_H
+#define COORDINATESPACE_PACKEDINSTANCE_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "shader.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Packed instance transforms
+ *  A glm::mat4 per instance is 64 bytes, and most instances only have a
+ *  position, a rotation and a uniform scale; 8 floats say the same. The
+ *  packed format keeps
+ *
+ *    position and scale   4 floats            16 bytes
+ *    rotation quaternion  4 snorm16 integers   8 bytes
+ *
+ *  24 bytes per instance in two buffers. A unit quaternion's components
+ *  are all in [-1, 1], so 16 bit fixed point holds them to about 3e-5,
+ *  far below a pixel at any sensible object size. The vertex shader
+ *  decodes the quaternion (GL 3.3 buffer textures have no snorm formats,
+ *  it reads them as integers and divides) and rotates with it directly:
+ *
+ *    v' = v + 2 cross(q.xyz, cross(q.xyz, v) + q.w v)
+ *
+ *  Packing is done with float8: eight quaternions are normalized at once
+ *  and written with storeSnorm16Interleaved4, positions and scales with
+ *  storeInterleaved4. The transforms live in structure of arrays for
+ *  that, padded to a multiple of 8.
+ *
+ *  The MATRIX format uploads full model matrices built with glm for
+ *  comparison. Either way every instance of the mesh is one instanced
+ *  draw and the data is read through buffer textures with gl_InstanceID,
+ *  like the MultiViewRenderer does, so the mesh's VAO stays untouched.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class PackedInstanceRenderer
+{
+public:
+  enum Format
+  {
+    MATRIX,
+    PACKED
+  };
+
+  Format format;
+  // packing with float8, or one instance at a time
+  bool simd;
+
+  PackedInstanceRenderer(unsigned int VAO, unsigned int indexCount,
+                         unsigned int maxInstances);
+  ~PackedInstanceRenderer();
+  PackedInstanceRenderer(const PackedInstanceRenderer &) = delete;
+  PackedInstanceRenderer &operator=(const PackedInstanceRenderer &) = delete;
+
+  // the number of instances drawn, at most maxInstances
+  void setCount(unsigned int count);
+  void setInstance(unsigned int index, const glm::vec3 &position,
+                   const glm::quat &rotation, float scale);
+  // packs and uploads all instances in the current format, then draws them
+  void render(const glm::mat4 &viewProjection);
+
+  // of the last render()
+  size_t uploadedBytes() const;
+  double packMilliseconds() const;
+  double uploadMilliseconds() const;
+  void printStats() const;
+
+private:
+  unsigned int VAO;
+  unsigned int indexCount;
+  unsigned int maxInstances;
+  unsigned int count;
+
+  // transforms as structure of arrays, padded to a multiple of 8
+  std::vector<float> x, y, z, scale;
+  std::vector<float> qx, qy, qz, qw;
+  // packed output, reused every frame
+  std::vector<float> positionScale;
+  std::vector<int16_t> rotation;
+  std::vector<glm::mat4> matrices;
+
+  unsigned int matrixBuffer, matrixTexture;
+  unsigned int positionBuffer, positionTexture;
+  unsigned int rotationBuffer, rotationTexture;
+  Shader matrixShader;
+  Shader packedShader;
+
+  size_t uploaded;
+  double packTime;
+  double uploadTime;
+
+  void packMatrices();
+  void packTransforms();
+};
+#endif //COORDINATESPACE_PACKEDINSTANCE_H
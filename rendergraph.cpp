@@ -0,0 +1,458 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "rendergraph.h"
+
+#include <algorithm>
+#include <iostream>
+
+bool RenderTargetDesc::operator==(const RenderTargetDesc &other) const
+{
+  return width == other.width && height == other.height &&
+         format == other.format;
+}
+
+bool RenderTargetDesc::isDepth() const
+{
+  return format == GL_DEPTH_COMPONENT16 || format == GL_DEPTH_COMPONENT24 ||
+         format == GL_DEPTH_COMPONENT32F || format == GL_DEPTH24_STENCIL8 ||
+         format == GL_DEPTH32F_STENCIL8;
+}
+
+size_t RenderTargetDesc::bytes() const
+{
+  size_t texelBytes;
+  switch (format)
+  {
+    case GL_R8:
+      texelBytes = 1;
+      break;
+    case GL_RG8:
+    case GL_R16F:
+    case GL_DEPTH_COMPONENT16:
+      texelBytes = 2;
+      break;
+    case GL_RGBA16F:
+    case GL_RG32F:
+    case GL_DEPTH32F_STENCIL8:
+      texelBytes = 8;
+      break;
+    case GL_RGBA32F:
+      texelBytes = 16;
+      break;
+    default:
+      // RGBA8, RGB10_A2, R11F_G11F_B10F, RG16F, R32F, 24/32 bit depth
+      texelBytes = 4;
+      break;
+  }
+  return (size_t)width * height * texelBytes;
+}
+
+RenderGraph::RenderGraph()
+  : frame(0), unaliasedBytes(0), usedPoolBytes(0), culledPasses(0)
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+  for (const std::pair<const std::vector<unsigned int>, unsigned int> &fbo :
+          framebuffers)
+    glDeleteFramebuffers(1, &fbo.second);
+  for (const PooledTexture &pooled : pool)
+    glDeleteTextures(1, &pooled.texture);
+}
+
+void RenderGraph::reset()
+{
+  resources.clear();
+  passes.clear();
+  order.clear();
+}
+
+int RenderGraph::createTexture(const char* name, const RenderTargetDesc &desc)
+{
+  Resource resource = {name, desc, false, false, 0, -1, -1};
+  resources.push_back(resource);
+  return (int)resources.size() - 1;
+}
+
+int RenderGraph::importTexture(const char* name, unsigned int texture,
+                               const RenderTargetDesc &desc)
+{
+  Resource resource = {name, desc, true, false, texture, -1, -1};
+  resources.push_back(resource);
+  return (int)resources.size() - 1;
+}
+
+int RenderGraph::addPass(const char* name, PassFunction execute)
+{
+  Pass pass;
+  pass.name = name;
+  pass.execute = execute;
+  pass.culled = false;
+  passes.push_back(pass);
+  return (int)passes.size() - 1;
+}
+
+void RenderGraph::read(int pass, int resource)
+{
+  passes[pass].reads.push_back(resource);
+}
+
+void RenderGraph::write(int pass, int resource)
+{
+  passes[pass].writes.push_back(resource);
+}
+
+void RenderGraph::markOutput(int resource)
+{
+  resources[resource].output = true;
+}
+
+void RenderGraph::compile()
+{
+  frame++;
+  cull();
+  sortPasses();
+  assignTextures();
+  trimPool();
+}
+
+void RenderGraph::cull()
+{
+  // walking the passes backwards, a pass is needed when it writes something
+  // that is needed, and then everything it reads is needed too. Passes
+  // reading a resource are added after the ones writing it, so one sweep
+  // is enough.
+  std::vector<bool> needed(resources.size(), false);
+  for (size_t i = 0; i < resources.size(); i++)
+    needed[i] = resources[i].output;
+
+  culledPasses = 0;
+  for (int p = (int)passes.size() - 1; p >= 0; p--)
+  {
+    Pass &pass = passes[p];
+    pass.culled = true;
+    for (int resource : pass.writes)
+      if (needed[resource])
+        pass.culled = false;
+    if (pass.culled)
+    {
+      culledPasses++;
+      continue;
+    }
+    for (int resource : pass.reads)
+      needed[resource] = true;
+  }
+}
+
+void RenderGraph::sortPasses()
+{
+  // dependency edges between the passes that survived culling, per
+  // resource in the order the passes were added: a reader runs after the
+  // latest writer before it, a writer after the writers and readers before
+  // it
+  size_t count = passes.size();
+  std::vector<std::vector<int>> dependents(count);
+  std::vector<int> dependencies(count, 0);
+  for (size_t r = 0; r < resources.size(); r++)
+  {
+    int lastWriter = -1;
+    std::vector<int> readersSinceWrite;
+    for (size_t p = 0; p < count; p++)
+    {
+      const Pass &pass = passes[p];
+      if (pass.culled)
+        continue;
+      bool reads = std::find(pass.reads.begin(), pass.reads.end(), (int)r) !=
+                   pass.reads.end();
+      bool writes = std::find(pass.writes.begin(), pass.writes.end(),
+                              (int)r) != pass.writes.end();
+      if (reads && lastWriter >= 0)
+      {
+        dependents[lastWriter].push_back((int)p);
+        dependencies[p]++;
+      }
+      if (writes)
+      {
+        if (lastWriter >= 0 && !reads)
+        {
+          dependents[lastWriter].push_back((int)p);
+          dependencies[p]++;
+        }
+        for (int reader : readersSinceWrite)
+        {
+          if (reader == (int)p)
+            continue;
+          dependents[reader].push_back((int)p);
+          dependencies[p]++;
+        }
+        readersSinceWrite.clear();
+        lastWriter = (int)p;
+      }
+      else if (reads)
+      {
+        readersSinceWrite.push_back((int)p);
+      }
+    }
+  }
+
+  // Kahn's algorithm, of the ready passes the one added first goes next so
+  // the order stays close to how the frame was written down
+  std::vector<bool> scheduled(count, false);
+  order.clear();
+  for (;;)
+  {
+    int next = -1;
+    for (size_t p = 0; p < count && next < 0; p++)
+      if (!passes[p].culled && !scheduled[p] && dependencies[p] == 0)
+        next = (int)p;
+    if (next < 0)
+      break;
+    scheduled[next] = true;
+    order.push_back(next);
+    for (int dependent : dependents[next])
+      dependencies[dependent]--;
+  }
+
+  for (size_t p = 0; p < count; p++)
+  {
+    if (!passes[p].culled && !scheduled[p])
+    {
+      std::cout << "ERROR::RENDERGRAPH::DEPENDENCY_CYCLE at pass "
+                << passes[p].name << std::endl;
+      order.push_back((int)p);
+    }
+  }
+}
+
+void RenderGraph::assignTextures()
+{
+  for (Resource &resource : resources)
+  {
+    resource.firstUse = -1;
+    resource.lastUse = -1;
+  }
+  for (size_t i = 0; i < order.size(); i++)
+  {
+    const Pass &pass = passes[order[i]];
+    for (int r : pass.reads)
+    {
+      Resource &resource = resources[r];
+      if (resource.firstUse < 0)
+        resource.firstUse = (int)i;
+      resource.lastUse = (int)i;
+    }
+    for (int r : pass.writes)
+    {
+      Resource &resource = resources[r];
+      if (resource.firstUse < 0)
+        resource.firstUse = (int)i;
+      resource.lastUse = (int)i;
+    }
+  }
+
+  // transients in the order they come alive, each takes the first pooled
+  // texture of its kind that is free by then
+  std::vector<int> transients;
+  for (size_t r = 0; r < resources.size(); r++)
+    if (!resources[r].imported && resources[r].firstUse >= 0)
+      transients.push_back((int)r);
+  std::stable_sort(transients.begin(), transients.end(),
+                   [this](int a, int b)
+                   {
+                     return resources[a].firstUse < resources[b].firstUse;
+                   });
+
+  for (PooledTexture &pooled : pool)
+    pooled.busyUntil = -1;
+  unaliasedBytes = 0;
+  usedPoolBytes = 0;
+  for (int r : transients)
+  {
+    Resource &resource = resources[r];
+    unaliasedBytes += resource.desc.bytes();
+
+    PooledTexture* match = NULL;
+    for (PooledTexture &pooled : pool)
+    {
+      if (pooled.desc == resource.desc &&
+          pooled.busyUntil < resource.firstUse)
+      {
+        match = &pooled;
+        break;
+      }
+    }
+    if (match == NULL)
+    {
+      PooledTexture pooled;
+      pooled.desc = resource.desc;
+      pooled.busyUntil = -1;
+      glGenTextures(1, &pooled.texture);
+      glBindTexture(GL_TEXTURE_2D, pooled.texture);
+      unsigned int format = GL_RGBA, type = GL_UNSIGNED_BYTE;
+      if (resource.desc.format == GL_DEPTH24_STENCIL8)
+      {
+        format = GL_DEPTH_STENCIL;
+        type = GL_UNSIGNED_INT_24_8;
+      }
+      else if (resource.desc.format == GL_DEPTH32F_STENCIL8)
+      {
+        format = GL_DEPTH_STENCIL;
+        type = GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+      }
+      else if (resource.desc.isDepth())
+      {
+        format = GL_DEPTH_COMPONENT;
+        type = GL_FLOAT;
+      }
+      glTexImage2D(GL_TEXTURE_2D, 0, resource.desc.format,
+                   resource.desc.width, resource.desc.height, 0, format,
+                   type, NULL);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      pool.push_back(pooled);
+      match = &pool.back();
+    }
+    if (match->busyUntil < 0)
+      usedPoolBytes += match->desc.bytes();
+    match->busyUntil = resource.lastUse;
+    match->lastFrame = frame;
+    resource.texture = match->texture;
+  }
+}
+
+void RenderGraph::trimPool()
+{
+  for (size_t i = 0; i < pool.size();)
+  {
+    if (frame - pool[i].lastFrame < POOL_FRAMES)
+    {
+      i++;
+      continue;
+    }
+    unsigned int texture = pool[i].texture;
+    // framebuffers using it go as well
+    for (std::map<std::vector<unsigned int>, unsigned int>::iterator it =
+            framebuffers.begin(); it != framebuffers.end();)
+    {
+      if (std::find(it->first.begin(), it->first.end(), texture) !=
+          it->first.end())
+      {
+        glDeleteFramebuffers(1, &it->second);
+        it = framebuffers.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+    glDeleteTextures(1, &texture);
+    pool[i] = pool.back();
+    pool.pop_back();
+  }
+}
+
+unsigned int RenderGraph::framebufferFor(const Pass &pass)
+{
+  std::vector<unsigned int> attachments;
+  unsigned int depth = 0;
+  for (int r : pass.writes)
+  {
+    const Resource &resource = resources[r];
+    // the default framebuffer can't be combined with textures
+    if (resource.imported && resource.texture == 0)
+      return 0;
+    if (resource.desc.isDepth())
+      depth = resource.texture;
+    else
+      attachments.push_back(resource.texture);
+  }
+  attachments.push_back(depth);
+
+  std::map<std::vector<unsigned int>, unsigned int>::iterator it =
+          framebuffers.find(attachments);
+  if (it != framebuffers.end())
+    return it->second;
+
+  unsigned int FBO;
+  glGenFramebuffers(1, &FBO);
+  glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+  std::vector<unsigned int> drawBuffers;
+  for (size_t i = 0; i + 1 < attachments.size(); i++)
+  {
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i,
+                           GL_TEXTURE_2D, attachments[i], 0);
+    drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + i);
+  }
+  if (depth != 0)
+  {
+    unsigned int attachment = GL_DEPTH_ATTACHMENT;
+    for (int r : pass.writes)
+      if (resources[r].texture == depth &&
+          (resources[r].desc.format == GL_DEPTH24_STENCIL8 ||
+           resources[r].desc.format == GL_DEPTH32F_STENCIL8))
+        attachment = GL_DEPTH_STENCIL_ATTACHMENT;
+    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, depth,
+                           0);
+  }
+  if (drawBuffers.empty())
+    glDrawBuffer(GL_NONE);
+  else
+    glDrawBuffers((GLsizei)drawBuffers.size(), drawBuffers.data());
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    std::cout << "ERROR::RENDERGRAPH::FRAMEBUFFER_INCOMPLETE for pass "
+              << pass.name << std::endl;
+  framebuffers[attachments] = FBO;
+  return FBO;
+}
+
+void RenderGraph::execute()
+{
+  for (int p : order)
+  {
+    const Pass &pass = passes[p];
+    if (!pass.writes.empty())
+    {
+      const RenderTargetDesc &desc = resources[pass.writes[0]].desc;
+      glBindFramebuffer(GL_FRAMEBUFFER, framebufferFor(pass));
+      glViewport(0, 0, desc.width, desc.height);
+    }
+    pass.execute(*this);
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+unsigned int RenderGraph::getTexture(int resource) const
+{
+  return resources[resource].texture;
+}
+
+size_t RenderGraph::transientBytes() const
+{
+  return unaliasedBytes;
+}
+
+size_t RenderGraph::aliasedBytes() const
+{
+  return usedPoolBytes;
+}
+
+int RenderGraph::culledPassCount() const
+{
+  return culledPasses;
+}
+
+void RenderGraph::printStats() const
+{
+  const double MiB = 1024.0 * 1024.0;
+  std::cout << "render graph: " << order.size() << " passes ("
+            << culledPasses << " culled), render targets "
+            << unaliasedBytes / MiB << " MiB without aliasing, "
+            << usedPoolBytes / MiB << " MiB aliased, pool holds "
+            << pool.size() << " textures" << std::endl;
+}
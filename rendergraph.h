@@ -0,0 +1,139 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_RENDERGRAPH_H
+#define COORDINATESPACE_RENDERGRAPH_H
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Render graph
+ *  Instead of every pass owning its framebuffers, each frame describes its
+ *  passes up front: which render targets a pass reads and which it writes.
+ *  Only after the whole frame is known are real textures handed out.
+ *
+ *  compile() then
+ *   1. culls passes whose results nobody needs: starting from the resources
+ *      marked as outputs (usually the default framebuffer) it walks back
+ *      through the passes that write them and the resources those read,
+ *      everything not reached is skipped,
+ *   2. orders the remaining passes so that every pass runs after the
+ *      passes writing what it reads (resources written by several passes
+ *      are written in the order the passes were added),
+ *   3. works out the lifetime of each transient render target, from the
+ *      first to the last pass using it, and gives targets whose lifetimes
+ *      don't overlap the same texture.
+ *
+ *  GL has no way to place two textures in the same memory, so aliasing here
+ *  means reusing a whole texture object: a target can take over a pooled
+ *  texture of the same size and format once the previous user is done with
+ *  it. The pool survives from frame to frame, textures that haven't been
+ *  used for a few frames are deleted.
+ *
+ *  Imported resources are textures owned by someone else; texture 0 stands
+ *  for the default framebuffer.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+struct RenderTargetDesc
+{
+  int width;
+  int height;
+  // sized internal format, e.g. GL_RGBA16F or GL_DEPTH24_STENCIL8
+  unsigned int format;
+
+  bool operator==(const RenderTargetDesc &other) const;
+  bool isDepth() const;
+  size_t bytes() const;
+};
+
+class RenderGraph
+{
+public:
+  typedef std::function<void(const RenderGraph &graph)> PassFunction;
+
+  RenderGraph();
+  ~RenderGraph();
+  RenderGraph(const RenderGraph &) = delete;
+  RenderGraph &operator=(const RenderGraph &) = delete;
+
+  // forget the passes and resources of the last frame, the texture pool
+  // stays
+  void reset();
+
+  int createTexture(const char* name, const RenderTargetDesc &desc);
+  int importTexture(const char* name, unsigned int texture,
+                    const RenderTargetDesc &desc);
+  int addPass(const char* name, PassFunction execute);
+  void read(int pass, int resource);
+  void write(int pass, int resource);
+  void markOutput(int resource);
+
+  void compile();
+  // binds each pass' framebuffer and viewport, then runs it
+  void execute();
+
+  // texture behind a resource, valid after compile()
+  unsigned int getTexture(int resource) const;
+
+  // render target memory this frame if every transient had its own texture
+  size_t transientBytes() const;
+  // memory of the pooled textures this frame actually uses
+  size_t aliasedBytes() const;
+  int culledPassCount() const;
+  void printStats() const;
+
+private:
+  struct Resource
+  {
+    const char* name;
+    RenderTargetDesc desc;
+    bool imported;
+    bool output;
+    unsigned int texture;
+    int firstUse;
+    int lastUse;
+  };
+
+  struct Pass
+  {
+    const char* name;
+    PassFunction execute;
+    std::vector<int> reads;
+    std::vector<int> writes;
+    bool culled;
+  };
+
+  struct PooledTexture
+  {
+    RenderTargetDesc desc;
+    unsigned int texture;
+    int busyUntil;
+    int lastFrame;
+  };
+
+  static const int POOL_FRAMES = 3;
+
+  std::vector<Resource> resources;
+  std::vector<Pass> passes;
+  std::vector<int> order;
+  std::vector<PooledTexture> pool;
+  // framebuffers by their attachments, depth last
+  std::map<std::vector<unsigned int>, unsigned int> framebuffers;
+  int frame;
+  size_t unaliasedBytes;
+  size_t usedPoolBytes;
+  int culledPasses;
+
+  void cull();
+  void sortPasses();
+  void assignTextures();
+  void trimPool();
+  unsigned int framebufferFor(const Pass &pass);
+};
+#endif //COORDINATESPACE_RENDERGRAPH_H
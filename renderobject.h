@@ -0,0 +1,34 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_RENDEROBJECT_H
+#define COORDINATESPACE_RENDEROBJECT_H
+
+#include <glm/glm.hpp>
+#include "frustum.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * A RenderObject is everything a pass needs to know to draw one mesh
+ * instance: the vertex array holding its (indexed) geometry, where it sits
+ * in the world (the model matrix) and a world-space bounding box used for
+ * culling. Whoever moves the object is responsible for keeping bounds in
+ * sync with model.
+ *
+ * depthVAO optionally holds the same triangles as a position-only stream
+ * (attribute 0 only, the same indexCount, vertices shared wherever the
+ * positions match). Depth-only passes draw it instead of VAO and fetch 12
+ * bytes per vertex rather than the full vertex; 0 means use VAO.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+struct RenderObject
+{
+  unsigned int VAO;
+  unsigned int indexCount;
+  glm::mat4 model;
+  AABB bounds;
+  unsigned int depthVAO = 0;
+};
+#endif //COORDINATESPACE_RENDEROBJECT_H
@@ -4,6 +4,7 @@
 
 #include <glad/glad.h>
 #include "shader.h"
+#include <glm/gtc/type_ptr.hpp>
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath)
 {
@@ -79,6 +80,87 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
   glDeleteShader(fragment);
 }
 
+Shader::Shader(const char* vertexPath,
+               const std::vector<const char*> &varyings)
+{
+  unsigned int vertex = compile(GL_VERTEX_SHADER, vertexPath, "VERTEX");
+
+  ID = glCreateProgram();
+  glAttachShader(ID, vertex);
+  // the captured outputs have to be known before linking
+  glTransformFeedbackVaryings(ID, (GLsizei)varyings.size(), varyings.data(),
+                              GL_INTERLEAVED_ATTRIBS);
+  glLinkProgram(ID);
+  checkCompileErrors(ID, "PROGRAM");
+
+  glDeleteShader(vertex);
+}
+
+Shader::Shader(const char* vertexPath, const char* geometryPath,
+               const char* fragmentPath,
+               const std::vector<const char*> &varyings)
+{
+  unsigned int vertex = compile(GL_VERTEX_SHADER, vertexPath, "VERTEX");
+  unsigned int geometry = compile(GL_GEOMETRY_SHADER, geometryPath,
+                                  "GEOMETRY");
+  unsigned int fragment = compile(GL_FRAGMENT_SHADER, fragmentPath,
+                                  "FRAGMENT");
+
+  ID = glCreateProgram();
+  glAttachShader(ID, vertex);
+  glAttachShader(ID, geometry);
+  glAttachShader(ID, fragment);
+  if (!varyings.empty())
+    glTransformFeedbackVaryings(ID, (GLsizei)varyings.size(),
+                                varyings.data(), GL_INTERLEAVED_ATTRIBS);
+  glLinkProgram(ID);
+  checkCompileErrors(ID, "PROGRAM");
+
+  glDeleteShader(vertex);
+  glDeleteShader(geometry);
+  glDeleteShader(fragment);
+}
+
+Shader::Shader(const char* computePath)
+{
+  unsigned int compute = compile(GL_COMPUTE_SHADER, computePath, "COMPUTE");
+  ID = glCreateProgram();
+  glAttachShader(ID, compute);
+  glLinkProgram(ID);
+  checkCompileErrors(ID, "PROGRAM");
+  glDeleteShader(compute);
+}
+
+std::string Shader::readFile(const char* path)
+{
+  std::ifstream file;
+  file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+  try
+  {
+    file.open(path);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    file.close();
+    return stream.str();
+  }
+  catch(std::ifstream::failure e)
+  {
+    std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
+  }
+  return std::string();
+}
+
+unsigned int Shader::compile(GLenum stage, const char* path, std::string type)
+{
+  std::string code = readFile(path);
+  const char* source = code.c_str();
+  unsigned int shader = glCreateShader(stage);
+  glShaderSource(shader, 1, &source, nullptr);
+  glCompileShader(shader);
+  checkCompileErrors(shader, type);
+  return shader;
+}
+
 //the use function is straightforward:
 void Shader::use()
 {
@@ -101,6 +183,27 @@ void Shader::setFloat(const std::string &name, float value) const
   glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
 }
 
+void Shader::setVec2(const std::string &name, const glm::vec2 &value) const
+{
+  glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+}
+
+void Shader::setVec3(const std::string &name, const glm::vec3 &value) const
+{
+  glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+}
+
+void Shader::setVec4(const std::string &name, const glm::vec4 &value) const
+{
+  glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+}
+
+void Shader::setMat4(const std::string &name, const glm::mat4 &value) const
+{
+  glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE,
+                     glm::value_ptr(value));
+}
+
 void Shader::checkCompileErrors(GLuint shader, std::string type)
 {
   GLint success;
@@ -9,6 +9,9 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+
+#include <glm/glm.hpp>
 
 ///////////////////////////////////////////////////////////////////////////
 /*
@@ -31,13 +34,30 @@ public:
 
   // constructor reads and builds the shader
   Shader(const char* vertexPath, const char* fragmentPath);
+  // vertex only program whose outputs are captured with transform feedback,
+  // the varyings are interleaved into a single buffer in the given order
+  Shader(const char* vertexPath, const std::vector<const char*> &varyings);
+  // vertex, geometry and fragment shader; varyings (may be empty) are
+  // captured interleaved from the geometry shader's outputs
+  Shader(const char* vertexPath, const char* geometryPath,
+         const char* fragmentPath, const std::vector<const char*> &varyings);
+  // compute shader program (GL 4.3 or ARB_compute_shader)
+  explicit Shader(const char* computePath);
   // use/activate the shader
   void use();
   //utility uniform functions
   void setBool(const std::string &name, bool value) const;
   void setInt(const std::string &name, int value) const;
   void setFloat(const std::string &name, float value)const;
+  void setVec2(const std::string &name, const glm::vec2 &value) const;
+  void setVec3(const std::string &name, const glm::vec3 &value) const;
+  void setVec4(const std::string &name, const glm::vec4 &value) const;
+  void setMat4(const std::string &name, const glm::mat4 &value) const;
   void checkCompileErrors(GLuint shader, std::string type);
   unsigned int getProgram();
+
+private:
+  static std::string readFile(const char* path);
+  unsigned int compile(GLenum stage, const char* path, std::string type);
 };
 #endif //SHADERCLASS_SHADER_H
@@ -0,0 +1,270 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "shadowmap.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+  // FNV-1a, good enough to notice that a matrix or caster list changed
+  unsigned long long hashBytes(unsigned long long hash, const void *data,
+                               size_t size)
+  {
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++)
+    {
+      hash ^= bytes[i];
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  const unsigned long long HASH_SEED = 14695981039346656037ULL;
+}
+
+CascadedShadowMap::CascadedShadowMap(int cascadeCount, int resolution)
+  : splitLambda(0.75f), shadowDistance(100.0f), cachedFromCascade(2),
+    cascadeCount(std::min(std::max(cascadeCount, 1), (int)MAX_CASCADES)),
+    resolution(resolution),
+    depthShader("shaders/shadowdepthvs.txt", "shaders/shadowdepthfs.txt")
+{
+  for (int i = 0; i < MAX_CASCADES; i++)
+  {
+    cascades[i].splitNear = 0.0f;
+    cascades[i].splitFar = 0.0f;
+    cascades[i].lightSpaceMatrix = glm::mat4(1.0f);
+    cascades[i].signature = 0;
+    cascades[i].renderedSignature = 0;
+    cascades[i].needsRender = true;
+    renderedThisFrame[i] = false;
+  }
+
+  glGenTextures(1, &depthTexture);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, depthTexture);
+  glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, resolution,
+               resolution, this->cascadeCount, 0, GL_DEPTH_COMPONENT, GL_FLOAT,
+               NULL);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+  // everything outside the map counts as lit
+  float border[] = {1.0f, 1.0f, 1.0f, 1.0f};
+  glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, border);
+  // let the sampler do the depth comparison (and filter the result)
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE,
+                  GL_COMPARE_REF_TO_TEXTURE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+  glGenFramebuffers(1, &FBO);
+  glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+  glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthTexture,
+                            0, 0);
+  // depth only, there is no color buffer to draw to or read from
+  glDrawBuffer(GL_NONE);
+  glReadBuffer(GL_NONE);
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    std::cout << "ERROR::SHADOWMAP::FRAMEBUFFER_INCOMPLETE" << std::endl;
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+CascadedShadowMap::~CascadedShadowMap()
+{
+  glDeleteFramebuffers(1, &FBO);
+  glDeleteTextures(1, &depthTexture);
+  glDeleteProgram(depthShader.ID);
+}
+
+void CascadedShadowMap::update(const glm::mat4 &view, float fovy,
+                               float aspect, float zNear, float zFar,
+                               const glm::vec3 &lightDir,
+                               const std::vector<RenderObject> &casters)
+{
+  float farthest = std::min(zFar, shadowDistance);
+
+  // rotation only view of the light, looking down lightDir
+  glm::vec3 direction = glm::normalize(lightDir);
+  glm::vec3 up = std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f)
+                                               : glm::vec3(0.0f, 1.0f, 0.0f);
+  glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), direction, up);
+
+  // light space bounds of every caster, shared by all cascades
+  std::vector<AABB> lightBounds(casters.size());
+  for (size_t i = 0; i < casters.size(); i++)
+    lightBounds[i] = transformAABB(casters[i].bounds, lightView);
+
+  for (int c = 0; c < cascadeCount; c++)
+  {
+    Cascade &cascade = cascades[c];
+
+    // split distances, a blend of the logarithmic and uniform scheme
+    float ratio = (float)c / (float)cascadeCount;
+    float nextRatio = (float)(c + 1) / (float)cascadeCount;
+    float logNear = zNear * std::pow(farthest / zNear, ratio);
+    float logFar = zNear * std::pow(farthest / zNear, nextRatio);
+    float uniNear = zNear + (farthest - zNear) * ratio;
+    float uniFar = zNear + (farthest - zNear) * nextRatio;
+    cascade.splitNear = splitLambda * logNear + (1.0f - splitLambda) * uniNear;
+    cascade.splitFar = splitLambda * logFar + (1.0f - splitLambda) * uniFar;
+
+    // bounding sphere of the world space slice corners
+    glm::mat4 sliceProjection = glm::perspective(fovy, aspect,
+                                                 cascade.splitNear,
+                                                 cascade.splitFar);
+    glm::vec3 corners[8];
+    Frustum::corners(sliceProjection * view, corners);
+    glm::vec3 center(0.0f);
+    for (int i = 0; i < 8; i++)
+      center += corners[i];
+    center /= 8.0f;
+    float radius = 0.0f;
+    for (int i = 0; i < 8; i++)
+      radius = std::max(radius, glm::length(corners[i] - center));
+    // round the radius up so floating point noise doesn't change the size
+    radius = std::ceil(radius * 16.0f) / 16.0f;
+
+    // snap the center to the texel grid of the shadow map
+    float texelSize = 2.0f * radius / (float)resolution;
+    glm::vec3 lightCenter = glm::vec3(lightView * glm::vec4(center, 1.0f));
+    lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+    lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+
+    float left = lightCenter.x - radius, right = lightCenter.x + radius;
+    float bottom = lightCenter.y - radius, top = lightCenter.y + radius;
+    // the light looks down -z, so further along the light is a lower z
+    float sliceBack = lightCenter.z - radius;
+    float sliceFront = lightCenter.z + radius;
+
+    // a caster can only shadow the slice when it overlaps the slice
+    // rectangle and isn't completely behind it
+    cascade.casters.clear();
+    float front = sliceFront;
+    for (size_t i = 0; i < casters.size(); i++)
+    {
+      const AABB &box = lightBounds[i];
+      if (box.max.x < left || box.min.x > right ||
+          box.max.y < bottom || box.min.y > top || box.max.z < sliceBack)
+        continue;
+      cascade.casters.push_back((unsigned int)i);
+      front = std::max(front, box.max.z);
+    }
+
+    // quantize the depth range as well so it only moves in coarse steps
+    float depthStep = radius * 0.25f;
+    sliceBack = std::floor(sliceBack / depthStep) * depthStep;
+    front = std::ceil(front / depthStep) * depthStep;
+
+    glm::mat4 projection = glm::ortho(left, right, bottom, top, -front,
+                                      -sliceBack);
+    cascade.lightSpaceMatrix = projection * lightView;
+
+    unsigned long long signature = hashBytes(HASH_SEED,
+                                             &cascade.lightSpaceMatrix,
+                                             sizeof(glm::mat4));
+    for (size_t i = 0; i < cascade.casters.size(); i++)
+    {
+      unsigned int index = cascade.casters[i];
+      signature = hashBytes(signature, &index, sizeof(index));
+      signature = hashBytes(signature, &casters[index].model,
+                            sizeof(glm::mat4));
+    }
+    cascade.signature = signature;
+    cascade.needsRender = c < cachedFromCascade ||
+                          signature != cascade.renderedSignature;
+  }
+}
+
+void CascadedShadowMap::render(const std::vector<RenderObject> &casters)
+{
+  // the caller's target and depth state, put back at the end
+  GLint viewport[4], framebuffer;
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+  bool depthTest = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+  GLboolean depthMask;
+  glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+  glViewport(0, 0, resolution, resolution);
+  glEnable(GL_DEPTH_TEST);
+  glDepthMask(GL_TRUE);
+  // push the stored depth back a bit to avoid shadow acne
+  glEnable(GL_POLYGON_OFFSET_FILL);
+  glPolygonOffset(2.0f, 4.0f);
+  depthShader.use();
+
+  for (int c = 0; c < cascadeCount; c++)
+  {
+    Cascade &cascade = cascades[c];
+    renderedThisFrame[c] = cascade.needsRender;
+    if (!cascade.needsRender)
+      continue;
+
+    timers[c].begin();
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                              depthTexture, 0, c);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    depthShader.setMat4("lightSpaceMatrix", cascade.lightSpaceMatrix);
+    for (size_t i = 0; i < cascade.casters.size(); i++)
+    {
+      const RenderObject &object = casters[cascade.casters[i]];
+      depthShader.setMat4("model", object.model);
+      glBindVertexArray(object.VAO);
+      glDrawElements(GL_TRIANGLES, object.indexCount, GL_UNSIGNED_INT, 0);
+    }
+    timers[c].end();
+
+    cascade.renderedSignature = cascade.signature;
+    cascade.needsRender = false;
+  }
+
+  glDisable(GL_POLYGON_OFFSET_FILL);
+  glDepthMask(depthMask);
+  if (!depthTest)
+    glDisable(GL_DEPTH_TEST);
+  glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)framebuffer);
+  glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+void CascadedShadowMap::bind(Shader &shader, int textureUnit) const
+{
+  glActiveTexture(GL_TEXTURE0 + textureUnit);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, depthTexture);
+  shader.use();
+  shader.setInt("shadowMap", textureUnit);
+  shader.setInt("cascadeCount", cascadeCount);
+  for (int c = 0; c < cascadeCount; c++)
+  {
+    std::string index = "[" + std::to_string(c) + "]";
+    shader.setMat4("lightSpaceMatrices" + index, cascades[c].lightSpaceMatrix);
+    shader.setFloat("cascadeSplits" + index, cascades[c].splitFar);
+  }
+}
+
+int CascadedShadowMap::getCascadeCount() const
+{
+  return cascadeCount;
+}
+
+double CascadedShadowMap::cascadeMilliseconds(int cascade)
+{
+  return timers[cascade].milliseconds();
+}
+
+void CascadedShadowMap::printStats()
+{
+  for (int c = 0; c < cascadeCount; c++)
+  {
+    std::cout << "cascade " << c << " [" << cascades[c].splitNear << ", "
+              << cascades[c].splitFar << "]: "
+              << cascades[c].casters.size() << " casters, "
+              << (renderedThisFrame[c] ? "rendered" : "cached") << ", "
+              << cascadeMilliseconds(c) << " ms" << std::endl;
+  }
+}
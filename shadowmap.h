@@ -0,0 +1,111 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_SHADOWMAP_H
+#define COORDINATESPACE_SHADOWMAP_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "gputimer.h"
+#include "renderobject.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Cascaded shadow maps
+ *  A single shadow map stretched over a large view spends most of its
+ *  texels far away from the camera, where they're the least visible. We
+ *  split the camera frustum along its view direction into slices
+ *  (cascades) and give every slice its own shadow map, so the slices close
+ *  to the camera get a lot more texels per world unit.
+ *
+ *  The split distances blend a logarithmic and a uniform distribution,
+ *  splitLambda = 1 is fully logarithmic.
+ *
+ *  For every slice the light uses an orthographic projection (glm::ortho)
+ *  that is fitted around the bounding sphere of the slice corners. Using a
+ *  sphere keeps the projection the same size however the camera rotates and
+ *  snapping its center to whole shadow map texels keeps the edges of the
+ *  shadows from crawling when the camera moves.
+ *
+ *  Casters are culled per cascade against the light space rectangle of the
+ *  slice; only casters that can actually throw a shadow into the slice are
+ *  drawn into it and the depth range of the projection is pulled tight
+ *  around them.
+ *
+ *  Re-rendering a cascade is skipped when neither its light matrix nor any
+ *  of its casters changed since the last time it was rendered. The near
+ *  cascades change with almost every camera move so that's only done from
+ *  cachedFromCascade on; for the far ones the snapped matrix stays the same
+ *  for a long time.
+ *
+ *  The depth maps live in one GL_TEXTURE_2D_ARRAY, a layer per cascade. A
+ *  shader sampling them through bind() gets the uniforms:
+ *    sampler2DArrayShadow shadowMap;
+ *    mat4 lightSpaceMatrices[4];
+ *    float cascadeSplits[4];    // view space far distance of each cascade
+ *    int cascadeCount;
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class CascadedShadowMap
+{
+public:
+  static const int MAX_CASCADES = 4;
+
+  struct Cascade
+  {
+    float splitNear;
+    float splitFar;
+    glm::mat4 lightSpaceMatrix;
+    // indices into the caster list passed to update()
+    std::vector<unsigned int> casters;
+    // hash of the light matrix and the transforms of all casters in it
+    unsigned long long signature;
+    unsigned long long renderedSignature;
+    bool needsRender;
+  };
+
+  // 0 uniform, 1 logarithmic split distribution
+  float splitLambda;
+  // shadows end here even if the camera far plane is further away
+  float shadowDistance;
+  // cascades with this index and up are only rendered when they changed
+  int cachedFromCascade;
+
+  Cascade cascades[MAX_CASCADES];
+  unsigned int depthTexture;
+
+  CascadedShadowMap(int cascadeCount, int resolution);
+  ~CascadedShadowMap();
+  CascadedShadowMap(const CascadedShadowMap &) = delete;
+  CascadedShadowMap &operator=(const CascadedShadowMap &) = delete;
+
+  // fit the cascades to the camera and cull the casters, lightDir points
+  // from the light into the scene
+  void update(const glm::mat4 &view, float fovy, float aspect, float zNear,
+              float zFar, const glm::vec3 &lightDir,
+              const std::vector<RenderObject> &casters);
+  // draw the casters of every cascade that needs it into its layer; the
+  // framebuffer, viewport and depth test and mask are left as they were
+  void render(const std::vector<RenderObject> &casters);
+  // bind the depth maps and cascade uniforms to a shader that samples them
+  void bind(Shader &shader, int textureUnit) const;
+
+  int getCascadeCount() const;
+  // GPU time of the latest finished render of a cascade, -1 if none yet
+  double cascadeMilliseconds(int cascade);
+  // print the per cascade caster counts, cache state and GPU times
+  void printStats();
+
+private:
+  int cascadeCount;
+  int resolution;
+  unsigned int FBO;
+  Shader depthShader;
+  GpuTimer timers[MAX_CASCADES];
+  bool renderedThisFrame[MAX_CASCADES];
+};
+#endif //COORDINATESPACE_SHADOWMAP_H
@@ -0,0 +1,695 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_SIMD_H
+#define COORDINATESPACE_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COORDINATESPACE_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define COORDINATESPACE_SIMD_SSE2 1
+#endif
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * float8 is eight floats processed as one value. The CPU side kernels
+ * (particles, skinning, curve sampling, ...) keep their data as structure
+ * of arrays so eight consecutive elements of one attribute can be loaded
+ * into a float8 at once.
+ *
+ * With AVX2 (COORDINATESPACE_AVX2 in CMake) a float8 is a single 256 bit
+ * register; without it the same code runs on two SSE2 registers, and on
+ * other architectures as a plain loop the compiler can still vectorize.
+ * Comparisons return a mask with every bit of a lane set where the
+ * comparison is true, select() and moveMask() consume such masks.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+struct float8
+{
+#if defined(COORDINATESPACE_SIMD_AVX2)
+  __m256 v;
+
+  float8() {}
+  float8(__m256 v) : v(v) {}
+  explicit float8(float f) : v(_mm256_set1_ps(f)) {}
+
+  static float8 load(const float* p) { return _mm256_loadu_ps(p); }
+  void store(float* p) const { _mm256_storeu_ps(p, v); }
+
+  friend float8 operator+(float8 a, float8 b) { return _mm256_add_ps(a.v, b.v); }
+  friend float8 operator-(float8 a, float8 b) { return _mm256_sub_ps(a.v, b.v); }
+  friend float8 operator*(float8 a, float8 b) { return _mm256_mul_ps(a.v, b.v); }
+  friend float8 operator/(float8 a, float8 b) { return _mm256_div_ps(a.v, b.v); }
+  friend float8 operator&(float8 a, float8 b) { return _mm256_and_ps(a.v, b.v); }
+  friend float8 operator|(float8 a, float8 b) { return _mm256_or_ps(a.v, b.v); }
+  friend float8 operator<(float8 a, float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+  friend float8 operator<=(float8 a, float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ); }
+  friend float8 operator>(float8 a, float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+  friend float8 operator>=(float8 a, float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ); }
+
+  // a * b + c
+  friend float8 fmadd(float8 a, float8 b, float8 c)
+  {
+#if defined(__FMA__)
+    return _mm256_fmadd_ps(a.v, b.v, c.v);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a.v, b.v), c.v);
+#endif
+  }
+  friend float8 min(float8 a, float8 b) { return _mm256_min_ps(a.v, b.v); }
+  friend float8 max(float8 a, float8 b) { return _mm256_max_ps(a.v, b.v); }
+  friend float8 sqrt(float8 a) { return _mm256_sqrt_ps(a.v); }
+  friend float8 floor(float8 a) { return _mm256_floor_ps(a.v); }
+  friend float8 abs(float8 a)
+  {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v);
+  }
+  // lanes of a where mask is set, b elsewhere
+  friend float8 select(float8 mask, float8 a, float8 b)
+  {
+    return _mm256_blendv_ps(b.v, a.v, mask.v);
+  }
+  // bit i set when lane i of the mask is set
+  friend int moveMask(float8 mask) { return _mm256_movemask_ps(mask.v); }
+#elif defined(COORDINATESPACE_SIMD_SSE2)
+  __m128 lo, hi;
+
+  float8() {}
+  float8(__m128 lo, __m128 hi) : lo(lo), hi(hi) {}
+  explicit float8(float f) : lo(_mm_set1_ps(f)), hi(_mm_set1_ps(f)) {}
+
+  static float8 load(const float* p)
+  {
+    return float8(_mm_loadu_ps(p), _mm_loadu_ps(p + 4));
+  }
+  void store(float* p) const
+  {
+    _mm_storeu_ps(p, lo);
+    _mm_storeu_ps(p + 4, hi);
+  }
+
+#define COORDINATESPACE_FLOAT8_BINARY(op, intrinsic) \
+  friend float8 op(float8 a, float8 b) \
+  { \
+    return float8(intrinsic(a.lo, b.lo), intrinsic(a.hi, b.hi)); \
+  }
+  COORDINATESPACE_FLOAT8_BINARY(operator+, _mm_add_ps)
+  COORDINATESPACE_FLOAT8_BINARY(operator-, _mm_sub_ps)
+  COORDINATESPACE_FLOAT8_BINARY(operator*, _mm_mul_ps)
+  COORDINATESPACE_FLOAT8_BINARY(operator/, _mm_div_ps)
+  COORDINATESPACE_FLOAT8_BINARY(operator&, _mm_and_ps)
+  COORDINATESPACE_FLOAT8_BINARY(operator|, _mm_or_ps)
+  COORDINATESPACE_FLOAT8_BINARY(operator<, _mm_cmplt_ps)
+  COORDINATESPACE_FLOAT8_BINARY(operator<=, _mm_cmple_ps)
+  COORDINATESPACE_FLOAT8_BINARY(operator>, _mm_cmpgt_ps)
+  COORDINATESPACE_FLOAT8_BINARY(operator>=, _mm_cmpge_ps)
+  COORDINATESPACE_FLOAT8_BINARY(min, _mm_min_ps)
+  COORDINATESPACE_FLOAT8_BINARY(max, _mm_max_ps)
+#undef COORDINATESPACE_FLOAT8_BINARY
+
+  friend float8 fmadd(float8 a, float8 b, float8 c) { return a * b + c; }
+  friend float8 sqrt(float8 a)
+  {
+    return float8(_mm_sqrt_ps(a.lo), _mm_sqrt_ps(a.hi));
+  }
+  friend float8 floor(float8 a)
+  {
+    // SSE2 has no floor: truncate and step down where that rounded up
+    __m128 tlo = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.lo));
+    __m128 thi = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.hi));
+    __m128 one = _mm_set1_ps(1.0f);
+    tlo = _mm_sub_ps(tlo, _mm_and_ps(_mm_cmpgt_ps(tlo, a.lo), one));
+    thi = _mm_sub_ps(thi, _mm_and_ps(_mm_cmpgt_ps(thi, a.hi), one));
+    return float8(tlo, thi);
+  }
+  friend float8 abs(float8 a)
+  {
+    __m128 sign = _mm_set1_ps(-0.0f);
+    return float8(_mm_andnot_ps(sign, a.lo), _mm_andnot_ps(sign, a.hi));
+  }
+  friend float8 select(float8 mask, float8 a, float8 b)
+  {
+    return float8(_mm_or_ps(_mm_and_ps(mask.lo, a.lo),
+                            _mm_andnot_ps(mask.lo, b.lo)),
+                  _mm_or_ps(_mm_and_ps(mask.hi, a.hi),
+                            _mm_andnot_ps(mask.hi, b.hi)));
+  }
+  friend int moveMask(float8 mask)
+  {
+    return _mm_movemask_ps(mask.lo) | (_mm_movemask_ps(mask.hi) << 4);
+  }
+#else
+  float f[8];
+
+  float8() {}
+  explicit float8(float value)
+  {
+    for (int i = 0; i < 8; i++)
+      f[i] = value;
+  }
+
+  static float8 load(const float* p)
+  {
+    float8 r;
+    for (int i = 0; i < 8; i++)
+      r.f[i] = p[i];
+    return r;
+  }
+  void store(float* p) const
+  {
+    for (int i = 0; i < 8; i++)
+      p[i] = f[i];
+  }
+
+  static float bits(bool b)
+  {
+    uint32_t u = b ? 0xffffffffu : 0u;
+    float r;
+    std::memcpy(&r, &u, sizeof(r));
+    return r;
+  }
+  static uint32_t asBits(float value)
+  {
+    uint32_t u;
+    std::memcpy(&u, &value, sizeof(u));
+    return u;
+  }
+  static float fromBits(uint32_t u)
+  {
+    float r;
+    std::memcpy(&r, &u, sizeof(r));
+    return r;
+  }
+
+#define COORDINATESPACE_FLOAT8_LANES(op, expression) \
+  friend float8 op(float8 a, float8 b) \
+  { \
+    float8 r; \
+    for (int i = 0; i < 8; i++) \
+      r.f[i] = expression; \
+    return r; \
+  }
+  COORDINATESPACE_FLOAT8_LANES(operator+, a.f[i] + b.f[i])
+  COORDINATESPACE_FLOAT8_LANES(operator-, a.f[i] - b.f[i])
+  COORDINATESPACE_FLOAT8_LANES(operator*, a.f[i] * b.f[i])
+  COORDINATESPACE_FLOAT8_LANES(operator/, a.f[i] / b.f[i])
+  COORDINATESPACE_FLOAT8_LANES(operator&, fromBits(asBits(a.f[i]) & asBits(b.f[i])))
+  COORDINATESPACE_FLOAT8_LANES(operator|, fromBits(asBits(a.f[i]) | asBits(b.f[i])))
+  COORDINATESPACE_FLOAT8_LANES(operator<, bits(a.f[i] < b.f[i]))
+  COORDINATESPACE_FLOAT8_LANES(operator<=, bits(a.f[i] <= b.f[i]))
+  COORDINATESPACE_FLOAT8_LANES(operator>, bits(a.f[i] > b.f[i]))
+  COORDINATESPACE_FLOAT8_LANES(operator>=, bits(a.f[i] >= b.f[i]))
+  COORDINATESPACE_FLOAT8_LANES(min, a.f[i] < b.f[i] ? a.f[i] : b.f[i])
+  COORDINATESPACE_FLOAT8_LANES(max, a.f[i] > b.f[i] ? a.f[i] : b.f[i])
+#undef COORDINATESPACE_FLOAT8_LANES
+
+  friend float8 fmadd(float8 a, float8 b, float8 c) { return a * b + c; }
+  friend float8 sqrt(float8 a)
+  {
+    for (int i = 0; i < 8; i++)
+      a.f[i] = std::sqrt(a.f[i]);
+    return a;
+  }
+  friend float8 floor(float8 a)
+  {
+    for (int i = 0; i < 8; i++)
+      a.f[i] = std::floor(a.f[i]);
+    return a;
+  }
+  friend float8 abs(float8 a)
+  {
+    for (int i = 0; i < 8; i++)
+      a.f[i] = std::fabs(a.f[i]);
+    return a;
+  }
+  friend float8 select(float8 mask, float8 a, float8 b)
+  {
+    float8 r;
+    for (int i = 0; i < 8; i++)
+      r.f[i] = asBits(mask.f[i]) ? a.f[i] : b.f[i];
+    return r;
+  }
+  friend int moveMask(float8 mask)
+  {
+    int bitsSet = 0;
+    for (int i = 0; i < 8; i++)
+      bitsSet |= (asBits(mask.f[i]) >> 31) << i;
+    return bitsSet;
+  }
+#endif
+};
+
+// interleave eight xyzw quadruples from four float8 lanes, the structure
+// of arrays to array of structures step when writing vertex/instance data
+inline void storeInterleaved4(float* out, float8 x, float8 y, float8 z,
+                              float8 w)
+{
+#if defined(COORDINATESPACE_SIMD_AVX2)
+  __m256 xy0 = _mm256_unpacklo_ps(x.v, y.v);
+  __m256 xy1 = _mm256_unpackhi_ps(x.v, y.v);
+  __m256 zw0 = _mm256_unpacklo_ps(z.v, w.v);
+  __m256 zw1 = _mm256_unpackhi_ps(z.v, w.v);
+  // each holds particle n in the low and n + 4 in the high half
+  __m256 p04 = _mm256_shuffle_ps(xy0, zw0, 0x44);
+  __m256 p15 = _mm256_shuffle_ps(xy0, zw0, 0xee);
+  __m256 p26 = _mm256_shuffle_ps(xy1, zw1, 0x44);
+  __m256 p37 = _mm256_shuffle_ps(xy1, zw1, 0xee);
+  _mm256_storeu_ps(out, _mm256_permute2f128_ps(p04, p15, 0x20));
+  _mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(p26, p37, 0x20));
+  _mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(p04, p15, 0x31));
+  _mm256_storeu_ps(out + 24, _mm256_permute2f128_ps(p26, p37, 0x31));
+#elif defined(COORDINATESPACE_SIMD_SSE2)
+  __m128 lo[4] = {x.lo, y.lo, z.lo, w.lo};
+  __m128 hi[4] = {x.hi, y.hi, z.hi, w.hi};
+  _MM_TRANSPOSE4_PS(lo[0], lo[1], lo[2], lo[3]);
+  _MM_TRANSPOSE4_PS(hi[0], hi[1], hi[2], hi[3]);
+  for (int i = 0; i < 4; i++)
+  {
+    _mm_storeu_ps(out + i * 4, lo[i]);
+    _mm_storeu_ps(out + 16 + i * 4, hi[i]);
+  }
+#else
+  for (int i = 0; i < 8; i++)
+  {
+    out[i * 4 + 0] = x.f[i];
+    out[i * 4 + 1] = y.f[i];
+    out[i * 4 + 2] = z.f[i];
+    out[i * 4 + 3] = w.f[i];
+  }
+#endif
+}
+
+// the same interleave into signed normalized 16 bit integers (value *
+// 32767, rounded to nearest) for vertex attributes; the inputs are
+// clamped to [-1, 1] first
+inline void storeSnorm16Interleaved4(int16_t* out, float8 x, float8 y,
+                                     float8 z, float8 w)
+{
+  const float8 one(1.0f), minusOne(-1.0f), scale(32767.0f);
+  x = min(max(x, minusOne), one) * scale;
+  y = min(max(y, minusOne), one) * scale;
+  z = min(max(z, minusOne), one) * scale;
+  w = min(max(w, minusOne), one) * scale;
+#if defined(COORDINATESPACE_SIMD_AVX2)
+  // packs works within the 128 bit halves: xy holds x0-3 y0-3 | x4-7 y4-7
+  __m256i xy = _mm256_packs_epi32(_mm256_cvtps_epi32(x.v),
+                                  _mm256_cvtps_epi32(y.v));
+  __m256i zw = _mm256_packs_epi32(_mm256_cvtps_epi32(z.v),
+                                  _mm256_cvtps_epi32(w.v));
+  __m256i xz = _mm256_unpacklo_epi16(xy, zw);
+  __m256i yw = _mm256_unpackhi_epi16(xy, zw);
+  // elements 0, 1 | 4, 5 and 2, 3 | 6, 7
+  __m256i e01 = _mm256_unpacklo_epi16(xz, yw);
+  __m256i e23 = _mm256_unpackhi_epi16(xz, yw);
+  _mm256_storeu_si256((__m256i*)out, _mm256_permute2x128_si256(e01, e23, 0x20));
+  _mm256_storeu_si256((__m256i*)(out + 16),
+                      _mm256_permute2x128_si256(e01, e23, 0x31));
+#elif defined(COORDINATESPACE_SIMD_SSE2)
+  __m128 lanes[2][4] = {{x.lo, y.lo, z.lo, w.lo}, {x.hi, y.hi, z.hi, w.hi}};
+  for (int half = 0; half < 2; half++)
+  {
+    __m128i xy = _mm_packs_epi32(_mm_cvtps_epi32(lanes[half][0]),
+                                 _mm_cvtps_epi32(lanes[half][1]));
+    __m128i zw = _mm_packs_epi32(_mm_cvtps_epi32(lanes[half][2]),
+                                 _mm_cvtps_epi32(lanes[half][3]));
+    __m128i xz = _mm_unpacklo_epi16(xy, zw);
+    __m128i yw = _mm_unpackhi_epi16(xy, zw);
+    _mm_storeu_si128((__m128i*)(out + half * 16), _mm_unpacklo_epi16(xz, yw));
+    _mm_storeu_si128((__m128i*)(out + half * 16 + 8),
+                     _mm_unpackhi_epi16(xz, yw));
+  }
+#else
+  for (int i = 0; i < 8; i++)
+  {
+    out[i * 4 + 0] = (int16_t)std::lrint(x.f[i]);
+    out[i * 4 + 1] = (int16_t)std::lrint(y.f[i]);
+    out[i * 4 + 2] = (int16_t)std::lrint(z.f[i]);
+    out[i * 4 + 3] = (int16_t)std::lrint(w.f[i]);
+  }
+#endif
+}
+
+// eight normalized vectors as 10_10_10_2 (GL_INT_2_10_10_10_REV, the
+// layout of glm::packSnorm3x10_1x2): x, y, z * 511 in 10 bit fields from
+// the low bits up, w (-1, 0 or 1) in the top 2 bits; the inputs are
+// clamped to [-1, 1] and rounded to nearest
+inline void storeSnorm3x10_1x2(uint32_t* out, float8 x, float8 y, float8 z,
+                               float8 w)
+{
+  const float8 one(1.0f), minusOne(-1.0f), scale(511.0f);
+  x = min(max(x, minusOne), one) * scale;
+  y = min(max(y, minusOne), one) * scale;
+  z = min(max(z, minusOne), one) * scale;
+  w = min(max(w, minusOne), one);
+#if defined(COORDINATESPACE_SIMD_AVX2)
+  __m256i field = _mm256_set1_epi32(0x3ff);
+  __m256i v = _mm256_or_si256(
+          _mm256_or_si256(
+                  _mm256_and_si256(_mm256_cvtps_epi32(x.v), field),
+                  _mm256_slli_epi32(_mm256_and_si256(_mm256_cvtps_epi32(y.v),
+                                                     field), 10)),
+          _mm256_or_si256(
+                  _mm256_slli_epi32(_mm256_and_si256(_mm256_cvtps_epi32(z.v),
+                                                     field), 20),
+                  _mm256_slli_epi32(_mm256_cvtps_epi32(w.v), 30)));
+  _mm256_storeu_si256((__m256i*)out, v);
+#elif defined(COORDINATESPACE_SIMD_SSE2)
+  __m128 lanes[2][4] = {{x.lo, y.lo, z.lo, w.lo}, {x.hi, y.hi, z.hi, w.hi}};
+  __m128i field = _mm_set1_epi32(0x3ff);
+  for (int half = 0; half < 2; half++)
+  {
+    __m128i v = _mm_or_si128(
+            _mm_or_si128(
+                    _mm_and_si128(_mm_cvtps_epi32(lanes[half][0]), field),
+                    _mm_slli_epi32(_mm_and_si128(
+                            _mm_cvtps_epi32(lanes[half][1]), field), 10)),
+            _mm_or_si128(
+                    _mm_slli_epi32(_mm_and_si128(
+                            _mm_cvtps_epi32(lanes[half][2]), field), 20),
+                    _mm_slli_epi32(_mm_cvtps_epi32(lanes[half][3]), 30)));
+    _mm_storeu_si128((__m128i*)(out + half * 4), v);
+  }
+#else
+  for (int i = 0; i < 8; i++)
+    out[i] = ((uint32_t)std::lrint(x.f[i]) & 0x3ffu) |
+             ((uint32_t)std::lrint(y.f[i]) & 0x3ffu) << 10 |
+             ((uint32_t)std::lrint(z.f[i]) & 0x3ffu) << 20 |
+             (uint32_t)std::lrint(w.f[i]) << 30;
+#endif
+}
+
+// sine and cosine of eight angles at once. The angle is wrapped to
+// [-pi, pi] and mirrored into [-pi/2, pi/2] where an odd polynomial (the
+// Taylor series up to x^11) is accurate to about 1e-7; cos(x) is
+// sin(x + pi/2).
+inline float8 sinReduced(float8 x)
+{
+  const float8 pi(3.14159265f), halfPi(1.57079633f);
+  x = select(x > halfPi, pi - x, x);
+  x = select(x < float8(0.0f) - halfPi, float8(0.0f) - pi - x, x);
+  float8 x2 = x * x;
+  float8 p = float8(-2.50521084e-8f);
+  p = fmadd(p, x2, float8(2.75573192e-6f));
+  p = fmadd(p, x2, float8(-1.98412698e-4f));
+  p = fmadd(p, x2, float8(8.33333333e-3f));
+  p = fmadd(p, x2, float8(-1.66666667e-1f));
+  p = fmadd(p, x2, float8(1.0f));
+  return p * x;
+}
+
+inline void sincos(float8 angle, float8 &s, float8 &c)
+{
+  const float8 twoPi(6.28318531f), inverseTwoPi(0.159154943f);
+  const float8 pi(3.14159265f), halfPi(1.57079633f);
+  float8 x = angle - twoPi * floor(fmadd(angle, inverseTwoPi, float8(0.5f)));
+  s = sinReduced(x);
+  // x + pi/2 can leave [-pi, pi] by up to pi/2, wrap it back once
+  float8 y = x + halfPi;
+  c = sinReduced(select(y > pi, y - twoPi, y));
+}
+
+// the inverse of storeInterleaved4: eight xyzw quadruples into four float8
+inline void loadDeinterleaved4(const float* in, float8 &x, float8 &y,
+                               float8 &z, float8 &w)
+{
+#if defined(COORDINATESPACE_SIMD_AVX2)
+  __m256 m0 = _mm256_loadu_ps(in);
+  __m256 m1 = _mm256_loadu_ps(in + 8);
+  __m256 m2 = _mm256_loadu_ps(in + 16);
+  __m256 m3 = _mm256_loadu_ps(in + 24);
+  // quadruples 0 and 4, 2 and 6, 1 and 5, 3 and 7
+  __m256 t0 = _mm256_permute2f128_ps(m0, m2, 0x20);
+  __m256 t1 = _mm256_permute2f128_ps(m1, m3, 0x20);
+  __m256 t2 = _mm256_permute2f128_ps(m0, m2, 0x31);
+  __m256 t3 = _mm256_permute2f128_ps(m1, m3, 0x31);
+  __m256 xy0 = _mm256_unpacklo_ps(t0, t2);
+  __m256 xy1 = _mm256_unpacklo_ps(t1, t3);
+  __m256 zw0 = _mm256_unpackhi_ps(t0, t2);
+  __m256 zw1 = _mm256_unpackhi_ps(t1, t3);
+  x = _mm256_shuffle_ps(xy0, xy1, 0x44);
+  y = _mm256_shuffle_ps(xy0, xy1, 0xee);
+  z = _mm256_shuffle_ps(zw0, zw1, 0x44);
+  w = _mm256_shuffle_ps(zw0, zw1, 0xee);
+#elif defined(COORDINATESPACE_SIMD_SSE2)
+  __m128 lo[4], hi[4];
+  for (int i = 0; i < 4; i++)
+  {
+    lo[i] = _mm_loadu_ps(in + i * 4);
+    hi[i] = _mm_loadu_ps(in + 16 + i * 4);
+  }
+  _MM_TRANSPOSE4_PS(lo[0], lo[1], lo[2], lo[3]);
+  _MM_TRANSPOSE4_PS(hi[0], hi[1], hi[2], hi[3]);
+  x = float8(lo[0], hi[0]);
+  y = float8(lo[1], hi[1]);
+  z = float8(lo[2], hi[2]);
+  w = float8(lo[3], hi[3]);
+#else
+  for (int i = 0; i < 8; i++)
+  {
+    x.f[i] = in[i * 4 + 0];
+    y.f[i] = in[i * 4 + 1];
+    z.f[i] = in[i * 4 + 2];
+    w.f[i] = in[i * 4 + 3];
+  }
+#endif
+}
+
+// eight 8 bit xyzw quadruples (RGBA pixels) into four float8 holding 0 to
+// 255
+inline void loadUnorm8Deinterleaved4(const uint8_t* in, float8 &x,
+                                     float8 &y, float8 &z, float8 &w)
+{
+#if defined(COORDINATESPACE_SIMD_AVX2)
+  // one quadruple per 32 bit lane
+  __m256i v = _mm256_loadu_si256((const __m256i*)in);
+  __m256i byte = _mm256_set1_epi32(0xff);
+  x = _mm256_cvtepi32_ps(_mm256_and_si256(v, byte));
+  y = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(v, 8), byte));
+  z = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(v, 16), byte));
+  w = _mm256_cvtepi32_ps(_mm256_srli_epi32(v, 24));
+#elif defined(COORDINATESPACE_SIMD_SSE2)
+  __m128i lo = _mm_loadu_si128((const __m128i*)in);
+  __m128i hi = _mm_loadu_si128((const __m128i*)(in + 16));
+  __m128i byte = _mm_set1_epi32(0xff);
+  x = float8(_mm_cvtepi32_ps(_mm_and_si128(lo, byte)),
+             _mm_cvtepi32_ps(_mm_and_si128(hi, byte)));
+  y = float8(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(lo, 8), byte)),
+             _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(hi, 8), byte)));
+  z = float8(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(lo, 16), byte)),
+             _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(hi, 16), byte)));
+  w = float8(_mm_cvtepi32_ps(_mm_srli_epi32(lo, 24)),
+             _mm_cvtepi32_ps(_mm_srli_epi32(hi, 24)));
+#else
+  for (int i = 0; i < 8; i++)
+  {
+    x.f[i] = in[i * 4 + 0];
+    y.f[i] = in[i * 4 + 1];
+    z.f[i] = in[i * 4 + 2];
+    w.f[i] = in[i * 4 + 3];
+  }
+#endif
+}
+
+// the inverse: rounded to nearest (even, like lrint) and clamped to
+// [0, 255]
+inline void storeUnorm8Interleaved4(uint8_t* out, float8 x, float8 y,
+                                    float8 z, float8 w)
+{
+  const float8 zero(0.0f), byte(255.0f);
+  x = min(max(x, zero), byte);
+  y = min(max(y, zero), byte);
+  z = min(max(z, zero), byte);
+  w = min(max(w, zero), byte);
+#if defined(COORDINATESPACE_SIMD_AVX2)
+  __m256i v = _mm256_or_si256(
+          _mm256_or_si256(_mm256_cvtps_epi32(x.v),
+                          _mm256_slli_epi32(_mm256_cvtps_epi32(y.v), 8)),
+          _mm256_or_si256(_mm256_slli_epi32(_mm256_cvtps_epi32(z.v), 16),
+                          _mm256_slli_epi32(_mm256_cvtps_epi32(w.v), 24)));
+  _mm256_storeu_si256((__m256i*)out, v);
+#elif defined(COORDINATESPACE_SIMD_SSE2)
+  __m128i lo = _mm_or_si128(
+          _mm_or_si128(_mm_cvtps_epi32(x.lo),
+                       _mm_slli_epi32(_mm_cvtps_epi32(y.lo), 8)),
+          _mm_or_si128(_mm_slli_epi32(_mm_cvtps_epi32(z.lo), 16),
+                       _mm_slli_epi32(_mm_cvtps_epi32(w.lo), 24)));
+  __m128i hi = _mm_or_si128(
+          _mm_or_si128(_mm_cvtps_epi32(x.hi),
+                       _mm_slli_epi32(_mm_cvtps_epi32(y.hi), 8)),
+          _mm_or_si128(_mm_slli_epi32(_mm_cvtps_epi32(z.hi), 16),
+                       _mm_slli_epi32(_mm_cvtps_epi32(w.hi), 24)));
+  _mm_storeu_si128((__m128i*)out, lo);
+  _mm_storeu_si128((__m128i*)(out + 16), hi);
+#else
+  for (int i = 0; i < 8; i++)
+  {
+    out[i * 4 + 0] = (uint8_t)std::lrint(x.f[i]);
+    out[i * 4 + 1] = (uint8_t)std::lrint(y.f[i]);
+    out[i * 4 + 2] = (uint8_t)std::lrint(z.f[i]);
+    out[i * 4 + 3] = (uint8_t)std::lrint(w.f[i]);
+  }
+#endif
+}
+
+// table[index] for every lane, the indices are whole numbers
+inline float8 gather(const float* table, float8 index)
+{
+#if defined(COORDINATESPACE_SIMD_AVX2)
+  return _mm256_i32gather_ps(table, _mm256_cvttps_epi32(index.v), 4);
+#else
+  float indices[8], values[8];
+  index.store(indices);
+  for (int i = 0; i < 8; i++)
+    values[i] = table[(int)indices[i]];
+  return float8::load(values);
+#endif
+}
+
+// x = mantissa * 2^exponent with the mantissa in [0.5, 1), for normal
+// x > 0 (the integer part of std::frexp)
+inline void splitExponent(float8 x, float8 &mantissa, float8 &exponent)
+{
+#if defined(COORDINATESPACE_SIMD_AVX2)
+  __m256i bits = _mm256_castps_si256(x.v);
+  exponent = _mm256_cvtepi32_ps(
+          _mm256_sub_epi32(_mm256_srli_epi32(bits, 23),
+                           _mm256_set1_epi32(126)));
+  mantissa = _mm256_castsi256_ps(_mm256_or_si256(
+          _mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+          _mm256_set1_epi32(0x3f000000)));
+#elif defined(COORDINATESPACE_SIMD_SSE2)
+  __m128i mask = _mm_set1_epi32(0x007fffff);
+  __m128i half = _mm_set1_epi32(0x3f000000);
+  __m128i bias = _mm_set1_epi32(126);
+  __m128i lo = _mm_castps_si128(x.lo), hi = _mm_castps_si128(x.hi);
+  exponent = float8(
+          _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(lo, 23), bias)),
+          _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(hi, 23), bias)));
+  mantissa = float8(
+          _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(lo, mask), half)),
+          _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(hi, mask), half)));
+#else
+  for (int i = 0; i < 8; i++)
+  {
+    uint32_t bits = float8::asBits(x.f[i]);
+    exponent.f[i] = (float)((int)(bits >> 23) - 126);
+    mantissa.f[i] = float8::fromBits((bits & 0x007fffffu) | 0x3f000000u);
+  }
+#endif
+}
+
+// 2^n for whole numbers n in [-126, 127]
+inline float8 powerOf2(float8 n)
+{
+#if defined(COORDINATESPACE_SIMD_AVX2)
+  __m256i e = _mm256_add_epi32(_mm256_cvttps_epi32(n.v),
+                               _mm256_set1_epi32(127));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+#elif defined(COORDINATESPACE_SIMD_SSE2)
+  __m128i bias = _mm_set1_epi32(127);
+  return float8(
+          _mm_castsi128_ps(_mm_slli_epi32(
+                  _mm_add_epi32(_mm_cvttps_epi32(n.lo), bias), 23)),
+          _mm_castsi128_ps(_mm_slli_epi32(
+                  _mm_add_epi32(_mm_cvttps_epi32(n.hi), bias), 23)));
+#else
+  float8 r;
+  for (int i = 0; i < 8; i++)
+    r.f[i] = float8::fromBits((uint32_t)((int)n.f[i] + 127) << 23);
+  return r;
+#endif
+}
+
+// log2(x) for x > 0 and 2^x, the Cephes logf and exp2f polynomials;
+// accurate to a few units in the last place. log2 of 0 or a denormal
+// comes out finite but meaningless, callers select those lanes away.
+inline float8 log2(float8 x)
+{
+  const float8 one(1.0f), sqrtHalf(0.707106781f);
+  float8 mantissa, exponent;
+  splitExponent(x, mantissa, exponent);
+  // mantissa into [sqrt(0.5), sqrt(2)) around 1
+  float8 small = mantissa < sqrtHalf;
+  exponent = exponent - (small & one);
+  float8 f = mantissa + (small & mantissa) - one;
+  float8 f2 = f * f;
+  float8 p = float8(7.0376836292e-2f);
+  p = fmadd(p, f, float8(-1.1514610310e-1f));
+  p = fmadd(p, f, float8(1.1676998740e-1f));
+  p = fmadd(p, f, float8(-1.2420140846e-1f));
+  p = fmadd(p, f, float8(1.4249322787e-1f));
+  p = fmadd(p, f, float8(-1.6668057665e-1f));
+  p = fmadd(p, f, float8(2.0000714765e-1f));
+  p = fmadd(p, f, float8(-2.4999993993e-1f));
+  p = fmadd(p, f, float8(3.3333331174e-1f));
+  // ln(1 + f)
+  float8 ln = fmadd(p * f, f2, fmadd(float8(-0.5f), f2, f));
+  return fmadd(ln, float8(1.44269504f), exponent);
+}
+
+inline float8 exp2(float8 x)
+{
+  x = min(max(x, float8(-126.0f)), float8(126.0f));
+  float8 n = floor(x + float8(0.5f));
+  float8 f = x - n;
+  float8 p = float8(1.535336188319500e-4f);
+  p = fmadd(p, f, float8(1.339887440266574e-3f));
+  p = fmadd(p, f, float8(9.618437357674640e-3f));
+  p = fmadd(p, f, float8(5.550332471162809e-2f));
+  p = fmadd(p, f, float8(2.402264791363012e-1f));
+  p = fmadd(p, f, float8(6.931472028550421e-1f));
+  return fmadd(p, f, float8(1.0f)) * powerOf2(n);
+}
+
+// acos(x) for x in [-1, 1] (clamped), the Cephes asinf polynomial;
+// accurate to about 1e-7. Above 0.5 it works on sqrt((1 - |x|) / 2), where
+// acos(|x|) = 2 asin of that, so the steep end near 1 keeps its precision.
+inline float8 acos(float8 x)
+{
+  const float8 one(1.0f), half(0.5f), pi(3.14159265f), halfPi(1.57079633f);
+  x = min(max(x, float8(-1.0f)), one);
+  float8 a = abs(x);
+  float8 big = a > half;
+  float8 z = select(big, half * (one - a), a * a);
+  float8 s = select(big, sqrt(z), a);
+  float8 p = float8(4.2163199048e-2f);
+  p = fmadd(p, z, float8(2.4181311049e-2f));
+  p = fmadd(p, z, float8(4.5470025998e-2f));
+  p = fmadd(p, z, float8(7.4953002686e-2f));
+  p = fmadd(p, z, float8(1.6666752422e-1f));
+  // asin(s)
+  float8 r = fmadd(s * z, p, s);
+  r = select(big, r + r, halfPi - r);
+  return select(x < float8(0.0f), pi - r, r);
+}
+
+// SIMD loads want their arrays aligned to the register size; C++14 has no
+// aligned operator new so over-allocate and keep the original pointer in
+// front of the aligned block
+inline void* alignedAlloc(size_t bytes, size_t alignment = 32)
+{
+  void* raw = std::malloc(bytes + alignment + sizeof(void*));
+  if (raw == NULL)
+    return NULL;
+  uintptr_t start = (uintptr_t)raw + sizeof(void*);
+  uintptr_t aligned = (start + alignment - 1) & ~(uintptr_t)(alignment - 1);
+  ((void**)aligned)[-1] = raw;
+  return (void*)aligned;
+}
+
+inline void alignedFree(void* p)
+{
+  if (p != NULL)
+    std::free(((void**)p)[-1]);
+}
+#endif //COORDINATESPACE_SIMD_H
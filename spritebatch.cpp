@@ -0,0 +1,318 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "spritebatch.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace
+{
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+
+  uint32_t packUV(float u, float v)
+  {
+    u = std::min(std::max(u, 0.0f), 1.0f);
+    v = std::min(std::max(v, 0.0f), 1.0f);
+    return (uint32_t)(u * 65535.0f + 0.5f) |
+           ((uint32_t)(v * 65535.0f + 0.5f) << 16);
+  }
+}
+
+SpriteBatch::SpriteBatch(unsigned int maxSprites)
+  : sortByTexture(true), maxSprites((maxSprites + 7) & ~7u), count(0),
+    anyRotation(false), ringOffset(0),
+    shader("shaders/spritevs.txt", "shaders/spritefs.txt"),
+    projection(1.0f), draws(0), sprites(0), buildMilliseconds(0.0)
+{
+  float** floatArrays[] = {&centerX, &centerY, &halfWidth, &halfHeight,
+                           &rotation};
+  for (float** array : floatArrays)
+  {
+    *array = (float*)alignedAlloc(this->maxSprites * sizeof(float));
+    std::fill(*array, *array + this->maxSprites, 0.0f);
+  }
+  cornersA = (float*)alignedAlloc(this->maxSprites * 4 * sizeof(float));
+  cornersB = (float*)alignedAlloc(this->maxSprites * 4 * sizeof(float));
+  uv0 = new uint32_t[this->maxSprites];
+  uv1 = new uint32_t[this->maxSprites];
+  color = new uint32_t[this->maxSprites];
+  layer = new uint16_t[this->maxSprites];
+  texture = new unsigned int[this->maxSprites];
+  buckets.resize(this->maxSprites);
+  order.resize(this->maxSprites);
+
+  // the same two triangles for every quad
+  std::vector<unsigned int> indices(this->maxSprites * 6);
+  for (unsigned int q = 0; q < this->maxSprites; q++)
+  {
+    unsigned int pattern[] = {0, 1, 2, 2, 3, 0};
+    for (int i = 0; i < 6; i++)
+      indices[q * 6 + i] = q * 4 + pattern[i];
+  }
+
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &VBO);
+  glGenBuffers(1, &EBO);
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glBufferData(GL_ARRAY_BUFFER, this->maxSprites * 4 * sizeof(Vertex), NULL,
+               GL_STREAM_DRAW);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(Vertex),
+                        (void*)(2 * sizeof(float)));
+  glEnableVertexAttribArray(1);
+  // the layer arrives as a plain (not normalized) float
+  glVertexAttribPointer(2, 1, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(Vertex),
+                        (void*)(3 * sizeof(float)));
+  glEnableVertexAttribArray(2);
+  glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex),
+                        (void*)(4 * sizeof(float)));
+  glEnableVertexAttribArray(3);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
+               indices.data(), GL_STATIC_DRAW);
+  glBindVertexArray(0);
+}
+
+SpriteBatch::~SpriteBatch()
+{
+  float* floatArrays[] = {centerX, centerY, halfWidth, halfHeight, rotation,
+                          cornersA, cornersB};
+  for (float* array : floatArrays)
+    alignedFree(array);
+  delete[] uv0;
+  delete[] uv1;
+  delete[] color;
+  delete[] layer;
+  delete[] texture;
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &VBO);
+  glDeleteBuffers(1, &EBO);
+  glDeleteProgram(shader.ID);
+}
+
+void SpriteBatch::begin(const glm::mat4 &projection)
+{
+  this->projection = projection;
+  count = 0;
+  anyRotation = false;
+  draws = 0;
+  sprites = 0;
+  buildMilliseconds = 0.0;
+}
+
+void SpriteBatch::draw(unsigned int texture, int layer,
+                       const glm::vec2 &center, const glm::vec2 &size,
+                       float rotation, const glm::vec4 &uv, uint32_t color)
+{
+  if (count == maxSprites)
+    flush();
+  centerX[count] = center.x;
+  centerY[count] = center.y;
+  halfWidth[count] = size.x * 0.5f;
+  halfHeight[count] = size.y * 0.5f;
+  this->rotation[count] = rotation;
+  anyRotation = anyRotation || rotation != 0.0f;
+  uv0[count] = packUV(uv.x, uv.y);
+  uv1[count] = packUV(uv.z, uv.w);
+  this->color[count] = color;
+  this->layer[count] = (uint16_t)layer;
+  this->texture[count] = texture;
+  count++;
+}
+
+void SpriteBatch::computeCorners()
+{
+  // corner k is center + R * (+-halfWidth, +-halfHeight), so with
+  // a = hw cos, b = hw sin, d = hh sin, e = hh cos:
+  //   0 = (-a + d, -b - e)   1 = (a + d, b - e)
+  //   2 = (a - d, b + e)     3 = (-a - d, -b + e)
+  // the arrays are padded to a multiple of 8, a partial last group just
+  // computes a few corners nobody reads
+  for (unsigned int i = 0; i < count; i += 8)
+  {
+    float8 cx = float8::load(centerX + i);
+    float8 cy = float8::load(centerY + i);
+    float8 hw = float8::load(halfWidth + i);
+    float8 hh = float8::load(halfHeight + i);
+    float8 a = hw, b(0.0f), d(0.0f), e = hh;
+    if (anyRotation)
+    {
+      float8 s, c;
+      sincos(float8::load(rotation + i), s, c);
+      a = hw * c;
+      b = hw * s;
+      d = hh * s;
+      e = hh * c;
+    }
+    float8 x0 = cx - a + d, y0 = cy - b - e;
+    float8 x1 = cx + a + d, y1 = cy + b - e;
+    float8 x2 = cx + a - d, y2 = cy + b + e;
+    float8 x3 = cx - a - d, y3 = cy - b + e;
+    storeInterleaved4(cornersA + i * 4, x0, y0, x1, y1);
+    storeInterleaved4(cornersB + i * 4, x2, y2, x3, y3);
+  }
+}
+
+void SpriteBatch::flush()
+{
+  if (count == 0)
+    return;
+  double start = now();
+
+  // texture of each sprite as an index into the textures of this batch.
+  // Texture names are small integers, so a tiny direct mapped table on the
+  // low bits finds the index without searching in almost all cases.
+  textures.clear();
+  unsigned int slots[64];
+  std::fill(slots, slots + 64, 0u);
+  for (unsigned int i = 0; i < count; i++)
+  {
+    unsigned int t = texture[i];
+    unsigned int index = slots[t & 63];
+    if (index >= textures.size() || textures[index] != t)
+    {
+      index = (unsigned int)(std::find(textures.begin(), textures.end(), t) -
+                             textures.begin());
+      if (index == textures.size())
+        textures.push_back(t);
+      slots[t & 63] = index;
+    }
+    buckets[i] = index;
+  }
+
+  // the draw ranges as (texture index, first sprite, sprite count)
+  struct Range
+  {
+    unsigned int texture, first, count;
+  };
+  std::vector<Range> ranges;
+  if (sortByTexture && textures.size() > 1)
+  {
+    // stable counting sort by texture
+    textureCounts.assign(textures.size(), 0);
+    for (unsigned int i = 0; i < count; i++)
+      textureCounts[buckets[i]]++;
+    unsigned int first = 0;
+    for (unsigned int t = 0; t < textures.size(); t++)
+    {
+      Range range = {t, first, textureCounts[t]};
+      ranges.push_back(range);
+      textureCounts[t] = first;
+      first += range.count;
+    }
+    for (unsigned int i = 0; i < count; i++)
+      order[textureCounts[buckets[i]]++] = i;
+  }
+  else
+  {
+    for (unsigned int i = 0; i < count; i++)
+    {
+      order[i] = i;
+      if (ranges.empty() || ranges.back().texture != buckets[i])
+      {
+        Range range = {buckets[i], i, 0};
+        ranges.push_back(range);
+      }
+      ranges.back().count++;
+    }
+  }
+
+  computeCorners();
+  buildMilliseconds += now() - start;
+
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  // unsynchronized appends into a ring, orphaned when it runs full
+  if (ringOffset + count * 4 > maxSprites * 4)
+  {
+    glBufferData(GL_ARRAY_BUFFER, maxSprites * 4 * sizeof(Vertex), NULL,
+                 GL_STREAM_DRAW);
+    ringOffset = 0;
+  }
+  Vertex* vertices = (Vertex*)glMapBufferRange(
+          GL_ARRAY_BUFFER, ringOffset * sizeof(Vertex),
+          count * 4 * sizeof(Vertex),
+          GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+          GL_MAP_UNSYNCHRONIZED_BIT);
+  start = now();
+  for (unsigned int k = 0; k < count; k++)
+  {
+    unsigned int i = order[k];
+    const float* a = cornersA + i * 4;
+    const float* b = cornersB + i * 4;
+    uint16_t u0 = (uint16_t)(uv0[i] & 0xffff), v0 = (uint16_t)(uv0[i] >> 16);
+    uint16_t u1 = (uint16_t)(uv1[i] & 0xffff), v1 = (uint16_t)(uv1[i] >> 16);
+    Vertex* quad = vertices + k * 4;
+    Vertex vertex;
+    vertex.layer = layer[i];
+    vertex.padding = 0;
+    vertex.color = color[i];
+    vertex.x = a[0]; vertex.y = a[1]; vertex.u = u0; vertex.v = v0;
+    quad[0] = vertex;
+    vertex.x = a[2]; vertex.y = a[3]; vertex.u = u1;
+    quad[1] = vertex;
+    vertex.x = b[0]; vertex.y = b[1]; vertex.v = v1;
+    quad[2] = vertex;
+    vertex.x = b[2]; vertex.y = b[3]; vertex.u = u0;
+    quad[3] = vertex;
+  }
+  buildMilliseconds += now() - start;
+  glUnmapBuffer(GL_ARRAY_BUFFER);
+
+  shader.use();
+  shader.setMat4("projection", projection);
+  shader.setInt("sprites", 0);
+  glActiveTexture(GL_TEXTURE0);
+  glDisable(GL_DEPTH_TEST);
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glBindVertexArray(VAO);
+  for (const Range &range : ranges)
+  {
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textures[range.texture]);
+    glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)(range.count * 6),
+                             GL_UNSIGNED_INT,
+                             (void*)(range.first * 6 * sizeof(unsigned int)),
+                             (GLint)ringOffset);
+  }
+  glBindVertexArray(0);
+  glDisable(GL_BLEND);
+
+  ringOffset += count * 4;
+  draws += (unsigned int)ranges.size();
+  sprites += count;
+  count = 0;
+  anyRotation = false;
+}
+
+void SpriteBatch::end()
+{
+  flush();
+}
+
+unsigned int SpriteBatch::drawCalls() const
+{
+  return draws;
+}
+
+unsigned int SpriteBatch::spriteCount() const
+{
+  return sprites;
+}
+
+double SpriteBatch::cpuMilliseconds() const
+{
+  return buildMilliseconds;
+}
@@ -0,0 +1,114 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_SPRITEBATCH_H
+#define COORDINATESPACE_SPRITEBATCH_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Sprite batch
+ *  2D sprites drawn with the orthographic projection from the notes in
+ *  main.cpp, e.g. glm::ortho(0.0f, 800.0f, 0.0f, 600.0f, -1.0f, 1.0f) so
+ *  one unit is one pixel. (The sketch's near plane of 0.1 would clip
+ *  sprites at z = 0, which is why the range goes through zero here.)
+ *
+ *  Drawing sprites one call each falls over long before 100k sprites, so
+ *  draw() only records the sprite. end() turns everything recorded into
+ *  quads in a streaming vertex buffer and draws as few ranges of it as
+ *  possible: every texture is a GL_TEXTURE_2D_ARRAY and the layer is a
+ *  vertex attribute, so sprites only need a new draw call when the texture
+ *  object changes, not when they use a different image of the same array.
+ *
+ *  With sortByTexture the sprites are grouped by texture first (a stable
+ *  counting sort, so within a texture the submission order stays), which
+ *  gives one draw call per texture. Turn it off when sprites of different
+ *  textures overlap and the submission order is the painting order; then
+ *  only consecutive sprites of the same texture share a draw.
+ *
+ *  The corners are computed on the CPU, eight sprites at a time with
+ *  float8: scale is part of the sprite size and rotation (around the
+ *  sprite's center) uses the SIMD sincos. Batches without any rotation
+ *  skip the sincos.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class SpriteBatch
+{
+public:
+  bool sortByTexture;
+
+  explicit SpriteBatch(unsigned int maxSprites = 131072);
+  ~SpriteBatch();
+  SpriteBatch(const SpriteBatch &) = delete;
+  SpriteBatch &operator=(const SpriteBatch &) = delete;
+
+  void begin(const glm::mat4 &projection);
+  // center and size in projection units, uv as (u0, v0, u1, v1), color as
+  // 0xAABBGGRR
+  void draw(unsigned int texture, int layer, const glm::vec2 &center,
+            const glm::vec2 &size, float rotation = 0.0f,
+            const glm::vec4 &uv = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+            uint32_t color = 0xffffffffu);
+  // draws what was recorded since begin() or the last flush
+  void flush();
+  void end();
+
+  // totals since begin()
+  unsigned int drawCalls() const;
+  unsigned int spriteCount() const;
+  // CPU time flushes spent sorting, transforming and writing vertices, not
+  // counting the GL calls (buffer mapping and draws) themselves
+  double cpuMilliseconds() const;
+
+private:
+  struct Vertex
+  {
+    float x, y;
+    uint16_t u, v;
+    uint16_t layer, padding;
+    uint32_t color;
+  };
+
+  unsigned int maxSprites;
+  unsigned int count;
+  bool anyRotation;
+  // recorded sprites, structure of arrays
+  float* centerX;
+  float* centerY;
+  float* halfWidth;
+  float* halfHeight;
+  float* rotation;
+  uint32_t* uv0;
+  uint32_t* uv1;
+  uint32_t* color;
+  uint16_t* layer;
+  unsigned int* texture;
+  // corners 0, 1 and 2, 3 of each sprite as x, y pairs
+  float* cornersA;
+  float* cornersB;
+
+  std::vector<unsigned int> textures;
+  std::vector<unsigned int> textureCounts;
+  std::vector<unsigned int> buckets;
+  std::vector<unsigned int> order;
+
+  unsigned int VAO;
+  unsigned int VBO;
+  unsigned int EBO;
+  unsigned int ringOffset;
+  Shader shader;
+  glm::mat4 projection;
+  unsigned int draws;
+  unsigned int sprites;
+  double buildMilliseconds;
+
+  void computeCorners();
+};
+#endif //COORDINATESPACE_SPRITEBATCH_H
@@ -0,0 +1,343 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "staticbatch.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <tuple>
+
+namespace
+{
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+
+  // instances per job, they differ a lot in size so keep the chunks small
+  const size_t INSTANCES_PER_JOB = 16;
+}
+
+StaticMesh::StaticMesh()
+  : vertexCount(0)
+{
+  bounds.min = glm::vec3(0.0f);
+  bounds.max = glm::vec3(0.0f);
+}
+
+void StaticMesh::setVertices(const std::vector<glm::vec3> &positions,
+                             const std::vector<glm::vec3> &normals)
+{
+  vertexCount = (unsigned int)positions.size();
+  size_t padded = (positions.size() + 7) & ~(size_t)7;
+  std::vector<float>* arrays[] = {&x, &y, &z, &nx, &ny, &nz};
+  for (std::vector<float>* array : arrays)
+    array->assign(padded, 0.0f);
+  bounds.min = glm::vec3(positions.empty() ? 0.0f : 1e30f);
+  bounds.max = glm::vec3(positions.empty() ? 0.0f : -1e30f);
+  for (size_t i = 0; i < positions.size(); i++)
+  {
+    x[i] = positions[i].x;
+    y[i] = positions[i].y;
+    z[i] = positions[i].z;
+    bounds.min = glm::min(bounds.min, positions[i]);
+    bounds.max = glm::max(bounds.max, positions[i]);
+  }
+  if (normals.size() != positions.size())
+  {
+    nx.clear();
+    ny.clear();
+    nz.clear();
+    return;
+  }
+  for (size_t i = 0; i < normals.size(); i++)
+  {
+    nx[i] = normals[i].x;
+    ny[i] = normals[i].y;
+    nz[i] = normals[i].z;
+  }
+}
+
+StaticBatcher::StaticBatcher()
+  : chunkSize(64.0f), simd(true), vertexTotal(0), indexTotal(0), VAO(0),
+    VBO(0), EBO(0),
+    shader("shaders/staticbatchvs.txt", "shaders/staticbatchfs.txt"),
+    draws(0), drawn(0), buildTime(0.0),
+    transformTime(0.0)
+{
+  materialColors.push_back(glm::vec3(0.8f));
+}
+
+StaticBatcher::~StaticBatcher()
+{
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &VBO);
+  glDeleteBuffers(1, &EBO);
+  glDeleteProgram(shader.ID);
+}
+
+void StaticBatcher::add(const StaticMesh &mesh, unsigned int material,
+                        const glm::mat4 &model)
+{
+  Instance instance;
+  instance.mesh = &mesh;
+  instance.material = material;
+  instance.model = model;
+  instance.bounds = transformAABB(mesh.bounds, model);
+  instance.firstVertex = 0;
+  instance.firstIndex = 0;
+  instances.push_back(instance);
+}
+
+void transformMesh(const StaticMesh &mesh, const glm::mat4 &model,
+                   bool simd, float* positions, float* normals)
+{
+  const glm::mat4 &m = model;
+  // normals go through the inverse transpose, which keeps them
+  // perpendicular under non-uniform scale
+  glm::mat3 n = glm::transpose(glm::inverse(glm::mat3(m)));
+  bool hasNormals = !mesh.nx.empty();
+  size_t padded = mesh.x.size();
+
+  if (simd)
+  {
+    const float8 one(1.0f), zero(0.0f), tiny(1e-20f);
+    float8 m00(m[0][0]), m01(m[0][1]), m02(m[0][2]);
+    float8 m10(m[1][0]), m11(m[1][1]), m12(m[1][2]);
+    float8 m20(m[2][0]), m21(m[2][1]), m22(m[2][2]);
+    float8 m30(m[3][0]), m31(m[3][1]), m32(m[3][2]);
+    float8 n00(n[0][0]), n01(n[0][1]), n02(n[0][2]);
+    float8 n10(n[1][0]), n11(n[1][1]), n12(n[1][2]);
+    float8 n20(n[2][0]), n21(n[2][1]), n22(n[2][2]);
+    for (size_t i = 0; i < padded; i += 8)
+    {
+      float8 x = float8::load(mesh.x.data() + i);
+      float8 y = float8::load(mesh.y.data() + i);
+      float8 z = float8::load(mesh.z.data() + i);
+      float8 px = fmadd(m00, x, fmadd(m10, y, fmadd(m20, z, m30)));
+      float8 py = fmadd(m01, x, fmadd(m11, y, fmadd(m21, z, m31)));
+      float8 pz = fmadd(m02, x, fmadd(m12, y, fmadd(m22, z, m32)));
+      storeInterleaved4(positions + i * 4, px, py, pz, one);
+      if (!hasNormals)
+      {
+        storeInterleaved4(normals + i * 4, zero, zero, zero, zero);
+        continue;
+      }
+      x = float8::load(mesh.nx.data() + i);
+      y = float8::load(mesh.ny.data() + i);
+      z = float8::load(mesh.nz.data() + i);
+      float8 wx = n00 * x + n10 * y + n20 * z;
+      float8 wy = n01 * x + n11 * y + n21 * z;
+      float8 wz = n02 * x + n12 * y + n22 * z;
+      float8 inverse = one / sqrt(max(wx * wx + wy * wy + wz * wz, tiny));
+      storeInterleaved4(normals + i * 4, wx * inverse, wy * inverse,
+                        wz * inverse, zero);
+    }
+  }
+  else
+  {
+    for (size_t i = 0; i < padded; i++)
+    {
+      glm::vec4 p = m * glm::vec4(mesh.x[i], mesh.y[i], mesh.z[i], 1.0f);
+      glm::vec3 w(0.0f);
+      if (hasNormals)
+      {
+        w = n * glm::vec3(mesh.nx[i], mesh.ny[i], mesh.nz[i]);
+        w /= std::sqrt(std::max(glm::dot(w, w), 1e-20f));
+      }
+      float* out = positions + i * 4;
+      out[0] = p.x;
+      out[1] = p.y;
+      out[2] = p.z;
+      out[3] = 1.0f;
+      out = normals + i * 4;
+      out[0] = w.x;
+      out[1] = w.y;
+      out[2] = w.z;
+      out[3] = 0.0f;
+    }
+  }
+}
+
+void StaticBatcher::transform(const Instance &instance, float* positions,
+                              float* normals, unsigned int* indices) const
+{
+  const StaticMesh &mesh = *instance.mesh;
+  transformMesh(mesh, instance.model, simd,
+                positions + instance.firstVertex * 4,
+                normals + instance.firstVertex * 4);
+  unsigned int base = (unsigned int)instance.firstVertex;
+  unsigned int* out = indices + instance.firstIndex;
+  for (size_t k = 0; k < mesh.indices.size(); k++)
+    out[k] = mesh.indices[k] + base;
+}
+
+void StaticBatcher::build(JobSystem* jobs)
+{
+  double start = now();
+
+  // group by material, then chunk; the map keeps the groups of a material
+  // together so rendering changes the color once per material
+  typedef std::tuple<unsigned int, int, int, int> ChunkKey;
+  std::map<ChunkKey, std::vector<unsigned int> > groups;
+  for (size_t i = 0; i < instances.size(); i++)
+  {
+    const Instance &instance = instances[i];
+    glm::vec3 cell = glm::floor(0.5f * (instance.bounds.min +
+                                        instance.bounds.max) / chunkSize);
+    ChunkKey key(instance.material, (int)cell.x, (int)cell.y, (int)cell.z);
+    groups[key].push_back((unsigned int)i);
+  }
+
+  // each instance's place in the merged buffers, in chunk order so a
+  // chunk is one contiguous index range
+  std::vector<unsigned int> order;
+  chunks.clear();
+  vertexTotal = 0;
+  indexTotal = 0;
+  for (const std::pair<const ChunkKey, std::vector<unsigned int> > &group :
+       groups)
+  {
+    Chunk chunk;
+    chunk.material = std::get<0>(group.first);
+    chunk.bounds.min = glm::vec3(1e30f);
+    chunk.bounds.max = glm::vec3(-1e30f);
+    chunk.firstIndex = indexTotal;
+    chunk.instanceCount = (unsigned int)group.second.size();
+    for (unsigned int i : group.second)
+    {
+      Instance &instance = instances[i];
+      instance.firstVertex = vertexTotal;
+      instance.firstIndex = indexTotal;
+      vertexTotal += instance.mesh->x.size();
+      indexTotal += instance.mesh->indices.size();
+      chunk.bounds.min = glm::min(chunk.bounds.min, instance.bounds.min);
+      chunk.bounds.max = glm::max(chunk.bounds.max, instance.bounds.max);
+      order.push_back(i);
+    }
+    chunk.indexCount = indexTotal - chunk.firstIndex;
+    chunks.push_back(chunk);
+  }
+
+  std::vector<float> positions(vertexTotal * 4);
+  std::vector<float> normals(vertexTotal * 4);
+  std::vector<unsigned int> indices(indexTotal);
+  JobSystem::RangeFunction transformRange = [&](size_t begin, size_t end)
+  {
+    for (size_t k = begin; k < end; k++)
+      transform(instances[order[k]], positions.data(), normals.data(),
+                indices.data());
+  };
+  double transformStart = now();
+  parallelFor(jobs, order.size(), INSTANCES_PER_JOB, transformRange);
+  transformTime = now() - transformStart;
+
+  // positions then normals in one buffer
+  if (VAO == 0)
+  {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+  }
+  size_t block = vertexTotal * 4 * sizeof(float);
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glBufferData(GL_ARRAY_BUFFER, 2 * block, NULL, GL_STATIC_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, block, positions.data());
+  glBufferSubData(GL_ARRAY_BUFFER, block, block, normals.data());
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexTotal * sizeof(unsigned int),
+               indices.data(), GL_STATIC_DRAW);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                        (void*)0);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
+                        (void*)block);
+  glEnableVertexAttribArray(1);
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  buildTime = now() - start;
+}
+
+void StaticBatcher::render(const glm::mat4 &viewProjection)
+{
+  Frustum frustum(viewProjection);
+  shader.use();
+  shader.setMat4("viewProjection", viewProjection);
+  int colorLocation = glGetUniformLocation(shader.ID, "color");
+  glBindVertexArray(VAO);
+  draws = 0;
+  drawn = 0;
+  unsigned int currentMaterial = ~0u;
+  for (const Chunk &chunk : chunks)
+  {
+    if (!frustum.intersects(chunk.bounds))
+      continue;
+    if (chunk.material != currentMaterial)
+    {
+      currentMaterial = chunk.material;
+      glm::vec3 color = materialColors[currentMaterial %
+                                       materialColors.size()];
+      glUniform3f(colorLocation, color.x, color.y, color.z);
+    }
+    glDrawElements(GL_TRIANGLES, (GLsizei)chunk.indexCount, GL_UNSIGNED_INT,
+                   (void*)(chunk.firstIndex * sizeof(unsigned int)));
+    draws++;
+    drawn += chunk.instanceCount;
+  }
+  glBindVertexArray(0);
+}
+
+unsigned int StaticBatcher::instanceCount() const
+{
+  return (unsigned int)instances.size();
+}
+
+unsigned int StaticBatcher::chunkCount() const
+{
+  return (unsigned int)chunks.size();
+}
+
+unsigned int StaticBatcher::drawCalls() const
+{
+  return draws;
+}
+
+unsigned int StaticBatcher::drawnInstances() const
+{
+  return drawn;
+}
+
+double StaticBatcher::buildMilliseconds() const
+{
+  return buildTime;
+}
+
+double StaticBatcher::transformMilliseconds() const
+{
+  return transformTime;
+}
+
+size_t StaticBatcher::bufferBytes() const
+{
+  return vertexTotal * 8 * sizeof(float) + indexTotal * sizeof(unsigned int);
+}
+
+void StaticBatcher::printReport() const
+{
+  std::cout << "static batching: " << instances.size()
+            << " instances (one draw each without batching) merged into "
+            << chunks.size() << " chunks, " << bufferBytes() / (1024.0 * 1024.0)
+            << " MiB of buffers, built in " << buildTime << " ms ("
+            << transformTime << " transforming); last frame "
+            << draws << " draws for " << drawn << " instances" << std::endl;
+}
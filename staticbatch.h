@@ -0,0 +1,133 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_STATICBATCH_H
+#define COORDINATESPACE_STATICBATCH_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "frustum.h"
+#include "jobsystem.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Static batching
+ *  Most of a level never moves: walls, rocks, props. Drawn one by one each
+ *  of them costs a draw call and a model matrix upload every frame, for
+ *  geometry that's the same every frame.
+ *
+ *  The StaticBatcher takes all of those instances at load time and
+ *  transforms their vertices into world space once. Instances sharing a
+ *  material are merged into one index range per chunk of a regular grid
+ *  (chunkSize world units on a side, by the center of the instance), and
+ *  each chunk keeps the bounds of everything in it. At run time a visible
+ *  chunk is a single draw without a model matrix; a chunk outside the
+ *  frustum is skipped as a whole. Chunks keep the culling useful: one
+ *  batch for the whole level would always be drawn completely.
+ *
+ *  The pre-transform is the expensive part of the build. The meshes keep
+ *  their vertices as structure of arrays padded to a multiple of 8, so
+ *  eight vertices are transformed at once with float8 and written with
+ *  storeInterleaved4: positions as (x, y, z, 1) and normals as (x, y, z,
+ *  0) in two blocks of the same buffer. The instances are spread over the
+ *  JobSystem, each writing its own vertex and index range. Every instance
+ *  gets its padded vertex count in the buffer, the few padding vertices
+ *  are never referenced.
+ *
+ *  The price is memory: every instance now has its own copy of the
+ *  vertices (32 bytes each), where instancing would share one mesh.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+struct StaticMesh
+{
+  // vertices as structure of arrays, padded to a multiple of 8
+  std::vector<float> x, y, z;
+  std::vector<float> nx, ny, nz;
+  std::vector<unsigned int> indices;
+  unsigned int vertexCount;
+  AABB bounds;
+
+  StaticMesh();
+  // normals may be empty, the fragment shader falls back to face normals
+  void setVertices(const std::vector<glm::vec3> &positions,
+                   const std::vector<glm::vec3> &normals);
+};
+
+// writes the mesh's padded vertices transformed by model as (x, y, z, 1)
+// to positions and (x, y, z, 0) to normals, 4 floats per vertex each
+void transformMesh(const StaticMesh &mesh, const glm::mat4 &model,
+                   bool simd, float* positions, float* normals);
+
+class StaticBatcher
+{
+public:
+  float chunkSize;
+  // the pre-transform with float8, or one vertex at a time
+  bool simd;
+  // color of each material index
+  std::vector<glm::vec3> materialColors;
+
+  StaticBatcher();
+  ~StaticBatcher();
+  StaticBatcher(const StaticBatcher &) = delete;
+  StaticBatcher &operator=(const StaticBatcher &) = delete;
+
+  // mesh must stay alive until build()
+  void add(const StaticMesh &mesh, unsigned int material,
+           const glm::mat4 &model);
+  // transform, merge and upload everything added; jobs may be NULL
+  void build(JobSystem* jobs);
+  // draws the chunks intersecting the frustum
+  void render(const glm::mat4 &viewProjection);
+
+  unsigned int instanceCount() const;
+  unsigned int chunkCount() const;
+  // of the last render(): draw calls and the instances they covered
+  unsigned int drawCalls() const;
+  unsigned int drawnInstances() const;
+  // all of build(), and the part of it spent transforming vertices
+  double buildMilliseconds() const;
+  double transformMilliseconds() const;
+  size_t bufferBytes() const;
+  void printReport() const;
+
+private:
+  struct Instance
+  {
+    const StaticMesh* mesh;
+    unsigned int material;
+    glm::mat4 model;
+    AABB bounds;
+    size_t firstVertex;
+    size_t firstIndex;
+  };
+
+  struct Chunk
+  {
+    unsigned int material;
+    AABB bounds;
+    size_t firstIndex;
+    size_t indexCount;
+    unsigned int instanceCount;
+  };
+
+  std::vector<Instance> instances;
+  std::vector<Chunk> chunks;
+  size_t vertexTotal;
+  size_t indexTotal;
+
+  unsigned int VAO, VBO, EBO;
+  Shader shader;
+  unsigned int draws;
+  unsigned int drawn;
+  double buildTime;
+  double transformTime;
+
+  void transform(const Instance &instance, float* positions, float* normals,
+                 unsigned int* indices) const;
+};
+#endif //COORDINATESPACE_STATICBATCH_H
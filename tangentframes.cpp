@@ -0,0 +1,466 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "tangentframes.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtx/normal.hpp>
+#include <glm/gtx/orthonormalize.hpp>
+#include <glm/gtx/vector_angle.hpp>
+
+namespace
+{
+  // triangles per job of the face pass, a multiple of 8
+  const size_t FACE_CHUNK = 16384;
+  // corners per chunk of the counting sort, fixed like the blocks
+  const size_t CORNER_CHUNK = 65536;
+  // the sums: normal, tangent, bitangent
+  const int SUM_ARRAYS = 9;
+
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+
+  float8 dot(const float8 a[3], const float8 b[3])
+  {
+    return fmadd(a[0], b[0], fmadd(a[1], b[1], a[2] * b[2]));
+  }
+
+  void cross(const float8 a[3], const float8 b[3], float8 out[3])
+  {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+  }
+
+  // v / |v|, 0 where |v| is 0; the length goes to length
+  void normalize(float8 v[3], float8 &length)
+  {
+    float8 squared = dot(v, v);
+    length = sqrt(squared);
+    float8 valid = squared > float8(0.0f);
+    float8 inverse = select(valid, float8(1.0f) / length, float8(0.0f));
+    for (int c = 0; c < 3; c++)
+      v[c] = v[c] * inverse;
+  }
+
+  // the face tangent and bitangent: the directions of increasing u and v,
+  // 0 where the texture coordinates don't span the triangle
+  void triangleTangents(const glm::vec3 &edge1, const glm::vec3 &edge2,
+                        const glm::vec2 &uv1, const glm::vec2 &uv2,
+                        glm::vec3 &tangent, glm::vec3 &bitangent)
+  {
+    tangent = bitangent = glm::vec3(0.0f);
+    float determinant = uv1.x * uv2.y - uv2.x * uv1.y;
+    if (determinant == 0.0f)
+      return;
+    float r = 1.0f / determinant;
+    glm::vec3 t = (edge1 * uv2.y - edge2 * uv1.y) * r;
+    glm::vec3 b = (edge2 * uv1.x - edge1 * uv2.x) * r;
+    if (glm::dot(t, t) > 0.0f)
+      tangent = glm::normalize(t);
+    if (glm::dot(b, b) > 0.0f)
+      bitangent = glm::normalize(b);
+  }
+
+  // t in the plane perpendicular to the unit normal n, normalized; 0 if t
+  // is 0 or parallel to n
+  glm::vec3 projectTangent(const glm::vec3 &n, const glm::vec3 &t)
+  {
+    glm::vec3 projected = t - n * glm::dot(n, t);
+    float squared = glm::dot(projected, projected);
+    return squared > 1e-12f ? projected / std::sqrt(squared)
+                            : glm::vec3(0.0f);
+  }
+
+  // the angle of the triangle at each corner
+  void cornerAngles(const glm::vec3 &p0, const glm::vec3 &p1,
+                    const glm::vec3 &p2, float angles[3])
+  {
+    angles[0] = glm::angle(glm::normalize(p1 - p0), glm::normalize(p2 - p0));
+    angles[1] = glm::angle(glm::normalize(p0 - p1), glm::normalize(p2 - p1));
+    angles[2] = glm::angle(glm::normalize(p0 - p2), glm::normalize(p1 - p2));
+  }
+
+  // the tangent of normal n from the summed t and b: Gram-Schmidt, or any
+  // perpendicular when t is (nearly) parallel to n; the side of b in w
+  glm::vec4 finishTangent(const glm::vec3 &n, const glm::vec3 &t,
+                          const glm::vec3 &b)
+  {
+    glm::vec3 projected = t - n * glm::dot(n, t);
+    glm::vec3 tangent;
+    if (glm::dot(projected, projected) > 1e-6f * glm::dot(t, t) &&
+        glm::dot(t, t) > 0.0f)
+      tangent = glm::orthonormalize(t, n);
+    else if (std::abs(n.x) < 0.9f)
+      tangent = glm::normalize(glm::vec3(0.0f, n.z, -n.y));
+    else
+      tangent = glm::normalize(glm::vec3(-n.z, 0.0f, n.x));
+    float side = glm::dot(glm::cross(n, tangent), b) < 0.0f ? -1.0f : 1.0f;
+    return glm::vec4(tangent, side);
+  }
+}
+
+TangentFrameGenerator::TangentFrameGenerator()
+  : weighting(ANGLE), simd(true), lastMilliseconds(0.0)
+{
+}
+
+void TangentFrameGenerator::generate(const std::vector<glm::vec3> &positions,
+                                     const std::vector<glm::vec2> &uvs,
+                                     const std::vector<unsigned int> &indices,
+                                     std::vector<uint32_t> &normals,
+                                     std::vector<uint32_t> &tangents,
+                                     JobSystem* jobs)
+{
+  double start = now();
+  bool withUvs = !uvs.empty();
+  if (withUvs && uvs.size() != positions.size())
+  {
+    std::cout << "ERROR::TANGENTFRAMES::UV_COUNT " << uvs.size() << " for "
+              << positions.size() << " positions" << std::endl;
+    return;
+  }
+  for (unsigned int index : indices)
+    if (index >= positions.size())
+    {
+      std::cout << "ERROR::TANGENTFRAMES::INDEX_OUT_OF_RANGE " << index
+                << std::endl;
+      return;
+    }
+  if (simd)
+    generateSimd(positions, uvs, indices, normals, tangents, jobs);
+  else
+    generateScalar(positions, uvs, indices, normals, tangents);
+  lastMilliseconds = now() - start;
+}
+
+void TangentFrameGenerator::generateSimd(
+        const std::vector<glm::vec3> &positions,
+        const std::vector<glm::vec2> &uvs,
+        const std::vector<unsigned int> &indices,
+        std::vector<uint32_t> &normals, std::vector<uint32_t> &tangents,
+        JobSystem* jobs)
+{
+  size_t triangles = indices.size() / 3;
+  size_t cornerCount = triangles * 3;
+  size_t vertexCount = positions.size();
+  bool withUvs = !uvs.empty();
+  // padded to whole float8, the padding is cut off again at the end
+  size_t paddedFaces = (triangles + 7) & ~(size_t)7;
+  size_t paddedVertices = (vertexCount + 7) & ~(size_t)7;
+  size_t blocks = (paddedVertices + VERTEX_BLOCK - 1) / VERTEX_BLOCK;
+  size_t chunks = (cornerCount + CORNER_CHUNK - 1) / CORNER_CHUNK;
+  faceNormals.resize(paddedFaces);
+  faceTangents.resize(paddedFaces);
+  faceBitangents.resize(paddedFaces);
+  faceAngles.resize(paddedFaces);
+  corners.resize(cornerCount);
+  chunkOffsets.assign(chunks * blocks, 0);
+  blockStart.resize(blocks + 1);
+  sums.resize(SUM_ARRAYS * paddedVertices);
+  normals.resize(paddedVertices);
+  tangents.resize(withUvs ? paddedVertices : 0);
+  const Weighting weighting = this->weighting;
+
+  // eight triangles at a time; the lanes past the last triangle repeat it
+  parallelFor(jobs, paddedFaces, FACE_CHUNK, [&](size_t begin, size_t end)
+  {
+    for (size_t first = begin; first < end; first += 8)
+    {
+      float gathered[3][5][8];
+      for (int lane = 0; lane < 8; lane++)
+      {
+        size_t triangle = std::min(first + lane, triangles - 1);
+        for (int corner = 0; corner < 3; corner++)
+        {
+          unsigned int index = indices[triangle * 3 + corner];
+          const glm::vec3 &p = positions[index];
+          glm::vec2 uv = withUvs ? uvs[index] : glm::vec2(0.0f);
+          gathered[corner][0][lane] = p.x;
+          gathered[corner][1][lane] = p.y;
+          gathered[corner][2][lane] = p.z;
+          gathered[corner][3][lane] = uv.x;
+          gathered[corner][4][lane] = uv.y;
+        }
+      }
+      float8 p[3][5];
+      for (int corner = 0; corner < 3; corner++)
+        for (int c = 0; c < 5; c++)
+          p[corner][c] = float8::load(gathered[corner][c]);
+      float8 edge1[3], edge2[3], normal[3], area;
+      for (int c = 0; c < 3; c++)
+      {
+        edge1[c] = p[1][c] - p[0][c];
+        edge2[c] = p[2][c] - p[0][c];
+      }
+      cross(edge1, edge2, normal);
+      normalize(normal, area);
+
+      // the angle between the two edges leaving each corner, 0 for a
+      // degenerate triangle; the normals use it with ANGLE weighting, the
+      // tangents always
+      float8 angles[3] = {float8(0.0f), float8(0.0f), float8(0.0f)};
+      if (weighting == ANGLE || withUvs)
+      {
+        float8 edge3[3], length1, length2, length3;
+        for (int c = 0; c < 3; c++)
+          edge3[c] = p[2][c] - p[1][c];
+        normalize(edge1, length1);
+        normalize(edge2, length2);
+        normalize(edge3, length3);
+        float8 valid = area > float8(0.0f);
+        angles[0] = select(valid, acos(dot(edge1, edge2)), float8(0.0f));
+        angles[1] = select(valid, acos(float8(0.0f) - dot(edge1, edge3)),
+                           float8(0.0f));
+        angles[2] = select(valid, acos(dot(edge2, edge3)), float8(0.0f));
+      }
+
+      float8 tangent[3], bitangent[3];
+      if (withUvs)
+      {
+        float8 u1 = p[1][3] - p[0][3], v1 = p[1][4] - p[0][4];
+        float8 u2 = p[2][3] - p[0][3], v2 = p[2][4] - p[0][4];
+        float8 determinant = u1 * v2 - u2 * v1;
+        float8 r = select(abs(determinant) > float8(0.0f),
+                          float8(1.0f) / determinant, float8(0.0f));
+        // the edges were normalized for the angles, rebuild them
+        for (int c = 0; c < 3; c++)
+        {
+          float8 e1 = p[1][c] - p[0][c], e2 = p[2][c] - p[0][c];
+          tangent[c] = (e1 * v2 - e2 * v1) * r;
+          bitangent[c] = (e2 * u1 - e1 * u2) * r;
+        }
+        float8 length;
+        normalize(tangent, length);
+        normalize(bitangent, length);
+      }
+      else
+        for (int c = 0; c < 3; c++)
+          tangent[c] = bitangent[c] = float8(0.0f);
+
+      storeInterleaved4(&faceNormals[first].x, normal[0], normal[1],
+                        normal[2], area);
+      storeInterleaved4(&faceTangents[first].x, tangent[0], tangent[1],
+                        tangent[2], float8(0.0f));
+      storeInterleaved4(&faceBitangents[first].x, bitangent[0],
+                        bitangent[1], bitangent[2], float8(0.0f));
+      storeInterleaved4(&faceAngles[first].x, angles[0], angles[1],
+                        angles[2], float8(0.0f));
+    }
+  });
+
+  // the corners of every chunk by vertex block
+  parallelFor(jobs, chunks, 1, [&](size_t begin, size_t end)
+  {
+    for (size_t chunk = begin; chunk < end; chunk++)
+    {
+      unsigned int* counts = &chunkOffsets[chunk * blocks];
+      size_t last = std::min(cornerCount, (chunk + 1) * CORNER_CHUNK);
+      for (size_t i = chunk * CORNER_CHUNK; i < last; i++)
+        counts[indices[i] / VERTEX_BLOCK]++;
+    }
+  });
+  unsigned int offset = 0;
+  for (size_t block = 0; block < blocks; block++)
+  {
+    blockStart[block] = offset;
+    for (size_t chunk = 0; chunk < chunks; chunk++)
+    {
+      unsigned int &slot = chunkOffsets[chunk * blocks + block];
+      unsigned int chunkCount = slot;
+      slot = offset;
+      offset += chunkCount;
+    }
+  }
+  blockStart[blocks] = offset;
+  parallelFor(jobs, chunks, 1, [&](size_t begin, size_t end)
+  {
+    for (size_t chunk = begin; chunk < end; chunk++)
+    {
+      unsigned int* offsets = &chunkOffsets[chunk * blocks];
+      size_t last = std::min(cornerCount, (chunk + 1) * CORNER_CHUNK);
+      for (size_t i = chunk * CORNER_CHUNK; i < last; i++)
+        corners[offsets[indices[i] / VERTEX_BLOCK]++] = (unsigned int)i;
+    }
+  });
+
+  // every block sums and finishes its own vertices
+  parallelFor(jobs, blocks, 1, [&](size_t begin, size_t end)
+  {
+    float* sum[SUM_ARRAYS];
+    for (int a = 0; a < SUM_ARRAYS; a++)
+      sum[a] = &sums[a * paddedVertices];
+    for (size_t block = begin; block < end; block++)
+    {
+      size_t firstVertex = block * VERTEX_BLOCK;
+      size_t lastVertex = std::min(paddedVertices, firstVertex + VERTEX_BLOCK);
+      for (int a = 0; a < SUM_ARRAYS; a++)
+        std::fill(sum[a] + firstVertex, sum[a] + lastVertex, 0.0f);
+      for (unsigned int i = blockStart[block]; i < blockStart[block + 1]; i++)
+      {
+        unsigned int corner = corners[i];
+        unsigned int vertex = indices[corner];
+        size_t triangle = corner / 3;
+        const glm::vec4 &n = faceNormals[triangle];
+        float weight = weighting == ANGLE
+                       ? faceAngles[triangle][corner - triangle * 3] : n.w;
+        sum[0][vertex] += weight * n.x;
+        sum[1][vertex] += weight * n.y;
+        sum[2][vertex] += weight * n.z;
+      }
+
+      const float8 zero(0.0f), one(1.0f);
+      for (size_t v = firstVertex; v < lastVertex; v += 8)
+      {
+        float8 n[3], length;
+        for (int c = 0; c < 3; c++)
+          n[c] = float8::load(sum[c] + v);
+        normalize(n, length);
+        // unused vertices face +z
+        n[2] = select(length > zero, n[2], one);
+        storeSnorm3x10_1x2(&normals[v], n[0], n[1], n[2], zero);
+        for (int c = 0; c < 3; c++)
+          n[c].store(sum[c] + v);
+      }
+      if (!withUvs)
+        continue;
+
+      // every corner's tangent and bitangent go into the plane of its
+      // vertex normal before they are added, weighted by the corner angle
+      for (unsigned int i = blockStart[block]; i < blockStart[block + 1]; i++)
+      {
+        unsigned int corner = corners[i];
+        unsigned int vertex = indices[corner];
+        size_t triangle = corner / 3;
+        glm::vec3 n(sum[0][vertex], sum[1][vertex], sum[2][vertex]);
+        float weight = faceAngles[triangle][corner - triangle * 3];
+        glm::vec3 t = projectTangent(n, glm::vec3(faceTangents[triangle]));
+        glm::vec3 b = projectTangent(n, glm::vec3(faceBitangents[triangle]));
+        sum[3][vertex] += weight * t.x;
+        sum[4][vertex] += weight * t.y;
+        sum[5][vertex] += weight * t.z;
+        sum[6][vertex] += weight * b.x;
+        sum[7][vertex] += weight * b.y;
+        sum[8][vertex] += weight * b.z;
+      }
+
+      for (size_t v = firstVertex; v < lastVertex; v += 8)
+      {
+        float8 n[3], t[3], b[3], length;
+        for (int c = 0; c < 3; c++)
+        {
+          n[c] = float8::load(sum[c] + v);
+          t[c] = float8::load(sum[3 + c] + v);
+          b[c] = float8::load(sum[6 + c] + v);
+        }
+
+        float8 tangentLength = dot(t, t);
+        float8 along = dot(n, t);
+        float8 projected[3];
+        for (int c = 0; c < 3; c++)
+          projected[c] = t[c] - n[c] * along;
+        float8 usable = (dot(projected, projected) >
+                         tangentLength * float8(1e-6f)) &
+                        (tangentLength > zero);
+        // cross(n, x) or cross(n, y), whichever axis is further from n
+        float8 nearX = abs(n[0]) < float8(0.9f);
+        float8 perpendicular[3] = {select(nearX, zero, zero - n[2]),
+                                   select(nearX, n[2], zero),
+                                   select(nearX, zero - n[1], n[0])};
+        for (int c = 0; c < 3; c++)
+          projected[c] = select(usable, projected[c], perpendicular[c]);
+        normalize(projected, length);
+        float8 side[3];
+        cross(n, projected, side);
+        float8 w = select(dot(side, b) < zero, float8(-1.0f), one);
+        storeSnorm3x10_1x2(&tangents[v], projected[0], projected[1],
+                           projected[2], w);
+      }
+    }
+  });
+  normals.resize(vertexCount);
+  tangents.resize(withUvs ? vertexCount : 0);
+}
+
+void TangentFrameGenerator::generateScalar(
+        const std::vector<glm::vec3> &positions,
+        const std::vector<glm::vec2> &uvs,
+        const std::vector<unsigned int> &indices,
+        std::vector<uint32_t> &normals, std::vector<uint32_t> &tangents)
+{
+  size_t vertexCount = positions.size();
+  bool withUvs = !uvs.empty();
+  std::vector<glm::vec3> n(vertexCount, glm::vec3(0.0f));
+  std::vector<glm::vec3> t(vertexCount, glm::vec3(0.0f));
+  std::vector<glm::vec3> b(vertexCount, glm::vec3(0.0f));
+  for (size_t i = 0; i + 2 < indices.size(); i += 3)
+  {
+    unsigned int corner[3] = {indices[i], indices[i + 1], indices[i + 2]};
+    const glm::vec3 &p0 = positions[corner[0]];
+    const glm::vec3 &p1 = positions[corner[1]];
+    const glm::vec3 &p2 = positions[corner[2]];
+    glm::vec3 edge1 = p1 - p0, edge2 = p2 - p0;
+    float area = glm::length(glm::cross(edge1, edge2));
+    if (area == 0.0f)
+      continue;
+    glm::vec3 normal = glm::triangleNormal(p0, p1, p2);
+    float weights[3] = {area, area, area};
+    if (weighting == ANGLE)
+      cornerAngles(p0, p1, p2, weights);
+    for (int k = 0; k < 3; k++)
+      n[corner[k]] += weights[k] * normal;
+  }
+
+  normals.resize(vertexCount);
+  for (size_t v = 0; v < vertexCount; v++)
+  {
+    n[v] = glm::dot(n[v], n[v]) > 0.0f ? glm::normalize(n[v])
+                                       : glm::vec3(0, 0, 1);
+    normals[v] = glm::packSnorm3x10_1x2(glm::vec4(n[v], 0.0f));
+  }
+  tangents.resize(withUvs ? vertexCount : 0);
+  if (!withUvs)
+    return;
+
+  // the face tangents projected into every corner's normal plane and
+  // weighted by its angle
+  for (size_t i = 0; i + 2 < indices.size(); i += 3)
+  {
+    unsigned int corner[3] = {indices[i], indices[i + 1], indices[i + 2]};
+    const glm::vec3 &p0 = positions[corner[0]];
+    const glm::vec3 &p1 = positions[corner[1]];
+    const glm::vec3 &p2 = positions[corner[2]];
+    glm::vec3 edge1 = p1 - p0, edge2 = p2 - p0;
+    if (glm::length(glm::cross(edge1, edge2)) == 0.0f)
+      continue;
+    float angles[3];
+    cornerAngles(p0, p1, p2, angles);
+    glm::vec3 tangent, bitangent;
+    triangleTangents(edge1, edge2, uvs[corner[1]] - uvs[corner[0]],
+                     uvs[corner[2]] - uvs[corner[0]], tangent, bitangent);
+    for (int k = 0; k < 3; k++)
+    {
+      const glm::vec3 &normal = n[corner[k]];
+      t[corner[k]] += angles[k] * projectTangent(normal, tangent);
+      b[corner[k]] += angles[k] * projectTangent(normal, bitangent);
+    }
+  }
+  for (size_t v = 0; v < vertexCount; v++)
+    tangents[v] = glm::packSnorm3x10_1x2(finishTangent(n[v], t[v], b[v]));
+}
+
+double TangentFrameGenerator::milliseconds() const
+{
+  return lastMilliseconds;
+}
@@ -0,0 +1,117 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_TANGENTFRAMES_H
+#define COORDINATESPACE_TANGENTFRAMES_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "jobsystem.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Normal and tangent generation
+ *  A mesh imported without normals and tangents gets them from its
+ *  triangles: every triangle adds its normal to its three vertices,
+ *  weighted so that large or wide triangles count more, and every vertex
+ *  normalizes the sum. Tangents follow the texture coordinates: the
+ *  direction of increasing u across the triangle (and of v, the
+ *  bitangent), summed per vertex as well.
+ *
+ *   - AREA weighting adds the cross product of two edges, twice the
+ *     triangle's area; cheap, but a long thin triangle bends the normal of
+ *     a corner it barely touches.
+ *   - ANGLE weighting adds the unit normal (glm::triangleNormal) times the
+ *     angle of the triangle at that corner, which doesn't depend on how
+ *     the surface is triangulated.
+ *
+ *  The tangent sums follow MikkTSpace: the normals are finished first,
+ *  then every corner projects its triangle's tangent and bitangent into
+ *  the plane of its vertex normal, normalizes them and adds them weighted
+ *  by the corner angle, whatever the normal weighting. A sum of vectors in
+ *  that plane stays in it; Gram-Schmidt (glm::orthonormalize) only
+ *  removes rounding. The bitangent is kept only as its side, the sign of
+ *  dot(cross(n, t), b), in w, which is what glTF and most engines' shaders
+ *  expect: bitangent = w * cross(n, t). Unlike MikkTSpace the vertices are
+ *  never split: a vertex shared across a mirrored texture seam averages
+ *  both sides, so such a mesh has to come with the seam split.
+ *
+ *  Both come out packed as 10_10_10_2 (GL_INT_2_10_10_10_REV), 4 bytes a
+ *  vector instead of 12, about 0.1 degrees of precision.
+ *
+ *  The sums are where threads collide: neighbouring triangles share
+ *  vertices. Instead of atomics the generator sorts the triangle corners
+ *  by the block of VERTEX_BLOCK vertices they belong to (a counting sort
+ *  over fixed chunks of corners, like the VertexWelder's partitions); then
+ *  every block sums its own vertices, which nobody else writes, and
+ *  finishes them right away while the sums are in the cache. The corners
+ *  of a block keep the input order, so the result is the same whatever the
+ *  thread count. The per triangle work (normals, angles, tangents) and the
+ *  per vertex work (normalizing, Gram-Schmidt, packing) run on float8,
+ *  eight triangles or vertices at once.
+ *
+ *  simd off is the plain loop, one thread: glm per triangle, sums straight
+ *  into the vertices, glm::packSnorm3x10_1x2. Vertices no triangle with
+ *  any area uses get the normal +z; where the texture coordinates are
+ *  degenerate the tangent is any direction perpendicular to the normal.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class TangentFrameGenerator
+{
+public:
+  enum Weighting
+  {
+    AREA,
+    ANGLE
+  };
+
+  // vertices per block of the sums, a multiple of 8
+  static const unsigned int VERTEX_BLOCK = 4096;
+
+  Weighting weighting;
+  bool simd;
+
+  TangentFrameGenerator();
+
+  // one normal and tangent per position, for the triangle list indices;
+  // uvs can be empty, the tangents are left out then
+  void generate(const std::vector<glm::vec3> &positions,
+                const std::vector<glm::vec2> &uvs,
+                const std::vector<unsigned int> &indices,
+                std::vector<uint32_t> &normals,
+                std::vector<uint32_t> &tangents, JobSystem* jobs = nullptr);
+
+  // CPU time of the last generate()
+  double milliseconds() const;
+
+private:
+  // per triangle, eight at a time: the unit normal with the area in w,
+  // the unit tangent and bitangent, and the angles at corner 0, 1 and 2
+  std::vector<glm::vec4> faceNormals;
+  std::vector<glm::vec4> faceTangents;
+  std::vector<glm::vec4> faceBitangents;
+  std::vector<glm::vec4> faceAngles;
+  // the corners (3 * triangle + corner) sorted by vertex block
+  std::vector<unsigned int> corners;
+  std::vector<unsigned int> chunkOffsets;
+  std::vector<unsigned int> blockStart;
+  // the sums of a block's vertices, structure of arrays for float8
+  std::vector<float> sums;
+  double lastMilliseconds;
+
+  void generateSimd(const std::vector<glm::vec3> &positions,
+                    const std::vector<glm::vec2> &uvs,
+                    const std::vector<unsigned int> &indices,
+                    std::vector<uint32_t> &normals,
+                    std::vector<uint32_t> &tangents, JobSystem* jobs);
+  void generateScalar(const std::vector<glm::vec3> &positions,
+                      const std::vector<glm::vec2> &uvs,
+                      const std::vector<unsigned int> &indices,
+                      std::vector<uint32_t> &normals,
+                      std::vector<uint32_t> &tangents);
+};
+#endif //COORDINATESPACE_TANGENTFRAMES_H
@@ -0,0 +1,214 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "temporalupscale.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+  // radical inverse of index in the given base, in [0, 1)
+  float halton(unsigned int index, unsigned int base)
+  {
+    float result = 0.0f, fraction = 1.0f / base;
+    while (index > 0)
+    {
+      result += (index % base) * fraction;
+      index /= base;
+      fraction /= base;
+    }
+    return result;
+  }
+}
+
+TemporalUpscaler::TemporalUpscaler(int outputWidth, int outputHeight,
+                                   float renderScale)
+  : blendFactor(0.5f), outputWidth(outputWidth), outputHeight(outputHeight),
+    width(0), height(0), renderScale(renderScale), current(0),
+    historyValid(false), frame(0), jitter(0.0f), jittered(1.0f),
+    viewProjection(1.0f), previousViewProjection(1.0f),
+    shader("shaders/upscalevs.txt", "shaders/temporalfs.txt")
+{
+  glGenVertexArrays(1, &VAO);
+  createTargets();
+}
+
+TemporalUpscaler::~TemporalUpscaler()
+{
+  deleteTargets();
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteProgram(shader.ID);
+}
+
+void TemporalUpscaler::createTargets()
+{
+  width = std::max((int)std::ceil(outputWidth * renderScale), 1);
+  height = std::max((int)std::ceil(outputHeight * renderScale), 1);
+
+  glGenTextures(1, &sceneColor);
+  glBindTexture(GL_TEXTURE_2D, sceneColor);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA,
+               GL_UNSIGNED_BYTE, NULL);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glGenTextures(1, &sceneDepth);
+  glBindTexture(GL_TEXTURE_2D, sceneDepth);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0,
+               GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glGenFramebuffers(1, &sceneFBO);
+  glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                         sceneColor, 0);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D,
+                         sceneDepth, 0);
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    std::cout << "ERROR::TEMPORALUPSCALE::FRAMEBUFFER_INCOMPLETE" << std::endl;
+
+  // half floats so slow accumulation doesn't band
+  glGenTextures(2, history);
+  glGenFramebuffers(2, historyFBO);
+  for (int i = 0; i < 2; i++)
+  {
+    glBindTexture(GL_TEXTURE_2D, history[i]);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, outputWidth, outputHeight, 0,
+                 GL_RGBA, GL_HALF_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindFramebuffer(GL_FRAMEBUFFER, historyFBO[i]);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                           GL_TEXTURE_2D, history[i], 0);
+  }
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  historyValid = false;
+}
+
+void TemporalUpscaler::deleteTargets()
+{
+  glDeleteFramebuffers(1, &sceneFBO);
+  glDeleteTextures(1, &sceneColor);
+  glDeleteTextures(1, &sceneDepth);
+  glDeleteFramebuffers(2, historyFBO);
+  glDeleteTextures(2, history);
+}
+
+void TemporalUpscaler::setOutputSize(int width, int height)
+{
+  if (width <= 0 || height <= 0 ||
+      (width == outputWidth && height == outputHeight))
+    return;
+  outputWidth = width;
+  outputHeight = height;
+  deleteTargets();
+  createTargets();
+}
+
+void TemporalUpscaler::reset()
+{
+  historyValid = false;
+}
+
+void TemporalUpscaler::beginScene(const glm::mat4 &view,
+                                  const glm::mat4 &projection)
+{
+  previousViewProjection = viewProjection;
+  viewProjection = projection * view;
+
+  // the sequence starts at 1, index 0 would be (0, 0) for both bases
+  unsigned int phase = frame % JITTER_PHASES + 1;
+  jitter = glm::vec2(halton(phase, 2) - 0.5f, halton(phase, 3) - 0.5f);
+  frame++;
+  // a translation after the projection moves the image by the jitter in
+  // pixels, 2 / size per pixel in NDC, for any kind of projection
+  jittered = glm::translate(glm::mat4(1.0f),
+                            glm::vec3(2.0f * jitter.x / width,
+                                      2.0f * jitter.y / height, 0.0f)) *
+             projection;
+
+  glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+  glViewport(0, 0, width, height);
+  sceneTimer.begin();
+}
+
+const glm::mat4 &TemporalUpscaler::jitteredProjection() const
+{
+  return jittered;
+}
+
+void TemporalUpscaler::endScene()
+{
+  sceneTimer.end();
+}
+
+void TemporalUpscaler::resolve(unsigned int framebuffer)
+{
+  resolveTimer.begin();
+  int next = 1 - current;
+  glBindFramebuffer(GL_FRAMEBUFFER, historyFBO[next]);
+  glViewport(0, 0, outputWidth, outputHeight);
+  bool depthTest = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+  glDisable(GL_DEPTH_TEST);
+
+  shader.use();
+  shader.setInt("scene", 0);
+  shader.setInt("sceneDepth", 1);
+  shader.setInt("history", 2);
+  glUniform2i(glGetUniformLocation(shader.ID, "renderSize"), width, height);
+  shader.setVec2("outputSize", glm::vec2(outputWidth, outputHeight));
+  shader.setVec2("jitter", jitter);
+  shader.setMat4("reprojection",
+                 previousViewProjection * glm::inverse(viewProjection));
+  shader.setInt("hasHistory", historyValid ? 1 : 0);
+  shader.setFloat("blendFactor", blendFactor);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, sceneColor);
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, sceneDepth);
+  glActiveTexture(GL_TEXTURE2);
+  glBindTexture(GL_TEXTURE_2D, history[current]);
+  glBindVertexArray(VAO);
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+  glBindVertexArray(0);
+  glActiveTexture(GL_TEXTURE0);
+
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, historyFBO[next]);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+  glBlitFramebuffer(0, 0, outputWidth, outputHeight, 0, 0, outputWidth,
+                    outputHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  if (depthTest)
+    glEnable(GL_DEPTH_TEST);
+  resolveTimer.end();
+
+  current = next;
+  historyValid = true;
+}
+
+int TemporalUpscaler::renderWidth() const
+{
+  return width;
+}
+
+int TemporalUpscaler::renderHeight() const
+{
+  return height;
+}
+
+double TemporalUpscaler::sceneGpuMilliseconds()
+{
+  return sceneTimer.milliseconds();
+}
+
+double TemporalUpscaler::resolveGpuMilliseconds()
+{
+  return resolveTimer.milliseconds();
+}
@@ -0,0 +1,114 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_TEMPORALUPSCALE_H
+#define COORDINATESPACE_TEMPORALUPSCALE_H
+
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "gputimer.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Temporal upscaling
+ *  On a high-DPI display most of the frame goes into shading pixels. The
+ *  scene can be rendered at half the width and height (a quarter of the
+ *  fragments) and still resolve close to full resolution, if every frame
+ *  samples different points inside the pixels and the frames are
+ *  accumulated:
+ *
+ *   - jitter: the projection is moved by a subpixel offset each frame,
+ *     taken from the Halton (2, 3) sequence. Over 8 frames the samples of
+ *     one low resolution pixel cover the four output pixels it overlaps.
+ *
+ *   - reprojection: the camera moved since the last frame, so a point's
+ *     pixel in the history isn't the pixel it's in now. The depth of the
+ *     current frame turns the output pixel back into a world position
+ *     (inverse of this frame's view-projection), the previous frame's
+ *     view-projection tells where it was in the history. Only the camera
+ *     motion is handled this way, objects moving on their own would need
+ *     per pixel motion vectors.
+ *
+ *   - neighborhood clamp: the history can hold colors that aren't there
+ *     any more (something moved in front, a light changed). The history
+ *     color is clamped into the range of the current frame's 3x3 samples
+ *     around the pixel, which stops most of the ghosting.
+ *
+ *   - blending: each output pixel takes the current samples weighted by
+ *     how close they landed to its center. The closest sample's weight
+ *     also decides how much of the result comes from this frame, so a
+ *     sample right on the pixel replaces much of the history and one a
+ *     pixel away barely changes it.
+ *
+ *  The history is kept at output resolution in two half float textures
+ *  used in turns; the resolved frame is copied to the output framebuffer.
+ *
+ *  Usage per frame:
+ *    upscaler.beginScene(view, projection);
+ *    ... draw with upscaler.jitteredProjection() ...
+ *    upscaler.endScene();
+ *    upscaler.resolve(framebuffer);
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class TemporalUpscaler
+{
+public:
+  static const int JITTER_PHASES = 8;
+
+  // largest share of the current frame in a resolved pixel
+  float blendFactor;
+
+  TemporalUpscaler(int outputWidth, int outputHeight,
+                   float renderScale = 0.5f);
+  ~TemporalUpscaler();
+  TemporalUpscaler(const TemporalUpscaler &) = delete;
+  TemporalUpscaler &operator=(const TemporalUpscaler &) = delete;
+
+  void setOutputSize(int width, int height);
+  // forget the history, after a camera cut
+  void reset();
+
+  // binds the low resolution target and picks this frame's jitter
+  void beginScene(const glm::mat4 &view, const glm::mat4 &projection);
+  const glm::mat4 &jitteredProjection() const;
+  void endScene();
+  // reproject, clamp and accumulate into the history, then copy the result
+  // to framebuffer
+  void resolve(unsigned int framebuffer = 0);
+
+  int renderWidth() const;
+  int renderHeight() const;
+  double sceneGpuMilliseconds();
+  double resolveGpuMilliseconds();
+
+private:
+  int outputWidth, outputHeight;
+  int width, height;
+  float renderScale;
+
+  unsigned int sceneFBO;
+  unsigned int sceneColor;
+  unsigned int sceneDepth;
+  unsigned int historyFBO[2];
+  unsigned int history[2];
+  int current;
+  bool historyValid;
+
+  unsigned int frame;
+  glm::vec2 jitter;
+  glm::mat4 jittered;
+  glm::mat4 viewProjection;
+  glm::mat4 previousViewProjection;
+
+  unsigned int VAO;
+  Shader shader;
+  GpuTimer sceneTimer;
+  GpuTimer resolveTimer;
+
+  void createTargets();
+  void deleteTargets();
+};
+#endif //COORDINATESPACE_TEMPORALUPSCALE_H
@@ -0,0 +1,469 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "terrain.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  const int GRID_VERTICES = Terrain::CHUNK_CELLS + 1;
+
+  // height of the coarse surface at (u, v) inside a coarse cell with corner
+  // heights a (0,0), b (1,0), c (0,1) and d (1,1); the same a-d diagonal the
+  // index buffers use
+  float coarseHeight(float a, float b, float c, float d, float u, float v)
+  {
+    if (u >= v)
+      return a + u * (b - a) + v * (d - b);
+    return a + v * (c - a) + u * (d - c);
+  }
+}
+
+Terrain::Terrain(HeightFunction heightFunction, float cellSize,
+                 JobSystem* jobs)
+  : pixelErrorTolerance(2.0f), viewDistance(1000.0f),
+    memoryBudget(64u << 20), maxLoadsPerFrame(4),
+    heightFunction(heightFunction), cellSize(cellSize), jobs(jobs),
+    shader("shaders/terrainvs.txt", "shaders/terrainfs.txt"),
+    drawnChunks(0), drawnTriangles(0), loadsLastFrame(0),
+    evictionsLastFrame(0)
+{
+  for (int l = 0; l < LOD_COUNT; l++)
+    levelError[l] = 0.0f;
+
+  // the grid coordinates every chunk is drawn with
+  std::vector<float> grid;
+  grid.reserve(GRID_VERTICES * GRID_VERTICES * 2);
+  for (int z = 0; z < GRID_VERTICES; z++)
+  {
+    for (int x = 0; x < GRID_VERTICES; x++)
+    {
+      grid.push_back((float)x);
+      grid.push_back((float)z);
+    }
+  }
+
+  std::vector<unsigned int> indices;
+  for (int l = 0; l < LOD_COUNT; l++)
+  {
+    for (int edges = 0; edges < EDGE_VARIANTS; edges++)
+    {
+      ranges[l][edges].offset = (unsigned int)indices.size();
+      buildIndices(l, edges, indices);
+      ranges[l][edges].count = (unsigned int)indices.size() -
+                               ranges[l][edges].offset;
+    }
+  }
+
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &gridVBO);
+  glGenBuffers(1, &EBO);
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, gridVBO);
+  glBufferData(GL_ARRAY_BUFFER, grid.size() * sizeof(float), grid.data(),
+               GL_STATIC_DRAW);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+  glEnableVertexAttribArray(0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
+               indices.data(), GL_STATIC_DRAW);
+  glBindVertexArray(0);
+}
+
+Terrain::~Terrain()
+{
+  for (size_t i = 0; i < tiles.size(); i++)
+    glDeleteTextures(1, &tiles[i].heightTexture);
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &gridVBO);
+  glDeleteBuffers(1, &EBO);
+  glDeleteProgram(shader.ID);
+}
+
+long long Terrain::key(int x, int z)
+{
+  return ((long long)x << 32) ^ (long long)(unsigned int)z;
+}
+
+size_t Terrain::tileBytes() const
+{
+  return GRID_VERTICES * GRID_VERTICES * sizeof(float);
+}
+
+void Terrain::buildIndices(int level, int edges,
+                           std::vector<unsigned int> &out)
+{
+  int step = 1 << level;
+  int cells = CHUNK_CELLS / step;
+  // on a stitched edge the odd vertices of this level are snapped onto the
+  // previous even one, which leaves only the vertices the coarser
+  // neighbour has along that edge
+  auto vertex = [&](int x, int z) -> unsigned int
+  {
+    if (((x == 0 && (edges & EDGE_MIN_X)) ||
+         (x == CHUNK_CELLS && (edges & EDGE_MAX_X))) && (z / step) % 2)
+      z -= step;
+    if (((z == 0 && (edges & EDGE_MIN_Z)) ||
+         (z == CHUNK_CELLS && (edges & EDGE_MAX_Z))) && (x / step) % 2)
+      x -= step;
+    return (unsigned int)(z * GRID_VERTICES + x);
+  };
+  auto triangle = [&](unsigned int a, unsigned int b, unsigned int c)
+  {
+    if (a == b || b == c || a == c)
+      return;
+    out.push_back(a);
+    out.push_back(b);
+    out.push_back(c);
+  };
+
+  for (int j = 0; j < cells; j++)
+  {
+    for (int i = 0; i < cells; i++)
+    {
+      unsigned int a = vertex(i * step, j * step);
+      unsigned int b = vertex((i + 1) * step, j * step);
+      unsigned int c = vertex(i * step, (j + 1) * step);
+      unsigned int d = vertex((i + 1) * step, (j + 1) * step);
+      // counter clockwise seen from above
+      triangle(a, d, b);
+      triangle(a, c, d);
+    }
+  }
+}
+
+void Terrain::update(const glm::vec3 &cameraPosition)
+{
+  float chunkSize = CHUNK_CELLS * cellSize;
+  glm::vec2 camera(cameraPosition.x, cameraPosition.z);
+  auto tileDistance = [&](int x, int z) -> float
+  {
+    glm::vec2 min = glm::vec2(x, z) * chunkSize;
+    glm::vec2 closest = glm::clamp(camera, min, min + glm::vec2(chunkSize));
+    return glm::length(camera - closest);
+  };
+
+  // drop what went out of range, with some slack so tiles on the border
+  // don't flip between loaded and dropped
+  evictionsLastFrame = 0;
+  for (size_t i = tiles.size(); i-- > 0;)
+  {
+    if (tileDistance(tiles[i].x, tiles[i].z) > viewDistance + chunkSize * 0.5f)
+    {
+      evictTile(i);
+      evictionsLastFrame++;
+    }
+  }
+
+  // missing tiles in range, nearest first
+  int centerX = (int)std::floor(camera.x / chunkSize);
+  int centerZ = (int)std::floor(camera.y / chunkSize);
+  int radius = (int)std::ceil(viewDistance / chunkSize);
+  std::vector<std::pair<float, glm::ivec2> > missing;
+  for (int z = centerZ - radius; z <= centerZ + radius; z++)
+  {
+    for (int x = centerX - radius; x <= centerX + radius; x++)
+    {
+      float distance = tileDistance(x, z);
+      if (distance <= viewDistance && findTile(x, z) == NULL)
+        missing.push_back(std::make_pair(distance, glm::ivec2(x, z)));
+    }
+  }
+  std::sort(missing.begin(), missing.end(),
+            [](const std::pair<float, glm::ivec2> &a,
+               const std::pair<float, glm::ivec2> &b)
+            { return a.first < b.first; });
+
+  // the budget may have shrunk, drop the farthest tiles until it fits
+  size_t maxTiles = std::max(memoryBudget / tileBytes(), (size_t)1);
+  while (tiles.size() > maxTiles)
+  {
+    size_t farthest = 0;
+    for (size_t i = 1; i < tiles.size(); i++)
+    {
+      if (tileDistance(tiles[i].x, tiles[i].z) >
+          tileDistance(tiles[farthest].x, tiles[farthest].z))
+        farthest = i;
+    }
+    evictTile(farthest);
+    evictionsLastFrame++;
+  }
+
+  std::vector<glm::ivec2> load;
+  for (size_t m = 0; m < missing.size() && (int)load.size() < maxLoadsPerFrame;
+       m++)
+  {
+    if (tiles.size() + load.size() >= maxTiles)
+    {
+      // over budget: make room only if a resident tile is farther away
+      size_t farthest = 0;
+      float farthestDistance = -1.0f;
+      for (size_t i = 0; i < tiles.size(); i++)
+      {
+        float distance = tileDistance(tiles[i].x, tiles[i].z);
+        if (distance > farthestDistance)
+        {
+          farthest = i;
+          farthestDistance = distance;
+        }
+      }
+      if (farthestDistance <= missing[m].first)
+        break;
+      evictTile(farthest);
+      evictionsLastFrame++;
+    }
+    load.push_back(missing[m].second);
+  }
+  loadTiles(load);
+  loadsLastFrame = (unsigned int)load.size();
+}
+
+void Terrain::loadTiles(const std::vector<glm::ivec2> &coordinates)
+{
+  if (coordinates.empty())
+    return;
+  std::vector<std::vector<float> > heights(coordinates.size());
+  std::vector<Tile> loaded(coordinates.size());
+
+  auto sampleTile = [&](size_t begin, size_t end)
+  {
+    for (size_t t = begin; t < end; t++)
+    {
+      Tile &tile = loaded[t];
+      std::vector<float> &h = heights[t];
+      tile.x = coordinates[t].x;
+      tile.z = coordinates[t].y;
+      h.resize(GRID_VERTICES * GRID_VERTICES);
+      float originX = tile.x * CHUNK_CELLS * cellSize;
+      float originZ = tile.z * CHUNK_CELLS * cellSize;
+      for (int z = 0; z < GRID_VERTICES; z++)
+        for (int x = 0; x < GRID_VERTICES; x++)
+          h[z * GRID_VERTICES + x] = heightFunction(originX + x * cellSize,
+                                                    originZ + z * cellSize);
+      tile.minHeight = *std::min_element(h.begin(), h.end());
+      tile.maxHeight = *std::max_element(h.begin(), h.end());
+
+      // error of a level: the largest distance between a full resolution
+      // height and the coarse surface above or below it, never smaller
+      // than the error of the finer level
+      tile.error[0] = 0.0f;
+      for (int l = 1; l < LOD_COUNT; l++)
+      {
+        int step = 1 << l;
+        float error = tile.error[l - 1];
+        for (int z = 0; z < GRID_VERTICES; z++)
+        {
+          for (int x = 0; x < GRID_VERTICES; x++)
+          {
+            int x0 = std::min(x / step * step, CHUNK_CELLS - step);
+            int z0 = std::min(z / step * step, CHUNK_CELLS - step);
+            float u = (float)(x - x0) / step, v = (float)(z - z0) / step;
+            float coarse = coarseHeight(
+                    h[z0 * GRID_VERTICES + x0],
+                    h[z0 * GRID_VERTICES + x0 + step],
+                    h[(z0 + step) * GRID_VERTICES + x0],
+                    h[(z0 + step) * GRID_VERTICES + x0 + step], u, v);
+            error = std::max(error, std::abs(h[z * GRID_VERTICES + x] -
+                                             coarse));
+          }
+        }
+        tile.error[l] = error;
+      }
+    }
+  };
+  parallelFor(jobs, coordinates.size(), 1, sampleTile);
+
+  // uploads have to happen on the thread owning the context
+  for (size_t t = 0; t < loaded.size(); t++)
+  {
+    Tile &tile = loaded[t];
+    glGenTextures(1, &tile.heightTexture);
+    glBindTexture(GL_TEXTURE_2D, tile.heightTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, GRID_VERTICES, GRID_VERTICES, 0,
+                 GL_RED, GL_FLOAT, heights[t].data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    tile.level = -1;
+    for (int l = 0; l < LOD_COUNT; l++)
+      levelError[l] = std::max(levelError[l], tile.error[l]);
+    tileLookup[key(tile.x, tile.z)] = tiles.size();
+    tiles.push_back(tile);
+  }
+}
+
+void Terrain::evictTile(size_t index)
+{
+  glDeleteTextures(1, &tiles[index].heightTexture);
+  tileLookup.erase(key(tiles[index].x, tiles[index].z));
+  if (index != tiles.size() - 1)
+  {
+    tiles[index] = tiles.back();
+    tileLookup[key(tiles[index].x, tiles[index].z)] = index;
+  }
+  tiles.pop_back();
+}
+
+const Terrain::Tile* Terrain::findTile(int x, int z) const
+{
+  std::unordered_map<long long, size_t>::const_iterator it =
+          tileLookup.find(key(x, z));
+  return it == tileLookup.end() ? NULL : &tiles[it->second];
+}
+
+void Terrain::render(const glm::mat4 &view, const glm::mat4 &projection,
+                     const glm::vec3 &cameraPosition, float fovy,
+                     float viewportHeight)
+{
+  // distance at which each level's error shrinks to pixelErrorTolerance
+  float projectionScale = viewportHeight / (2.0f * std::tan(fovy * 0.5f));
+  float switchDistance[LOD_COUNT + 1];
+  switchDistance[0] = 0.0f;
+  for (int l = 1; l < LOD_COUNT; l++)
+    switchDistance[l] = std::max(levelError[l] * projectionScale /
+                                 pixelErrorTolerance, switchDistance[l - 1]);
+  switchDistance[LOD_COUNT] = 1e30f;
+
+  // vertices of level l finish morphing into level l + 1 at its switch
+  // distance; the coarsest level never morphs
+  float morphRanges[LOD_COUNT * 2];
+  for (int l = 0; l < LOD_COUNT; l++)
+  {
+    float start = switchDistance[l], end = switchDistance[l + 1];
+    bool coarsest = l == LOD_COUNT - 1;
+    morphRanges[l * 2] = coarsest ? 1e30f : start + (end - start) * 0.6f;
+    morphRanges[l * 2 + 1] = coarsest ? 1e30f : end;
+  }
+
+  // cull and pick a level per chunk
+  Frustum frustum(projection * view);
+  float chunkSize = CHUNK_CELLS * cellSize;
+  std::vector<size_t> visible;
+  for (size_t i = 0; i < tiles.size(); i++)
+  {
+    Tile &tile = tiles[i];
+    AABB bounds;
+    bounds.min = glm::vec3(tile.x * chunkSize, tile.minHeight,
+                           tile.z * chunkSize);
+    bounds.max = glm::vec3((tile.x + 1) * chunkSize, tile.maxHeight,
+                           (tile.z + 1) * chunkSize);
+    tile.level = -1;
+    if (!frustum.intersects(bounds))
+      continue;
+    float distance = glm::length(cameraPosition -
+                                 glm::clamp(cameraPosition, bounds.min,
+                                            bounds.max));
+    int level = 0;
+    while (level + 1 < LOD_COUNT && switchDistance[level + 1] <= distance)
+      level++;
+    tile.level = level;
+    visible.push_back(i);
+  }
+
+  // neighbours may only differ by one level, refine the coarse side until
+  // that holds
+  const glm::ivec2 offsets[4] = {glm::ivec2(-1, 0), glm::ivec2(1, 0),
+                                 glm::ivec2(0, -1), glm::ivec2(0, 1)};
+  for (int pass = 0; pass < LOD_COUNT; pass++)
+  {
+    bool changed = false;
+    for (size_t v = 0; v < visible.size(); v++)
+    {
+      Tile &tile = tiles[visible[v]];
+      for (int n = 0; n < 4; n++)
+      {
+        const Tile* neighbour = findTile(tile.x + offsets[n].x,
+                                         tile.z + offsets[n].y);
+        if (neighbour != NULL && neighbour->level >= 0 &&
+            tile.level > neighbour->level + 1)
+        {
+          tile.level = neighbour->level + 1;
+          changed = true;
+        }
+      }
+    }
+    if (!changed)
+      break;
+  }
+
+  shader.use();
+  shader.setMat4("view", view);
+  shader.setMat4("projection", projection);
+  shader.setVec3("cameraPosition", cameraPosition);
+  shader.setFloat("cellSize", cellSize);
+  shader.setInt("heightMap", 0);
+  glUniform2fv(glGetUniformLocation(shader.ID, "morphRanges"), LOD_COUNT,
+               morphRanges);
+  int levelLocation = glGetUniformLocation(shader.ID, "level");
+  int edgeLocation = glGetUniformLocation(shader.ID, "edgeLevels");
+  int originLocation = glGetUniformLocation(shader.ID, "chunkOrigin");
+
+  glActiveTexture(GL_TEXTURE0);
+  glBindVertexArray(VAO);
+  drawnChunks = 0;
+  drawnTriangles = 0;
+  for (size_t v = 0; v < visible.size(); v++)
+  {
+    const Tile &tile = tiles[visible[v]];
+    int edges = 0;
+    int edgeLevels[4];
+    const int edgeBits[4] = {EDGE_MIN_X, EDGE_MAX_X, EDGE_MIN_Z, EDGE_MAX_Z};
+    for (int n = 0; n < 4; n++)
+    {
+      const Tile* neighbour = findTile(tile.x + offsets[n].x,
+                                       tile.z + offsets[n].y);
+      edgeLevels[n] = tile.level;
+      if (neighbour != NULL && neighbour->level > tile.level)
+      {
+        edges |= edgeBits[n];
+        edgeLevels[n] = neighbour->level;
+      }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, tile.heightTexture);
+    glUniform1i(levelLocation, tile.level);
+    glUniform4iv(edgeLocation, 1, edgeLevels);
+    glUniform2f(originLocation, tile.x * chunkSize, tile.z * chunkSize);
+    const IndexRange &range = ranges[tile.level][edges];
+    glDrawElements(GL_TRIANGLES, range.count, GL_UNSIGNED_INT,
+                   (void*)(range.offset * sizeof(unsigned int)));
+    drawnChunks++;
+    drawnTriangles += range.count / 3;
+  }
+  glBindVertexArray(0);
+}
+
+size_t Terrain::getResidentTiles() const
+{
+  return tiles.size();
+}
+
+size_t Terrain::getResidentBytes() const
+{
+  return tiles.size() * tileBytes();
+}
+
+unsigned int Terrain::getDrawnChunks() const
+{
+  return drawnChunks;
+}
+
+unsigned int Terrain::getDrawnTriangles() const
+{
+  return drawnTriangles;
+}
+
+void Terrain::printStats() const
+{
+  std::cout << "terrain: " << tiles.size() << " tiles resident ("
+            << getResidentBytes() / 1024 << " KiB of "
+            << memoryBudget / 1024 << " KiB), " << loadsLastFrame
+            << " loaded, " << evictionsLastFrame << " dropped, "
+            << drawnChunks << " chunks / " << drawnTriangles
+            << " triangles drawn" << std::endl;
+}
@@ -0,0 +1,143 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_TERRAIN_H
+#define COORDINATESPACE_TERRAIN_H
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "frustum.h"
+#include "jobsystem.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Terrain
+ *  A large heightfield is cut into square tiles of CHUNK_CELLS x CHUNK_CELLS
+ *  cells. Every tile is one chunk: its heights live in a small float
+ *  texture and it's drawn with a grid mesh that is the same for all chunks,
+ *  the vertex shader reads the height for each grid vertex. So there is a
+ *  single vertex buffer holding the grid coordinates and per level of
+ *  detail a set of index buffers, shared by every chunk.
+ *
+ *  Level l uses every 2^l-th grid vertex. A chunk picks its level from the
+ *  screen-space error: dropping to level l moves the surface by at most
+ *  error(l) world units (measured when the tile is loaded), which covers
+ *  error(l) * projectionScale / distance pixels on screen, with
+ *  projectionScale = viewportHeight / (2 tan(fovy / 2)) from the camera's
+ *  glm::perspective. The coarsest level that stays under
+ *  pixelErrorTolerance wins, which turns into one switch distance per
+ *  level.
+ *
+ *  To hide the switch, vertices geomorph: towards the switch distance every
+ *  odd vertex of a level slides onto its even neighbour, so by the time the
+ *  chunk switches to the next level it already has that level's shape.
+ *
+ *  Neighbouring chunks may differ by one level (more is prevented by
+ *  refining the coarser one). Along an edge next to a coarser chunk the
+ *  finer one uses an index buffer variant that skips the odd edge vertices
+ *  (stitching) and morphs that edge like its neighbour, so no cracks open
+ *  up between them. Each level has 16 variants, one per combination of
+ *  stitched edges.
+ *
+ *  Tiles are streamed: tiles within viewDistance of the camera are loaded
+ *  nearest first, at most maxLoadsPerFrame per frame, tiles beyond
+ *  viewDistance (plus some slack) are dropped, and the farthest ones are
+ *  dropped as well when the resident tiles would exceed memoryBudget. The
+ *  work per frame depends on the view distance and budget, not on how large
+ *  the whole map is.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class Terrain
+{
+public:
+  typedef std::function<float(float x, float z)> HeightFunction;
+
+  static const int CHUNK_CELLS = 64;
+  static const int LOD_COUNT = 6;
+
+  float pixelErrorTolerance;
+  float viewDistance;
+  // bytes of height data allowed to be resident
+  size_t memoryBudget;
+  int maxLoadsPerFrame;
+
+  // heights are sampled from heightFunction at cellSize spacing; jobs (may
+  // be NULL) is used to sample the tiles loaded in a frame in parallel
+  Terrain(HeightFunction heightFunction, float cellSize, JobSystem* jobs);
+  ~Terrain();
+  Terrain(const Terrain &) = delete;
+  Terrain &operator=(const Terrain &) = delete;
+
+  // stream tiles in and out around the camera
+  void update(const glm::vec3 &cameraPosition);
+  void render(const glm::mat4 &view, const glm::mat4 &projection,
+              const glm::vec3 &cameraPosition, float fovy,
+              float viewportHeight);
+
+  size_t getResidentTiles() const;
+  size_t getResidentBytes() const;
+  unsigned int getDrawnChunks() const;
+  unsigned int getDrawnTriangles() const;
+  void printStats() const;
+
+private:
+  enum
+  {
+    EDGE_MIN_X = 1,
+    EDGE_MAX_X = 2,
+    EDGE_MIN_Z = 4,
+    EDGE_MAX_Z = 8,
+    EDGE_VARIANTS = 16
+  };
+
+  struct Tile
+  {
+    int x, z;
+    unsigned int heightTexture;
+    float minHeight, maxHeight;
+    // max height deviation when drawn at each level
+    float error[LOD_COUNT];
+    // level chosen for the current frame, -1 when not drawn
+    int level;
+  };
+
+  struct IndexRange
+  {
+    unsigned int offset;
+    unsigned int count;
+  };
+
+  HeightFunction heightFunction;
+  float cellSize;
+  JobSystem* jobs;
+  Shader shader;
+  unsigned int VAO;
+  unsigned int gridVBO;
+  unsigned int EBO;
+  IndexRange ranges[LOD_COUNT][EDGE_VARIANTS];
+
+  std::vector<Tile> tiles;
+  std::unordered_map<long long, size_t> tileLookup;
+  // largest error seen per level, kept monotonic so levels don't pop when
+  // tiles come and go
+  float levelError[LOD_COUNT];
+
+  unsigned int drawnChunks;
+  unsigned int drawnTriangles;
+  unsigned int loadsLastFrame;
+  unsigned int evictionsLastFrame;
+
+  static long long key(int x, int z);
+  size_t tileBytes() const;
+  void buildIndices(int level, int edges, std::vector<unsigned int> &out);
+  void loadTiles(const std::vector<glm::ivec2> &coordinates);
+  void evictTile(size_t index);
+  const Tile* findTile(int x, int z) const;
+};
+#endif //COORDINATESPACE_TERRAIN_H
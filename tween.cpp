@@ -0,0 +1,265 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "tween.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <glm/glm.hpp>
+#include <glm/gtx/easing.hpp>
+
+namespace
+{
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+
+  // the glm/gtx/easing.inl formulas, 8 at once; the piecewise ones
+  // compute every piece and select
+  float8 ease(TweenEngine::Easing easing, float8 a)
+  {
+    const float8 one(1.0f), two(2.0f), half(0.5f);
+    switch (easing)
+    {
+      case TweenEngine::QUADRATIC_IN:
+        return a * a;
+      case TweenEngine::QUADRATIC_OUT:
+        return a * (two - a);
+      case TweenEngine::QUADRATIC_IN_OUT:
+        return select(a < half, two * a * a,
+                      float8(4.0f) * a - two * a * a - one);
+      case TweenEngine::CUBIC_IN:
+        return a * a * a;
+      case TweenEngine::CUBIC_OUT:
+      {
+        float8 f = a - one;
+        return fmadd(f * f, f, one);
+      }
+      case TweenEngine::CUBIC_IN_OUT:
+      {
+        float8 f = two * a - two;
+        return select(a < half, float8(4.0f) * a * a * a,
+                      fmadd(half * f * f, f, one));
+      }
+      case TweenEngine::SINE_IN_OUT:
+      {
+        float8 s, c;
+        sincos(a * float8(3.14159265f), s, c);
+        return half * (one - c);
+      }
+      case TweenEngine::BACK_OUT:
+      {
+        const float8 o(1.70158f);
+        float8 n = a - one;
+        return fmadd(n * n, fmadd(o + one, n, o), one);
+      }
+      case TweenEngine::BOUNCE_OUT:
+      {
+        float8 a2 = a * a;
+        float8 first = float8(121.0f / 16.0f) * a2;
+        float8 second = float8(363.0f / 40.0f) * a2 -
+                        float8(99.0f / 10.0f) * a + float8(17.0f / 5.0f);
+        float8 third = float8(4356.0f / 361.0f) * a2 -
+                       float8(35442.0f / 1805.0f) * a +
+                       float8(16061.0f / 1805.0f);
+        float8 fourth = float8(54.0f / 5.0f) * a2 -
+                        float8(513.0f / 25.0f) * a + float8(268.0f / 25.0f);
+        return select(a < float8(4.0f / 11.0f), first,
+                      select(a < float8(8.0f / 11.0f), second,
+                             select(a < float8(9.0f / 10.0f), third,
+                                    fourth)));
+      }
+      case TweenEngine::EXPONENTIAL_IN:
+        return select(a > float8(0.0f),
+                      exp2(float8(10.0f) * a - float8(10.0f)), a);
+      case TweenEngine::EXPONENTIAL_OUT:
+        return select(a < one, one - exp2(float8(-10.0f) * a), a);
+      case TweenEngine::EXPONENTIAL_IN_OUT:
+      {
+        float8 in = half * exp2(float8(20.0f) * a - float8(10.0f));
+        float8 out = one - half * exp2(float8(10.0f) - float8(20.0f) * a);
+        return select(a < half, in, out);
+      }
+      case TweenEngine::ELASTIC_OUT:
+      {
+        // sin(-13 pi / 2 (a + 1)) 2^(-10 a) + 1
+        float8 s, c;
+        sincos(float8(-20.4203522f) * (a + one), s, c);
+        return fmadd(s, exp2(float8(-10.0f) * a), one);
+      }
+      default:
+        return a;
+    }
+  }
+
+  float easeScalar(TweenEngine::Easing easing, float a)
+  {
+    switch (easing)
+    {
+      case TweenEngine::QUADRATIC_IN:
+        return glm::quadraticEaseIn(a);
+      case TweenEngine::QUADRATIC_OUT:
+        return glm::quadraticEaseOut(a);
+      case TweenEngine::QUADRATIC_IN_OUT:
+        return glm::quadraticEaseInOut(a);
+      case TweenEngine::CUBIC_IN:
+        return glm::cubicEaseIn(a);
+      case TweenEngine::CUBIC_OUT:
+        return glm::cubicEaseOut(a);
+      case TweenEngine::CUBIC_IN_OUT:
+        return glm::cubicEaseInOut(a);
+      case TweenEngine::SINE_IN_OUT:
+        return glm::sineEaseInOut(a);
+      case TweenEngine::BACK_OUT:
+        return glm::backEaseOut(a);
+      case TweenEngine::BOUNCE_OUT:
+        return glm::bounceEaseOut(a);
+      case TweenEngine::EXPONENTIAL_IN:
+        return glm::exponentialEaseIn(a);
+      case TweenEngine::EXPONENTIAL_OUT:
+        return glm::exponentialEaseOut(a);
+      case TweenEngine::EXPONENTIAL_IN_OUT:
+        return glm::exponentialEaseInOut(a);
+      case TweenEngine::ELASTIC_OUT:
+        return glm::elasticEaseOut(a);
+      default:
+        return glm::linearInterpolation(a);
+    }
+  }
+}
+
+TweenEngine::TweenEngine()
+  : simd(true), finished(0), lastMilliseconds(0.0)
+{
+  for (Group &group : groups)
+    group.count = 0;
+}
+
+void TweenEngine::add(Easing easing, float* target, float from, float to,
+                      float duration)
+{
+  if (easing < 0 || easing >= EASING_COUNT || target == nullptr)
+    return;
+  Group &group = groups[easing];
+  if (group.count == group.elapsed.size())
+  {
+    // grow by a whole float8, the padding lanes never finish or write
+    size_t size = group.elapsed.size() + 8;
+    group.elapsed.resize(size, 0.0f);
+    group.inverseDuration.resize(size, 0.0f);
+    group.from.resize(size, 0.0f);
+    group.to.resize(size, 0.0f);
+    group.targets.resize(size, nullptr);
+  }
+  unsigned int i = group.count++;
+  group.elapsed[i] = 0.0f;
+  // a zero duration jumps to the end on the next update
+  group.inverseDuration[i] = duration > 0.0f ? 1.0f / duration : 1e30f;
+  group.from[i] = from;
+  group.to[i] = to;
+  group.targets[i] = target;
+}
+
+bool TweenEngine::updateSimd(Easing easing, Group &group, float deltaTime)
+{
+  const float8 step(deltaTime), one(1.0f);
+  bool anyFinished = false;
+  for (unsigned int i = 0; i < group.count; i += 8)
+  {
+    float8 elapsed = float8::load(&group.elapsed[i]) + step;
+    elapsed.store(&group.elapsed[i]);
+    float8 progress = min(elapsed * float8::load(&group.inverseDuration[i]),
+                          one);
+    float8 from = float8::load(&group.from[i]);
+    float8 to = float8::load(&group.to[i]);
+    float values[8];
+    fmadd(to - from, ease(easing, progress), from).store(values);
+    unsigned int lanes = std::min(group.count - i, 8u);
+    float* const* targets = &group.targets[i];
+    for (unsigned int j = 0; j < lanes; j++)
+      *targets[j] = values[j];
+    anyFinished = anyFinished ||
+                  (moveMask(progress >= one) & ((1 << lanes) - 1)) != 0;
+  }
+  return anyFinished;
+}
+
+bool TweenEngine::updateScalar(Easing easing, Group &group, float deltaTime)
+{
+  bool anyFinished = false;
+  for (unsigned int i = 0; i < group.count; i++)
+  {
+    group.elapsed[i] += deltaTime;
+    float progress = std::min(group.elapsed[i] * group.inverseDuration[i],
+                              1.0f);
+    *group.targets[i] = group.from[i] + (group.to[i] - group.from[i]) *
+                                        easeScalar(easing, progress);
+    anyFinished = anyFinished || progress >= 1.0f;
+  }
+  return anyFinished;
+}
+
+void TweenEngine::compact(Group &group)
+{
+  // keep the running tweens in order, the same test as the update
+  unsigned int kept = 0;
+  for (unsigned int i = 0; i < group.count; i++)
+  {
+    if (group.elapsed[i] * group.inverseDuration[i] >= 1.0f)
+      continue;
+    group.elapsed[kept] = group.elapsed[i];
+    group.inverseDuration[kept] = group.inverseDuration[i];
+    group.from[kept] = group.from[i];
+    group.to[kept] = group.to[i];
+    group.targets[kept] = group.targets[i];
+    kept++;
+  }
+  finished += group.count - kept;
+  group.count = kept;
+}
+
+void TweenEngine::update(float deltaTime)
+{
+  double start = now();
+  finished = 0;
+  for (int easing = 0; easing < EASING_COUNT; easing++)
+  {
+    Group &group = groups[easing];
+    bool anyFinished = simd
+                       ? updateSimd((Easing)easing, group, deltaTime)
+                       : updateScalar((Easing)easing, group, deltaTime);
+    if (anyFinished)
+      compact(group);
+  }
+  lastMilliseconds = now() - start;
+}
+
+void TweenEngine::clear()
+{
+  for (Group &group : groups)
+    group.count = 0;
+}
+
+unsigned int TweenEngine::activeCount() const
+{
+  unsigned int count = 0;
+  for (const Group &group : groups)
+    count += group.count;
+  return count;
+}
+
+unsigned int TweenEngine::finishedLastUpdate() const
+{
+  return finished;
+}
+
+double TweenEngine::cpuMilliseconds() const
+{
+  return lastMilliseconds;
+}
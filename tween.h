@@ -0,0 +1,99 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_TWEEN_H
+#define COORDINATESPACE_TWEEN_H
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Batched tweens
+ *  A tween moves one float (a position, an alpha, a scale) from one value
+ *  to another over a duration, shaped by an easing function like the ones
+ *  in glm/gtx/easing.hpp. A UI with thousands of animated properties
+ *  usually keeps a list of tween objects and, for each one, switches on its
+ *  easing type, calls the scalar easing function and writes the result.
+ *
+ *  The TweenEngine keeps one group per easing type instead, each structure
+ *  of arrays (elapsed time, 1 / duration, from, to, target). An update runs
+ *  through every group with float8: advance the time, clamp the progress
+ *  to 1, ease, lerp, and write the 8 results straight to the floats the
+ *  tweens animate (the component fields themselves, no copying back
+ *  afterwards). The easing function is picked once per group, not per
+ *  tween.
+ *
+ *  A tween that reached its end writes its final value and is removed in
+ *  the same update: if a group had any finished lanes its arrays are
+ *  compacted in one pass, so the next update only visits running tweens.
+ *
+ *  The float8 easing functions follow the glm formulas: polynomials, a
+ *  cosine, and for exponential and elastic easing simd.h's exp2 (and
+ *  sincos for the elastic oscillation). With simd off every tween goes
+ *  through the glm function, the way it would be done one tween at a time.
+ *
+ *  A target must stay valid while its tween runs; targets in a std::vector
+ *  that reallocates have to be cleared first.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class TweenEngine
+{
+public:
+  enum Easing
+  {
+    LINEAR,
+    QUADRATIC_IN,
+    QUADRATIC_OUT,
+    QUADRATIC_IN_OUT,
+    CUBIC_IN,
+    CUBIC_OUT,
+    CUBIC_IN_OUT,
+    SINE_IN_OUT,
+    BACK_OUT,
+    BOUNCE_OUT,
+    EXPONENTIAL_IN,
+    EXPONENTIAL_OUT,
+    EXPONENTIAL_IN_OUT,
+    ELASTIC_OUT,
+    EASING_COUNT
+  };
+
+  bool simd;
+
+  TweenEngine();
+
+  // animate *target from from to to over duration seconds
+  void add(Easing easing, float* target, float from, float to,
+           float duration);
+  // advance every tween, write the values and drop the finished ones
+  void update(float deltaTime);
+  void clear();
+
+  unsigned int activeCount() const;
+  unsigned int finishedLastUpdate() const;
+  // CPU time of the last update()
+  double cpuMilliseconds() const;
+
+private:
+  // one easing type, the arrays padded to a multiple of 8
+  struct Group
+  {
+    unsigned int count;
+    std::vector<float> elapsed;
+    std::vector<float> inverseDuration;
+    std::vector<float> from;
+    std::vector<float> to;
+    std::vector<float*> targets;
+  };
+
+  Group groups[EASING_COUNT];
+  unsigned int finished;
+  double lastMilliseconds;
+
+  bool updateSimd(Easing easing, Group &group, float deltaTime);
+  bool updateScalar(Easing easing, Group &group, float deltaTime);
+  void compact(Group &group);
+};
+#endif //COORDINATESPACE_TWEEN_H
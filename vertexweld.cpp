@@ -0,0 +1,300 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "vertexweld.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <unordered_map>
+#include <glm/gtx/hash.hpp>
+
+namespace
+{
+  // input vertices per chunk of the parallel passes, fixed like the
+  // partition count
+  const size_t WELD_CHUNK = 65536;
+  const uint64_t EMPTY_SLOT = ~(uint64_t)0;
+  // the top 10 bits of a hash pick one of the 1024 partitions
+  const int PARTITION_SHIFT = 22;
+
+  double now()
+  {
+    using namespace std::chrono;
+    return duration<double, std::milli>(
+            steady_clock::now().time_since_epoch()).count();
+  }
+
+  // the key of the unordered_map, compared by value
+  struct MapKey
+  {
+    MeshVertex vertex;
+
+    bool operator==(const MapKey &other) const
+    {
+      return vertex.position == other.vertex.position &&
+             vertex.normal == other.vertex.normal &&
+             vertex.uv == other.vertex.uv;
+    }
+  };
+
+  struct MapKeyHash
+  {
+    size_t operator()(const MapKey &key) const
+    {
+      size_t seed = std::hash<glm::vec3>()(key.vertex.position);
+      size_t h = std::hash<glm::vec3>()(key.vertex.normal);
+      seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      h = std::hash<glm::vec2>()(key.vertex.uv);
+      seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      return seed;
+    }
+  };
+
+  // the multiple of epsilon the flat key rounds to, as a float
+  void snap(float* values, int count, float inverse)
+  {
+    for (int i = 0; i < count; i++)
+      values[i] = (float)std::lrint(values[i] * inverse);
+  }
+
+  // packKey reads a vertex as 8 consecutive floats starting at position
+  static_assert(sizeof(MeshVertex) == 8 * sizeof(float),
+                "MeshVertex must be 8 tightly packed floats for packKey");
+  static_assert(offsetof(MeshVertex, position) == 0,
+                "MeshVertex must start with its position for packKey");
+
+  // the words a vertex is compared and hashed by: the bits of its floats,
+  // or with an epsilon the multiples of it they round to
+  inline void packKey(const MeshVertex &vertex, float inverseEpsilon,
+                      uint32_t key[8])
+  {
+    const float* values = &vertex.position.x;
+    if (inverseEpsilon > 0.0f)
+      for (int i = 0; i < 8; i++)
+        key[i] = (uint32_t)(int32_t)std::lrint(values[i] * inverseEpsilon);
+    else
+      for (int i = 0; i < 8; i++)
+      {
+        // + 0 turns -0 into 0
+        float value = values[i] + 0.0f;
+        std::memcpy(&key[i], &value, sizeof(uint32_t));
+      }
+  }
+
+  inline uint32_t hashKey(const uint32_t key[8])
+  {
+    // two independent chains of 64 bit words, half the multiply latency
+    uint64_t words[4];
+    std::memcpy(words, key, sizeof(words));
+    uint64_t a = (words[0] ^ 0x243f6a8885a308d3ull) * 0x9e3779b97f4a7c15ull;
+    uint64_t b = (words[1] ^ 0x13198a2e03707344ull) * 0xc2b2ae3d27d4eb4full;
+    a = (a ^ (a >> 29) ^ words[2]) * 0x9e3779b97f4a7c15ull;
+    b = (b ^ (b >> 29) ^ words[3]) * 0xc2b2ae3d27d4eb4full;
+    uint64_t h = (a ^ (b >> 31) ^ (b << 33)) * 0x9e3779b97f4a7c15ull;
+    return (uint32_t)(h >> 32);
+  }
+}
+
+VertexWelder::VertexWelder()
+  : flatTable(true), epsilon(0.0f), lastMilliseconds(0.0)
+{
+  std::memset(partitionStart, 0, sizeof(partitionStart));
+}
+
+void VertexWelder::weld(const std::vector<MeshVertex> &vertices,
+                        std::vector<MeshVertex> &unique,
+                        std::vector<unsigned int> &indices, JobSystem* jobs)
+{
+  double start = now();
+  if (flatTable)
+    weldFlat(vertices, unique, indices, jobs);
+  else
+    weldMap(vertices, unique, indices);
+  lastMilliseconds = now() - start;
+}
+
+void VertexWelder::weldFlat(const std::vector<MeshVertex> &vertices,
+                            std::vector<MeshVertex> &unique,
+                            std::vector<unsigned int> &indices,
+                            JobSystem* jobs)
+{
+  size_t count = vertices.size();
+  size_t chunks = (count + WELD_CHUNK - 1) / WELD_CHUNK;
+  hashes.resize(count);
+  keys.resize(count);
+  order.resize(count);
+  representative.resize(count);
+  chunkOffsets.assign(chunks * PARTITIONS, 0);
+  chunkUnique.resize(chunks);
+  float inverseEpsilon = epsilon > 0.0f ? 1.0f / epsilon : 0.0f;
+
+  // count the partitions of every chunk
+  parallelFor(jobs, chunks, 1, [&](size_t begin, size_t end)
+  {
+    for (size_t chunk = begin; chunk < end; chunk++)
+    {
+      unsigned int* counts = &chunkOffsets[chunk * PARTITIONS];
+      size_t last = std::min(count, (chunk + 1) * WELD_CHUNK);
+      for (size_t i = chunk * WELD_CHUNK; i < last; i++)
+      {
+        Key key;
+        packKey(vertices[i], inverseEpsilon, key.words);
+        hashes[i] = hashKey(key.words);
+        counts[hashes[i] >> PARTITION_SHIFT]++;
+      }
+    }
+  });
+  // partition by partition, chunk by chunk: every chunk's counts turn into
+  // where its vertices of that partition start
+  unsigned int offset = 0;
+  for (unsigned int partition = 0; partition < PARTITIONS; partition++)
+  {
+    partitionStart[partition] = offset;
+    for (size_t chunk = 0; chunk < chunks; chunk++)
+    {
+      unsigned int &slot = chunkOffsets[chunk * PARTITIONS + partition];
+      unsigned int chunkCount = slot;
+      slot = offset;
+      offset += chunkCount;
+    }
+  }
+  partitionStart[PARTITIONS] = offset;
+  // the keys move along, a partition's keys and table then fit the cache
+  // where the vertices are scattered over the whole input
+  parallelFor(jobs, chunks, 1, [&](size_t begin, size_t end)
+  {
+    for (size_t chunk = begin; chunk < end; chunk++)
+    {
+      unsigned int* offsets = &chunkOffsets[chunk * PARTITIONS];
+      size_t last = std::min(count, (chunk + 1) * WELD_CHUNK);
+      for (size_t i = chunk * WELD_CHUNK; i < last; i++)
+      {
+        unsigned int position = offsets[hashes[i] >> PARTITION_SHIFT]++;
+        packKey(vertices[i], inverseEpsilon, keys[position].words);
+        order[position] = (unsigned int)i;
+      }
+    }
+  });
+
+  // a table of at least twice the partition's size, the low bits of the
+  // hash pick the slot (the top bits are the partition)
+  std::vector<size_t> tableStart(PARTITIONS + 1, 0);
+  std::vector<uint32_t> tableMask(PARTITIONS);
+  for (unsigned int partition = 0; partition < PARTITIONS; partition++)
+  {
+    size_t size = 16;
+    while (size < 2 * (size_t)(partitionStart[partition + 1] -
+                               partitionStart[partition]))
+      size *= 2;
+    tableMask[partition] = (uint32_t)size - 1;
+    tableStart[partition + 1] = tableStart[partition] + size;
+  }
+  slots.resize(tableStart[PARTITIONS]);
+  parallelFor(jobs, PARTITIONS, 1, [&](size_t begin, size_t end)
+  {
+    for (size_t partition = begin; partition < end; partition++)
+    {
+      uint64_t* table = &slots[tableStart[partition]];
+      uint32_t mask = tableMask[partition];
+      std::fill(table, table + mask + 1, EMPTY_SLOT);
+      for (unsigned int position = partitionStart[partition];
+           position < partitionStart[partition + 1]; position++)
+      {
+        const Key &key = keys[position];
+        uint32_t h = hashKey(key.words);
+        for (uint32_t probe = h & mask;; probe = (probe + 1) & mask)
+        {
+          uint64_t slot = table[probe];
+          if (slot == EMPTY_SLOT)
+          {
+            table[probe] = (uint64_t)h << 32 | position;
+            representative[order[position]] = order[position];
+            break;
+          }
+          unsigned int other = (unsigned int)slot;
+          if ((uint32_t)(slot >> 32) == h &&
+              std::memcmp(key.words, keys[other].words, sizeof(Key)) == 0)
+          {
+            representative[order[position]] = order[other];
+            break;
+          }
+        }
+      }
+    }
+  });
+
+  // number the first appearances in input order: count per chunk, a
+  // prefix sum, then every chunk numbers its own
+  parallelFor(jobs, chunks, 1, [this, count](size_t begin, size_t end)
+  {
+    for (size_t chunk = begin; chunk < end; chunk++)
+    {
+      unsigned int firsts = 0;
+      size_t last = std::min(count, (chunk + 1) * WELD_CHUNK);
+      for (size_t i = chunk * WELD_CHUNK; i < last; i++)
+        firsts += representative[i] == i;
+      chunkUnique[chunk] = firsts;
+    }
+  });
+  unsigned int uniqueCount = 0;
+  for (size_t chunk = 0; chunk < chunks; chunk++)
+  {
+    unsigned int firsts = chunkUnique[chunk];
+    chunkUnique[chunk] = uniqueCount;
+    uniqueCount += firsts;
+  }
+  unique.resize(uniqueCount);
+  indices.resize(count);
+  parallelFor(jobs, chunks, 1, [&](size_t begin, size_t end)
+  {
+    for (size_t chunk = begin; chunk < end; chunk++)
+    {
+      unsigned int next = chunkUnique[chunk];
+      size_t last = std::min(count, (chunk + 1) * WELD_CHUNK);
+      for (size_t i = chunk * WELD_CHUNK; i < last; i++)
+        if (representative[i] == i)
+        {
+          unique[next] = vertices[i];
+          indices[i] = next++;
+        }
+    }
+  });
+  // a representative comes first in the input, its number is set by now
+  parallelFor(jobs, chunks, 1, [&](size_t begin, size_t end)
+  {
+    size_t last = std::min(count, end * WELD_CHUNK);
+    for (size_t i = begin * WELD_CHUNK; i < last; i++)
+      if (representative[i] != i)
+        indices[i] = indices[representative[i]];
+  });
+}
+
+void VertexWelder::weldMap(const std::vector<MeshVertex> &vertices,
+                           std::vector<MeshVertex> &unique,
+                           std::vector<unsigned int> &indices)
+{
+  std::unordered_map<MapKey, unsigned int, MapKeyHash> map;
+  unique.clear();
+  indices.resize(vertices.size());
+  for (size_t i = 0; i < vertices.size(); i++)
+  {
+    MapKey key = {vertices[i]};
+    if (epsilon > 0.0f)
+      snap(&key.vertex.position.x, 8, 1.0f / epsilon);
+    auto inserted = map.insert(std::make_pair(key,
+                                              (unsigned int)unique.size()));
+    if (inserted.second)
+      unique.push_back(vertices[i]);
+    indices[i] = inserted.first->second;
+  }
+}
+
+double VertexWelder::milliseconds() const
+{
+  return lastMilliseconds;
+}
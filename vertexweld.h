@@ -0,0 +1,106 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_VERTEXWELD_H
+#define COORDINATESPACE_VERTEXWELD_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "jobsystem.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Vertex welding
+ *  OBJ style files index positions, normals and texture coordinates
+ *  separately, so an importer first writes out one full vertex per
+ *  triangle corner, about six copies of every vertex of a closed mesh.
+ *  Welding finds the identical ones again and turns the stream into a
+ *  vertex and an index buffer. The usual code is a std::unordered_map from
+ *  the vertex (hashed with glm/gtx/hash.hpp) to its index: one allocation
+ *  per unique vertex and a pointer chase on every lookup.
+ *
+ *  The VertexWelder instead packs every vertex into a key of 8 words and
+ *  hashes that once, then:
+ *    1. splits the vertices into PARTITIONS by the top bits of the hash
+ *       (a counting sort, in parallel over chunks of the input that keep
+ *       their order),
+ *    2. welds every partition on its own, in parallel: an open addressing
+ *       table of (hash, vertex) pairs, linear probing, the first vertex
+ *       with a key becomes its representative,
+ *    3. numbers the representatives in input order (a prefix sum over
+ *       chunks) and points every vertex at its representative's number.
+ *  Identical vertices always land in the same partition, so no two
+ *  threads ever look for the same key. The output is the same as the
+ *  unordered_map gives: unique vertices in order of first appearance,
+ *  whatever the thread count.
+ *
+ *  With epsilon 0 the key is the bits of the 8 floats (-0 taken as 0):
+ *  only exactly equal vertices weld. Above 0 every attribute is rounded to
+ *  a multiple of epsilon for the key, so vertices that differ by float
+ *  noise (a seam written twice, transformed twice) weld too; the first
+ *  one's values are kept. Two values on either side of a rounding edge
+ *  stay apart even when they're closer than epsilon, snapping can't see
+ *  across the grid.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+struct MeshVertex
+{
+  glm::vec3 position;
+  glm::vec3 normal;
+  glm::vec2 uv;
+};
+
+class VertexWelder
+{
+public:
+  // fixed so the partitioning doesn't depend on the thread count
+  static const unsigned int PARTITIONS = 1024;
+
+  // the flat tables; off welds with a std::unordered_map, one thread
+  bool flatTable;
+  // 0 welds identical vertices only, see above
+  float epsilon;
+
+  VertexWelder();
+
+  // unique gets every distinct vertex in order of first appearance,
+  // indices one entry per input vertex
+  void weld(const std::vector<MeshVertex> &vertices,
+            std::vector<MeshVertex> &unique,
+            std::vector<unsigned int> &indices, JobSystem* jobs = nullptr);
+
+  // CPU time of the last weld()
+  double milliseconds() const;
+
+private:
+  struct Key
+  {
+    uint32_t words[8];
+  };
+
+  std::vector<uint32_t> hashes;
+  // the keys and vertex indices sorted by partition, input order within
+  // one
+  std::vector<Key> keys;
+  std::vector<unsigned int> order;
+  std::vector<unsigned int> chunkOffsets;
+  unsigned int partitionStart[PARTITIONS + 1];
+  // the slots of all partitions' tables, (hash, vertex) packed in 64 bits
+  std::vector<uint64_t> slots;
+  // the first vertex with the same key, itself for a first appearance
+  std::vector<unsigned int> representative;
+  std::vector<unsigned int> chunkUnique;
+  double lastMilliseconds;
+
+  void weldFlat(const std::vector<MeshVertex> &vertices,
+                std::vector<MeshVertex> &unique,
+                std::vector<unsigned int> &indices, JobSystem* jobs);
+  void weldMap(const std::vector<MeshVertex> &vertices,
+               std::vector<MeshVertex> &unique,
+               std::vector<unsigned int> &indices);
+};
+#endif //COORDINATESPACE_VERTEXWELD_H
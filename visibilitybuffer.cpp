@@ -0,0 +1,342 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#include <glad/glad.h>
+#include "visibilitybuffer.h"
+#include "frustum.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+namespace
+{
+  void createBufferTexture(unsigned int &buffer, unsigned int &texture,
+                           GLenum format)
+  {
+    glGenBuffers(1, &buffer);
+    glGenTextures(1, &texture);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_STATIC_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+  }
+
+  void deleteBufferTexture(unsigned int &buffer, unsigned int &texture)
+  {
+    glDeleteTextures(1, &texture);
+    glDeleteBuffers(1, &buffer);
+  }
+
+  void fillBuffer(unsigned int buffer, const void* data, size_t bytes,
+                  GLenum usage)
+  {
+    // orphan and refill, a buffer texture follows its buffer through
+    // reallocations
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, std::max(bytes, (size_t)16), NULL, usage);
+    if (bytes > 0)
+      glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, data);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+  }
+}
+
+VisibilityBufferRenderer::VisibilityBufferRenderer(int width, int height)
+  : width(std::max(width, 1)), height(std::max(height, 1)), maxTriangles(0),
+    idTriangleBits(0),
+    visibilityShader("shaders/visibilityvs.txt", "shaders/visibilityfs.txt"),
+    shadingShader("shaders/upscalevs.txt", "shaders/visibilityshadefs.txt"),
+    draws(0)
+{
+  createBufferTexture(positionBuffer, positionTexture, GL_RGBA32F);
+  createBufferTexture(normalBuffer, normalTexture, GL_RGBA32F);
+  createBufferTexture(indexBuffer, indexTexture, GL_R32UI);
+  createBufferTexture(modelBuffer, modelTexture, GL_RGBA32F);
+  createBufferTexture(instanceBuffer, instanceTexture, GL_RG32UI);
+  glGenVertexArrays(1, &VAO);
+  createTargets();
+}
+
+VisibilityBufferRenderer::~VisibilityBufferRenderer()
+{
+  deleteTargets();
+  deleteBufferTexture(positionBuffer, positionTexture);
+  deleteBufferTexture(normalBuffer, normalTexture);
+  deleteBufferTexture(indexBuffer, indexTexture);
+  deleteBufferTexture(modelBuffer, modelTexture);
+  deleteBufferTexture(instanceBuffer, instanceTexture);
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteProgram(visibilityShader.ID);
+  glDeleteProgram(shadingShader.ID);
+}
+
+void VisibilityBufferRenderer::createTargets()
+{
+  glGenTextures(1, &idTexture);
+  glBindTexture(GL_TEXTURE_2D, idTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, width, height, 0,
+               GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glGenTextures(1, &depthTexture);
+  glBindTexture(GL_TEXTURE_2D, depthTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0,
+               GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glGenFramebuffers(1, &visibilityFBO);
+  glBindFramebuffer(GL_FRAMEBUFFER, visibilityFBO);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                         idTexture, 0);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D,
+                         depthTexture, 0);
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    std::cout << "ERROR::VISIBILITYBUFFER::FRAMEBUFFER_INCOMPLETE"
+              << std::endl;
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void VisibilityBufferRenderer::deleteTargets()
+{
+  glDeleteFramebuffers(1, &visibilityFBO);
+  glDeleteTextures(1, &idTexture);
+  glDeleteTextures(1, &depthTexture);
+}
+
+void VisibilityBufferRenderer::setSize(int width, int height)
+{
+  if (width <= 0 || height <= 0 ||
+      (width == this->width && height == this->height))
+    return;
+  this->width = width;
+  this->height = height;
+  deleteTargets();
+  createTargets();
+}
+
+void VisibilityBufferRenderer::addMesh(unsigned int VAO,
+                                       const std::vector<float> &positions,
+                                       const std::vector<float> &normals,
+                                       const std::vector<unsigned int> &indices)
+{
+  if (meshes.count(VAO) != 0)
+  {
+    std::cout << "ERROR::VISIBILITYBUFFER::MESH_ALREADY_ADDED" << std::endl;
+    return;
+  }
+  size_t vertexCount = positions.size() / 3;
+  MeshRange range = {(unsigned int)indexData.size(),
+                     (unsigned int)positionData.size(),
+                     (unsigned int)indices.size()};
+  meshes[VAO] = range;
+  for (size_t v = 0; v < vertexCount; v++)
+  {
+    positionData.push_back(glm::vec4(positions[v * 3], positions[v * 3 + 1],
+                                     positions[v * 3 + 2], 1.0f));
+    // zero normals make the shading pass fall back to the face normal
+    if (normals.size() == positions.size())
+      normalData.push_back(glm::vec4(normals[v * 3], normals[v * 3 + 1],
+                                     normals[v * 3 + 2], 0.0f));
+    else
+      normalData.push_back(glm::vec4(0.0f));
+  }
+  indexData.insert(indexData.end(), indices.begin(), indices.end());
+
+  // gl_PrimitiveID counts the triangles of one draw from zero, the id
+  // needs enough low bits for the largest mesh
+  maxTriangles = std::max(maxTriangles, (unsigned int)indices.size() / 3);
+  idTriangleBits = 0;
+  while (idTriangleBits < 32 && (1ull << idTriangleBits) < maxTriangles)
+    idTriangleBits++;
+
+  // meshes are added at load time, the whole buffers are simply rewritten
+  fillBuffer(positionBuffer, positionData.data(),
+             positionData.size() * sizeof(glm::vec4), GL_STATIC_DRAW);
+  fillBuffer(normalBuffer, normalData.data(),
+             normalData.size() * sizeof(glm::vec4), GL_STATIC_DRAW);
+  fillBuffer(indexBuffer, indexData.data(),
+             indexData.size() * sizeof(uint32_t), GL_STATIC_DRAW);
+}
+
+void VisibilityBufferRenderer::uploadInstances()
+{
+  fillBuffer(modelBuffer, models.data(), models.size() * sizeof(glm::mat4),
+             GL_STREAM_DRAW);
+  fillBuffer(instanceBuffer, instanceMeshes.data(),
+             instanceMeshes.size() * sizeof(uint32_t), GL_STREAM_DRAW);
+}
+
+void VisibilityBufferRenderer::render(const std::vector<RenderObject> &objects,
+                                      const glm::mat4 &view,
+                                      const glm::mat4 &projection,
+                                      unsigned int framebuffer)
+{
+  glm::mat4 viewProjection = projection * view;
+  Frustum frustum(viewProjection);
+  // front to back like the forward pass, hidden triangles fail the depth
+  // test early
+  glm::vec4 depthRow(view[0][2], view[1][2], view[2][2], view[3][2]);
+  order.clear();
+  for (size_t i = 0; i < objects.size(); i++)
+  {
+    const AABB &box = objects[i].bounds;
+    if (meshes.count(objects[i].VAO) == 0 || !frustum.intersects(box))
+      continue;
+    glm::vec4 center(0.5f * (box.min + box.max), 1.0f);
+    order.push_back(std::make_pair(-glm::dot(depthRow, center),
+                                   (unsigned int)i));
+  }
+  std::sort(order.begin(), order.end());
+
+  // all ones is the cleared "nothing here" id, the last instance number is
+  // never handed out so no real id can produce it
+  size_t maxInstances = idTriangleBits >= 32
+                        ? 0 : (1ull << (32 - idTriangleBits)) - 1;
+  if (order.size() > maxInstances)
+  {
+    std::cout << "ERROR::VISIBILITYBUFFER::TOO_MANY_INSTANCES" << std::endl;
+    order.resize(maxInstances);
+  }
+
+  models.clear();
+  instanceMeshes.clear();
+  for (const std::pair<float, unsigned int> &entry : order)
+  {
+    const RenderObject &object = objects[entry.second];
+    const MeshRange &range = meshes[object.VAO];
+    models.push_back(object.model);
+    instanceMeshes.push_back(range.firstIndex);
+    instanceMeshes.push_back(range.baseVertex);
+  }
+  uploadInstances();
+
+  GLint previousViewport[4];
+  glGetIntegerv(GL_VIEWPORT, previousViewport);
+  bool depthTest = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+  GLint depthFunc;
+  glGetIntegerv(GL_DEPTH_FUNC, &depthFunc);
+  GLboolean depthMask;
+  glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+
+  // 1. closest triangle per pixel
+  visibilityTimer.begin();
+  glBindFramebuffer(GL_FRAMEBUFFER, visibilityFBO);
+  glViewport(0, 0, width, height);
+  const GLuint empty[4] = {0xffffffffu, 0, 0, 0};
+  glClearBufferuiv(GL_COLOR, 0, empty);
+  // the clear obeys the depth mask
+  glDepthMask(GL_TRUE);
+  glClear(GL_DEPTH_BUFFER_BIT);
+  glEnable(GL_DEPTH_TEST);
+  glDepthFunc(GL_LESS);
+  visibilityShader.use();
+  visibilityShader.setMat4("viewProjection", viewProjection);
+  glUniform1ui(glGetUniformLocation(visibilityShader.ID, "triangleBits"),
+               (GLuint)idTriangleBits);
+  int modelLocation = glGetUniformLocation(visibilityShader.ID, "model");
+  int instanceLocation = glGetUniformLocation(visibilityShader.ID,
+                                              "instance");
+  draws = 0;
+  unsigned int boundVAO = 0;
+  for (size_t k = 0; k < order.size(); k++)
+  {
+    const RenderObject &object = objects[order[k].second];
+    if (object.VAO != boundVAO)
+    {
+      glBindVertexArray(object.VAO);
+      boundVAO = object.VAO;
+    }
+    glUniformMatrix4fv(modelLocation, 1, GL_FALSE, &object.model[0][0]);
+    glUniform1ui(instanceLocation, (GLuint)k);
+    glDrawElements(GL_TRIANGLES, meshes[object.VAO].indexCount,
+                   GL_UNSIGNED_INT, 0);
+    draws++;
+  }
+  visibilityTimer.end();
+
+  // 2. one full-screen triangle shades every covered pixel once
+  shadingTimer.begin();
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  glDisable(GL_DEPTH_TEST);
+  shadingShader.use();
+  shadingShader.setMat4("viewProjection", viewProjection);
+  shadingShader.setVec2("viewportSize", glm::vec2(width, height));
+  shadingShader.setVec3("viewPos", glm::vec3(glm::inverse(view)[3]));
+  glUniform1ui(glGetUniformLocation(shadingShader.ID, "triangleBits"),
+               (GLuint)idTriangleBits);
+  int lightCount = (int)std::min(lights.size(), (size_t)MAX_LIGHTS);
+  shadingShader.setInt("lightCount", lightCount);
+  for (int i = 0; i < lightCount; i++)
+  {
+    std::string index = "[" + std::to_string(i) + "]";
+    shadingShader.setVec4("lightPositions" + index,
+                          glm::vec4(lights[i].position, lights[i].radius));
+    shadingShader.setVec3("lightColors" + index, lights[i].color);
+  }
+  const char* samplers[] = {"ids", "positions", "normals", "indices",
+                            "models", "instances"};
+  unsigned int textures[] = {idTexture, positionTexture, normalTexture,
+                             indexTexture, modelTexture, instanceTexture};
+  for (int unit = 0; unit < 6; unit++)
+  {
+    shadingShader.setInt(samplers[unit], unit);
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(unit == 0 ? GL_TEXTURE_2D : GL_TEXTURE_BUFFER,
+                  textures[unit]);
+  }
+  glBindVertexArray(VAO);
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+  draws++;
+  shadingTimer.end();
+
+  for (int unit = 5; unit >= 0; unit--)
+  {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(unit == 0 ? GL_TEXTURE_2D : GL_TEXTURE_BUFFER, 0);
+  }
+  glBindVertexArray(0);
+  glDepthFunc((GLenum)depthFunc);
+  glDepthMask(depthMask);
+  if (depthTest)
+    glEnable(GL_DEPTH_TEST);
+  glViewport(previousViewport[0], previousViewport[1], previousViewport[2],
+             previousViewport[3]);
+}
+
+unsigned int VisibilityBufferRenderer::drawCalls() const
+{
+  return draws;
+}
+
+unsigned int VisibilityBufferRenderer::instanceCount() const
+{
+  return (unsigned int)models.size();
+}
+
+int VisibilityBufferRenderer::triangleBits() const
+{
+  return idTriangleBits;
+}
+
+double VisibilityBufferRenderer::visibilityGpuMilliseconds()
+{
+  return visibilityTimer.milliseconds();
+}
+
+double VisibilityBufferRenderer::shadingGpuMilliseconds()
+{
+  return shadingTimer.milliseconds();
+}
+
+void VisibilityBufferRenderer::printStats()
+{
+  std::cout << "visibility buffer: " << instanceCount() << " instances, "
+            << meshes.size() << " meshes, " << idTriangleBits
+            << " triangle bits, " << draws << " draws, visibility "
+            << visibilityGpuMilliseconds() << " ms, shading "
+            << shadingGpuMilliseconds() << " ms on the GPU" << std::endl;
+}
@@ -0,0 +1,137 @@
+//
+// Created by Michael Walker on 10/18/2026.
+//
+
+#ifndef COORDINATESPACE_VISIBILITYBUFFER_H
+#define COORDINATESPACE_VISIBILITYBUFFER_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "renderobject.h"
+#include "opaquepass.h"
+#include "gputimer.h"
+
+///////////////////////////////////////////////////////////////////////////
+/*
+ * Visibility buffer
+ *  The GPU shades pixels in 2x2 quads so it can take derivatives. A
+ *  triangle covering a single pixel still runs the fragment shader four
+ *  times, and every vertex of it has its attributes interpolated even when
+ *  the triangle is hidden behind the next one a moment later. With dense
+ *  meshes whose triangles are only a few pixels large most of the shading
+ *  work of the forward pass (opaquepass.h) is thrown away.
+ *
+ *  Rendering here takes two passes:
+ *   1. the visibility pass draws positions only into a 32 bit unsigned
+ *      integer target with the depth test on. Each pixel keeps which
+ *      triangle of which instance is closest:
+ *
+ *        id = instance << triangleBits | gl_PrimitiveID
+ *
+ *      where triangleBits is just enough for the largest registered mesh,
+ *      the remaining bits number the visible instances of this frame.
+ *   2. the shading pass is one full-screen triangle. For its pixel it reads
+ *      the id back, fetches the three indices of the triangle, the vertex
+ *      positions and normals and the instance's model matrix from buffer
+ *      textures and projects the triangle itself. The perspective
+ *      correct barycentric coordinates of the pixel center follow from the
+ *      clip space corners with homogeneous edge functions, never dividing
+ *      by w, so triangles with a corner at or behind the eye (a ground
+ *      plane under the camera) come out right too; they interpolate the
+ *      attributes.
+ *
+ *  Every pixel is shaded exactly once whatever the triangle count, no
+ *  quads are wasted on triangle edges. In exchange the shading pass does
+ *  the vertex work again for each pixel and fetches scattered vertex data,
+ *  so it pays off for dense geometry, not for large triangles.
+ *
+ *  Meshes are registered once with addMesh() under the VAO the objects
+ *  use; their vertices and indices are copied into the shared buffers the
+ *  shading pass reads. Objects with an unregistered VAO are skipped. A
+ *  mesh without normals is shaded with its face normal like in the forward
+ *  pass, lighting and object colors match opaquefs.txt.
+ */
+///////////////////////////////////////////////////////////////////////////
+
+class VisibilityBufferRenderer
+{
+public:
+  static const int MAX_LIGHTS = OpaqueRenderer::MAX_LIGHTS;
+
+  std::vector<PointLight> lights;
+
+  VisibilityBufferRenderer(int width, int height);
+  ~VisibilityBufferRenderer();
+  VisibilityBufferRenderer(const VisibilityBufferRenderer &) = delete;
+  VisibilityBufferRenderer &operator=(const VisibilityBufferRenderer &) =
+          delete;
+
+  void setSize(int width, int height);
+  // positions as xyz triples, normals the same or empty; VAO is the vertex
+  // array the objects drawing this mesh use, attribute 0 must be the
+  // position
+  void addMesh(unsigned int VAO, const std::vector<float> &positions,
+               const std::vector<float> &normals,
+               const std::vector<unsigned int> &indices);
+
+  // cull and draw the objects into the visibility buffer, then shade it
+  // into framebuffer (which is cleared beforehand by the caller)
+  void render(const std::vector<RenderObject> &objects,
+              const glm::mat4 &view, const glm::mat4 &projection,
+              unsigned int framebuffer = 0);
+
+  unsigned int drawCalls() const;
+  unsigned int instanceCount() const;
+  int triangleBits() const;
+  double visibilityGpuMilliseconds();
+  double shadingGpuMilliseconds();
+  void printStats();
+
+private:
+  struct MeshRange
+  {
+    unsigned int firstIndex;
+    unsigned int baseVertex;
+    unsigned int indexCount;
+  };
+
+  int width, height;
+  std::map<unsigned int, MeshRange> meshes;
+  unsigned int maxTriangles;
+  int idTriangleBits;
+
+  // shared geometry of all registered meshes
+  std::vector<glm::vec4> positionData;
+  std::vector<glm::vec4> normalData;
+  std::vector<uint32_t> indexData;
+  unsigned int positionBuffer, positionTexture;
+  unsigned int normalBuffer, normalTexture;
+  unsigned int indexBuffer, indexTexture;
+
+  // per visible instance, rebuilt every frame
+  std::vector<std::pair<float, unsigned int> > order;
+  std::vector<glm::mat4> models;
+  std::vector<uint32_t> instanceMeshes;
+  unsigned int modelBuffer, modelTexture;
+  unsigned int instanceBuffer, instanceTexture;
+
+  unsigned int visibilityFBO;
+  unsigned int idTexture;
+  unsigned int depthTexture;
+  unsigned int VAO;
+
+  Shader visibilityShader;
+  Shader shadingShader;
+  GpuTimer visibilityTimer;
+  GpuTimer shadingTimer;
+  unsigned int draws;
+
+  void createTargets();
+  void deleteTargets();
+  void uploadInstances();
+};
+#endif //COORDINATESPACE_VISIBILITYBUFFER_H